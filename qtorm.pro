@@ -4,7 +4,7 @@ lessThan(QT_MAJOR_VERSION, 5) {
     message("Cannot build current QtOrm sources with Qt version $${QT_VERSION}.")
 }
 
-QTORM_BUILD_PARTS = libs tests examples
+QTORM_BUILD_PARTS = libs tools tests examples
 
 load(configure)
 load(qt_parts)
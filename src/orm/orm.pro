@@ -6,13 +6,21 @@ QMAKE_DOCS = $$PWD/doc/qtorm.qdocconf
 
 PUBLIC_HEADERS += \
     qormabstractprovider.h \
+    qormasynctransaction.h \
+    qormchange.h \
+    qormchangenotifier.h \
     qormclassproperty.h \
+    qormcoroutine.h \
+    qormcursor.h \
+    qormdatagenerator.h \
     qormentityinstancecache.h \
     qormentitylistmodel.h \
     qormerror.h \
     qormfilter.h \
     qormfilterexpression.h \
     qormglobal.h \
+    qormindex.h \
+    qormmemoryreport.h \
     qormmetadata.h \
     qormmetadatacache.h \
     qormorder.h \
@@ -23,18 +31,32 @@ PUBLIC_HEADERS += \
     qormrelation.h \
     qormsession.h \
     qormsessionconfiguration.h \
+    qormsessionpool.h \
+    qormsessionstatistics.h \
     qormsqliteconfiguration.h \
     qormsqliteprovider.h \
+    qormtracer.h \
     qormtransactiontoken.h \
 
 PRIVATE_HEADERS = \
+    qormasyncworker_p.h \
     qormglobal_p.h \
+    qormmemoryreport_p.h \
     qormmetadata_p.h \
+    qormsessionstatistics_p.h \
     qormsqlitestatementgenerator_p.h \
+    qormtracer_p.h \
+    qormworkloadlog_p.h \
 
 SOURCES += \
     qormabstractprovider.cpp \
+    qormasynctransaction.cpp \
+    qormasyncworker_p.cpp \
+    qormchange.cpp \
+    qormchangenotifier.cpp \
     qormclassproperty.cpp \
+    qormcursor.cpp \
+    qormdatagenerator.cpp \
     qormentityinstancecache.cpp \
     qormentitylistmodel.cpp \
     qormerror.cpp \
@@ -42,6 +64,8 @@ SOURCES += \
     qormfilterexpression.cpp \
     qormglobal.cpp \
     qormglobal_p.cpp \
+    qormindex.cpp \
+    qormmemoryreport.cpp \
     qormmetadata.cpp \
     qormmetadatacache.cpp \
     qormorder.cpp \
@@ -52,13 +76,28 @@ SOURCES += \
     qormrelation.cpp \
     qormsession.cpp \
     qormsessionconfiguration.cpp \
+    qormsessionpool.cpp \
+    qormsessionstatistics.cpp \
     qormsqliteconfiguration.cpp \
     qormsqliteprovider.cpp \
     qormsqlitestatementgenerator_p.cpp \
+    qormtracer.cpp \
     qormtransactiontoken.cpp \
+    qormworkloadlog_p.cpp \
 
 HEADERS += $$PUBLIC_HEADERS $$PRIVATE_HEADERS
 
+# The native SQLite API is used for change notifications and engine statistics if enabled with
+# CONFIG+=qtorm_native_sqlite. It must be the same SQLite library the QSQLITE driver is linked
+# against.
+qtorm_native_sqlite {
+    !packagesExist(sqlite3): error("qtorm_native_sqlite requires the SQLite library")
+
+    CONFIG += link_pkgconfig
+    PKGCONFIG_PRIVATE += sqlite3
+    DEFINES += QTORM_HAVE_SQLITE3
+}
+
 load(qt_module)
 
 CONFIG += c++17
@@ -19,9 +19,98 @@
  */
 
 #include "qormabstractprovider.h"
+#include "qormcursor.h"
+#include "qormerror.h"
+
+#include <QtCore/qpointer.h>
+
+#include <algorithm>
+#include <iterator>
 
 QT_BEGIN_NAMESPACE
 
+namespace
+{
+    class ResultCursor : public QOrmAbstractCursor
+    {
+    public:
+        explicit ResultCursor(const QOrmQueryResult<QObject>& result)
+            : m_error{result.error()}
+        {
+            if (!result.hasError())
+            {
+                const QVector<QObject*> instances = result.toVector();
+                m_instances.reserve(instances.size());
+                std::copy(std::cbegin(instances),
+                          std::cend(instances),
+                          std::back_inserter(m_instances));
+            }
+        }
+
+        // Instances deleted in the meantime, e.g. along with the session, are skipped
+        QObject* next() override
+        {
+            while (m_position < m_instances.size())
+            {
+                if (QObject* instance = m_instances[m_position++])
+                    return instance;
+            }
+
+            return nullptr;
+        }
+
+        QOrmError error() const override { return m_error; }
+
+    private:
+        QOrmError m_error;
+        QVector<QPointer<QObject>> m_instances;
+        int m_position{0};
+    };
+} // namespace
+
 QOrmAbstractProvider::~QOrmAbstractProvider() = default;
 
+void QOrmAbstractProvider::setChangeHandler(ChangeHandler handler)
+{
+    Q_UNUSED(handler)
+}
+
+void QOrmAbstractProvider::setStatistics(QOrmSessionStatistics* statistics)
+{
+    Q_UNUSED(statistics)
+}
+
+QOrmError QOrmAbstractProvider::insertRows(const QOrmMetadata& entity,
+                                           const std::vector<const QOrmPropertyMapping*>& columns,
+                                           const RowSource& nextRow)
+{
+    Q_UNUSED(entity)
+    Q_UNUSED(columns)
+    Q_UNUSED(nextRow)
+
+    return QOrmError{QOrm::ErrorType::Other,
+                     QStringLiteral("Bulk inserts are not supported by the provider")};
+}
+
+QOrmAbstractCursor* QOrmAbstractProvider::openCursor(const QOrmQuery& query,
+                                                     QOrmEntityInstanceCache& entityInstanceCache)
+{
+    return new ResultCursor{execute(query, entityInstanceCache)};
+}
+
+qint64 QOrmAbstractProvider::memoryUsed() const
+{
+    return -1;
+}
+
+qint64 QOrmAbstractProvider::memoryHighwater() const
+{
+    return -1;
+}
+
+QOrmAbstractProvider* QOrmAbstractProvider::clone() const
+{
+    return nullptr;
+}
+
 QT_END_NAMESPACE
@@ -21,20 +21,33 @@
 #ifndef QORMABSTRACTPROVIDER_H
 #define QORMABSTRACTPROVIDER_H
 
+#include <QtOrm/qormchange.h>
 #include <QtOrm/qormglobal.h>
 #include <QtOrm/qormqueryresult.h>
 
+#include <functional>
+#include <vector>
+
 QT_BEGIN_NAMESPACE
 
 class QObject;
+class QOrmAbstractCursor;
 class QOrmEntityInstanceCache;
 class QOrmError;
+class QOrmMetadata;
 class QOrmMetadataCache;
+class QOrmPropertyMapping;
 class QOrmQuery;
+class QOrmSessionStatistics;
 
 class Q_ORM_EXPORT QOrmAbstractProvider
 {
 public:
+    using ChangeHandler = std::function<void(const QOrmChangeSet&)>;
+    // Fills the values of the next row in the order of the columns. Returns false after the last
+    // row.
+    using RowSource = std::function<bool(QVariantList& row)>;
+
     virtual ~QOrmAbstractProvider();        
 
     virtual QOrmError connectToBackend() = 0;
@@ -48,7 +61,35 @@ public:
     virtual QOrmQueryResult<QObject> execute(const QOrmQuery& query,
                                              QOrmEntityInstanceCache& entityInstanceCache) = 0;
 
+    // Opens a forward-only cursor over the results of a read query. Providers that cannot step
+    // through the rows of a statement read all of them at once. A cursor must not return any
+    // instances after the provider has been disconnected.
+    [[nodiscard]] virtual QOrmAbstractCursor* openCursor(
+        const QOrmQuery& query,
+        QOrmEntityInstanceCache& entityInstanceCache);
+
     [[nodiscard]] virtual int capabilities() const = 0;
+
+    // Inserts the rows into the table of the entity without creating entity instances. Values of
+    // reference columns are the object IDs of the referenced rows. The rows are reported to the
+    // change handler by a single change.
+    virtual QOrmError insertRows(const QOrmMetadata& entity,
+                                 const std::vector<const QOrmPropertyMapping*>& columns,
+                                 const RowSource& nextRow);
+
+    // Providers able to observe committed row changes report them to the handler.
+    virtual void setChangeHandler(ChangeHandler handler);
+
+    // Providers record the statements they execute into the statistics of the session.
+    virtual void setStatistics(QOrmSessionStatistics* statistics);
+
+    // Memory allocated by the backend in bytes, or -1 if the provider cannot tell.
+    [[nodiscard]] virtual qint64 memoryUsed() const;
+    [[nodiscard]] virtual qint64 memoryHighwater() const;
+
+    // Creates a disconnected provider for the same backend that uses a connection of its own.
+    // Returns nullptr if the backend cannot be shared between connections.
+    [[nodiscard]] virtual QOrmAbstractProvider* clone() const;
 };
 
 QT_END_NAMESPACE
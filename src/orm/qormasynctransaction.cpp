@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2019 Dmitriy Purgin <dmitriy.purgin@sequality.at>
+ * Copyright (C) 2019 sequality software engineering e.U. <office@sequality.at>
+ *
+ * This file is part of QtOrm library.
+ *
+ * QtOrm is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QtOrm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QtOrm.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+
+#include "qormasynctransaction.h"
+
+#include "qormchangenotifier.h"
+#include "qormsession.h"
+
+#include <QtCore/qpointer.h>
+
+QT_BEGIN_NAMESPACE
+
+class QOrmAsyncTransactionPrivate
+{
+    friend class QOrmAsyncTransaction;
+
+    explicit QOrmAsyncTransactionPrivate(QOrmSession* session)
+        : m_session{session}
+        , m_sessionGuard{session->changeNotifier()}
+        , m_begun{session->beginTransactionAsync()}
+    {
+    }
+
+    // QOrmSession is not a QObject, its change notifier lives exactly as long as the session
+    [[nodiscard]] bool isSessionAlive() const { return !m_sessionGuard.isNull(); }
+
+    [[nodiscard]] static QFuture<QOrmError> abandoned()
+    {
+        return QOrmPrivate::AsyncResult<QOrmError>{}.future();
+    }
+
+    QOrmSession* m_session{nullptr};
+    QPointer<QOrmChangeNotifier> m_sessionGuard;
+    QFuture<QOrmError> m_begun;
+    bool m_isActive{true};
+};
+
+QOrmAsyncTransaction::QOrmAsyncTransaction(QOrmSession* session)
+    : d{new QOrmAsyncTransactionPrivate{session}}
+{
+    Q_ASSERT(session != nullptr);
+}
+
+QOrmAsyncTransaction::QOrmAsyncTransaction(QOrmAsyncTransaction&&) = default;
+
+QOrmAsyncTransaction& QOrmAsyncTransaction::operator=(QOrmAsyncTransaction&&) = default;
+
+QOrmAsyncTransaction::~QOrmAsyncTransaction()
+{
+    if (d != nullptr && d->m_isActive && d->isSessionAlive())
+    {
+        QFuture<QOrmError> rolledBack = d->m_session->rollbackTransactionAsync();
+        Q_UNUSED(rolledBack)
+    }
+}
+
+QFuture<QOrmError> QOrmAsyncTransaction::begun() const
+{
+    return d->m_begun;
+}
+
+bool QOrmAsyncTransaction::isActive() const
+{
+    return d->m_isActive;
+}
+
+QFuture<QOrmError> QOrmAsyncTransaction::commit()
+{
+    Q_ASSERT(d->m_isActive);
+
+    d->m_isActive = false;
+    return d->isSessionAlive() ? d->m_session->commitTransactionAsync()
+                               : QOrmAsyncTransactionPrivate::abandoned();
+}
+
+QFuture<QOrmError> QOrmAsyncTransaction::rollback()
+{
+    Q_ASSERT(d->m_isActive);
+
+    d->m_isActive = false;
+    return d->isSessionAlive() ? d->m_session->rollbackTransactionAsync()
+                               : QOrmAsyncTransactionPrivate::abandoned();
+}
+
+QT_END_NAMESPACE
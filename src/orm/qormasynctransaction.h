@@ -0,0 +1,65 @@
+/*
+ * Copyright (C) 2019 Dmitriy Purgin <dmitriy.purgin@sequality.at>
+ * Copyright (C) 2019 sequality software engineering e.U. <office@sequality.at>
+ *
+ * This file is part of QtOrm library.
+ *
+ * QtOrm is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QtOrm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QtOrm.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+
+#ifndef QORMASYNCTRANSACTION_H
+#define QORMASYNCTRANSACTION_H
+
+#include <QtOrm/qormerror.h>
+#include <QtOrm/qormglobal.h>
+
+#include <QtCore/qfuture.h>
+
+#include <memory>
+
+QT_BEGIN_NAMESPACE
+
+class QOrmSession;
+class QOrmAsyncTransactionPrivate;
+
+// Transaction of the database thread of a session. It is begun on construction and rolled back on
+// destruction unless it has been committed or rolled back before. If the session is destroyed
+// first, the transaction is abandoned along with it and commit() and rollback() return canceled
+// futures.
+class Q_ORM_EXPORT QOrmAsyncTransaction
+{
+public:
+    explicit QOrmAsyncTransaction(QOrmSession* session);
+    QOrmAsyncTransaction(const QOrmAsyncTransaction&) = delete;
+    QOrmAsyncTransaction(QOrmAsyncTransaction&&);
+    ~QOrmAsyncTransaction();
+
+    QOrmAsyncTransaction& operator=(const QOrmAsyncTransaction&) = delete;
+    QOrmAsyncTransaction& operator=(QOrmAsyncTransaction&&);
+
+    Q_REQUIRED_RESULT QFuture<QOrmError> begun() const;
+    Q_REQUIRED_RESULT bool isActive() const;
+
+    QFuture<QOrmError> commit();
+    QFuture<QOrmError> rollback();
+
+private:
+    std::unique_ptr<QOrmAsyncTransactionPrivate> d;
+};
+
+QT_END_NAMESPACE
+
+#endif // QORMASYNCTRANSACTION_H
@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2019 Dmitriy Purgin <dmitriy.purgin@sequality.at>
+ * Copyright (C) 2019 sequality software engineering e.U. <office@sequality.at>
+ *
+ * This file is part of QtOrm library.
+ *
+ * QtOrm is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QtOrm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QtOrm.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "qormasyncworker_p.h"
+
+#include "qormabstractprovider.h"
+#include "qormerror.h"
+
+QT_BEGIN_NAMESPACE
+
+namespace QOrmPrivate
+{
+    AsyncWorker::AsyncWorker(QOrmAbstractProvider* provider)
+        : m_provider{provider}
+        , m_workerContext{new QObject}
+    {
+        Q_ASSERT(provider != nullptr);
+
+        m_thread.setObjectName(QStringLiteral("QtOrm database thread"));
+        m_workerContext->moveToThread(&m_thread);
+        m_thread.start();
+    }
+
+    AsyncWorker::~AsyncWorker()
+    {
+        // Queued after the pending tasks. The connection must be closed in the thread that opened
+        // it.
+        QMetaObject::invokeMethod(
+            m_workerContext,
+            [this]() {
+                if (m_provider->isConnectedToBackend())
+                    m_provider->disconnectFromBackend();
+
+                m_provider.reset();
+                m_thread.quit();
+            },
+            Qt::QueuedConnection);
+
+        m_thread.wait();
+        delete m_workerContext;
+    }
+
+    void AsyncWorker::post(Task task)
+    {
+        QMetaObject::invokeMethod(
+            m_workerContext,
+            [this, task]() {
+                QOrmError connectionError;
+
+                if (!m_provider->isConnectedToBackend())
+                    connectionError = m_provider->connectToBackend();
+
+                task(*m_provider, connectionError);
+            },
+            Qt::QueuedConnection);
+    }
+
+    void AsyncWorker::deliver(std::function<void()> delivery)
+    {
+        QMetaObject::invokeMethod(&m_ownerContext, std::move(delivery), Qt::QueuedConnection);
+    }
+} // namespace QOrmPrivate
+
+QT_END_NAMESPACE
@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2019 Dmitriy Purgin <dmitriy.purgin@sequality.at>
+ * Copyright (C) 2019 sequality software engineering e.U. <office@sequality.at>
+ *
+ * This file is part of QtOrm library.
+ *
+ * QtOrm is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QtOrm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QtOrm.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef QORMASYNCWORKER_P_H
+#define QORMASYNCWORKER_P_H
+
+#include <QtOrm/qormglobal.h>
+
+#include <QtCore/qobject.h>
+#include <QtCore/qthread.h>
+
+#include <functional>
+#include <memory>
+
+QT_BEGIN_NAMESPACE
+
+class QOrmAbstractProvider;
+class QOrmError;
+
+namespace QOrmPrivate
+{
+    // Database thread of a session. It owns a provider with a connection of its own and runs the
+    // posted tasks one after another. Deliveries run in the thread that created the worker.
+    class AsyncWorker
+    {
+        Q_DISABLE_COPY(AsyncWorker)
+
+    public:
+        // The provider is connected before the task runs; the error tells whether that failed
+        using Task =
+            std::function<void(QOrmAbstractProvider& provider, const QOrmError& connectionError)>;
+
+        // Takes the ownership of the provider
+        explicit AsyncWorker(QOrmAbstractProvider* provider);
+        // Waits for the posted tasks to finish. Pending deliveries are discarded.
+        ~AsyncWorker();
+
+        void post(Task task);
+        void deliver(std::function<void()> delivery);
+
+        [[nodiscard]] QThread* ownerThread() const { return m_ownerContext.thread(); }
+
+    private:
+        std::unique_ptr<QOrmAbstractProvider> m_provider;
+        QThread m_thread;
+        QObject* m_workerContext{nullptr};
+        QObject m_ownerContext;
+    };
+} // namespace QOrmPrivate
+
+QT_END_NAMESPACE
+
+#endif // QORMASYNCWORKER_P_H
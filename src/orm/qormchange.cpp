@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2019 Dmitriy Purgin <dmitriy.purgin@sequality.at>
+ * Copyright (C) 2019 sequality software engineering e.U. <office@sequality.at>
+ *
+ * This file is part of QtOrm library.
+ *
+ * QtOrm is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QtOrm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QtOrm.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "qormchange.h"
+
+#include <QtCore/qdebug.h>
+
+QT_BEGIN_NAMESPACE
+
+QOrmChange::QOrmChange() = default;
+
+QOrmChange::QOrmChange(const QString& tableName,
+                       QOrm::Operation operation,
+                       qint64 rowId,
+                       qint64 rowCount)
+    : m_tableName{tableName}
+    , m_operation{operation}
+    , m_rowId{rowId}
+    , m_rowCount{rowCount}
+{
+}
+
+QString QOrmChange::tableName() const
+{
+    return m_tableName;
+}
+
+QOrm::Operation QOrmChange::operation() const
+{
+    return m_operation;
+}
+
+qint64 QOrmChange::rowId() const
+{
+    return m_rowId;
+}
+
+qint64 QOrmChange::rowCount() const
+{
+    return m_rowCount;
+}
+
+QDebug operator<<(QDebug dbg, const QOrmChange& change)
+{
+    QDebugStateSaver saver{dbg};
+
+    dbg.nospace().noquote() << "QOrmChange(" << change.tableName() << ", " << change.operation()
+                            << ", " << change.rowId();
+
+    if (change.rowCount() != 1)
+        dbg << ", " << change.rowCount() << " rows";
+
+    dbg << ")";
+
+    return dbg;
+}
+
+QT_END_NAMESPACE
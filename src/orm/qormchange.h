@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2019 Dmitriy Purgin <dmitriy.purgin@sequality.at>
+ * Copyright (C) 2019 sequality software engineering e.U. <office@sequality.at>
+ *
+ * This file is part of QtOrm library.
+ *
+ * QtOrm is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QtOrm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QtOrm.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef QORMCHANGE_H
+#define QORMCHANGE_H
+
+#include <QtOrm/qormglobal.h>
+
+#include <QtCore/qmetatype.h>
+#include <QtCore/qstring.h>
+#include <QtCore/qvector.h>
+
+QT_BEGIN_NAMESPACE
+
+class QDebug;
+
+class Q_ORM_EXPORT QOrmChange
+{
+public:
+    QOrmChange();
+    QOrmChange(const QString& tableName,
+               QOrm::Operation operation,
+               qint64 rowId,
+               qint64 rowCount = 1);
+
+    [[nodiscard]] QString tableName() const;
+    [[nodiscard]] QOrm::Operation operation() const;
+    // Rows inserted in bulk are reported by a single change without a row ID. If other rows of
+    // the table change in the same transaction, the table is reported by an update without a row
+    // ID and a row count of 0 instead.
+    [[nodiscard]] qint64 rowId() const;
+    [[nodiscard]] qint64 rowCount() const;
+
+private:
+    QString m_tableName;
+    QOrm::Operation m_operation{QOrm::Operation::Update};
+    qint64 m_rowId{0};
+    qint64 m_rowCount{1};
+};
+
+using QOrmChangeSet = QVector<QOrmChange>;
+
+extern Q_ORM_EXPORT QDebug operator<<(QDebug dbg, const QOrmChange& change);
+
+QT_END_NAMESPACE
+
+Q_DECLARE_METATYPE(QOrmChange)
+
+#endif // QORMCHANGE_H
@@ -0,0 +1,47 @@
+/*
+ * Copyright (C) 2019 Dmitriy Purgin <dmitriy.purgin@sequality.at>
+ * Copyright (C) 2019 sequality software engineering e.U. <office@sequality.at>
+ *
+ * This file is part of QtOrm library.
+ *
+ * QtOrm is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QtOrm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QtOrm.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef QORMCHANGENOTIFIER_H
+#define QORMCHANGENOTIFIER_H
+
+#include <QtOrm/qormchange.h>
+#include <QtOrm/qormglobal.h>
+
+#include <QtCore/qobject.h>
+
+QT_BEGIN_NAMESPACE
+
+// Publishes the rows changed through a session's connection. Changes are coalesced per
+// transaction and delivered once the transaction has been committed.
+class Q_ORM_EXPORT QOrmChangeNotifier : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit QOrmChangeNotifier(QObject* parent = nullptr);
+    ~QOrmChangeNotifier() override;
+
+Q_SIGNALS:
+    void changesCommitted(const QOrmChangeSet& changes);
+};
+
+QT_END_NAMESPACE
+
+#endif // QORMCHANGENOTIFIER_H
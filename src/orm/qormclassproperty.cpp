@@ -54,4 +54,14 @@ QOrmFilterExpression QOrmClassProperty::notContains(const QVariant& value) const
     return QOrmFilterTerminalPredicate{*this, QOrm::Comparison::NotContains, value};
 }
 
+QOrmFilterExpression QOrmClassProperty::equalsIgnoreCase(const QVariant& value) const
+{
+    return QOrmFilterTerminalPredicate{*this, QOrm::Comparison::EqualIgnoreCase, value};
+}
+
+QOrmFilterExpression QOrmClassProperty::notEqualsIgnoreCase(const QVariant& value) const
+{
+    return QOrmFilterTerminalPredicate{*this, QOrm::Comparison::NotEqualIgnoreCase, value};
+}
+
 QT_END_NAMESPACE
@@ -39,6 +39,11 @@ public:
     QOrmFilterExpression contains(const QVariant& value) const;
     QOrmFilterExpression notContains(const QVariant& value) const;
 
+    // Compares case-insensitively as lower(<column>) = lower(<value>), which can use an index
+    // declared with Q_ORM_CLASS(INDEX (lower(<property>)))
+    QOrmFilterExpression equalsIgnoreCase(const QVariant& value) const;
+    QOrmFilterExpression notEqualsIgnoreCase(const QVariant& value) const;
+
 private:
     QString m_descriptor;
 };
@@ -0,0 +1,189 @@
+/*
+ * Copyright (C) 2019 Dmitriy Purgin <dmitriy.purgin@sequality.at>
+ * Copyright (C) 2019 sequality software engineering e.U. <office@sequality.at>
+ *
+ * This file is part of QtOrm library.
+ *
+ * QtOrm is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QtOrm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QtOrm.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+
+#ifndef QORMCOROUTINE_H
+#define QORMCOROUTINE_H
+
+#include <QtOrm/qormerror.h>
+#include <QtOrm/qormglobal.h>
+#include <QtOrm/qormqueryresult.h>
+
+#include <QtCore/qfuture.h>
+#include <QtCore/qfuturewatcher.h>
+
+// The awaitables are only available if QtOrm is used from C++20 code
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+
+#define QTORM_HAVE_COROUTINES
+
+#include <coroutine>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <type_traits>
+
+QT_BEGIN_NAMESPACE
+
+namespace QOrmPrivate
+{
+    // Suspends the coroutine until the future has finished. The coroutine is resumed by the event
+    // loop of the awaiting thread.
+    template<typename R>
+    class FutureAwaiter
+    {
+    public:
+        explicit FutureAwaiter(QFuture<R> future)
+            : m_future{std::move(future)}
+        {
+        }
+
+        [[nodiscard]] bool await_ready() const { return m_future.isFinished(); }
+
+        void await_suspend(std::coroutine_handle<> handle)
+        {
+            auto* watcher = new QFutureWatcher<R>{};
+
+            QObject::connect(watcher, &QFutureWatcherBase::finished, watcher, [watcher, handle]() {
+                watcher->deleteLater();
+                handle.resume();
+            });
+
+            watcher->setFuture(m_future);
+        }
+
+        // A canceled operation has been abandoned by its session
+        [[nodiscard]] R await_resume() const
+        {
+            if (m_future.resultCount() == 0)
+            {
+                return R{QOrmError{QOrm::ErrorType::Other,
+                                   QStringLiteral("The operation was canceled")}};
+            }
+
+            return m_future.result();
+        }
+
+    private:
+        QFuture<R> m_future;
+    };
+
+    template<typename T>
+    struct TaskState
+    {
+        std::optional<T> value;
+        std::coroutine_handle<> continuation;
+        bool isDone{false};
+    };
+
+    template<>
+    struct TaskState<void>
+    {
+        std::coroutine_handle<> continuation;
+        bool isDone{false};
+    };
+
+    template<typename T>
+    struct TaskPromiseBase
+    {
+        std::shared_ptr<TaskState<T>> state{std::make_shared<TaskState<T>>()};
+
+        void return_value(T value) { state->value = std::move(value); }
+    };
+
+    template<>
+    struct TaskPromiseBase<void>
+    {
+        std::shared_ptr<TaskState<void>> state{std::make_shared<TaskState<void>>()};
+
+        void return_void() {}
+    };
+} // namespace QOrmPrivate
+
+template<typename T>
+[[nodiscard]] QOrmPrivate::FutureAwaiter<QOrmQueryResult<T>> operator co_await(
+    QFuture<QOrmQueryResult<T>> future)
+{
+    return QOrmPrivate::FutureAwaiter<QOrmQueryResult<T>>{std::move(future)};
+}
+
+[[nodiscard]] inline QOrmPrivate::FutureAwaiter<QOrmError> operator co_await(
+    QFuture<QOrmError> future)
+{
+    return QOrmPrivate::FutureAwaiter<QOrmError>{std::move(future)};
+}
+
+// Coroutine that starts right away and frees itself when it has finished, whether the task is
+// kept or not. Another coroutine of the same thread can co_await its result.
+template<typename T = void>
+class QOrmTask
+{
+public:
+    struct promise_type : QOrmPrivate::TaskPromiseBase<T>
+    {
+        struct FinalAwaiter
+        {
+            [[nodiscard]] bool await_ready() const noexcept { return false; }
+
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> handle)
+                noexcept
+            {
+                std::shared_ptr<QOrmPrivate::TaskState<T>> state = handle.promise().state;
+                state->isDone = true;
+                handle.destroy();
+
+                return state->continuation ? state->continuation : std::noop_coroutine();
+            }
+
+            void await_resume() const noexcept {}
+        };
+
+        QOrmTask get_return_object() { return QOrmTask{this->state}; }
+        std::suspend_never initial_suspend() const noexcept { return {}; }
+        FinalAwaiter final_suspend() const noexcept { return {}; }
+        void unhandled_exception() const noexcept { std::terminate(); }
+    };
+
+    [[nodiscard]] bool isDone() const { return m_state->isDone; }
+
+    [[nodiscard]] bool await_ready() const { return m_state->isDone; }
+    void await_suspend(std::coroutine_handle<> handle) { m_state->continuation = handle; }
+
+    T await_resume()
+    {
+        if constexpr (!std::is_void_v<T>)
+            return std::move(*m_state->value);
+    }
+
+private:
+    explicit QOrmTask(std::shared_ptr<QOrmPrivate::TaskState<T>> state)
+        : m_state{std::move(state)}
+    {
+    }
+
+    std::shared_ptr<QOrmPrivate::TaskState<T>> m_state;
+};
+
+QT_END_NAMESPACE
+
+#endif
+
+#endif // QORMCOROUTINE_H
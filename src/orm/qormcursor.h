@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2019 Dmitriy Purgin <dmitriy.purgin@sequality.at>
+ * Copyright (C) 2019 sequality software engineering e.U. <office@sequality.at>
+ *
+ * This file is part of QtOrm library.
+ *
+ * QtOrm is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QtOrm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QtOrm.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+
+#ifndef QORMCURSOR_H
+#define QORMCURSOR_H
+
+#include <QtOrm/qormerror.h>
+#include <QtOrm/qormglobal.h>
+
+#include <QtCore/qobject.h>
+
+#include <iterator>
+#include <memory>
+#include <type_traits>
+
+QT_BEGIN_NAMESPACE
+
+// Forward-only source of the entity instances read by a query. Implemented by the providers.
+class Q_ORM_EXPORT QOrmAbstractCursor
+{
+public:
+    virtual ~QOrmAbstractCursor();
+
+    // Returns the entity instance of the next row, or nullptr after the last row or on error
+    [[nodiscard]] virtual QObject* next() = 0;
+    [[nodiscard]] virtual QOrmError error() const = 0;
+};
+
+// Forward-only range over the results of a query. The rows are read from the database one at a
+// time while iterating. The cursor returns no more rows once its session has been destroyed.
+template<typename T>
+class QOrmCursor
+{
+public:
+    using Projection = T;
+    static_assert(std::is_convertible_v<Projection*, QObject*>,
+                  "Projection entity must be inherited from QObject");
+
+    class iterator
+    {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = Projection*;
+        using difference_type = std::ptrdiff_t;
+        using pointer = Projection* const*;
+        using reference = Projection* const&;
+
+        iterator() = default;
+
+        [[nodiscard]] reference operator*() const { return m_current; }
+
+        iterator& operator++()
+        {
+            m_current = m_cursor->next();
+            return *this;
+        }
+
+        [[nodiscard]] bool operator==(const iterator& other) const
+        {
+            return m_current == other.m_current;
+        }
+
+        [[nodiscard]] bool operator!=(const iterator& other) const { return !(*this == other); }
+
+    private:
+        friend class QOrmCursor;
+
+        iterator(QOrmCursor* cursor, Projection* current)
+            : m_cursor{cursor}
+            , m_current{current}
+        {
+        }
+
+        QOrmCursor* m_cursor{nullptr};
+        Projection* m_current{nullptr};
+    };
+
+    explicit QOrmCursor(std::unique_ptr<QOrmAbstractCursor> cursor)
+        : m_cursor{std::move(cursor)}
+    {
+        Q_ASSERT(m_cursor != nullptr);
+    }
+
+    QOrmCursor(const QOrmCursor&) = delete;
+    QOrmCursor(QOrmCursor&&) = default;
+
+    QOrmCursor& operator=(const QOrmCursor&) = delete;
+    QOrmCursor& operator=(QOrmCursor&&) = default;
+
+    // Reads the first row: the cursor can only be iterated once
+    [[nodiscard]] iterator begin() { return iterator{this, next()}; }
+    [[nodiscard]] iterator end() { return iterator{}; }
+
+    // Returns nullptr after the last row or on error
+    [[nodiscard]] Projection* next() { return static_cast<Projection*>(m_cursor->next()); }
+
+    [[nodiscard]] QOrmError error() const { return m_cursor->error(); }
+    [[nodiscard]] bool hasError() const { return error().type() != QOrm::ErrorType::None; }
+
+private:
+    std::unique_ptr<QOrmAbstractCursor> m_cursor;
+};
+
+QT_END_NAMESPACE
+
+#endif // QORMCURSOR_H
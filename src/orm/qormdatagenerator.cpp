@@ -0,0 +1,662 @@
+/*
+ * Copyright (C) 2019 Dmitriy Purgin <dmitriy.purgin@sequality.at>
+ * Copyright (C) 2019 sequality software engineering e.U. <office@sequality.at>
+ *
+ * This file is part of QtOrm library.
+ *
+ * QtOrm is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QtOrm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QtOrm.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "qormdatagenerator.h"
+
+#include "qormabstractprovider.h"
+#include "qormentityinstancecache.h"
+#include "qormerror.h"
+#include "qormmetadata.h"
+#include "qormmetadatacache.h"
+#include "qormorder.h"
+#include "qormpropertymapping.h"
+#include "qormquery.h"
+#include "qormqueryresult.h"
+#include "qormrelation.h"
+#include "qormsession.h"
+#include "qormtransactiontoken.h"
+
+#include <QtCore/qdatetime.h>
+#include <QtCore/qhash.h>
+#include <QtCore/qset.h>
+
+#include <cmath>
+#include <optional>
+#include <vector>
+
+QT_BEGIN_NAMESPACE
+
+namespace
+{
+    // SplitMix64, see http://prng.di.unimi.it/splitmix64.c. Unlike the engines and distributions
+    // of <random>, it yields the same values on every platform.
+    class SplitMix64
+    {
+    public:
+        explicit SplitMix64(quint64 state)
+            : m_state{state}
+        {
+        }
+
+        quint64 next()
+        {
+            quint64 z = (m_state += 0x9e3779b97f4a7c15);
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+            return z ^ (z >> 31);
+        }
+
+        // [0, 1)
+        double nextDouble() { return static_cast<double>(next() >> 11) * 0x1.0p-53; }
+
+        qint64 nextInt(qint64 minimum, qint64 maximum)
+        {
+            return minimum + static_cast<qint64>(nextDouble() * (maximum - minimum + 1));
+        }
+
+    private:
+        quint64 m_state;
+    };
+
+    // FNV-1a; qHash() is seeded per process
+    quint64 stableHash(const QString& string)
+    {
+        quint64 hash = 0xcbf29ce484222325;
+
+        for (char byte : string.toUtf8())
+        {
+            hash ^= static_cast<uchar>(byte);
+            hash *= 0x100000001b3;
+        }
+
+        return hash;
+    }
+
+    const QDateTime& epoch()
+    {
+        static const QDateTime epoch{QDate{2000, 1, 1}, QTime{0, 0}, Qt::UTC};
+        return epoch;
+    }
+
+    struct IdRange
+    {
+        qint64 first{0};
+        qint64 count{0};
+    };
+
+    struct PropertyOptions
+    {
+        std::optional<double> minimum;
+        std::optional<double> maximum;
+        std::optional<QOrmDataGenerator::Distribution> distribution;
+        int minimumLength{8};
+        int maximumLength{16};
+        QString pattern;
+    };
+
+    struct EntityOptions
+    {
+        qint64 rowCount{0};
+        QHash<QString, PropertyOptions> properties;
+    };
+
+    struct ColumnGenerator
+    {
+        const QOrmPropertyMapping* mapping{nullptr};
+        PropertyOptions options;
+        quint64 streamSeed{0};
+        double minimum{0};
+        double maximum{0};
+        QOrmDataGenerator::Distribution distribution{QOrmDataGenerator::Distribution::Uniform};
+        std::optional<IdRange> referencedIds;
+    };
+} // namespace
+
+class QOrmDataGeneratorPrivate
+{
+    Q_DECLARE_PUBLIC(QOrmDataGenerator)
+    QOrmDataGenerator* q_ptr{nullptr};
+
+public:
+    QOrmDataGeneratorPrivate(QOrmSession* session, quint64 seed, QOrmDataGenerator* parent)
+        : q_ptr{parent}
+        , m_session{session}
+        , m_seed{seed}
+    {
+    }
+
+    QOrmSession* m_session{nullptr};
+    quint64 m_seed{0};
+
+    QHash<const QMetaObject*, EntityOptions> m_entities;
+    QHash<const QMetaObject*, IdRange> m_generatedIds;
+
+    [[nodiscard]] QOrmError sortEntities(const QMetaObject* entity,
+                                         QSet<const QMetaObject*>& visiting,
+                                         QVector<const QMetaObject*>& sorted);
+    [[nodiscard]] QOrmError maximumObjectId(const QOrmMetadata& entity, qint64& objectId);
+    [[nodiscard]] QOrmError generateEntity(const QMetaObject& qMetaObject);
+    [[nodiscard]] QOrmError makeColumnGenerator(const QOrmMetadata& entity,
+                                                const QOrmPropertyMapping& mapping,
+                                                ColumnGenerator& generator);
+
+    [[nodiscard]] static double offset(QOrmDataGenerator::Distribution distribution,
+                                       qint64 rowNumber,
+                                       double valueCount,
+                                       SplitMix64& random);
+    [[nodiscard]] static QVariant value(const ColumnGenerator& generator, qint64 rowNumber);
+};
+
+// Orders the entities so that every entity is generated after the entities it references
+QOrmError QOrmDataGeneratorPrivate::sortEntities(const QMetaObject* entity,
+                                                 QSet<const QMetaObject*>& visiting,
+                                                 QVector<const QMetaObject*>& sorted)
+{
+    if (sorted.contains(entity))
+        return QOrmError{QOrm::ErrorType::None, {}};
+
+    if (visiting.contains(entity))
+    {
+        return QOrmError{QOrm::ErrorType::Other,
+                         QStringLiteral("Unable to generate cyclic references of %1")
+                             .arg(QString::fromUtf8(entity->className()))};
+    }
+
+    visiting.insert(entity);
+
+    const QOrmMetadata& metadata = (*m_session->metadataCache())[*entity];
+
+    for (const QOrmPropertyMapping& mapping : metadata.propertyMappings())
+    {
+        if (!mapping.isReference() || mapping.isTransient())
+            continue;
+
+        const QMetaObject* referenced = &mapping.referencedEntity()->qMetaObject();
+
+        if (referenced != entity && m_entities.value(referenced).rowCount > 0)
+        {
+            QOrmError error = sortEntities(referenced, visiting, sorted);
+
+            if (error.type() != QOrm::ErrorType::None)
+                return error;
+        }
+    }
+
+    visiting.remove(entity);
+    sorted.push_back(entity);
+
+    return QOrmError{QOrm::ErrorType::None, {}};
+}
+
+// Reading the row with the largest object ID also brings the schema of the entity up to date
+QOrmError QOrmDataGeneratorPrivate::maximumObjectId(const QOrmMetadata& entity, qint64& objectId)
+{
+    const QOrmPropertyMapping* objectIdMapping = entity.objectIdMapping();
+
+    QOrmQuery query{QOrm::Operation::Read,
+                    QOrmRelation{entity},
+                    std::nullopt,
+                    std::nullopt,
+                    std::nullopt,
+                    {QOrmOrder{*objectIdMapping, Qt::DescendingOrder}},
+                    QOrm::QueryFlags::None};
+    query.setLimit(1);
+
+    // The instance is read into a cache of its own and deleted with it, so that neither the
+    // instance nor the ones it references stay in the cache of the session
+    QOrmEntityInstanceCache entityInstanceCache;
+    QOrmQueryResult<QObject> result =
+        m_session->configuration().provider()->execute(query, entityInstanceCache);
+
+    if (result.error().type() != QOrm::ErrorType::None)
+        return result.error();
+
+    const QVector<QObject*> instances = result.toVector();
+
+    objectId = instances.isEmpty()
+                   ? 0
+                   : objectIdMapping->qMetaProperty().read(instances.first()).toLongLong();
+
+    // Instances the provider did not put into the cache are owned by the caller
+    for (QObject* instance : instances)
+    {
+        if (!entityInstanceCache.contains(instance))
+            delete instance;
+    }
+
+    return QOrmError{QOrm::ErrorType::None, {}};
+}
+
+QOrmError QOrmDataGeneratorPrivate::makeColumnGenerator(const QOrmMetadata& entity,
+                                                        const QOrmPropertyMapping& mapping,
+                                                        ColumnGenerator& generator)
+{
+    generator.mapping = &mapping;
+    generator.options = m_entities.value(&entity.qMetaObject())
+                            .properties.value(mapping.classPropertyName());
+    generator.streamSeed =
+        SplitMix64{m_seed}.next() ^
+        stableHash(entity.className() + QStringLiteral("::") + mapping.classPropertyName());
+
+    if (mapping.isReference())
+    {
+        auto it = m_generatedIds.constFind(&mapping.referencedEntity()->qMetaObject());
+
+        if (it != m_generatedIds.constEnd() && it->count > 0)
+            generator.referencedIds = *it;
+
+        generator.distribution =
+            generator.options.distribution.value_or(QOrmDataGenerator::Distribution::Uniform);
+
+        return QOrmError{QOrm::ErrorType::None, {}};
+    }
+
+    double defaultMaximum = 0;
+
+    switch (mapping.dataType())
+    {
+        case QVariant::Bool:
+            defaultMaximum = 1;
+            break;
+
+        case QVariant::Int:
+        case QVariant::UInt:
+        case QVariant::LongLong:
+        case QVariant::ULongLong:
+            defaultMaximum = 1000000;
+            break;
+
+        case QVariant::Double:
+            defaultMaximum = 1;
+            break;
+
+        case QVariant::Date:
+            defaultMaximum = 9131;
+            break;
+
+        case QVariant::DateTime:
+            defaultMaximum = 788918399;
+            break;
+
+        case QVariant::Time:
+            defaultMaximum = 86399999;
+            break;
+
+        case QVariant::String:
+        case QVariant::ByteArray:
+            break;
+
+        default:
+            return QOrmError{QOrm::ErrorType::InvalidMapping,
+                             QStringLiteral("Unable to generate values of type %1 for %2::%3")
+                                 .arg(mapping.dataTypeName(),
+                                      entity.className(),
+                                      mapping.classPropertyName())};
+    }
+
+    generator.minimum = generator.options.minimum.value_or(0);
+    generator.maximum = generator.options.maximum.value_or(defaultMaximum);
+    generator.distribution =
+        generator.options.distribution.value_or(QOrmDataGenerator::Distribution::Uniform);
+
+    if (generator.maximum < generator.minimum)
+    {
+        return QOrmError{QOrm::ErrorType::Other,
+                         QStringLiteral("Invalid value range of %1::%2")
+                             .arg(entity.className(), mapping.classPropertyName())};
+    }
+
+    return QOrmError{QOrm::ErrorType::None, {}};
+}
+
+// Offset in [0, valueCount) of the value of the row from the beginning of the range
+double QOrmDataGeneratorPrivate::offset(QOrmDataGenerator::Distribution distribution,
+                                        qint64 rowNumber,
+                                        double valueCount,
+                                        SplitMix64& random)
+{
+    constexpr double LargestFraction = 1.0 - 0x1.0p-53;
+
+    switch (distribution)
+    {
+        case QOrmDataGenerator::Distribution::Sequential:
+            return std::fmod(static_cast<double>(rowNumber - 1), valueCount);
+
+        case QOrmDataGenerator::Distribution::Uniform:
+            return random.nextDouble() * valueCount;
+
+        case QOrmDataGenerator::Distribution::Normal:
+        {
+            // Box-Muller transform
+            constexpr double Pi = 3.14159265358979323846;
+            double u1 = 1.0 - random.nextDouble();
+            double u2 = random.nextDouble();
+            double z = std::sqrt(-2.0 * std::log(u1)) * std::cos(2.0 * Pi * u2);
+
+            return qBound(0.0, 0.5 + z / 6.0, LargestFraction) * valueCount;
+        }
+
+        case QOrmDataGenerator::Distribution::Zipf:
+        {
+            // Inverse of the continuous approximation of the distribution with exponent 1
+            double fraction = (std::pow(valueCount + 1.0, random.nextDouble()) - 1.0) / valueCount;
+            return qBound(0.0, fraction, LargestFraction) * valueCount;
+        }
+    }
+
+    Q_ORM_UNEXPECTED_STATE;
+}
+
+QVariant QOrmDataGeneratorPrivate::value(const ColumnGenerator& generator, qint64 rowNumber)
+{
+    SplitMix64 random{generator.streamSeed ^ SplitMix64{static_cast<quint64>(rowNumber)}.next()};
+    const QOrmPropertyMapping& mapping = *generator.mapping;
+
+    if (mapping.isReference())
+    {
+        if (!generator.referencedIds.has_value())
+            return QVariant::fromValue(nullptr);
+
+        const IdRange& ids = *generator.referencedIds;
+        double index = offset(generator.distribution, rowNumber, ids.count, random);
+
+        return ids.first + static_cast<qint64>(index);
+    }
+
+    if (mapping.dataType() == QVariant::String && !generator.options.pattern.isEmpty())
+        return generator.options.pattern.arg(rowNumber);
+
+    if (mapping.dataType() == QVariant::String || mapping.dataType() == QVariant::ByteArray)
+    {
+        int length = static_cast<int>(
+            random.nextInt(generator.options.minimumLength, generator.options.maximumLength));
+
+        if (mapping.dataType() == QVariant::ByteArray)
+        {
+            QByteArray bytes{length, Qt::Uninitialized};
+
+            for (char& byte : bytes)
+                byte = static_cast<char>(random.next());
+
+            return bytes;
+        }
+
+        QString string{length, Qt::Uninitialized};
+
+        for (QChar& character : string)
+            character = QLatin1Char(static_cast<char>('a' + random.nextInt(0, 25)));
+
+        return string;
+    }
+
+    bool isIntegral = mapping.dataType() != QVariant::Double;
+    double minimum = isIntegral ? std::ceil(generator.minimum) : generator.minimum;
+    double valueCount = isIntegral ? std::floor(generator.maximum) - minimum + 1
+                                   : generator.maximum - minimum;
+
+    if (valueCount <= 0)
+        return isIntegral ? QVariant{static_cast<qint64>(minimum)} : QVariant{minimum};
+
+    double valueOffset = offset(generator.distribution, rowNumber, valueCount, random);
+
+    if (!isIntegral)
+        return minimum + valueOffset;
+
+    qint64 integer = static_cast<qint64>(minimum) + static_cast<qint64>(valueOffset);
+
+    switch (mapping.dataType())
+    {
+        case QVariant::Bool:
+            return integer != 0;
+
+        case QVariant::Date:
+            return epoch().date().addDays(integer);
+
+        case QVariant::DateTime:
+            return epoch().addSecs(integer);
+
+        case QVariant::Time:
+            return QTime{0, 0}.addMSecs(static_cast<int>(integer));
+
+        default:
+            return integer;
+    }
+}
+
+QOrmError QOrmDataGeneratorPrivate::generateEntity(const QMetaObject& qMetaObject)
+{
+    const QOrmMetadata& entity = (*m_session->metadataCache())[qMetaObject];
+    const QOrmPropertyMapping* objectIdMapping = entity.objectIdMapping();
+
+    if (objectIdMapping == nullptr || (objectIdMapping->dataType() != QVariant::Int &&
+                                       objectIdMapping->dataType() != QVariant::UInt &&
+                                       objectIdMapping->dataType() != QVariant::LongLong &&
+                                       objectIdMapping->dataType() != QVariant::ULongLong))
+    {
+        return QOrmError{QOrm::ErrorType::InvalidMapping,
+                         QStringLiteral("Generating rows of %1 requires an integer object ID")
+                             .arg(entity.className())};
+    }
+
+    qint64 firstObjectId = 0;
+    QOrmError error = maximumObjectId(entity, firstObjectId);
+
+    if (error.type() != QOrm::ErrorType::None)
+        return error;
+
+    ++firstObjectId;
+
+    std::vector<const QOrmPropertyMapping*> columns;
+    std::vector<ColumnGenerator> generators;
+
+    for (const QOrmPropertyMapping& mapping : entity.propertyMappings())
+    {
+        if (mapping.isTransient())
+            continue;
+
+        columns.push_back(&mapping);
+
+        if (mapping.isObjectId())
+            continue;
+
+        ColumnGenerator generator;
+        error = makeColumnGenerator(entity, mapping, generator);
+
+        if (error.type() != QOrm::ErrorType::None)
+            return error;
+
+        generators.push_back(generator);
+    }
+
+    const qint64 rowCount = m_entities.value(&qMetaObject).rowCount;
+    const qint64 firstRowNumber = m_generatedIds.value(&qMetaObject).count + 1;
+    qint64 rowIndex = 0;
+
+    auto nextRow = [&](QVariantList& row) {
+        if (rowIndex == rowCount)
+            return false;
+
+        qint64 rowNumber = firstRowNumber + rowIndex;
+        auto generator = generators.cbegin();
+
+        for (const QOrmPropertyMapping* column : columns)
+        {
+            if (column->isObjectId())
+                row.push_back(firstObjectId + rowIndex);
+            else
+                row.push_back(value(*generator++, rowNumber));
+        }
+
+        ++rowIndex;
+        return true;
+    };
+
+    error = m_session->configuration().provider()->insertRows(entity, columns, nextRow);
+
+    if (error.type() != QOrm::ErrorType::None)
+        return error;
+
+    IdRange& ids = m_generatedIds[&qMetaObject];
+
+    // Referencing rows are spread over the consecutive IDs generated so far
+    if (ids.count > 0 && ids.first + ids.count == firstObjectId)
+        ids.count += rowCount;
+    else
+        ids = IdRange{firstObjectId, rowCount};
+
+    return QOrmError{QOrm::ErrorType::None, {}};
+}
+
+QOrmDataGenerator::QOrmDataGenerator(QOrmSession* session, quint64 seed)
+    : d_ptr{new QOrmDataGeneratorPrivate{session, seed, this}}
+{
+}
+
+QOrmDataGenerator::~QOrmDataGenerator()
+{
+    delete d_ptr;
+}
+
+quint64 QOrmDataGenerator::seed() const
+{
+    Q_D(const QOrmDataGenerator);
+
+    return d->m_seed;
+}
+
+void QOrmDataGenerator::setSeed(quint64 seed)
+{
+    Q_D(QOrmDataGenerator);
+
+    d->m_seed = seed;
+}
+
+qint64 QOrmDataGenerator::rowCount(const QMetaObject& entity) const
+{
+    Q_D(const QOrmDataGenerator);
+
+    return d->m_entities.value(&entity).rowCount;
+}
+
+void QOrmDataGenerator::setRowCount(const QMetaObject& entity, qint64 rowCount)
+{
+    Q_D(QOrmDataGenerator);
+
+    d->m_entities[&entity].rowCount = qMax(rowCount, qint64{0});
+}
+
+void QOrmDataGenerator::setValueRange(const QMetaObject& entity,
+                                      const QString& property,
+                                      double minimum,
+                                      double maximum,
+                                      Distribution distribution)
+{
+    Q_D(QOrmDataGenerator);
+
+    PropertyOptions& options = d->m_entities[&entity].properties[property];
+    options.minimum = minimum;
+    options.maximum = maximum;
+    options.distribution = distribution;
+}
+
+void QOrmDataGenerator::setStringLength(const QMetaObject& entity,
+                                        const QString& property,
+                                        int minimum,
+                                        int maximum)
+{
+    Q_D(QOrmDataGenerator);
+
+    PropertyOptions& options = d->m_entities[&entity].properties[property];
+    options.minimumLength = qMax(minimum, 0);
+    options.maximumLength = qMax(maximum, options.minimumLength);
+}
+
+void QOrmDataGenerator::setStringPattern(const QMetaObject& entity,
+                                         const QString& property,
+                                         const QString& pattern)
+{
+    Q_D(QOrmDataGenerator);
+
+    d->m_entities[&entity].properties[property].pattern = pattern;
+}
+
+void QOrmDataGenerator::setReferenceDistribution(const QMetaObject& entity,
+                                                 const QString& property,
+                                                 Distribution distribution)
+{
+    Q_D(QOrmDataGenerator);
+
+    d->m_entities[&entity].properties[property].distribution = distribution;
+}
+
+QOrmError QOrmDataGenerator::generate()
+{
+    Q_D(QOrmDataGenerator);
+
+    QVector<const QMetaObject*> sorted;
+    QSet<const QMetaObject*> visiting;
+
+    for (auto it = d->m_entities.cbegin(); it != d->m_entities.cend(); ++it)
+    {
+        if (it->rowCount == 0)
+            continue;
+
+        QOrmError error = d->sortEntities(it.key(), visiting, sorted);
+
+        if (error.type() != QOrm::ErrorType::None)
+            return error;
+    }
+
+    // The IDs generated by this call are only kept if its rows have been committed
+    QHash<const QMetaObject*, IdRange> committedIds = d->m_generatedIds;
+
+    QOrmTransactionToken token = d->m_session->declareTransaction(
+        QOrm::TransactionPropagation::Require, QOrm::TransactionAction::Commit);
+
+    for (const QMetaObject* entity : qAsConst(sorted))
+    {
+        QOrmError error = d->generateEntity(*entity);
+
+        if (error.type() != QOrm::ErrorType::None)
+        {
+            token.rollback();
+            d->m_generatedIds = committedIds;
+            return error;
+        }
+    }
+
+    if (!token.commit())
+    {
+        d->m_generatedIds = committedIds;
+        return d->m_session->lastError();
+    }
+
+    return QOrmError{QOrm::ErrorType::None, {}};
+}
+
+qint64 QOrmDataGenerator::generatedRowCount(const QMetaObject& entity) const
+{
+    Q_D(const QOrmDataGenerator);
+
+    return d->m_generatedIds.value(&entity).count;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2019 Dmitriy Purgin <dmitriy.purgin@sequality.at>
+ * Copyright (C) 2019 sequality software engineering e.U. <office@sequality.at>
+ *
+ * This file is part of QtOrm library.
+ *
+ * QtOrm is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QtOrm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QtOrm.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef QORMDATAGENERATOR_H
+#define QORMDATAGENERATOR_H
+
+#include <QtOrm/qormglobal.h>
+
+#include <QtCore/qmetaobject.h>
+#include <QtCore/qstring.h>
+
+QT_BEGIN_NAMESPACE
+
+class QOrmDataGeneratorPrivate;
+class QOrmError;
+class QOrmSession;
+
+// Populates the tables of entities with synthetic rows for scale testing. The values are derived
+// from the seed, the entity, the property and the number of the row only: the same configuration
+// generates the same rows regardless of how they are split into generate() calls.
+class Q_ORM_EXPORT QOrmDataGenerator
+{
+    Q_DECLARE_PRIVATE(QOrmDataGenerator)
+    Q_DISABLE_COPY(QOrmDataGenerator)
+
+public:
+    enum class Distribution
+    {
+        // Steps through the range one value per row and starts over at its end
+        Sequential,
+        Uniform,
+        // Centered in the range with a standard deviation of one sixth of its width
+        Normal,
+        // Skewed towards the beginning of the range, as in Zipf's law
+        Zipf
+    };
+
+    explicit QOrmDataGenerator(QOrmSession* session, quint64 seed = 0);
+    ~QOrmDataGenerator();
+
+    [[nodiscard]] quint64 seed() const;
+    void setSeed(quint64 seed);
+
+    // Number of rows appended to the table of the entity by every generate() call
+    [[nodiscard]] qint64 rowCount(const QMetaObject& entity) const;
+    void setRowCount(const QMetaObject& entity, qint64 rowCount);
+
+    template<typename T>
+    void setRowCount(qint64 rowCount)
+    {
+        setRowCount(T::staticMetaObject, rowCount);
+    }
+
+    // Range of numeric properties. Dates are generated as days and date-times as seconds since
+    // 2000-01-01 UTC, times as milliseconds since midnight.
+    void setValueRange(const QMetaObject& entity,
+                       const QString& property,
+                       double minimum,
+                       double maximum,
+                       Distribution distribution = Distribution::Uniform);
+
+    // Length of random strings and byte arrays
+    void setStringLength(const QMetaObject& entity,
+                         const QString& property,
+                         int minimum,
+                         int maximum);
+
+    // Generates strings from the pattern instead, replacing %1 with the number of the row
+    void setStringPattern(const QMetaObject& entity,
+                          const QString& property,
+                          const QString& pattern);
+
+    // How the referencing rows are spread over the referenced rows. Sequential gives each
+    // referenced row the same number of referencing rows.
+    void setReferenceDistribution(const QMetaObject& entity,
+                                  const QString& property,
+                                  Distribution distribution);
+
+    // Appends the configured number of rows to the table of every entity, referenced entities
+    // first, in a single transaction. Object IDs continue after the largest existing one.
+    // References to entities without generated rows are left empty.
+    QOrmError generate();
+
+    // Rows generated for the entity by all generate() calls
+    [[nodiscard]] qint64 generatedRowCount(const QMetaObject& entity) const;
+
+    template<typename T>
+    [[nodiscard]] qint64 generatedRowCount() const
+    {
+        return generatedRowCount(T::staticMetaObject);
+    }
+
+private:
+    QOrmDataGeneratorPrivate* d_ptr{nullptr};
+};
+
+QT_END_NAMESPACE
+
+#endif // QORMDATAGENERATOR_H
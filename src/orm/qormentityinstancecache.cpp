@@ -20,6 +20,7 @@
 
 #include "qormentityinstancecache.h"
 #include "qormglobal_p.h"
+#include "qormmemoryreport_p.h"
 #include "qormmetadata.h"
 
 #include <QMap>
@@ -128,6 +129,41 @@ void QOrmEntityInstanceCache::markUnmodified(const QObject* instance) const
     d->m_modifiedInstances.remove(instance);
 }
 
+void QOrmEntityInstanceCache::markModified(const QObject* instance)
+{
+    Q_ASSERT(d->m_cache.contains(instance));
+    d->m_modifiedInstances.insert(instance);
+}
+
+QVector<QObject*> QOrmEntityInstanceCache::instances() const
+{
+    return d->m_cache.keys().toVector();
+}
+
+qint64 QOrmEntityInstanceCache::estimatedEntryBytes(const QObject* instance) const
+{
+    if (!contains(instance))
+        return 0;
+
+    // One node in m_cache and one in m_byObjectId, both holding a copy of the object ID
+    qint64 bytes = 2 * (QOrmPrivate::ContainerNodeBytes + sizeof(QObject*) +
+                        sizeof(QOrmEntityInstanceCachePrivate::ObjectId));
+
+    if (d->m_modifiedInstances.contains(instance))
+        bytes += QOrmPrivate::ContainerNodeBytes + sizeof(const QObject*);
+
+    // finalize() connects every NOTIFY signal
+    const QMetaObject* metaObject = instance->metaObject();
+
+    for (int i = QObject::staticMetaObject.propertyCount(); i < metaObject->propertyCount(); ++i)
+    {
+        if (metaObject->property(i).hasNotifySignal())
+            bytes += QOrmPrivate::ConnectionBytes;
+    }
+
+    return bytes;
+}
+
 QT_END_NAMESPACE
 
 #include "qormentityinstancecache.moc"
@@ -23,6 +23,7 @@
 
 #include <QtCore/qglobal.h>
 #include <QtCore/qscopedpointer.h>
+#include <QtCore/qvector.h>
 #include <QtOrm/qormglobal.h>
 
 QT_BEGIN_NAMESPACE
@@ -46,6 +47,12 @@ public:
     void finalize(const QOrmMetadata& metadata, QObject* instance);
     bool isModified(const QObject* instance) const;
     void markUnmodified(const QObject* instance) const;
+    void markModified(const QObject* instance);
+
+    [[nodiscard]] QVector<QObject*> instances() const;
+    // Estimated memory used to keep the instance in the cache, including the signal connections
+    // used to track its modifications
+    [[nodiscard]] qint64 estimatedEntryBytes(const QObject* instance) const;
 
 private:
     QScopedPointer<QOrmEntityInstanceCachePrivate> d;
@@ -22,6 +22,74 @@
 
 QT_BEGIN_NAMESPACE
 
+namespace QOrmPrivate
+{
+    EntityListModelRole::EntityListModelRole(const QOrmPropertyMapping& propertyMapping)
+        : property{propertyMapping.qMetaProperty()}
+    {
+        if (propertyMapping.isReference() && propertyMapping.isTransient() &&
+            (propertyMapping.dataTypeName().startsWith("QVector<") ||
+             propertyMapping.dataTypeName().startsWith("QSet<")) &&
+            propertyMapping.dataTypeName().endsWith("*>"))
+        {
+            converter = Converter::ObjectContainer;
+        }
+    }
+
+    QVariant EntityListModelRole::read(const QObject* entityInstance) const
+    {
+        QVariant propertyValue = property.read(entityInstance);
+
+        if (converter == Converter::ObjectContainer)
+        {
+            // Iterates QVector<T*> and QSet<T*> alike without converting the container
+            const QSequentialIterable instances = propertyValue.value<QSequentialIterable>();
+
+            QVariantList list;
+            list.reserve(instances.size());
+
+            for (const QVariant& instance : instances)
+                list.push_back(QVariant::fromValue(instance.value<QObject*>()));
+
+            propertyValue = list;
+        }
+
+        return propertyValue;
+    }
+
+    // Patience sorting in O(n log n), see
+    // https://en.wikipedia.org/wiki/Longest_increasing_subsequence
+    QVector<bool> longestIncreasingSubsequence(const QVector<int>& sequence)
+    {
+        QVector<int> tails;        // index of the smallest tail of each subsequence length
+        QVector<int> predecessors(sequence.size(), -1);
+
+        for (int i = 0; i < sequence.size(); ++i)
+        {
+            auto it = std::lower_bound(tails.begin(),
+                                       tails.end(),
+                                       sequence[i],
+                                       [&sequence](int index, int value)
+                                       { return sequence[index] < value; });
+
+            if (it != tails.begin())
+                predecessors[i] = *(it - 1);
+
+            if (it == tails.end())
+                tails.push_back(i);
+            else
+                *it = i;
+        }
+
+        QVector<bool> mask(sequence.size(), false);
+
+        for (int i = tails.isEmpty() ? -1 : tails.last(); i != -1; i = predecessors[i])
+            mask[i] = true;
+
+        return mask;
+    }
+} // namespace QOrmPrivate
+
 QOrmEntityListModelBase::QOrmEntityListModelBase(QObject* parent)
     : QAbstractListModel{parent}
 {
@@ -57,4 +125,80 @@ void QOrmEntityListModelBase::setOrder(QVariantList order)
     }
 }
 
+bool QOrmEntityListModelBase::isCollectionCachingEnabled() const
+{
+    return m_collectionCachingEnabled;
+}
+
+// When enabled, converted object containers are kept per row until the instance is updated
+// through the model or the model is re-read.
+void QOrmEntityListModelBase::setCollectionCachingEnabled(bool enabled)
+{
+    if (m_collectionCachingEnabled != enabled)
+    {
+        m_collectionCachingEnabled = enabled;
+        invalidateCollectionCache();
+        Q_EMIT collectionCachingChanged();
+    }
+}
+
+QVariant QOrmEntityListModelBase::roleData(int row, const QObject* entityInstance, int role) const
+{
+    const int roleIndex = role - Qt::UserRole;
+
+    if (roleIndex < 0 || roleIndex >= static_cast<int>(m_roles.size()))
+        return {};
+
+    const QOrmPrivate::EntityListModelRole& accessor = m_roles[static_cast<size_t>(roleIndex)];
+
+    if (!m_collectionCachingEnabled ||
+        accessor.converter != QOrmPrivate::EntityListModelRole::Converter::ObjectContainer)
+    {
+        return accessor.read(entityInstance);
+    }
+
+    if (m_collectionCache.size() <= row)
+        m_collectionCache.resize(row + 1);
+
+    QVector<QVariant>& cachedValues = m_collectionCache[row];
+
+    if (cachedValues.isEmpty())
+        cachedValues.resize(static_cast<int>(m_roles.size()));
+
+    if (!cachedValues[roleIndex].isValid())
+        cachedValues[roleIndex] = accessor.read(entityInstance);
+
+    return cachedValues[roleIndex];
+}
+
+void QOrmEntityListModelBase::invalidateCollectionCache(int row)
+{
+    if (row < 0)
+        m_collectionCache.clear();
+    else if (row < m_collectionCache.size())
+        m_collectionCache[row].clear();
+}
+
+// The cache only covers the rows up to the last one read with caching enabled
+void QOrmEntityListModelBase::removeCollectionCacheRows(int first, int count)
+{
+    if (first < m_collectionCache.size())
+        m_collectionCache.remove(first, qMin(count, m_collectionCache.size() - first));
+}
+
+void QOrmEntityListModelBase::insertCollectionCacheRows(int row, int count)
+{
+    if (row < m_collectionCache.size())
+        m_collectionCache.insert(row, count, QVector<QVariant>{});
+}
+
+void QOrmEntityListModelBase::moveCollectionCacheRow(int from, int to)
+{
+    if (from >= m_collectionCache.size() && to >= m_collectionCache.size())
+        return;
+
+    m_collectionCache.resize(qMax(m_collectionCache.size(), qMax(from, to) + 1));
+    m_collectionCache.move(from, to);
+}
+
 QT_END_NAMESPACE
@@ -24,6 +24,8 @@
 #include <QtCore/qabstractitemmodel.h>
 #include <QtCore/qbytearray.h>
 #include <QtCore/qhash.h>
+#include <QtCore/qmetaobject.h>
+#include <QtCore/qset.h>
 #include <QtCore/qvariant.h>
 #include <QtCore/qvector.h>
 
@@ -37,14 +39,44 @@
 
 #include <QDebug>
 
+#include <algorithm>
+#include <vector>
+
 QT_BEGIN_NAMESPACE
 
+namespace QOrmPrivate
+{
+    // Role accessor precomputed from a property mapping when the model is constructed.
+    // Roles are stored in a flat array indexed by role - Qt::UserRole.
+    struct Q_ORM_EXPORT EntityListModelRole
+    {
+        enum class Converter
+        {
+            None,
+            ObjectContainer
+        };
+
+        explicit EntityListModelRole(const QOrmPropertyMapping& propertyMapping);
+
+        [[nodiscard]] QVariant read(const QObject* entityInstance) const;
+
+        QMetaProperty property;
+        Converter converter{Converter::None};
+    };
+
+    // Returns a mask of the elements belonging to the longest strictly increasing subsequence.
+    [[nodiscard]] Q_ORM_EXPORT QVector<bool> longestIncreasingSubsequence(
+        const QVector<int>& sequence);
+} // namespace QOrmPrivate
+
 class Q_ORM_EXPORT QOrmEntityListModelBase : public QAbstractListModel
 {
     Q_OBJECT
 
     Q_PROPERTY(QVariantMap filter READ filter WRITE setFilter NOTIFY filterChanged)
     Q_PROPERTY(QVariantList order READ order WRITE setOrder NOTIFY orderChanged)
+    Q_PROPERTY(bool collectionCaching READ isCollectionCachingEnabled WRITE
+                   setCollectionCachingEnabled NOTIFY collectionCachingChanged)
 
 public:
     QOrmEntityListModelBase(QObject* parent = nullptr);
@@ -55,6 +87,9 @@ public:
     QVariantList order() const;
     void setOrder(QVariantList order);
 
+    bool isCollectionCachingEnabled() const;
+    void setCollectionCachingEnabled(bool enabled);
+
 public Q_SLOTS:
     virtual QObject* at(int index) const = 0;
     virtual int indexOf(QObject* entityInstance) const = 0;
@@ -69,6 +104,7 @@ Q_SIGNALS:
     void entityInstanceRemoved();
     void filterChanged();
     void orderChanged();    
+    void collectionCachingChanged();
 
 protected Q_SLOTS:
     virtual void onFilterChanged() = 0;
@@ -76,8 +112,23 @@ protected Q_SLOTS:
     virtual void readData() = 0;
 
 protected:
+    QVariant roleData(int row, const QObject* entityInstance, int role) const;
+    // Invalidates the cached collections of a row, or of all rows if row is -1
+    void invalidateCollectionCache(int row = -1);
+    // Keep the cached collections in line with the rows when rows are removed, inserted or moved
+    void removeCollectionCacheRows(int first, int count);
+    void insertCollectionCacheRows(int row, int count);
+    void moveCollectionCacheRow(int from, int to);
+
     QVariantMap m_filter;
     QVariantList m_order;
+    QHash<int, QByteArray> m_roleNames;
+    std::vector<QOrmPrivate::EntityListModelRole> m_roles;
+
+private:
+    bool m_collectionCachingEnabled{false};
+    // Converted collections per row, indexed by role - Qt::UserRole
+    mutable QVector<QVector<QVariant>> m_collectionCache;
 };
 
 template<typename T>
@@ -90,14 +141,14 @@ public:
     {
         readData();
 
-        int roleIndex = Qt::UserRole;
+        const auto& propertyMappings = m_session.metadataCache()->get<T>().propertyMappings();
+        m_roles.reserve(propertyMappings.size());
 
-        for (const QOrmPropertyMapping& propertyMapping :
-             m_session.metadataCache()->get<T>().propertyMappings())
+        for (const QOrmPropertyMapping& propertyMapping : propertyMappings)
         {
-            m_roles.insert(std::make_pair(roleIndex, propertyMapping));
-            m_roleNames.insert(roleIndex, propertyMapping.classPropertyName().toUtf8());
-            roleIndex++;
+            m_roleNames.insert(Qt::UserRole + static_cast<int>(m_roles.size()),
+                               propertyMapping.classPropertyName().toUtf8());
+            m_roles.emplace_back(propertyMapping);
         }
     }
 
@@ -106,18 +157,7 @@ public:
         return index >= 0 && index < m_data.size() ? m_data[index] : nullptr;
     }
 
-    int indexOf(QObject* instance) const override
-    {
-        for (int i = 0; i < m_data.size(); ++i)
-        {
-            if (static_cast<void*>(m_data[i]) == static_cast<void*>(instance))
-            {
-                return i;
-            }
-        }
-
-        return -1;
-    }
+    int indexOf(QObject* instance) const override { return m_rowIndex.value(instance, -1); }
 
     QObject* create(QVariantMap properties) override
     {
@@ -232,17 +272,18 @@ public:
         if (m_session.merge(t)) {
             int row = indexOf(instance);
             Q_ASSERT(row >= 0);
+            invalidateCollectionCache(row);
             emit dataChanged(index(row), index(row));
             return true;
         }
         return false;
     }
 
+    // Re-reads the rows from the database, including the values of the cached instances
     void read() override
     {
-        Q_EMIT beginResetModel();
-        readData();
-        Q_EMIT endResetModel();
+        invalidateCollectionCache();
+        applyData(fetchData(QOrm::QueryFlags::OverwriteCachedInstances));
     }
 
     int rowCount(const QModelIndex& = QModelIndex{}) const { return m_data.size(); }
@@ -252,28 +293,8 @@ public:
     QVariant data(const QModelIndex& index, int role) const
     {
         if (index.row() >= 0 && index.row() < m_data.size())
-        {
-            const QOrmPropertyMapping& propertyMapping = m_roles.at(role);
-
-            QVariant propertyValue =
-                m_data[index.row()]->property(propertyMapping.classPropertyName().toUtf8().data());
-
-            if (propertyValue.type() == QVariant::UserType &&
-                QString{propertyValue.typeName()}.startsWith("QVector<") &&
-                QString{propertyValue.typeName()}.endsWith("*>"))
-            {
-                QVariantList list;
-
-                for (QObject* o : propertyValue.value<QVector<QObject*>>())
-                {
-                    list.push_back(QVariant::fromValue(o));
-                }
-
-                propertyValue = list;
-            }
+            return roleData(index.row(), m_data[index.row()], role);
 
-            return propertyValue;
-        }
         return {};
     }
 
@@ -282,7 +303,9 @@ private:
 
     void onOrderChanged() override { readData(); }
 
-    void readData() override
+    void readData() override { applyData(fetchData()); }
+
+    QVector<T*> fetchData(QOrm::QueryFlags flags = QOrm::QueryFlags::None)
     {
         std::optional<QOrmFilterExpression> filterExpression;
         std::vector<QOrmOrder> order;
@@ -331,14 +354,162 @@ private:
             }
         }
 
-        m_data = query.select().toVector();
+        return query.select(flags).toVector();
+    }
+
+    // Turns the current rows into data by removing, moving and inserting rows instead of resetting
+    // the model. This way views keep their delegates and the scroll position. Instances are
+    // matched by identity, which is stable thanks to the entity instance cache. The values of the
+    // retained instances may have been re-read, so their rows are reported as changed.
+    void applyData(const QVector<T*>& data)
+    {
+        QSet<const QObject*> incoming;
+        incoming.reserve(data.size());
+
+        for (T* instance : data)
+            incoming.insert(instance);
+
+        // 1. Remove rows that are not part of the new data in contiguous blocks, bottom-up.
+        for (int last = m_data.size() - 1; last >= 0;)
+        {
+            if (incoming.contains(m_data[last]))
+            {
+                --last;
+                continue;
+            }
+
+            int first = last;
+
+            while (first > 0 && !incoming.contains(m_data[first - 1]))
+                --first;
+
+            beginRemoveRows(QModelIndex{}, first, last);
+            m_data.remove(first, last - first + 1);
+            removeCollectionCacheRows(first, last - first + 1);
+            endRemoveRows();
+
+            last = first - 1;
+        }
+
+        // 2. Move the retained rows whose relative order has changed. The rows on the longest
+        // increasing subsequence of their current positions stay in place, every other retained
+        // row is moved right behind its predecessor in the new data.
+        QHash<const QObject*, int> retainedRows;
+        retainedRows.reserve(m_data.size());
+
+        for (int row = 0; row < m_data.size(); ++row)
+            retainedRows.insert(m_data[row], row);
+
+        QVector<T*> retained;
+        QVector<int> retainedPositions;
+        retained.reserve(m_data.size());
+        retainedPositions.reserve(m_data.size());
+
+        for (T* instance : data)
+        {
+            auto it = retainedRows.constFind(instance);
+
+            if (it != retainedRows.constEnd())
+            {
+                retained.push_back(instance);
+                retainedPositions.push_back(it.value());
+            }
+        }
+
+        QVector<bool> isStable = QOrmPrivate::longestIncreasingSubsequence(retainedPositions);
+        int moveCount = static_cast<int>(std::count(isStable.cbegin(), isStable.cend(), false));
+
+        if (moveCount > MaxIncrementalMoves)
+        {
+            beginResetModel();
+            m_data = data;
+            invalidateCollectionCache();
+            rebuildRowIndex();
+            endResetModel();
+            return;
+        }
+
+        for (int i = 0; i < retained.size(); ++i)
+        {
+            if (isStable[i])
+                continue;
+
+            int source = m_data.indexOf(retained[i]);
+            int destination = i == 0 ? 0 : m_data.indexOf(retained[i - 1]) + 1;
+
+            if (source == destination)
+                continue;
+
+            beginMoveRows(QModelIndex{}, source, source, QModelIndex{}, destination);
+            m_data.move(source, source < destination ? destination - 1 : destination);
+            moveCollectionCacheRow(source, source < destination ? destination - 1 : destination);
+            endMoveRows();
+        }
+
+        // 3. Insert the new rows in contiguous blocks. At this point the rows are a subsequence of
+        // the new data in the right order.
+        for (int row = 0; row < data.size();)
+        {
+            if (row < m_data.size() && m_data[row] == data[row])
+            {
+                ++row;
+                continue;
+            }
+
+            int last = row;
+
+            while (last + 1 < data.size() && !retainedRows.contains(data[last + 1]))
+                ++last;
+
+            beginInsertRows(QModelIndex{}, row, last);
+            m_data.insert(row, last - row + 1, nullptr);
+            std::copy(data.cbegin() + row, data.cbegin() + last + 1, m_data.begin() + row);
+            insertCollectionCacheRows(row, last - row + 1);
+            endInsertRows();
+
+            row = last + 1;
+        }
+
+        Q_ASSERT(m_data == data);
+
+        // 4. Report the retained rows as changed in contiguous blocks.
+        for (int first = 0; first < m_data.size();)
+        {
+            if (!retainedRows.contains(m_data[first]))
+            {
+                ++first;
+                continue;
+            }
+
+            int last = first;
+
+            while (last + 1 < m_data.size() && retainedRows.contains(m_data[last + 1]))
+                ++last;
+
+            Q_EMIT dataChanged(index(first), index(last));
+
+            first = last + 1;
+        }
+
+        rebuildRowIndex();
+    }
+
+    void rebuildRowIndex()
+    {
+        m_rowIndex.clear();
+        m_rowIndex.reserve(m_data.size());
+
+        for (int row = 0; row < m_data.size(); ++row)
+            m_rowIndex.insert(m_data[row], row);
     }
 
 private:
+    // Above this number of moved rows a model reset is cheaper for both the model and its views.
+    static constexpr int MaxIncrementalMoves = 100;
+
     QOrmSession& m_session;
     QVector<T*> m_data;
-    QHash<int, QByteArray> m_roleNames;
-    std::unordered_map<int, QOrmPropertyMapping> m_roles;
+    QHash<const QObject*, int> m_rowIndex;
 };
 
 QT_END_NAMESPACE
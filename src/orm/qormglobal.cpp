@@ -183,6 +183,14 @@ namespace QOrm
             case Comparison::NotContains:
                 dbg << "NotContains";
                 break;
+
+            case Comparison::EqualIgnoreCase:
+                dbg << "EqualIgnoreCase";
+                break;
+
+            case Comparison::NotEqualIgnoreCase:
+                dbg << "NotEqualIgnoreCase";
+                break;
         }
 
         return dbg;
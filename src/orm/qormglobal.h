@@ -84,7 +84,9 @@ namespace QOrm
         InList,
         NotInList,
         Contains,
-        NotContains
+        NotContains,
+        EqualIgnoreCase,
+        NotEqualIgnoreCase
     };
     extern Q_ORM_EXPORT QDebug operator<<(QDebug dbg, QOrm::Comparison comparison);
     extern Q_ORM_EXPORT uint qHash(Comparison comparison) Q_DECL_NOTHROW;
@@ -143,7 +145,10 @@ namespace QOrm
     enum class QueryFlags
     {
         None = 0x00,
-        OverwriteCachedInstances = 0x01
+        OverwriteCachedInstances = 0x01,
+        // Cursors only: the instances created for a row, including the referenced ones, are
+        // removed from the entity instance cache and deleted when the cursor moves on
+        ReleaseConsumedInstances = 0x02
     };
 
     enum class Keyword
@@ -154,7 +159,10 @@ namespace QOrm
         Autogenerated,
         Identity,
         Transient,
-        Schema
+        Schema,
+        Index,
+        Unique,
+        Where
     };
     inline uint qHash(Keyword value) { return ::qHash(static_cast<int>(value)); }
 } // namespace QOrm
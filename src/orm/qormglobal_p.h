@@ -27,8 +27,10 @@
 #include <QtCore/qhashfunctions.h>
 #include <QtCore/qloggingcategory.h>
 #include <QtCore/qstring.h>
+#include <QtCore/qstringlist.h>
 #include <QtCore/qvariant.h>
 
+#include <atomic>
 #include <variant>
 #include <optional>
 
@@ -81,6 +83,30 @@ namespace QOrmPrivate
         return propertyValue(entityInstance, meta.objectIdMapping()->classPropertyName());
     }
 
+    // Partial entity instances are read with some of the properties of their rows only. They are
+    // not tracked by the session.
+    inline void markPartialInstance(QObject* entityInstance, const QStringList& classProperties)
+    {
+        entityInstance->setProperty("_q_ormPartialInstance", classProperties);
+    }
+
+    Q_REQUIRED_RESULT
+    inline bool isPartialInstance(const QObject* entityInstance)
+    {
+        return entityInstance->property("_q_ormPartialInstance").isValid();
+    }
+
+    // The class properties read into a partial instance in addition to the object ID
+    Q_REQUIRED_RESULT
+    inline QStringList partialInstanceProperties(const QObject* entityInstance)
+    {
+        return entityInstance->property("_q_ormPartialInstance").toStringList();
+    }
+
+    // SQLite providers connected while set behave as if the QSQLITE driver used another SQLite
+    // library than QtOrm. For tests of the fallbacks.
+    Q_ORM_EXPORT extern std::atomic<bool> nativeSqliteApiDisabled;
+
     Q_REQUIRED_RESULT
     Q_ORM_EXPORT
     extern QOrmFilterExpression resolvedFilterExpression(const QOrmRelation& relation,
@@ -0,0 +1,41 @@
+/*
+ * Copyright (C) 2019 Dmitriy Purgin <dmitriy.purgin@sequality.at>
+ * Copyright (C) 2019 sequality software engineering e.U. <office@sequality.at>
+ *
+ * This file is part of QtOrm library.
+ *
+ * QtOrm is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QtOrm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QtOrm.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "qormindex.h"
+
+#include <QtCore/qdebug.h>
+
+QT_BEGIN_NAMESPACE
+
+QDebug operator<<(QDebug dbg, const QOrmIndex& index)
+{
+    QDebugStateSaver saver{dbg};
+    dbg.noquote().nospace() << "QOrmIndex(" << index.name() << ", " << index.columns().join(", ")
+                            << (index.isUnique() ? ", UNIQUE" : "");
+
+    if (index.filter().has_value())
+        dbg << ", WHERE " << *index.filter();
+
+    dbg << ")";
+    return dbg;
+}
+
+QT_END_NAMESPACE
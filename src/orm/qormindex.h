@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2019 Dmitriy Purgin <dmitriy.purgin@sequality.at>
+ * Copyright (C) 2019 sequality software engineering e.U. <office@sequality.at>
+ *
+ * This file is part of QtOrm library.
+ *
+ * QtOrm is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QtOrm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QtOrm.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef QORMINDEX_H
+#define QORMINDEX_H
+
+#include <QtOrm/qormfilterexpression.h>
+#include <QtOrm/qormglobal.h>
+
+#include <QtCore/qstring.h>
+#include <QtCore/qstringlist.h>
+
+#include <optional>
+#include <utility>
+
+QT_BEGIN_NAMESPACE
+
+class QDebug;
+
+// An index declared with Q_ORM_PROPERTY(... INDEX), Q_ORM_PROPERTY(... UNIQUE),
+// Q_ORM_CLASS(INDEX (...)) or Q_ORM_CLASS(UNIQUE (...)). The columns are table field names, or
+// lower(<table field name>) for case-insensitive keys. The filter of a partial index refers to
+// class properties.
+class Q_ORM_EXPORT QOrmIndex
+{
+public:
+    QOrmIndex(QString name,
+              QStringList columns,
+              bool isUnique,
+              std::optional<QOrmFilterExpression> filter = std::nullopt)
+        : m_name{std::move(name)}
+        , m_columns{std::move(columns)}
+        , m_isUnique{isUnique}
+        , m_filter{std::move(filter)}
+    {
+    }
+
+    [[nodiscard]] QString name() const { return m_name; }
+    [[nodiscard]] QStringList columns() const { return m_columns; }
+    [[nodiscard]] bool isUnique() const { return m_isUnique; }
+    [[nodiscard]] const std::optional<QOrmFilterExpression>& filter() const { return m_filter; }
+
+private:
+    QString m_name;
+    QStringList m_columns;
+    bool m_isUnique{false};
+    std::optional<QOrmFilterExpression> m_filter;
+};
+
+extern Q_ORM_EXPORT QDebug operator<<(QDebug dbg, const QOrmIndex& index);
+
+QT_END_NAMESPACE
+
+#endif // QORMINDEX_H
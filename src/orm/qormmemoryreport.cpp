@@ -0,0 +1,184 @@
+/*
+ * Copyright (C) 2019 Dmitriy Purgin <dmitriy.purgin@sequality.at>
+ * Copyright (C) 2019 sequality software engineering e.U. <office@sequality.at>
+ *
+ * This file is part of QtOrm library.
+ *
+ * QtOrm is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QtOrm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QtOrm.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "qormmemoryreport.h"
+#include "qormmemoryreport_p.h"
+
+#include <QtCore/qarraydata.h>
+#include <QtCore/qdebug.h>
+#include <QtCore/qmetaobject.h>
+#include <QtCore/qobject.h>
+#include <QtCore/qsequentialiterable.h>
+
+QT_BEGIN_NAMESPACE
+
+namespace QOrmPrivate
+{
+    qint64 estimateValueBytes(const QVariant& value)
+    {
+        // Storage of the value itself, e.g. in a member of the entity class
+        qint64 bytes = QMetaType::sizeOf(value.userType());
+
+        switch (value.userType())
+        {
+            case QMetaType::QString:
+            {
+                QString string = value.toString();
+
+                if (!string.isNull())
+                    bytes += sizeof(QArrayData) + (string.capacity() + 1) * sizeof(QChar);
+
+                break;
+            }
+
+            case QMetaType::QByteArray:
+            {
+                QByteArray byteArray = value.toByteArray();
+
+                if (!byteArray.isNull())
+                    bytes += sizeof(QArrayData) + byteArray.capacity() + 1;
+
+                break;
+            }
+
+            case QMetaType::QVariantMap:
+            {
+                const QVariantMap map = value.toMap();
+
+                for (auto it = map.begin(); it != map.end(); ++it)
+                {
+                    bytes += ContainerNodeBytes + estimateValueBytes(it.key()) +
+                             estimateValueBytes(it.value());
+                }
+
+                break;
+            }
+
+            case QMetaType::QStringList:
+            {
+                bytes += sizeof(QArrayData);
+
+                for (const QString& string : value.toStringList())
+                    bytes += sizeof(void*) + estimateValueBytes(string);
+
+                break;
+            }
+
+            default:
+                // Sequential containers, e.g. QVector<T*> of one-to-many references. Referenced
+                // instances are accounted for separately.
+                if (value.canConvert<QVariantList>())
+                {
+                    bytes += sizeof(QArrayData);
+
+                    for (const QVariant& element : value.value<QSequentialIterable>())
+                        bytes += estimateValueBytes(element);
+                }
+
+                break;
+        }
+
+        return bytes;
+    }
+
+    qint64 estimateInstanceBytes(const QObject* instance)
+    {
+        // The size of the entity class is not known: it is estimated from its properties
+        qint64 bytes = sizeof(QObject) + ObjectPrivateBytes;
+
+        const QMetaObject* metaObject = instance->metaObject();
+
+        for (int i = QObject::staticMetaObject.propertyCount(); i < metaObject->propertyCount();
+             ++i)
+        {
+            bytes += estimateValueBytes(metaObject->property(i).read(instance));
+        }
+
+        for (const QByteArray& name : instance->dynamicPropertyNames())
+        {
+            bytes += ContainerNodeBytes + estimateValueBytes(name) + sizeof(QVariant) +
+                     estimateValueBytes(instance->property(name));
+        }
+
+        return bytes;
+    }
+} // namespace QOrmPrivate
+
+qint64 QOrmEntityMemoryUsage::bytesPerInstance() const
+{
+    return m_cachedInstances > 0 ? m_instanceBytes / m_cachedInstances : 0;
+}
+
+QVariantMap QOrmEntityMemoryUsage::toVariantMap() const
+{
+    return {{"cachedInstances", m_cachedInstances},
+            {"instanceBytes", m_instanceBytes},
+            {"bytesPerInstance", bytesPerInstance()},
+            {"identityMapBytes", m_identityMapBytes},
+            {"trackedInstances", m_trackedInstances},
+            {"totalBytes", totalBytes()}};
+}
+
+QOrmEntityMemoryUsage QOrmMemoryReport::entity(const QString& className) const
+{
+    for (const QOrmEntityMemoryUsage& entity : m_entities)
+    {
+        if (entity.className() == className)
+            return entity;
+    }
+
+    QOrmEntityMemoryUsage result;
+    result.m_className = className;
+    return result;
+}
+
+qint64 QOrmMemoryReport::totalBytes() const
+{
+    qint64 result = m_trackedInstanceBytes;
+
+    for (const QOrmEntityMemoryUsage& entity : m_entities)
+        result += entity.totalBytes();
+
+    return result;
+}
+
+QVariantMap QOrmMemoryReport::toVariantMap() const
+{
+    QVariantMap entities;
+
+    for (const QOrmEntityMemoryUsage& entity : m_entities)
+        entities.insert(entity.className(), entity.toVariantMap());
+
+    return {{"entities", entities},
+            {"trackedInstanceBytes", m_trackedInstanceBytes},
+            {"backendMemoryUsed", m_backendMemoryUsed},
+            {"backendMemoryHighwater", m_backendMemoryHighwater},
+            {"totalBytes", totalBytes()}};
+}
+
+QDebug operator<<(QDebug dbg, const QOrmMemoryReport& report)
+{
+    QDebugStateSaver saver{dbg};
+    dbg.nospace() << "QOrmMemoryReport(" << report.toVariantMap() << ")";
+    return dbg;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2019 Dmitriy Purgin <dmitriy.purgin@sequality.at>
+ * Copyright (C) 2019 sequality software engineering e.U. <office@sequality.at>
+ *
+ * This file is part of QtOrm library.
+ *
+ * QtOrm is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QtOrm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QtOrm.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef QORMMEMORYREPORT_H
+#define QORMMEMORYREPORT_H
+
+#include <QtOrm/qormglobal.h>
+
+#include <QtCore/qstring.h>
+#include <QtCore/qvariant.h>
+#include <QtCore/qvector.h>
+
+QT_BEGIN_NAMESPACE
+
+class QDebug;
+
+// Estimated memory held by a session for the cached instances of one entity. The estimates are
+// based on the property values and the sizes of the Qt containers; the members of the entity
+// classes which are not properties are not accounted for.
+class Q_ORM_EXPORT QOrmEntityMemoryUsage
+{
+public:
+    [[nodiscard]] QString className() const { return m_className; }
+
+    [[nodiscard]] int cachedInstances() const { return m_cachedInstances; }
+    // QObject, properties, dynamic properties and their payloads
+    [[nodiscard]] qint64 instanceBytes() const { return m_instanceBytes; }
+    [[nodiscard]] qint64 bytesPerInstance() const;
+    // Entries of the entity instance cache, including the signal connections used to track
+    // modifications
+    [[nodiscard]] qint64 identityMapBytes() const { return m_identityMapBytes; }
+    // Instances tracked by the current transaction
+    [[nodiscard]] int trackedInstances() const { return m_trackedInstances; }
+
+    [[nodiscard]] qint64 totalBytes() const { return m_instanceBytes + m_identityMapBytes; }
+
+    [[nodiscard]] QVariantMap toVariantMap() const;
+
+private:
+    friend class QOrmSession;
+
+    QString m_className;
+    int m_cachedInstances{0};
+    qint64 m_instanceBytes{0};
+    qint64 m_identityMapBytes{0};
+    int m_trackedInstances{0};
+};
+
+class Q_ORM_EXPORT QOrmMemoryReport
+{
+public:
+    [[nodiscard]] QVector<QOrmEntityMemoryUsage> entities() const { return m_entities; }
+    [[nodiscard]] QOrmEntityMemoryUsage entity(const QString& className) const;
+
+    template<typename T>
+    [[nodiscard]] QOrmEntityMemoryUsage entity() const
+    {
+        return entity(QString::fromUtf8(T::staticMetaObject.className()));
+    }
+
+    // Storage of the instances tracked by the current transaction
+    [[nodiscard]] qint64 trackedInstanceBytes() const { return m_trackedInstanceBytes; }
+
+    // Memory used by the backend, -1 if the provider cannot tell. For SQLite, this is the memory
+    // allocated by the library in the whole process.
+    [[nodiscard]] qint64 backendMemoryUsed() const { return m_backendMemoryUsed; }
+    [[nodiscard]] qint64 backendMemoryHighwater() const { return m_backendMemoryHighwater; }
+
+    // Memory held by the session itself, not including the backend
+    [[nodiscard]] qint64 totalBytes() const;
+
+    [[nodiscard]] QVariantMap toVariantMap() const;
+
+private:
+    friend class QOrmSession;
+
+    QVector<QOrmEntityMemoryUsage> m_entities;
+    qint64 m_trackedInstanceBytes{0};
+    qint64 m_backendMemoryUsed{-1};
+    qint64 m_backendMemoryHighwater{-1};
+};
+
+extern Q_ORM_EXPORT QDebug operator<<(QDebug dbg, const QOrmMemoryReport& report);
+
+QT_END_NAMESPACE
+
+#endif // QORMMEMORYREPORT_H
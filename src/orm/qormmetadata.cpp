@@ -93,6 +93,11 @@ const QOrmUserMetadata& QOrmMetadata::userMetadata() const
     return d->m_userMetadata;
 }
 
+const std::vector<QOrmIndex>& QOrmMetadata::indexes() const
+{
+    return d->m_indexes;
+}
+
 QDebug operator<<(QDebug dbg, const QOrmMetadata& metadata)
 {
     QDebugStateSaver saver{dbg};
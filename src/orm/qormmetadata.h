@@ -22,6 +22,7 @@
 #define QORMMETADATA_H
 
 #include <QtOrm/qormglobal.h>
+#include <QtOrm/qormindex.h>
 #include <QtOrm/qormpropertymapping.h>
 
 #include <QtCore/qstring.h>
@@ -57,6 +58,7 @@ public:
         const QString& classProperty) const;
     [[nodiscard]] const QOrmPropertyMapping* objectIdMapping() const;
     [[nodiscard]] const QOrmUserMetadata& userMetadata() const;
+    [[nodiscard]] const std::vector<QOrmIndex>& indexes() const;
 
 private:
     QSharedDataPointer<const QOrmMetadataPrivate> d;
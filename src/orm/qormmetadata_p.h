@@ -21,6 +21,7 @@
 #ifndef QORMMETADATA_P_H
 #define QORMMETADATA_P_H
 
+#include "QtOrm/qormindex.h"
 #include "QtOrm/qormpropertymapping.h"
 
 #include <QtCore/qshareddata.h>
@@ -45,6 +46,7 @@ public:
     QHash<QString, int> m_classPropertyMappingIndex;
     QHash<QString, int> m_tableFieldMappingIndex;
     QOrmUserMetadata m_userMetadata;
+    std::vector<QOrmIndex> m_indexes;
 };
 
 #endif
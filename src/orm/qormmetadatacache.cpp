@@ -20,6 +20,8 @@
  */
 
 #include "qormmetadatacache.h"
+#include "qormclassproperty.h"
+#include "qormfilterexpression.h"
 #include "qormglobal_p.h"
 #include "qormmetadata_p.h"
 #include "qormpropertymapping.h"
@@ -27,9 +29,15 @@
 #include <QtCore/qhash.h>
 #include <QtCore/qloggingcategory.h>
 #include <QtCore/qmetaobject.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qregularexpression.h>
 #include <QtCore/qset.h>
+#include <QtCore/qstringlist.h>
 #include <QtCore/qvector.h>
 
+#include <algorithm>
+#include <functional>
+#include <limits>
 #include <optional>
 
 namespace
@@ -47,12 +55,17 @@ namespace
     };
 
     const KeywordDescriptor ClassKeywords[] = {{QOrm::Keyword::Table, QLatin1String("TABLE")},
-                                               {QOrm::Keyword::Schema, QLatin1String("SCHEMA")}};
+                                               {QOrm::Keyword::Schema, QLatin1String("SCHEMA")},
+                                               {QOrm::Keyword::Index, QLatin1String("INDEX")},
+                                               {QOrm::Keyword::Unique, QLatin1String("UNIQUE")},
+                                               {QOrm::Keyword::Where, QLatin1String("WHERE")}};
     const KeywordDescriptor PropertyKeywords[] = {
         {QOrm::Keyword::Column, QLatin1String("COLUMN")},
         {QOrm::Keyword::Identity, QLatin1String("IDENTITY")},
         {QOrm::Keyword::Transient, QLatin1String("TRANSIENT")},
-        {QOrm::Keyword::Autogenerated, QLatin1String("AUTOGENERATED")}};
+        {QOrm::Keyword::Autogenerated, QLatin1String("AUTOGENERATED")},
+        {QOrm::Keyword::Index, QLatin1String("INDEX")},
+        {QOrm::Keyword::Unique, QLatin1String("UNIQUE")}};
 
     template<typename Iterable>
     KeywordPosition findNextKeyword(const QString& data,
@@ -127,6 +140,218 @@ namespace
         }
     }
 
+    // Parses the key list of INDEX (...) and UNIQUE (...): "(province,lower(name))"
+    [[nodiscard]] std::optional<QStringList> parsePropertyList(QString data)
+    {
+        static const QRegularExpression keyPattern{QStringLiteral(R"(^(lower\(\w+\)|\w+)$)")};
+
+        if (data.startsWith(QLatin1Char('(')) && data.endsWith(QLatin1Char(')')))
+            data = data.mid(1, data.size() - 2);
+
+        QStringList propertyNames = data.split(QLatin1Char(','));
+
+        for (QString& propertyName : propertyNames)
+        {
+            propertyName = propertyName.trimmed();
+
+            if (!keyPattern.match(propertyName).hasMatch())
+                return std::nullopt;
+        }
+
+        return propertyNames;
+    }
+
+    // Parses the predicate of INDEX (...) WHERE (...) written like a filter expression:
+    // "(active==true&&!(deletedOn!=null))"
+    class FilterPredicateParser
+    {
+    public:
+        explicit FilterPredicateParser(QString data)
+            : m_data{std::move(data)}
+        {
+        }
+
+        [[nodiscard]] std::optional<QOrmFilterExpression> parse()
+        {
+            std::optional<QOrmFilterExpression> expression = parseOr();
+            skipWhitespace();
+
+            if (m_pos != m_data.size())
+                return std::nullopt;
+
+            return expression;
+        }
+
+    private:
+        void skipWhitespace()
+        {
+            while (m_pos < m_data.size() && m_data[m_pos].isSpace())
+                ++m_pos;
+        }
+
+        bool consume(QLatin1String token)
+        {
+            skipWhitespace();
+
+            if (!m_data.midRef(m_pos).startsWith(token))
+                return false;
+
+            m_pos += token.size();
+            return true;
+        }
+
+        [[nodiscard]] std::optional<QOrmFilterExpression> parseOr()
+        {
+            std::optional<QOrmFilterExpression> lhs = parseAnd();
+
+            while (lhs.has_value() && consume(QLatin1String("||")))
+            {
+                std::optional<QOrmFilterExpression> rhs = parseAnd();
+
+                if (!rhs.has_value())
+                    return std::nullopt;
+
+                lhs = QOrmFilterExpression{*lhs || *rhs};
+            }
+
+            return lhs;
+        }
+
+        [[nodiscard]] std::optional<QOrmFilterExpression> parseAnd()
+        {
+            std::optional<QOrmFilterExpression> lhs = parseUnary();
+
+            while (lhs.has_value() && consume(QLatin1String("&&")))
+            {
+                std::optional<QOrmFilterExpression> rhs = parseUnary();
+
+                if (!rhs.has_value())
+                    return std::nullopt;
+
+                lhs = QOrmFilterExpression{*lhs && *rhs};
+            }
+
+            return lhs;
+        }
+
+        [[nodiscard]] std::optional<QOrmFilterExpression> parseUnary()
+        {
+            if (consume(QLatin1String("!")))
+            {
+                std::optional<QOrmFilterExpression> operand = parseUnary();
+
+                if (!operand.has_value())
+                    return std::nullopt;
+
+                return QOrmFilterExpression{!*operand};
+            }
+
+            if (consume(QLatin1String("(")))
+            {
+                std::optional<QOrmFilterExpression> expression = parseOr();
+
+                if (!expression.has_value() || !consume(QLatin1String(")")))
+                    return std::nullopt;
+
+                return expression;
+            }
+
+            return parseComparison();
+        }
+
+        [[nodiscard]] std::optional<QOrmFilterExpression> parseComparison()
+        {
+            static const std::pair<QLatin1String, QOrm::Comparison> operators[] = {
+                {QLatin1String("=="), QOrm::Comparison::Equal},
+                {QLatin1String("!="), QOrm::Comparison::NotEqual},
+                {QLatin1String("<="), QOrm::Comparison::LessOrEqual},
+                {QLatin1String(">="), QOrm::Comparison::GreaterOrEqual},
+                {QLatin1String("<"), QOrm::Comparison::Less},
+                {QLatin1String(">"), QOrm::Comparison::Greater}};
+
+            QString propertyName = consumeMatch(QStringLiteral(R"(\w+)"));
+
+            if (propertyName.isEmpty())
+                return std::nullopt;
+
+            for (const auto& [token, comparison] : operators)
+            {
+                if (!consume(token))
+                    continue;
+
+                std::optional<QVariant> value = parseValue();
+
+                if (!value.has_value())
+                    return std::nullopt;
+
+                return QOrmFilterExpression{
+                    QOrmFilterTerminalPredicate{QOrmClassProperty{qPrintable(propertyName)},
+                                                comparison,
+                                                *value}};
+            }
+
+            return std::nullopt;
+        }
+
+        [[nodiscard]] std::optional<QVariant> parseValue()
+        {
+            if (consume(QLatin1String("null")))
+                return QVariant{};
+
+            if (consume(QLatin1String("true")))
+                return QVariant{true};
+
+            if (consume(QLatin1String("false")))
+                return QVariant{false};
+
+            QString string = consumeMatch(QStringLiteral(R"('(?:[^']|'')*')"));
+
+            if (!string.isEmpty())
+                return QVariant{string.mid(1, string.size() - 2).replace("''", "'")};
+
+            QString number = consumeMatch(QStringLiteral(R"(-?\d+(?:\.\d+)?)"));
+
+            if (number.contains(QLatin1Char('.')))
+                return QVariant{number.toDouble()};
+
+            // Integers are compared to the object ids of referenced entities, which are mostly int
+            if (!number.isEmpty())
+            {
+                qlonglong integer = number.toLongLong();
+
+                if (integer >= std::numeric_limits<int>::min() &&
+                    integer <= std::numeric_limits<int>::max())
+                {
+                    return QVariant{static_cast<int>(integer)};
+                }
+
+                return QVariant{integer};
+            }
+
+            return std::nullopt;
+        }
+
+        // Consumes the longest match of the pattern at the current position
+        QString consumeMatch(const QString& pattern)
+        {
+            skipWhitespace();
+
+            QRegularExpression regExp{pattern};
+            QRegularExpressionMatch match =
+                regExp.match(m_data, m_pos, QRegularExpression::NormalMatch,
+                             QRegularExpression::AnchoredMatchOption);
+
+            if (!match.hasMatch())
+                return {};
+
+            m_pos += match.capturedLength();
+            return match.captured();
+        }
+
+        QString m_data;
+        int m_pos{0};
+    };
+
     [[nodiscard]] QOrmUserMetadata extractClassInfo(const QMetaObject& qMetaObject, QString data)
     {
         // Q_CLASSINFO removes whitespaces from its arguments. So a declaration like
@@ -182,6 +407,57 @@ namespace
                            qMetaObject.className());
                 }
             }
+            else if (keywordPosition.keyword->id == QOrm::Keyword::Index ||
+                     keywordPosition.keyword->id == QOrm::Keyword::Unique)
+            {
+                QOrm::Keyword keyword = keywordPosition.keyword->id;
+                QLatin1String token = keywordPosition.keyword->token;
+
+                auto extractResult = extractString(data, pos, ClassKeywords);
+
+                std::optional<QStringList> propertyNames = parsePropertyList(extractResult.value);
+                keywordPosition = extractResult.nextKeyword;
+
+                if (!propertyNames.has_value())
+                {
+                    qFatal("QtOrm: syntax error in %s: Q_ORM_CLASS(%s (<property>, ...)) requires "
+                           "a list of properties.",
+                           qMetaObject.className(),
+                           token.data());
+                }
+
+                QVariantMap index{{QStringLiteral("properties"), *propertyNames}};
+
+                // A partial index: INDEX (...) WHERE (...)
+                if (keywordPosition.keyword != nullptr &&
+                    keywordPosition.keyword->id == QOrm::Keyword::Where)
+                {
+                    pos = keywordPosition.pos + keywordPosition.keyword->token.size();
+                    extractResult = extractString(data, pos, ClassKeywords);
+                    keywordPosition = extractResult.nextKeyword;
+
+                    if (!FilterPredicateParser{extractResult.value}.parse().has_value())
+                    {
+                        qFatal("QtOrm: syntax error in %s: Q_ORM_CLASS(%s (...) WHERE <predicate>) "
+                               "requires a filter predicate.",
+                               qMetaObject.className(),
+                               token.data());
+                    }
+
+                    index.insert(QStringLiteral("where"), extractResult.value);
+                }
+
+                // A class can declare any number of indexes
+                QVariantList indexes = ormClassInfo.value(keyword).toList();
+                indexes.push_back(index);
+                ormClassInfo.insert(keyword, indexes);
+            }
+            else if (keywordPosition.keyword->id == QOrm::Keyword::Where)
+            {
+                qFatal("QtOrm: syntax error in %s: Q_ORM_CLASS(WHERE ...) must follow an INDEX or "
+                       "UNIQUE declaration.",
+                       qMetaObject.className());
+            }
         }
 
         return ormClassInfo;
@@ -301,6 +577,27 @@ namespace
                 ormPropertyInfo.insert(QOrm::Keyword::Autogenerated,
                                        isAutogenerated.value_or(true));
             }
+            else if (keywordPosition.keyword->id == QOrm::Keyword::Index ||
+                     keywordPosition.keyword->id == QOrm::Keyword::Unique)
+            {
+                QOrm::Keyword keyword = keywordPosition.keyword->id;
+                QLatin1String token = keywordPosition.keyword->token;
+
+                auto extractResult = extractBoolean(data, pos, PropertyKeywords);
+
+                if (!extractResult.has_value())
+                {
+                    qFatal("QtOrm: syntax error in %s in Q_ORM_PROPERTY(%s ...) after %s",
+                           qMetaObject.className(),
+                           qPrintable(propertyName),
+                           token.data());
+                }
+
+                std::optional<bool> isIndexed = extractResult->value;
+                keywordPosition = extractResult->nextKeyword;
+
+                ormPropertyInfo.insert(keyword, isIndexed.value_or(true));
+            }
         }
 
         return ormPropertyInfo;
@@ -323,6 +620,9 @@ class QOrmMetadataCachePrivate
         QVariant::Type dataType{QVariant::Invalid};
     };
 
+    // Guards the cache so that it can be shared between sessions of different threads. The
+    // constructed metadata is immutable.
+    QMutex m_mutex;
     std::unordered_map<QByteArray, QOrmMetadata> m_cache;
 
     QSet<QByteArray> m_underConstruction;
@@ -338,6 +638,9 @@ class QOrmMetadataCachePrivate
 
     void validateConstructor(const QMetaObject& qMetaObject);
 
+    [[nodiscard]] std::vector<QOrmIndex> indexes(const QOrmMetadataPrivate& data);
+    void validateIndexNames(const QByteArray& className);
+
     template<typename Container>
     void validateCrossReferences(Container&& entityNames);
 };
@@ -474,6 +777,9 @@ void QOrmMetadataCachePrivate::initialize(const QByteArray& className,
             data->m_objectIdPropertyMappingIdx = idx;
     }
 
+    data->m_indexes = indexes(*data);
+    validateIndexNames(className);
+
     m_underConstruction.remove(className);
     m_constructed.insert(className);
 
@@ -607,6 +913,207 @@ QOrmMetadataCachePrivate::MappingDescriptor QOrmMetadataCachePrivate::mappingDes
     return descriptor;
 }
 
+// Collects the indexes declared on the properties, followed by the ones declared on the class and
+// the indexes of the reference columns
+std::vector<QOrmIndex> QOrmMetadataCachePrivate::indexes(const QOrmMetadataPrivate& data)
+{
+    std::vector<QOrmIndex> result;
+    // Definitions of the indexes by name to tell duplicates from different indexes named alike
+    QHash<QString, QString> definitions;
+
+    auto propertyMapping = [&data](const QString& propertyName) -> const QOrmPropertyMapping& {
+        auto it = data.m_classPropertyMappingIndex.find(propertyName);
+
+        if (it == std::end(data.m_classPropertyMappingIndex))
+        {
+            qFatal("QtOrm: %s declares an index on %s which is not a property of the class",
+                   qPrintable(data.m_className),
+                   qPrintable(propertyName));
+        }
+
+        const QOrmPropertyMapping& mapping =
+            data.m_propertyMappings[static_cast<size_t>(it.value())];
+
+        if (mapping.isTransient())
+        {
+            qFatal("QtOrm: %s declares an index on the transient property %s",
+                   qPrintable(data.m_className),
+                   qPrintable(propertyName));
+        }
+
+        return mapping;
+    };
+
+    // The properties in the predicate of a partial index must be mapped to columns
+    std::function<void(const QOrmFilterExpression&)> validateFilter =
+        [&](const QOrmFilterExpression& expression) {
+            switch (expression.type())
+            {
+                case QOrm::FilterExpressionType::TerminalPredicate:
+                    propertyMapping(expression.terminalPredicate()->classProperty()->descriptor());
+                    break;
+
+                case QOrm::FilterExpressionType::BinaryPredicate:
+                    validateFilter(expression.binaryPredicate()->lhs());
+                    validateFilter(expression.binaryPredicate()->rhs());
+                    break;
+
+                case QOrm::FilterExpressionType::UnaryPredicate:
+                    validateFilter(expression.unaryPredicate()->rhs());
+                    break;
+            }
+        };
+
+    auto addIndex = [&](const QStringList& propertyNames,
+                        bool isUnique,
+                        const QString& where = QString{}) {
+        static const QRegularExpression lowerPattern{QStringLiteral(R"(^lower\((\w+)\)$)")};
+
+        QStringList columns;
+        QStringList nameParts;
+
+        for (const QString& propertyName : propertyNames)
+        {
+            QRegularExpressionMatch lowerMatch = lowerPattern.match(propertyName);
+
+            if (lowerMatch.hasMatch())
+            {
+                const QOrmPropertyMapping& mapping = propertyMapping(lowerMatch.captured(1));
+                columns.push_back(QStringLiteral("lower(%1)").arg(mapping.tableFieldName()));
+                nameParts.push_back(QStringLiteral("lower_%1").arg(mapping.tableFieldName()));
+            }
+            else
+            {
+                const QOrmPropertyMapping& mapping = propertyMapping(propertyName);
+                columns.push_back(mapping.tableFieldName());
+                nameParts.push_back(mapping.tableFieldName());
+            }
+        }
+
+        std::optional<QOrmFilterExpression> filter;
+
+        if (!where.isEmpty())
+        {
+            filter = FilterPredicateParser{where}.parse();
+            Q_ASSERT(filter.has_value());
+
+            validateFilter(*filter);
+            nameParts.push_back(QStringLiteral("partial"));
+        }
+
+        QString baseName = nameParts.join(QLatin1Char('_'));
+        QString definition = QStringLiteral("%1 %2 %3")
+                                 .arg(columns.join(QLatin1Char(',')),
+                                      isUnique ? QStringLiteral("UNIQUE") : QString{},
+                                      where.simplified());
+
+        // E.g. partial indexes of the same columns with different predicates are numbered
+        for (int number = 1;; ++number)
+        {
+            QString name =
+                QStringLiteral("qtorm_%1_%2_%3")
+                    .arg(data.m_tableName,
+                         number == 1 ? baseName : QStringLiteral("%1_%2").arg(baseName).arg(number),
+                         isUnique ? QStringLiteral("key") : QStringLiteral("idx"));
+
+            auto it = definitions.constFind(name);
+
+            if (it == definitions.constEnd())
+            {
+                definitions.insert(name, definition);
+                result.emplace_back(name, columns, isUnique, filter);
+                break;
+            }
+
+            if (it.value() == definition)
+                break;
+        }
+    };
+
+    for (const QOrmPropertyMapping& mapping : data.m_propertyMappings)
+    {
+        if (mapping.userMetadata().value(QOrm::Keyword::Index).toBool())
+            addIndex({mapping.classPropertyName()}, false);
+
+        if (mapping.userMetadata().value(QOrm::Keyword::Unique).toBool())
+            addIndex({mapping.classPropertyName()}, true);
+    }
+
+    for (const QVariant& index : data.m_userMetadata.value(QOrm::Keyword::Index).toList())
+    {
+        QVariantMap declaration = index.toMap();
+        addIndex(declaration.value(QStringLiteral("properties")).toStringList(),
+                 false,
+                 declaration.value(QStringLiteral("where")).toString());
+    }
+
+    for (const QVariant& index : data.m_userMetadata.value(QOrm::Keyword::Unique).toList())
+    {
+        QVariantMap declaration = index.toMap();
+        addIndex(declaration.value(QStringLiteral("properties")).toStringList(),
+                 true,
+                 declaration.value(QStringLiteral("where")).toString());
+    }
+
+    // Reference columns are indexed unless a full index starts with the column already or the
+    // property is declared with INDEX false
+    for (const QOrmPropertyMapping& mapping : data.m_propertyMappings)
+    {
+        if (!mapping.isReference() || mapping.isTransient() ||
+            !mapping.userMetadata().value(QOrm::Keyword::Index, true).toBool())
+        {
+            continue;
+        }
+
+        bool isCovered =
+            std::any_of(result.begin(), result.end(), [&mapping](const QOrmIndex& index) {
+                return !index.filter().has_value() &&
+                       index.columns().first() == mapping.tableFieldName();
+            });
+
+        if (!isCovered)
+            addIndex({mapping.classPropertyName()}, false);
+    }
+
+    return result;
+}
+
+// Index names are unique within a database. Names derived from different tables and columns may
+// still coincide, e.g. for the tables a_b and a with the columns c and b_c.
+void QOrmMetadataCachePrivate::validateIndexNames(const QByteArray& className)
+{
+    const QOrmMetadata& entity = m_cache.at(className);
+
+    for (const QByteArray& otherClassName : qAsConst(m_constructed))
+    {
+        const QOrmMetadata& other = m_cache.at(otherClassName);
+
+        // Entities mapped to the same table share its indexes
+        if (other.tableName() == entity.tableName())
+            continue;
+
+        for (const QOrmIndex& index : entity.indexes())
+        {
+            bool collides =
+                std::any_of(other.indexes().begin(),
+                            other.indexes().end(),
+                            [&index](const QOrmIndex& otherIndex) {
+                                return otherIndex.name().compare(index.name(),
+                                                                 Qt::CaseInsensitive) == 0;
+                            });
+
+            if (collides)
+            {
+                qFatal("QtOrm: The index %s of %s has the same name as an index of %s. Rename "
+                       "the table or the columns of either entity.",
+                       index.name().toUtf8().data(),
+                       className.data(),
+                       otherClassName.data());
+            }
+        }
+    }
+}
+
 void QOrmMetadataCachePrivate::validateConstructor(const QMetaObject& qMetaObject)
 {
     bool hasError = false;
@@ -700,5 +1207,7 @@ QOrmMetadataCache::~QOrmMetadataCache() = default;
 
 const QOrmMetadata& QOrmMetadataCache::operator[](const QMetaObject& qMetaObject)
 {
+    QMutexLocker locker{&d->m_mutex};
+
     return d->get(qMetaObject);
 }
@@ -22,6 +22,7 @@
 #include "qormfilter.h"
 #include "qormmetadata.h"
 #include "qormorder.h"
+#include "qormpropertymapping.h"
 #include "qormrelation.h"
 
 #include <QDebug>
@@ -67,6 +68,8 @@ public:
     QFlags<QOrm::QueryFlags> m_flags;
     std::optional<int> m_limit;
     std::optional<int> m_offset;
+    std::vector<QOrmPropertyMapping> m_columns;
+    QOrmError m_error{QOrm::ErrorType::None, {}};
 };
 
 QOrmQuery::QOrmQuery(QOrm::Operation operation,
@@ -163,6 +166,26 @@ void QOrmQuery::setOffset(std::optional<int> offset)
     d->m_offset = offset;
 }
 
+const std::vector<QOrmPropertyMapping>& QOrmQuery::columns() const
+{
+    return d->m_columns;
+}
+
+void QOrmQuery::setColumns(const std::vector<QOrmPropertyMapping>& columns)
+{
+    d->m_columns = columns;
+}
+
+QOrmError QOrmQuery::error() const
+{
+    return d->m_error;
+}
+
+void QOrmQuery::setError(const QOrmError& error)
+{
+    d->m_error = error;
+}
+
 QDebug operator<<(QDebug dbg, const QOrmQuery& query)
 {
     QDebugStateSaver saver{dbg};
@@ -204,6 +227,11 @@ QDebug operator<<(QDebug dbg, const QOrmQuery& query)
         dbg << ", offset " << *query.offset();
     }
 
+    if (!query.columns().empty())
+    {
+        dbg << ", columns " << query.columns();
+    }
+
     dbg << ")";
 
     return dbg;
@@ -34,6 +34,7 @@ QT_BEGIN_NAMESPACE
 
 class QOrmFilter;
 class QOrmOrder;
+class QOrmPropertyMapping;
 class QOrmQueryPrivate;
 class QOrmRelation;
 class QOrmMetadata;
@@ -86,6 +87,15 @@ public:
     [[nodiscard]] std::optional<int> offset() const;
     void setOffset(std::optional<int> offset);
 
+    // Properties read by the query in addition to the object ID. If empty, all properties are read.
+    [[nodiscard]] const std::vector<QOrmPropertyMapping>& columns() const;
+    void setColumns(const std::vector<QOrmPropertyMapping>& columns);
+
+    // Set if the query could not be built, e.g. from an invalid page token. Such a query is not
+    // executed, the error is returned instead.
+    [[nodiscard]] QOrmError error() const;
+    void setError(const QOrmError& error);
+
 private:
     QSharedDataPointer<QOrmQueryPrivate> d;
 };
@@ -21,6 +21,7 @@
 #include "qormquerybuilder.h"
 
 #include "qormabstractprovider.h"
+#include "qormcursor.h"
 #include "qormerror.h"
 #include "qormfilter.h"
 #include "qormfilterexpression.h"
@@ -32,8 +33,11 @@
 #include "qormrelation.h"
 #include "qormsession.h"
 
+#include <QDataStream>
 #include <QDebug>
 
+#include <algorithm>
+
 QT_BEGIN_NAMESPACE
 
 namespace QOrmPrivate
@@ -110,10 +114,261 @@ namespace QOrmPrivate
         QObject* m_entityInstance{nullptr};
         std::vector<QOrmFilter> m_filters;
         std::vector<QOrmOrder> m_order;
+        std::vector<QOrmPropertyMapping> m_columns;
         std::optional<int> m_limit{std::nullopt};
         std::optional<int> m_offset{std::nullopt};
+
+        // Keyset pagination: the rows following or preceding a row in the order of the query
+        const QObject* m_seekInstance{nullptr};
+        std::optional<QString> m_pageToken;
+        bool m_seekBackward{false};
+
+        [[nodiscard]] bool isSeeking() const
+        {
+            return m_seekInstance != nullptr || m_pageToken.has_value();
+        }
+
+        [[nodiscard]] std::vector<QOrmOrder> seekOrder() const;
+        [[nodiscard]] QString seekShape(const std::vector<QOrmOrder>& order) const;
+        [[nodiscard]] QVariantList seekKey(const QObject* instance,
+                                           const std::vector<QOrmOrder>& order) const;
+        // The key would take the default values of the order properties that have not been read
+        [[nodiscard]] std::optional<QString> unselectedOrderProperty(
+            const std::vector<QOrmOrder>& order) const;
+        [[nodiscard]] static std::optional<QString> unreadOrderProperty(
+            const std::vector<QOrmOrder>& order,
+            const QObject* instance);
+        [[nodiscard]] Expected<QVariantList, QOrmError> resolveSeekKey(
+            const std::vector<QOrmOrder>& order) const;
+        [[nodiscard]] QOrmFilterExpression seekFilter(const std::vector<QOrmOrder>& order,
+                                                      const QVariantList& key) const;
     };
 
+    // The object ID breaks the ties between rows having the same values in the order columns
+    std::vector<QOrmOrder> QueryBuilderHelperPrivate::seekOrder() const
+    {
+        const QOrmPropertyMapping* objectIdMapping = m_projection->objectIdMapping();
+        Q_ASSERT(objectIdMapping != nullptr);
+
+        std::vector<QOrmOrder> order = m_order;
+
+        bool hasObjectId =
+            std::any_of(std::begin(order), std::end(order), [objectIdMapping](const QOrmOrder& o) {
+                return o.mapping().classPropertyName() == objectIdMapping->classPropertyName();
+            });
+
+        if (!hasObjectId)
+            order.emplace_back(*objectIdMapping, Qt::AscendingOrder);
+
+        return order;
+    }
+
+    QString QueryBuilderHelperPrivate::seekShape(const std::vector<QOrmOrder>& order) const
+    {
+        QStringList columns;
+
+        for (const QOrmOrder& element : order)
+        {
+            columns.push_back(element.mapping().classPropertyName() +
+                              (element.direction() == Qt::AscendingOrder ? '+' : '-'));
+        }
+
+        return m_projection->className() + ':' + columns.join(',');
+    }
+
+    QVariantList QueryBuilderHelperPrivate::seekKey(const QObject* instance,
+                                                    const std::vector<QOrmOrder>& order) const
+    {
+        QVariantList key;
+
+        for (const QOrmOrder& element : order)
+        {
+            QVariant value = QOrmPrivate::propertyValue(instance, element.mapping());
+
+            // References are compared by the object ID so that the key can be serialized
+            if (element.mapping().isReference())
+            {
+                const QObject* referencedInstance = value.value<QObject*>();
+                value = referencedInstance != nullptr
+                            ? QOrmPrivate::objectIdPropertyValue(
+                                  referencedInstance, *element.mapping().referencedEntity())
+                            : QVariant{};
+            }
+
+            key.push_back(value);
+        }
+
+        return key;
+    }
+
+    // The object ID is always read
+    std::optional<QString> QueryBuilderHelperPrivate::unselectedOrderProperty(
+        const std::vector<QOrmOrder>& order) const
+    {
+        if (m_columns.empty())
+            return std::nullopt;
+
+        for (const QOrmOrder& element : order)
+        {
+            const QOrmPropertyMapping& mapping = element.mapping();
+
+            if (!mapping.isObjectId() &&
+                std::none_of(std::cbegin(m_columns),
+                             std::cend(m_columns),
+                             [&mapping](const QOrmPropertyMapping& column) {
+                                 return column.classPropertyName() == mapping.classPropertyName();
+                             }))
+            {
+                return mapping.classPropertyName();
+            }
+        }
+
+        return std::nullopt;
+    }
+
+    std::optional<QString> QueryBuilderHelperPrivate::unreadOrderProperty(
+        const std::vector<QOrmOrder>& order,
+        const QObject* instance)
+    {
+        if (!isPartialInstance(instance))
+            return std::nullopt;
+
+        QStringList classProperties = partialInstanceProperties(instance);
+
+        for (const QOrmOrder& element : order)
+        {
+            const QOrmPropertyMapping& mapping = element.mapping();
+
+            if (!mapping.isObjectId() && !classProperties.contains(mapping.classPropertyName()))
+                return mapping.classPropertyName();
+        }
+
+        return std::nullopt;
+    }
+
+    Expected<QVariantList, QOrmError> QueryBuilderHelperPrivate::resolveSeekKey(
+        const std::vector<QOrmOrder>& order) const
+    {
+        // The next key would be taken from a row without the order property
+        if (std::optional<QString> property = unselectedOrderProperty(order))
+        {
+            return makeUnexpected(QOrmError{
+                QOrm::ErrorType::Other,
+                QStringLiteral("The order property %1 must be selected by columns() to seek")
+                    .arg(*property)});
+        }
+
+        if (m_seekInstance != nullptr)
+        {
+            if (std::optional<QString> property = unreadOrderProperty(order, m_seekInstance))
+            {
+                return makeUnexpected(QOrmError{
+                    QOrm::ErrorType::Other,
+                    QStringLiteral("The order property %1 has not been read into the instance")
+                        .arg(*property)});
+            }
+
+            return seekKey(m_seekInstance, order);
+        }
+
+        QByteArray data = QByteArray::fromBase64(m_pageToken->toLatin1(),
+                                                 QByteArray::Base64UrlEncoding |
+                                                     QByteArray::OmitTrailingEquals);
+        QDataStream stream{data};
+        stream.setVersion(QDataStream::Qt_5_12);
+
+        quint8 version = 0;
+        QString shape;
+        QVariantList key;
+        stream >> version >> shape >> key;
+
+        // A token only fits the query it was made for
+        if (stream.status() != QDataStream::Ok || version != 1 || shape != seekShape(order) ||
+            key.size() != static_cast<int>(order.size()))
+        {
+            return makeUnexpected(QOrmError{QOrm::ErrorType::Other,
+                                            QStringLiteral("Invalid page token")});
+        }
+
+        return key;
+    }
+
+    // after (a, id) in ascending order: a >= :a AND (a > :a OR (a = :a AND id > :id)). The first
+    // term is redundant but lets SQLite search an index on a instead of scanning the table. SQLite
+    // sorts NULL before the other values, so a NULL in the key is compared with IS NULL and IS NOT
+    // NULL.
+    QOrmFilterExpression QueryBuilderHelperPrivate::seekFilter(const std::vector<QOrmOrder>& order,
+                                                               const QVariantList& key) const
+    {
+        Q_ASSERT(!order.empty() && key.size() == static_cast<int>(order.size()));
+
+        // The values following the key value in the order, if there are any
+        auto follows = [this](const QOrmOrder& element,
+                              const QVariant& value) -> std::optional<QOrmFilterExpression> {
+            const QOrmPropertyMapping& mapping = element.mapping();
+            bool isAscending = (element.direction() == Qt::AscendingOrder) != m_seekBackward;
+
+            if (value.isNull())
+            {
+                if (!isAscending)
+                    return std::nullopt;
+
+                return QOrmFilterTerminalPredicate{mapping, QOrm::Comparison::NotEqual, QVariant{}};
+            }
+
+            if (isAscending)
+                return QOrmFilterTerminalPredicate{mapping, QOrm::Comparison::Greater, value};
+
+            return QOrmFilterTerminalPredicate{mapping, QOrm::Comparison::Less, value} ||
+                   QOrmFilterTerminalPredicate{mapping, QOrm::Comparison::Equal, QVariant{}};
+        };
+
+        std::optional<QOrmFilterExpression> expression;
+
+        for (int i = static_cast<int>(order.size()) - 1; i >= 0; --i)
+        {
+            std::optional<QOrmFilterExpression> following = follows(order[i], key[i]);
+
+            if (!expression.has_value())
+            {
+                expression = following;
+                continue;
+            }
+
+            // Compares to NULL with IS NULL if the key value is NULL
+            QOrmFilterTerminalPredicate equals{order[i].mapping(), QOrm::Comparison::Equal, key[i]};
+
+            if (following.has_value())
+                expression = *following || (equals && *expression);
+            else
+                expression = equals && *expression;
+        }
+
+        // Nothing follows the key, e.g. NULL in descending order. The object ID is never NULL.
+        if (!expression.has_value())
+        {
+            return QOrmFilterTerminalPredicate{
+                *m_projection->objectIdMapping(), QOrm::Comparison::Equal, QVariant{}};
+        }
+
+        // A single comparison needs no bound, a NULL in the key leaves the leading column unbounded
+        if (order.size() == 1 || key.front().isNull())
+            return *expression;
+
+        const QOrmPropertyMapping& leading = order.front().mapping();
+
+        if ((order.front().direction() == Qt::AscendingOrder) != m_seekBackward)
+        {
+            return QOrmFilterTerminalPredicate{
+                       leading, QOrm::Comparison::GreaterOrEqual, key.front()} &&
+                   *expression;
+        }
+
+        return (QOrmFilterTerminalPredicate{leading, QOrm::Comparison::LessOrEqual, key.front()} ||
+                QOrmFilterTerminalPredicate{leading, QOrm::Comparison::Equal, QVariant{}}) &&
+               *expression;
+    }
+
     QueryBuilderHelper::QueryBuilderHelper(QOrmSession* ormSession, const QOrmRelation& relation)
         : d{new QueryBuilderHelperPrivate{ormSession, relation}}
     {
@@ -148,6 +403,17 @@ namespace QOrmPrivate
         d->m_order.emplace_back(*mapping, direction);
     }
 
+    void QueryBuilderHelper::addColumn(const QOrmClassProperty& classProperty)
+    {
+        Q_ASSERT(d->m_projection.has_value());
+
+        const QOrmPropertyMapping* mapping =
+            d->m_projection->classPropertyMapping(classProperty.descriptor());
+        Q_ASSERT(mapping != nullptr);
+
+        d->m_columns.push_back(*mapping);
+    }
+
     void QueryBuilderHelper::setLimit(int limit)
     {
         d->m_limit = limit;
@@ -158,6 +424,41 @@ namespace QOrmPrivate
         d->m_offset = offset;
     }
 
+    void QueryBuilderHelper::setSeekInstance(const QObject* instance, bool isBackward)
+    {
+        Q_ASSERT(instance != nullptr);
+
+        d->m_seekInstance = instance;
+        d->m_pageToken.reset();
+        d->m_seekBackward = isBackward;
+    }
+
+    void QueryBuilderHelper::setPageToken(const QString& pageToken, bool isBackward)
+    {
+        d->m_seekInstance = nullptr;
+        d->m_pageToken = pageToken;
+        d->m_seekBackward = isBackward;
+    }
+
+    QString QueryBuilderHelper::pageToken(const QObject* instance) const
+    {
+        Q_ASSERT(instance != nullptr);
+
+        std::vector<QOrmOrder> order = d->seekOrder();
+
+        // The instance has no position in the order: the token is rejected by after() and before()
+        if (d->unreadOrderProperty(order, instance).has_value())
+            return {};
+
+        QByteArray data;
+        QDataStream stream{&data, QIODevice::WriteOnly};
+        stream.setVersion(QDataStream::Qt_5_12);
+        stream << quint8{1} << d->seekShape(order) << d->seekKey(instance, order);
+
+        return QString::fromLatin1(
+            data.toBase64(QByteArray::Base64UrlEncoding | QByteArray::OmitTrailingEquals));
+    }
+
     QOrmQuery QueryBuilderHelper::build(QOrm::Operation operation, QOrm::QueryFlags flags) const
     {
         if (operation == QOrm::Operation::Merge ||  //
@@ -172,24 +473,98 @@ namespace QOrmPrivate
         else if (operation == QOrm::Operation::Read || operation == QOrm::Operation::Delete)
         {
             FoldedFilters filters = foldFilters(d->m_relation, d->m_filters);
+            std::vector<QOrmOrder> order = d->m_order;
+            QOrmError error{QOrm::ErrorType::None, {}};
+
+            if (operation == QOrm::Operation::Read && d->isSeeking())
+            {
+                order = d->seekOrder();
+
+                Expected<QVariantList, QOrmError> key = d->resolveSeekKey(order);
+
+                // A page token comes from the client: an invalid one is reported by the query
+                if (!key)
+                    error = key.error();
+                else
+                {
+                    QOrmFilterExpression seek = d->seekFilter(order, key.value());
+
+                    filters.expression =
+                        filters.expression.has_value()
+                            ? QOrmFilter{*filters.expression->expression() && seek}
+                            : QOrmFilter{seek};
+
+                    // The preceding rows are read backwards from the key
+                    if (d->m_seekBackward)
+                    {
+                        for (QOrmOrder& element : order)
+                        {
+                            element = QOrmOrder{element.mapping(),
+                                                element.direction() == Qt::AscendingOrder
+                                                    ? Qt::DescendingOrder
+                                                    : Qt::AscendingOrder};
+                        }
+                    }
+                }
+            }
+
             QOrmQuery query = QOrmQuery{operation,
                                         d->m_relation,
                                         d->m_projection,
                                         filters.expression,
                                         filters.invokable,
-                                        d->m_order,
+                                        order,
                                         flags};
             query.setLimit(d->m_limit);
             query.setOffset(d->m_offset);
+
+            if (operation == QOrm::Operation::Read)
+                query.setColumns(d->m_columns);
+
+            query.setError(error);
+
             return query;
         }
 
         qFatal("Unexpected state");
     }
 
+    // The rows preceding the seek key are read backwards and returned in the order of the query
+    static QOrmQueryResult<QObject> reversed(const QOrmQueryResult<QObject>& result)
+    {
+        if (result.hasError())
+            return result;
+
+        QVector<QObject*> instances = result.toVector();
+        std::reverse(std::begin(instances), std::end(instances));
+
+        return QOrmQueryResult<QObject>{
+            {}, instances, result.lastInsertedId(), result.numRowsAffected()};
+    }
+
     QOrmQueryResult<QObject> QueryBuilderHelper::select(QOrm::QueryFlags flags) const
     {
-        return d->m_session->execute(build(QOrm::Operation::Read, flags));
+        QOrmQueryResult<QObject> result =
+            d->m_session->execute(build(QOrm::Operation::Read, flags));
+
+        return d->isSeeking() && d->m_seekBackward ? reversed(result) : result;
+    }
+
+    void QueryBuilderHelper::selectAsync(QOrm::QueryFlags flags, AsyncCompletion completion) const
+    {
+        if (d->isSeeking() && d->m_seekBackward)
+        {
+            completion = [completion](const QOrmQueryResult<QObject>& result) {
+                completion(reversed(result));
+            };
+        }
+
+        d->m_session->executeAsync(build(QOrm::Operation::Read, flags), std::move(completion));
+    }
+
+    std::unique_ptr<QOrmAbstractCursor> QueryBuilderHelper::stream(QOrm::QueryFlags flags) const
+    {
+        return d->m_session->openCursor(build(QOrm::Operation::Read, flags));
     }
 
     QOrmQueryResult<QObject> QueryBuilderHelper::remove() const
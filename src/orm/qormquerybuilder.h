@@ -21,6 +21,7 @@
 #ifndef QORMQUERYBUILDER_H
 #define QORMQUERYBUILDER_H
 
+#include <QtOrm/qormcursor.h>
 #include <QtOrm/qormfilter.h>
 #include <QtOrm/qormfilterexpression.h>
 #include <QtOrm/qormglobal.h>
@@ -60,14 +61,21 @@ namespace QOrmPrivate
         void setInstance(const QMetaObject& qMetaObject, QObject* instance);
         void addFilter(const QOrmFilter& filter);
         void addOrder(const QOrmClassProperty& classProperty, Qt::SortOrder direction);
+        void addColumn(const QOrmClassProperty& classProperty);
         void setLimit(int limit);
         void setOffset(int offset);
+        void setSeekInstance(const QObject* instance, bool isBackward);
+        void setPageToken(const QString& pageToken, bool isBackward);
+
+        [[nodiscard]] QString pageToken(const QObject* instance) const;
 
         Q_REQUIRED_RESULT
         QOrmQuery build(QOrm::Operation operation, QOrm::QueryFlags flags) const;
 
         Q_REQUIRED_RESULT
         QOrmQueryResult<QObject> select(QOrm::QueryFlags flags) const;
+        void selectAsync(QOrm::QueryFlags flags, AsyncCompletion completion) const;
+        [[nodiscard]] std::unique_ptr<QOrmAbstractCursor> stream(QOrm::QueryFlags flags) const;
 
         [[nodiscard]] QOrmQueryResult<QObject> remove() const;
 
@@ -124,6 +132,16 @@ public:
         return *this;
     }
 
+    // Reads only the given properties and the object ID. The instances read are partial: they
+    // are not tracked by the session and belong to the caller, and they cannot be merged. Seeking
+    // with after() or before() fails unless the order properties are selected.
+    template<typename... ClassProperties>
+    QOrmQueryBuilder& columns(const ClassProperties&... classProperties)
+    {
+        (m_helper.addColumn(classProperties), ...);
+        return *this;
+    }
+
     QOrmQueryBuilder& instance(const QMetaObject& qMetaObject, QObject* instance)
     {
         m_helper.setInstance(qMetaObject, instance);
@@ -142,12 +160,78 @@ public:
         return *this;
     }
 
+    // Keyset pagination: restricts the result to the rows following or preceding the instance in
+    // the order of the query, which is completed with the object ID. Unlike offset(), the rows
+    // before the page are not read. Call it after order(). NULL sorts before the other values.
+    QOrmQueryBuilder& after(const Projection* instance)
+    {
+        m_helper.setSeekInstance(instance, false);
+        return *this;
+    }
+
+    // The rows are returned in the order of the query, except for stream() which returns them
+    // backwards from the instance
+    QOrmQueryBuilder& before(const Projection* instance)
+    {
+        m_helper.setSeekInstance(instance, true);
+        return *this;
+    }
+
+    // A page token made by pageToken() for a query with the same order
+    QOrmQueryBuilder& after(const QString& pageToken)
+    {
+        m_helper.setPageToken(pageToken, false);
+        return *this;
+    }
+
+    QOrmQueryBuilder& before(const QString& pageToken)
+    {
+        m_helper.setPageToken(pageToken, true);
+        return *this;
+    }
+
+    // Encodes the position of the instance in the order of the query, e.g. for stateless services.
+    // Returns an invalid token for a partial instance without the order properties.
+    [[nodiscard]] QString pageToken(const Projection* instance) const
+    {
+        return m_helper.pageToken(instance);
+    }
+
     Q_REQUIRED_RESULT
     QOrmQueryResult<Projection> select(QOrm::QueryFlags flags = QOrm::QueryFlags::None) const
     {
         return m_helper.select(flags);
     }
 
+    // Reads in the database thread of the session. The future finishes in the thread of the
+    // session.
+    [[nodiscard]] QFuture<QOrmQueryResult<Projection>> selectAsync(
+        QOrm::QueryFlags flags = QOrm::QueryFlags::None) const
+    {
+        QFuture<QOrmQueryResult<Projection>> future;
+        m_helper.selectAsync(flags, QOrmPrivate::asyncCompletion(future));
+        return future;
+    }
+
+    // Calls callback(const QOrmQueryResult<Projection>&) in the thread of the receiver
+    template<typename Functor>
+    void selectAsync(const QObject* receiver,
+                     Functor callback,
+                     QOrm::QueryFlags flags = QOrm::QueryFlags::None) const
+    {
+        m_helper.selectAsync(
+            flags, QOrmPrivate::asyncCompletion<Projection>(receiver, std::move(callback)));
+    }
+
+    // Reads the rows one at a time while the cursor is iterated, so that large results need not
+    // be held in memory at once. With QOrm::QueryFlags::ReleaseConsumedInstances, an instance is
+    // only valid until the cursor moves on unless it is taken from the entity instance cache.
+    [[nodiscard]] QOrmCursor<Projection> stream(
+        QOrm::QueryFlags flags = QOrm::QueryFlags::None) const
+    {
+        return QOrmCursor<Projection>{m_helper.stream(flags)};
+    }
+
     [[nodiscard]] QOrmQueryResult<Projection> remove() { return m_helper.remove(); }
 
     Q_REQUIRED_RESULT
@@ -24,11 +24,16 @@
 #include <QtOrm/qormerror.h>
 #include <QtOrm/qormglobal.h>
 
+#include <QtCore/qfuture.h>
 #include <QtCore/qobject.h>
+#include <QtCore/qpointer.h>
 #include <QtCore/qshareddata.h>
 #include <QtCore/qvariant.h>
 #include <QtCore/qvector.h>
 
+#include <functional>
+#include <memory>
+
 QT_BEGIN_NAMESPACE
 
 class QOrmError;
@@ -74,7 +79,8 @@ public:
     using iterator = typename QVector<Projection*>::iterator;
     using const_iterator = typename QVector<Projection*>::const_iterator;
 
-    QOrmQueryResult(const QOrmQueryResult&) = delete;
+    // Copyable so that results can be delivered with QFuture
+    QOrmQueryResult(const QOrmQueryResult&) = default;
     QOrmQueryResult(QOrmQueryResult&& other) = default;
 
     template<typename U>
@@ -82,7 +88,7 @@ public:
         : QtOrmPrivate::QOrmQueryResultBase<T>{other.error(),
                                                other.lastInsertedId(),
                                                other.numRowsAffected()}
-        , m_result{convertVector<U, T>(other.toVector())}
+        , m_result{other.hasError() ? QVector<T*>{} : convertVector<U, T>(other.toVector())}
     {
     }
 
@@ -114,7 +120,7 @@ public:
     {
     }
 
-    QOrmQueryResult& operator=(const QOrmQueryResult&) = delete;
+    QOrmQueryResult& operator=(const QOrmQueryResult&) = default;
     QOrmQueryResult& operator=(QOrmQueryResult&&) = default;
 
     [[nodiscard]] const QVector<Projection*>& toVector() const
@@ -240,6 +246,70 @@ public:
     }
 };
 
+namespace QOrmPrivate
+{
+    // Called in the thread of the session when an asynchronous operation has finished
+    using AsyncCompletion = std::function<void(const QOrmQueryResult<QObject>&)>;
+
+    // Reports the result of an asynchronous operation to a future. The future is canceled if the
+    // operation is abandoned because its session is destroyed.
+    template<typename R>
+    class AsyncResult
+    {
+    public:
+        AsyncResult() { m_interface.reportStarted(); }
+
+        ~AsyncResult()
+        {
+            if (!m_interface.isFinished())
+            {
+                m_interface.reportCanceled();
+                m_interface.reportFinished();
+            }
+        }
+
+        [[nodiscard]] QFuture<R> future() { return m_interface.future(); }
+
+        void report(const R& result)
+        {
+            m_interface.reportResult(result);
+            m_interface.reportFinished();
+        }
+
+    private:
+        QFutureInterface<R> m_interface;
+    };
+
+    template<typename T>
+    [[nodiscard]] AsyncCompletion asyncCompletion(QFuture<QOrmQueryResult<T>>& future)
+    {
+        auto result = std::make_shared<AsyncResult<QOrmQueryResult<T>>>();
+        future = result->future();
+
+        return [result](const QOrmQueryResult<QObject>& value) {
+            result->report(QOrmQueryResult<T>{value});
+        };
+    }
+
+    // Invokes the callback in the thread of the receiver unless the receiver has been destroyed
+    template<typename T, typename Functor>
+    [[nodiscard]] AsyncCompletion asyncCompletion(const QObject* receiver, Functor callback)
+    {
+        QPointer<QObject> context{const_cast<QObject*>(receiver)};
+
+        return [context, callback](const QOrmQueryResult<QObject>& value) {
+            if (context.isNull())
+                return;
+
+            QOrmQueryResult<T> result{value};
+            QMetaObject::invokeMethod(context.data(), [context, callback, result]() {
+                if (!context.isNull())
+                    callback(result);
+            });
+        };
+    }
+} // namespace QOrmPrivate
+
 QT_END_NAMESPACE
 
 #endif
@@ -21,21 +21,90 @@
 #include "qormsession.h"
 
 #include "qormabstractprovider.h"
+#include "qormasyncworker_p.h"
+#include "qormchangenotifier.h"
+#include "qormcursor.h"
 #include "qormentityinstancecache.h"
 #include "qormerror.h"
 #include "qormglobal_p.h"
+#include "qormmemoryreport.h"
+#include "qormmemoryreport_p.h"
 #include "qormmetadatacache.h"
 #include "qormorder.h"
 #include "qormquery.h"
 #include "qormrelation.h"
 #include "qormsessionconfiguration.h"
+#include "qormsessionstatistics.h"
+#include "qormsessionstatistics_p.h"
+#include "qormtracer_p.h"
 #include "qormtransactiontoken.h"
 
 #include <QDebug>
+#include <QPointer>
 #include <QScopeGuard>
 
+#include <algorithm>
+#include <iterator>
+
 QT_BEGIN_NAMESPACE
 
+namespace
+{
+    // Outcome of an asynchronous operation, sent from the database thread. The entity instances
+    // that are not adopted by the session are deleted with it.
+    struct AsyncDelivery
+    {
+        Q_DISABLE_COPY(AsyncDelivery)
+
+        AsyncDelivery() = default;
+        ~AsyncDelivery()
+        {
+            qDeleteAll(instances);
+            qDeleteAll(untrackedInstances);
+        }
+
+        QOrmError error;
+        QVector<QObject*> instances;
+        // Instances of the result which are not cached, e.g. partial ones
+        QVector<QObject*> untrackedInstances;
+        QVector<QObject*> result;
+        // IDs generated for the created instances of a merge, by merge step
+        QVector<QVariant> insertedIds;
+        QVariant lastInsertedId;
+        int numRowsAffected{0};
+        // Depth of the asynchronous transactions the operation ran in
+        int transactionDepth{0};
+    };
+
+    // Copies of the instances to be merged, taken in the session thread. The worker thread reads
+    // and updates the copies only.
+    struct AsyncSnapshots
+    {
+        Q_DISABLE_COPY(AsyncSnapshots)
+
+        AsyncSnapshots() = default;
+        ~AsyncSnapshots() { qDeleteAll(copies); }
+
+        QHash<const QObject*, QObject*> copies;
+    };
+
+    // Cursor of a query that could not be built
+    class ErrorCursor : public QOrmAbstractCursor
+    {
+    public:
+        explicit ErrorCursor(QOrmError error)
+            : m_error{std::move(error)}
+        {
+        }
+
+        QObject* next() override { return nullptr; }
+        QOrmError error() const override { return m_error; }
+
+    private:
+        QOrmError m_error;
+    };
+} // namespace
+
 class QOrmSessionPrivate
 {
     using TrackedEntityInstance = std::pair<QObject*, QOrm::Operation>;
@@ -45,12 +114,21 @@ class QOrmSessionPrivate
     QOrmSessionConfiguration m_sessionConfiguration;
     QOrmEntityInstanceCache m_entityInstanceCache;
     QOrmError m_lastError{QOrm::ErrorType::None, {}};
-    QOrmMetadataCache m_metadataCache;
+    std::shared_ptr<QOrmMetadataCache> m_metadataCache;
+    QOrmChangeNotifier m_changeNotifier;
+    QOrmSessionStatistics m_statistics;
     QSet<const QObject*> m_mergingInstances;
     int m_transactionCounter{0};
     std::vector<TrackedEntityInstance> m_trackedInstances;
-
-    explicit QOrmSessionPrivate(QOrmSessionConfiguration sessionConfiguration, QOrmSession* parent);
+    std::unique_ptr<QOrmPrivate::AsyncWorker> m_asyncWorker;
+    // Only accessed in the database thread
+    int m_asyncTransactionDepth{0};
+    // Instances merged in the active asynchronous transaction
+    std::vector<std::pair<QPointer<QObject>, QOrm::Operation>> m_asyncTrackedInstances;
+
+    QOrmSessionPrivate(QOrmSessionConfiguration sessionConfiguration,
+                       std::shared_ptr<QOrmMetadataCache> metadataCache,
+                       QOrmSession* parent);
     ~QOrmSessionPrivate();
 
     void ensureProviderConnected();
@@ -66,15 +144,36 @@ class QOrmSessionPrivate
     void commitTrackedInstances();
     void rollbackTrackedInstances();
 
+    [[nodiscard]] static QOrmError partialInstanceError(const QObject* instance);
+
+    // Returns nullptr if the provider cannot be cloned
+    [[nodiscard]] QOrmPrivate::AsyncWorker* asyncWorker();
+    [[nodiscard]] QOrmQueryResult<QObject> adopt(AsyncDelivery& delivery,
+                                                 const QFlags<QOrm::QueryFlags>& flags);
+
+    enum class AsyncTransactionStep
+    {
+        Begin,
+        Commit,
+        Rollback
+    };
+
+    [[nodiscard]] QFuture<QOrmError> transactionAsync(AsyncTransactionStep step);
+    // Reverts the cache state of the instances merged in a rolled back asynchronous transaction
+    void rollbackAsyncTrackedInstances();
+
     void clearLastError();
     void setLastError(QOrmError lastError);
 };
 
 QOrmSessionPrivate::QOrmSessionPrivate(QOrmSessionConfiguration sessionConfiguration,
+                                       std::shared_ptr<QOrmMetadataCache> metadataCache,
                                        QOrmSession* parent)
     : q_ptr{parent}
     , m_sessionConfiguration{std::move(sessionConfiguration)}
+    , m_metadataCache{std::move(metadataCache)}
 {
+    Q_ASSERT(m_metadataCache != nullptr);
 }
 
 QOrmSessionPrivate::~QOrmSessionPrivate() = default;
@@ -102,7 +201,7 @@ void QOrmSessionPrivate::rollbackTrackedInstances()
     {
         Q_UNUSED(operation)
 
-        QOrmMetadata relation = m_metadataCache.get(*instance->metaObject());
+        QOrmMetadata relation = m_metadataCache->get(*instance->metaObject());
         QOrmMetadata projection = relation;
         QOrmFilter filter{*relation.objectIdMapping() ==
                           QOrmPrivate::objectIdPropertyValue(instance, relation)};
@@ -124,6 +223,235 @@ void QOrmSessionPrivate::rollbackTrackedInstances()
     m_trackedInstances.clear();
 }
 
+QOrmError QOrmSessionPrivate::partialInstanceError(const QObject* instance)
+{
+    QString errorString;
+    QDebug dbg{&errorString};
+    dbg << "Entity instance" << instance
+        << "was read with some of its properties only and cannot be merged.";
+
+    return QOrmError{QOrm::ErrorType::Other, errorString};
+}
+
+QOrmPrivate::AsyncWorker* QOrmSessionPrivate::asyncWorker()
+{
+    if (m_asyncWorker == nullptr)
+    {
+        QOrmAbstractProvider* provider = m_sessionConfiguration.provider()->clone();
+
+        if (provider == nullptr)
+            return nullptr;
+
+        // The counters are updated atomically and can be shared with the worker thread
+        provider->setStatistics(&m_statistics);
+        provider->setChangeHandler([this](const QOrmChangeSet& changes) {
+            m_asyncWorker->deliver(
+                [this, changes]() { Q_EMIT m_changeNotifier.changesCommitted(changes); });
+        });
+
+        m_asyncWorker = std::make_unique<QOrmPrivate::AsyncWorker>(provider);
+    }
+
+    return m_asyncWorker.get();
+}
+
+QOrmQueryResult<QObject> QOrmSessionPrivate::adopt(AsyncDelivery& delivery,
+                                                   const QFlags<QOrm::QueryFlags>& flags)
+{
+    if (delivery.error.type() != QOrm::ErrorType::None)
+        return QOrmQueryResult<QObject>{delivery.error};
+
+    bool overwrite = flags.testFlag(QOrm::QueryFlags::OverwriteCachedInstances);
+
+    // Instances already cached by the session take the place of the ones read
+    QHash<QObject*, QObject*> replacements;
+
+    for (QObject* instance : delivery.instances)
+    {
+        const QOrmMetadata& entity = (*m_metadataCache)[*instance->metaObject()];
+        QObject* cachedInstance =
+            m_entityInstanceCache.get(entity, QOrmPrivate::objectIdPropertyValue(instance, entity));
+
+        if (cachedInstance == nullptr)
+            continue;
+
+        if (m_entityInstanceCache.isModified(cachedInstance) && !overwrite)
+        {
+            QString errorString;
+            QDebug dbg{&errorString};
+            dbg << "Entity instance" << cachedInstance
+                << "was read from the database but has unsaved changes in the OR-mapper. Merge "
+                   "this instance or discard changes before reading.";
+
+            return QOrmQueryResult<QObject>{
+                QOrmError{QOrm::ErrorType::UnsynchronizedEntity, errorString}};
+        }
+
+        replacements.insert(instance, cachedInstance);
+    }
+
+    auto replacement = [&replacements](QObject* instance) {
+        return replacements.value(instance, instance);
+    };
+
+    // Point the references at the instances of the session. Cached instances are only updated if
+    // requested.
+    for (QObject* instance : delivery.instances + delivery.untrackedInstances)
+    {
+        QObject* target = replacement(instance);
+
+        if ((target != instance && !overwrite) || (target == instance && replacements.isEmpty()))
+            continue;
+
+        const QOrmMetadata& entity = (*m_metadataCache)[*instance->metaObject()];
+
+        for (const QOrmPropertyMapping& mapping : entity.propertyMappings())
+        {
+            if (mapping.isTransient() && !mapping.isReference())
+                continue;
+
+            QVariant value = QOrmPrivate::propertyValue(instance, mapping);
+
+            if (mapping.isReference() && mapping.isTransient())
+            {
+                QVector<QObject*> referencedInstances = value.value<QVector<QObject*>>();
+
+                std::transform(std::begin(referencedInstances),
+                               std::end(referencedInstances),
+                               std::begin(referencedInstances),
+                               replacement);
+
+                value = QVariant::fromValue(referencedInstances);
+            }
+            else if (mapping.isReference())
+            {
+                QObject* referencedInstance = value.value<QObject*>();
+
+                if (referencedInstance == nullptr)
+                    continue;
+
+                value = QVariant::fromValue(replacement(referencedInstance));
+            }
+            else if (target == instance)
+                continue;
+
+            if (!QOrmPrivate::setPropertyValue(target, mapping.classPropertyName(), value))
+                Q_ORM_UNEXPECTED_STATE;
+        }
+    }
+
+    for (QObject* instance : delivery.instances)
+    {
+        QObject* target = replacement(instance);
+
+        if (target == instance)
+        {
+            const QOrmMetadata& entity = (*m_metadataCache)[*instance->metaObject()];
+
+            m_entityInstanceCache.insert(entity, instance);
+            m_entityInstanceCache.finalize(entity, instance);
+        }
+        else
+            m_entityInstanceCache.markUnmodified(target);
+    }
+
+    QVector<QObject*> result;
+    result.reserve(delivery.result.size());
+    std::transform(std::begin(delivery.result),
+                   std::end(delivery.result),
+                   std::back_inserter(result),
+                   replacement);
+
+    // The replaced instances are deleted with the delivery, the untracked ones belong to the caller
+    delivery.instances = replacements.keys().toVector();
+    delivery.untrackedInstances.clear();
+
+    return QOrmQueryResult<QObject>{{}, result, delivery.lastInsertedId, delivery.numRowsAffected};
+}
+
+QFuture<QOrmError> QOrmSessionPrivate::transactionAsync(AsyncTransactionStep step)
+{
+    auto result = std::make_shared<QOrmPrivate::AsyncResult<QOrmError>>();
+    QFuture<QOrmError> future = result->future();
+
+    QOrmPrivate::AsyncWorker* worker = asyncWorker();
+
+    if (worker == nullptr)
+    {
+        result->report(
+            QOrmError{QOrm::ErrorType::Provider,
+                      QStringLiteral("The provider does not support asynchronous execution")});
+        return future;
+    }
+
+    worker->post([this, worker, step, result](QOrmAbstractProvider& provider,
+                                              const QOrmError& connectionError) {
+        QOrmError error = connectionError;
+
+        if (error.type() == QOrm::ErrorType::None)
+        {
+            if (step == AsyncTransactionStep::Begin)
+            {
+                error = provider.beginTransaction();
+
+                if (error.type() == QOrm::ErrorType::None)
+                    ++m_asyncTransactionDepth;
+            }
+            else if (m_asyncTransactionDepth == 0)
+            {
+                error = QOrmError{QOrm::ErrorType::TransactionNotActive,
+                                  QStringLiteral("Transaction is not active")};
+            }
+            else
+            {
+                --m_asyncTransactionDepth;
+                error = step == AsyncTransactionStep::Commit ? provider.commitTransaction()
+                                                             : provider.rollbackTransaction();
+            }
+        }
+
+        int depth = m_asyncTransactionDepth;
+
+        worker->deliver([this, step, error, depth, result]() {
+            if (step != AsyncTransactionStep::Begin && depth == 0 &&
+                error.type() != QOrm::ErrorType::TransactionNotActive)
+            {
+                // A failed commit ends the transaction as well
+                if (step == AsyncTransactionStep::Commit &&
+                    error.type() == QOrm::ErrorType::None)
+                {
+                    m_asyncTrackedInstances.clear();
+                }
+                else
+                    rollbackAsyncTrackedInstances();
+            }
+
+            result->report(error);
+        });
+    });
+
+    return future;
+}
+
+void QOrmSessionPrivate::rollbackAsyncTrackedInstances()
+{
+    // Newest first: an instance created and then updated ends up not cached
+    for (auto it = m_asyncTrackedInstances.rbegin(); it != m_asyncTrackedInstances.rend(); ++it)
+    {
+        QObject* instance = it->first.data();
+
+        if (instance == nullptr || !m_entityInstanceCache.contains(instance))
+            continue;
+
+        if (it->second == QOrm::Operation::Create)
+            m_entityInstanceCache.take(instance);
+        else
+            m_entityInstanceCache.markModified(instance);
+    }
+
+    m_asyncTrackedInstances.clear();
+}
+
 void QOrmSessionPrivate::clearLastError()
 {
     m_lastError = QOrmError{QOrm::ErrorType::None, {}};
@@ -135,14 +463,32 @@ void QOrmSessionPrivate::setLastError(QOrmError lastError)
 }
 
 QOrmSession::QOrmSession(QOrmSessionConfiguration sessionConfiguration)
-    : d_ptr{new QOrmSessionPrivate{sessionConfiguration, this}}
+    : QOrmSession{std::move(sessionConfiguration), std::make_shared<QOrmMetadataCache>()}
+{
+}
+
+QOrmSession::QOrmSession(QOrmSessionConfiguration sessionConfiguration,
+                         std::shared_ptr<QOrmMetadataCache> metadataCache)
+    : d_ptr{new QOrmSessionPrivate{std::move(sessionConfiguration),
+                                   std::move(metadataCache),
+                                   this}}
 {    
+    Q_D(QOrmSession);
+
+    d->m_sessionConfiguration.provider()->setChangeHandler(
+        [d](const QOrmChangeSet& changes) { Q_EMIT d->m_changeNotifier.changesCommitted(changes); });
+    d->m_sessionConfiguration.provider()->setStatistics(&d->m_statistics);
 }
 
 QOrmSession::~QOrmSession()
 {
     Q_D(QOrmSession);
 
+    d->m_asyncWorker.reset();
+
+    d->m_sessionConfiguration.provider()->setChangeHandler({});
+    d->m_sessionConfiguration.provider()->setStatistics(nullptr);
+
     if (d->m_sessionConfiguration.provider()->isConnectedToBackend())
         d->m_sessionConfiguration.provider()->disconnectFromBackend();
 
@@ -153,16 +499,63 @@ QOrmQueryResult<QObject> QOrmSession::execute(const QOrmQuery& query)
 {
     Q_D(QOrmSession);
 
+    QOrmPrivate::TraceSpan span{"QOrmSession::execute"};
+    span.setOperation(query.operation());
+
+    if (query.projection().has_value())
+        span.setEntity(*query.projection());
+    else if (query.relation().mapping() != nullptr)
+        span.setEntity(*query.relation().mapping());
+
     d->clearLastError();
+
+    if (query.error().type() != QOrm::ErrorType::None)
+    {
+        d->setLastError(query.error());
+        return QOrmQueryResult<QObject>{query.error()};
+    }
+
     d->ensureProviderConnected();
 
     QOrmQueryResult<QObject> providerResult =
         d->m_sessionConfiguration.provider()->execute(query, d->m_entityInstanceCache);
 
     d->setLastError(providerResult.error());
+
+    if (span.isActive())
+    {
+        span.setRows(query.operation() == QOrm::Operation::Read
+                         ? providerResult.toVector().size()
+                         : providerResult.numRowsAffected());
+    }
+
     return providerResult;
 }
 
+std::unique_ptr<QOrmAbstractCursor> QOrmSession::openCursor(const QOrmQuery& query)
+{
+    Q_D(QOrmSession);
+
+    Q_ASSERT(query.operation() == QOrm::Operation::Read);
+
+    d->clearLastError();
+
+    if (query.error().type() != QOrm::ErrorType::None)
+    {
+        d->setLastError(query.error());
+        return std::make_unique<ErrorCursor>(query.error());
+    }
+
+    d->ensureProviderConnected();
+
+    std::unique_ptr<QOrmAbstractCursor> cursor{
+        d->m_sessionConfiguration.provider()->openCursor(query, d->m_entityInstanceCache)};
+
+    d->setLastError(cursor->error());
+
+    return cursor;
+}
+
 QOrmQueryBuilder<QObject> QOrmSession::from(const QOrmQuery& query)
 {
     Q_ASSERT(query.operation() == QOrm::Operation::Read);
@@ -174,7 +567,8 @@ QOrmQueryBuilder<QObject> QOrmSession::queryBuilderFor(const QMetaObject& relati
 {
     Q_D(QOrmSession);
 
-    return QOrmQueryBuilder<QObject>{this, QOrmRelation{d->m_metadataCache[relationMetaObject]}};
+    return QOrmQueryBuilder<QObject>{this,
+                                     QOrmRelation{(*d->m_metadataCache)[relationMetaObject]}};
 }
 
 bool QOrmSession::doMerge(QObject* entityInstance, const QMetaObject& qMetaObject)
@@ -186,6 +580,14 @@ bool QOrmSession::doMerge(QObject* entityInstance, const QMetaObject& qMetaObjec
     if (d->m_mergingInstances.contains(entityInstance))
         return true;
 
+    if (QOrmPrivate::isPartialInstance(entityInstance))
+    {
+        d->setLastError(d->partialInstanceError(entityInstance));
+        return false;
+    }
+
+    QOrmPrivate::TraceSpan span{"QOrmSession::doMerge"};
+
     auto token = declareTransaction(QOrm::TransactionPropagation::Require,
                                     QOrm::TransactionAction::Rollback);
 
@@ -209,7 +611,9 @@ bool QOrmSession::doMerge(QObject* entityInstance, const QMetaObject& qMetaObjec
         return true;
     }
 
-    QOrmMetadata entity = d->m_metadataCache[qMetaObject];
+    QOrmMetadata entity = (*d->m_metadataCache)[qMetaObject];
+    span.setEntity(entity);
+    span.setOperation(operation);
 
     if (auto result = QOrmPrivate::crossReferenceError(entity, entityInstance))
     {
@@ -244,7 +648,7 @@ bool QOrmSession::doMerge(QObject* entityInstance, const QMetaObject& qMetaObjec
         if (operation == QOrm::Operation::Create)
         {
             const QOrmPropertyMapping* objectIdMapping =
-                d->m_metadataCache[qMetaObject].objectIdMapping();
+                (*d->m_metadataCache)[qMetaObject].objectIdMapping();
 
             if (objectIdMapping != nullptr && objectIdMapping->isAutogenerated())
             {
@@ -256,8 +660,8 @@ bool QOrmSession::doMerge(QObject* entityInstance, const QMetaObject& qMetaObjec
                 }
             }
 
-            d->m_entityInstanceCache.insert(d->m_metadataCache[qMetaObject], entityInstance);
-            d->m_entityInstanceCache.finalize(d->m_metadataCache[qMetaObject], entityInstance);
+            d->m_entityInstanceCache.insert((*d->m_metadataCache)[qMetaObject], entityInstance);
+            d->m_entityInstanceCache.finalize((*d->m_metadataCache)[qMetaObject], entityInstance);
         }
         else
             d->m_entityInstanceCache.markUnmodified(entityInstance);
@@ -291,6 +695,327 @@ bool QOrmSession::doRemove(QObject* entityInstance, const QMetaObject& qMetaObje
     return d->m_lastError.type() == QOrm::ErrorType::None;
 }
 
+void QOrmSession::executeAsync(const QOrmQuery& query, QOrmPrivate::AsyncCompletion completion)
+{
+    Q_D(QOrmSession);
+
+    Q_ASSERT(query.operation() == QOrm::Operation::Read);
+
+    if (query.error().type() != QOrm::ErrorType::None)
+    {
+        completion(QOrmQueryResult<QObject>{query.error()});
+        return;
+    }
+
+    QOrmPrivate::AsyncWorker* worker = d->asyncWorker();
+
+    if (worker == nullptr)
+    {
+        completion(QOrmQueryResult<QObject>{
+            QOrmError{QOrm::ErrorType::Provider,
+                      QStringLiteral("The provider does not support asynchronous execution")}});
+        return;
+    }
+
+    worker->post([d, worker, query, completion](QOrmAbstractProvider& provider,
+                                                const QOrmError& connectionError) {
+        auto delivery = std::make_shared<AsyncDelivery>();
+        delivery->error = connectionError;
+
+        if (delivery->error.type() == QOrm::ErrorType::None)
+        {
+            // The instances are read into a cache of their own and handed over to the session
+            QOrmEntityInstanceCache entityInstanceCache;
+            QOrmQueryResult<QObject> result = provider.execute(query, entityInstanceCache);
+
+            delivery->error = result.error();
+
+            if (delivery->error.type() == QOrm::ErrorType::None)
+            {
+                delivery->instances = entityInstanceCache.instances();
+                delivery->result = result.toVector();
+                delivery->numRowsAffected = result.numRowsAffected();
+
+                for (QObject* instance : delivery->result)
+                {
+                    if (!entityInstanceCache.contains(instance))
+                    {
+                        delivery->untrackedInstances.push_back(instance);
+                        instance->moveToThread(worker->ownerThread());
+                    }
+                }
+
+                for (QObject* instance : delivery->instances)
+                {
+                    entityInstanceCache.take(instance);
+                    instance->moveToThread(worker->ownerThread());
+                }
+            }
+        }
+
+        worker->deliver([d, delivery, query, completion]() {
+            completion(d->adopt(*delivery, query.flags()));
+        });
+    });
+}
+
+void QOrmSession::doMergeAsync(QObject* entityInstance,
+                               const QMetaObject& qMetaObject,
+                               QOrmPrivate::AsyncCompletion completion)
+{
+    Q_D(QOrmSession);
+
+    QOrmPrivate::AsyncWorker* worker = d->asyncWorker();
+
+    if (worker == nullptr)
+    {
+        completion(QOrmQueryResult<QObject>{
+            QOrmError{QOrm::ErrorType::Provider,
+                      QStringLiteral("The provider does not support asynchronous execution")}});
+        return;
+    }
+
+    struct MergeStep
+    {
+        QObject* instance;
+        QObject* snapshot;
+        QOrmMetadata entity;
+        QOrmQuery query;
+    };
+
+    auto snapshots = std::make_shared<AsyncSnapshots>();
+
+    // Referenced instances that are not merged are copied with their object ID only
+    auto snapshot = [&snapshots](const QObject* instance, const QOrmMetadata& entity) {
+        QObject*& copy = snapshots->copies[instance];
+
+        if (copy == nullptr)
+        {
+            copy = entity.qMetaObject().newInstance();
+
+            QVariant objectId = QOrmPrivate::objectIdPropertyValue(instance, entity);
+
+            if (!QOrmPrivate::setPropertyValue(
+                    copy, entity.objectIdMapping()->classPropertyName(), objectId))
+            {
+                Q_ORM_UNEXPECTED_STATE;
+            }
+        }
+
+        return copy;
+    };
+
+    auto copyColumns = [&snapshot](const QObject* instance, const QOrmMetadata& entity) {
+        QObject* copy = snapshot(instance, entity);
+
+        for (const QOrmPropertyMapping& mapping : entity.propertyMappings())
+        {
+            if (mapping.isTransient())
+                continue;
+
+            QVariant value = QOrmPrivate::propertyValue(instance, mapping);
+
+            if (mapping.isReference())
+            {
+                QObject* referencedInstance = value.value<QObject*>();
+
+                if (referencedInstance == nullptr)
+                    continue;
+
+                value = QVariant::fromValue(
+                    snapshot(referencedInstance, *mapping.referencedEntity()));
+            }
+
+            if (!QOrmPrivate::setPropertyValue(copy, mapping.classPropertyName(), value))
+                Q_ORM_UNEXPECTED_STATE;
+        }
+
+        return copy;
+    };
+
+    // Like doMerge(): the modified referenced instances are merged first
+    std::vector<MergeStep> steps;
+    QSet<const QObject*> plannedInstances;
+    const QObject* partialInstance = nullptr;
+
+    std::function<void(QObject*, const QMetaObject&)> plan =
+        [this, d, &steps, &plannedInstances, &partialInstance, &copyColumns, &plan](
+            QObject* instance, const QMetaObject& instanceMetaObject) {
+            if (plannedInstances.contains(instance))
+                return;
+
+            plannedInstances.insert(instance);
+
+            if (QOrmPrivate::isPartialInstance(instance))
+            {
+                partialInstance = instance;
+                return;
+            }
+
+            QOrm::Operation operation = d->m_entityInstanceCache.contains(instance)
+                                            ? QOrm::Operation::Update
+                                            : QOrm::Operation::Create;
+
+            if (operation == QOrm::Operation::Update &&
+                !d->m_entityInstanceCache.isModified(instance))
+            {
+                return;
+            }
+
+            const QOrmMetadata& entity = (*d->m_metadataCache)[instanceMetaObject];
+
+            if (auto result = QOrmPrivate::crossReferenceError(entity, instance))
+                qFatal("QtOrm: %s", result->toUtf8().data());
+
+            for (const QOrmPropertyMapping& mapping : entity.propertyMappings())
+            {
+                if (!mapping.isReference() || mapping.isTransient())
+                    continue;
+
+                QObject* referencedInstance =
+                    QOrmPrivate::propertyValue(instance, mapping).value<QObject*>();
+
+                if (d->needsMerge(referencedInstance))
+                    plan(referencedInstance, *referencedInstance->metaObject());
+            }
+
+            QObject* copy = copyColumns(instance, entity);
+
+            steps.push_back(
+                {instance,
+                 copy,
+                 entity,
+                 queryBuilderFor(instanceMetaObject).instance(instanceMetaObject, copy).build(
+                     operation)});
+        };
+
+    plan(entityInstance, qMetaObject);
+
+    if (partialInstance != nullptr)
+    {
+        completion(QOrmQueryResult<QObject>{d->partialInstanceError(partialInstance)});
+        return;
+    }
+
+    worker->post([d, worker, steps, snapshots, entityInstance, completion](
+                     QOrmAbstractProvider& provider, const QOrmError& connectionError) mutable {
+        auto delivery = std::make_shared<AsyncDelivery>();
+        delivery->error = connectionError;
+        delivery->transactionDepth = d->m_asyncTransactionDepth;
+
+        if (delivery->error.type() == QOrm::ErrorType::None && !steps.empty())
+            delivery->error = provider.beginTransaction();
+
+        if (delivery->error.type() == QOrm::ErrorType::None && !steps.empty())
+        {
+            QOrmEntityInstanceCache entityInstanceCache;
+
+            for (const MergeStep& step : steps)
+            {
+                QOrmQueryResult<QObject> result = provider.execute(step.query,
+                                                                   entityInstanceCache);
+                delivery->error = result.error();
+
+                if (delivery->error.type() != QOrm::ErrorType::None)
+                    break;
+
+                // Set right away: the instances merged next may refer to this one. The instance
+                // itself is updated in the session thread.
+                const QOrmPropertyMapping* objectIdMapping = step.entity.objectIdMapping();
+                QVariant insertedId;
+
+                if (step.query.operation() == QOrm::Operation::Create &&
+                    objectIdMapping != nullptr && objectIdMapping->isAutogenerated())
+                {
+                    insertedId = result.lastInsertedId();
+
+                    if (!QOrmPrivate::setPropertyValue(step.snapshot,
+                                                       objectIdMapping->classPropertyName(),
+                                                       insertedId))
+                    {
+                        Q_ORM_UNEXPECTED_STATE;
+                    }
+                }
+
+                delivery->insertedIds.push_back(insertedId);
+                delivery->lastInsertedId = result.lastInsertedId();
+                delivery->numRowsAffected += result.numRowsAffected();
+            }
+
+            if (delivery->error.type() == QOrm::ErrorType::None)
+            {
+                delivery->error = provider.commitTransaction();
+            }
+            else
+            {
+                QOrmError rollbackError = provider.rollbackTransaction();
+                Q_UNUSED(rollbackError)
+            }
+        }
+
+        // The copies are destroyed in the session thread along with the delivery
+        worker->deliver([d, delivery, steps, snapshots = std::move(snapshots), entityInstance,
+                         completion]() {
+            if (delivery->error.type() != QOrm::ErrorType::None)
+            {
+                completion(QOrmQueryResult<QObject>{delivery->error});
+                return;
+            }
+
+            for (size_t i = 0; i < steps.size(); ++i)
+            {
+                const MergeStep& step = steps[i];
+                const QVariant& insertedId = delivery->insertedIds[static_cast<int>(i)];
+                const QOrmPropertyMapping* objectIdMapping = step.entity.objectIdMapping();
+
+                if (insertedId.isValid() &&
+                    !QOrmPrivate::setPropertyValue(
+                        step.instance, objectIdMapping->classPropertyName(), insertedId))
+                {
+                    Q_ORM_UNEXPECTED_STATE;
+                }
+
+                if (step.query.operation() == QOrm::Operation::Create)
+                {
+                    d->m_entityInstanceCache.insert(step.entity, step.instance);
+                    d->m_entityInstanceCache.finalize(step.entity, step.instance);
+                }
+                else
+                    d->m_entityInstanceCache.markUnmodified(step.instance);
+
+                if (delivery->transactionDepth > 0)
+                {
+                    d->m_asyncTrackedInstances.emplace_back(step.instance,
+                                                            step.query.operation());
+                }
+            }
+
+            completion(QOrmQueryResult<QObject>{{},
+                                                {entityInstance},
+                                                delivery->lastInsertedId,
+                                                delivery->numRowsAffected});
+        });
+    });
+}
+
+QFuture<QOrmError> QOrmSession::beginTransactionAsync()
+{
+    Q_D(QOrmSession);
+    return d->transactionAsync(QOrmSessionPrivate::AsyncTransactionStep::Begin);
+}
+
+QFuture<QOrmError> QOrmSession::commitTransactionAsync()
+{
+    Q_D(QOrmSession);
+    return d->transactionAsync(QOrmSessionPrivate::AsyncTransactionStep::Commit);
+}
+
+QFuture<QOrmError> QOrmSession::rollbackTransactionAsync()
+{
+    Q_D(QOrmSession);
+    return d->transactionAsync(QOrmSessionPrivate::AsyncTransactionStep::Rollback);
+}
+
 QOrmTransactionToken QOrmSession::declareTransaction(QOrm::TransactionPropagation propagation,
                                                      QOrm::TransactionAction finalAction)
 {
@@ -339,7 +1064,7 @@ const QOrmSessionConfiguration& QOrmSession::configuration() const
 QOrmMetadataCache* QOrmSession::metadataCache()
 {
     Q_D(QOrmSession);
-    return &d->m_metadataCache;
+    return d->m_metadataCache.get();
 }
 
 QOrmEntityInstanceCache* QOrmSession::entityInstanceCache()
@@ -348,6 +1073,64 @@ QOrmEntityInstanceCache* QOrmSession::entityInstanceCache()
     return &d->m_entityInstanceCache;
 }
 
+QOrmChangeNotifier* QOrmSession::changeNotifier()
+{
+    Q_D(QOrmSession);
+    return &d->m_changeNotifier;
+}
+
+QOrmSessionStatistics* QOrmSession::statistics()
+{
+    Q_D(QOrmSession);
+    return &d->m_statistics;
+}
+
+QOrmMemoryReport QOrmSession::memoryReport() const
+{
+    Q_D(const QOrmSession);
+
+    QOrmMemoryReport report;
+    QHash<QString, QOrmEntityMemoryUsage> entities;
+
+    auto entityUsage = [&entities](const QObject* instance) -> QOrmEntityMemoryUsage& {
+        QString className = QString::fromUtf8(instance->metaObject()->className());
+
+        auto it = entities.find(className);
+
+        if (it == entities.end())
+        {
+            it = entities.insert(className, {});
+            it->m_className = className;
+        }
+
+        return *it;
+    };
+
+    for (const QObject* instance : d->m_entityInstanceCache.instances())
+    {
+        QOrmEntityMemoryUsage& usage = entityUsage(instance);
+        usage.m_cachedInstances += 1;
+        usage.m_instanceBytes += QOrmPrivate::estimateInstanceBytes(instance);
+        usage.m_identityMapBytes += d->m_entityInstanceCache.estimatedEntryBytes(instance);
+    }
+
+    for (const QOrmSessionPrivate::TrackedEntityInstance& trackedInstance : d->m_trackedInstances)
+        entityUsage(trackedInstance.first).m_trackedInstances += 1;
+
+    report.m_entities = entities.values().toVector();
+    std::sort(report.m_entities.begin(),
+              report.m_entities.end(),
+              [](const QOrmEntityMemoryUsage& lhs, const QOrmEntityMemoryUsage& rhs) {
+                  return lhs.className() < rhs.className();
+              });
+    report.m_trackedInstanceBytes = static_cast<qint64>(
+        d->m_trackedInstances.capacity() * sizeof(QOrmSessionPrivate::TrackedEntityInstance));
+    report.m_backendMemoryUsed = d->m_sessionConfiguration.provider()->memoryUsed();
+    report.m_backendMemoryHighwater = d->m_sessionConfiguration.provider()->memoryHighwater();
+
+    return report;
+}
+
 bool QOrmSession::beginTransaction()
 {
     Q_D(QOrmSession);
@@ -364,6 +1147,9 @@ bool QOrmSession::beginTransaction()
 
         if (d->m_lastError.type() == QOrm::ErrorType::None)
         {
+            QOrmPrivate::increment(
+                QOrmSessionStatisticsPrivate::get(&d->m_statistics)->m_transactionsBegun);
+            QOrmSessionStatisticsPrivate::get(&d->m_statistics)->resetStatementShapes();
             d->m_transactionCounter++;
         }
         else if (d->m_sessionConfiguration.isVerbose())
@@ -394,11 +1180,16 @@ bool QOrmSession::commitTransaction()
         if (d->m_sessionConfiguration.isVerbose())
             qCDebug(qtorm) << "Committing transaction";
 
+        QOrmPrivate::TraceSpan span{"QOrmSession::commitTransaction"};
+
         d->ensureProviderConnected();
         d->setLastError(d->m_sessionConfiguration.provider()->commitTransaction());
 
         if (d->m_lastError.type() == QOrm::ErrorType::None)
         {
+            QOrmPrivate::increment(
+                QOrmSessionStatisticsPrivate::get(&d->m_statistics)->m_transactionsCommitted);
+            QOrmSessionStatisticsPrivate::get(&d->m_statistics)->resetStatementShapes();
             d->commitTrackedInstances();
             d->m_transactionCounter = 0;
         }
@@ -435,6 +1226,9 @@ bool QOrmSession::rollbackTransaction()
 
         if (d->m_lastError.type() == QOrm::ErrorType::None)
         {
+            QOrmPrivate::increment(
+                QOrmSessionStatisticsPrivate::get(&d->m_statistics)->m_transactionsRolledBack);
+            QOrmSessionStatisticsPrivate::get(&d->m_statistics)->resetStatementShapes();
             d->rollbackTrackedInstances();
             d->m_transactionCounter = 0;
         }
@@ -23,6 +23,7 @@
 
 #include <QtOrm/qormclassproperty.h>
 #include <QtOrm/qormglobal.h>
+#include <QtOrm/qormmemoryreport.h>
 #include <QtOrm/qormmetadata.h>
 #include <QtOrm/qormquerybuilder.h>
 #include <QtOrm/qormqueryresult.h>
@@ -35,11 +36,15 @@
 
 QT_BEGIN_NAMESPACE
 
+class QOrmAbstractCursor;
 class QOrmAbstractProvider;
+class QOrmChangeNotifier;
 class QOrmEntityInstanceCache;
 class QOrmError;
+class QOrmMetadataCache;
 class QOrmQuery;
 class QOrmSessionPrivate;
+class QOrmSessionStatistics;
 
 template<typename Projection>
 class QOrmQueryBuilder;
@@ -51,6 +56,9 @@ class Q_ORM_EXPORT QOrmSession
 public:
     explicit QOrmSession(
         QOrmSessionConfiguration configuration = QOrmSessionConfiguration::defaultConfiguration());
+    // Sessions of different threads can share the metadata cache
+    QOrmSession(QOrmSessionConfiguration configuration,
+                std::shared_ptr<QOrmMetadataCache> metadataCache);
     ~QOrmSession();
 
     Q_REQUIRED_RESULT
@@ -59,6 +67,10 @@ public:
     Q_REQUIRED_RESULT
     QOrmQueryBuilder<QObject> from(const QOrmQuery& query);
 
+    // Reads the results of the query row by row. The cursor returns no more rows once the session
+    // has been destroyed.
+    [[nodiscard]] std::unique_ptr<QOrmAbstractCursor> openCursor(const QOrmQuery& query);
+
     template<typename T>
     bool merge(T* entityInstance)
     {
@@ -110,6 +122,35 @@ public:
         return true;
     }
 
+    // Asynchronous operations run in the database thread of the session, which has a connection
+    // of its own, outside of the transactions of the session. Their results are adopted by the
+    // session and delivered in its thread, which must run an event loop. The entity instance must
+    // not be modified before the merge has finished.
+    template<typename T>
+    [[nodiscard]] QFuture<QOrmQueryResult<T>> mergeAsync(T* entityInstance)
+    {
+        QFuture<QOrmQueryResult<T>> future;
+        doMergeAsync(entityInstance, T::staticMetaObject, QOrmPrivate::asyncCompletion(future));
+        return future;
+    }
+
+    // Calls callback(const QOrmQueryResult<T>&) in the thread of the receiver
+    template<typename T, typename Functor>
+    void mergeAsync(T* entityInstance, const QObject* receiver, Functor callback)
+    {
+        doMergeAsync(entityInstance,
+                     T::staticMetaObject,
+                     QOrmPrivate::asyncCompletion<T>(receiver, std::move(callback)));
+    }
+
+    void executeAsync(const QOrmQuery& query, QOrmPrivate::AsyncCompletion completion);
+
+    // Transactions of the database thread. They nest like the synchronous ones, and the
+    // asynchronous merges issued in between become part of them. See also QOrmAsyncTransaction.
+    [[nodiscard]] QFuture<QOrmError> beginTransactionAsync();
+    [[nodiscard]] QFuture<QOrmError> commitTransactionAsync();
+    [[nodiscard]] QFuture<QOrmError> rollbackTransactionAsync();
+
     template<typename T>
     std::unique_ptr<T> remove(T* entityInstance)
     {
@@ -145,6 +186,16 @@ public:
     Q_REQUIRED_RESULT
     QOrmEntityInstanceCache* entityInstanceCache();
 
+    Q_REQUIRED_RESULT
+    QOrmChangeNotifier* changeNotifier();
+
+    Q_REQUIRED_RESULT
+    QOrmSessionStatistics* statistics();
+
+    // Estimates the memory held by the cached and tracked entity instances
+    Q_REQUIRED_RESULT
+    QOrmMemoryReport memoryReport() const;
+
     bool beginTransaction();
     bool commitTransaction();
     bool rollbackTransaction();
@@ -153,6 +204,9 @@ public:
 private:
     bool doMerge(QObject* entityInstance, const QMetaObject& qMetaObject);
     bool doRemove(QObject* entityInstance, const QMetaObject& qMetaObject);
+    void doMergeAsync(QObject* entityInstance,
+                      const QMetaObject& qMetaObject,
+                      QOrmPrivate::AsyncCompletion completion);
 
     QOrmQueryBuilder<QObject> queryBuilderFor(const QMetaObject& relationMetaObject);
 
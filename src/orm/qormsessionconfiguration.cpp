@@ -52,6 +52,98 @@ QOrmSessionConfigurationData::QOrmSessionConfigurationData(QOrmAbstractProvider*
     Q_ASSERT(provider != nullptr);
 }
 
+// Returns the enumerator for the JSON value of the key, warning about unknown values
+template<typename T>
+static std::optional<T> _json_enum_value(const QJsonObject& object,
+                                         const QString& key,
+                                         const QHash<QString, T>& values)
+{
+    if (!object.contains(key))
+        return std::nullopt;
+
+    QString valueStr = object[key].toString().toLower();
+
+    if (!values.contains(valueStr))
+    {
+        qCWarning(qtorm) << "Invalid" << key << "in SQL provider configuration. Ignoring it";
+        return std::nullopt;
+    }
+
+    return values[valueStr];
+}
+
+static std::optional<qint64> _json_integer_value(const QJsonObject& object, const QString& key)
+{
+    if (!object.contains(key))
+        return std::nullopt;
+
+    if (!object[key].isDouble())
+    {
+        qCWarning(qtorm) << "Invalid" << key << "in SQL provider configuration. Ignoring it";
+        return std::nullopt;
+    }
+
+    return static_cast<qint64>(object[key].toDouble());
+}
+
+static void _apply_json_sqlite_performance(const QJsonObject& object,
+                                           QOrmSqliteConfiguration& sqlConfiguration)
+{
+    using Configuration = QOrmSqliteConfiguration;
+
+    static const QHash<QString, Configuration::PerformancePreset> presets = {
+        {"durable", Configuration::PerformancePreset::Durable},
+        {"throughput", Configuration::PerformancePreset::Throughput},
+        {"read-mostly", Configuration::PerformancePreset::ReadMostly}};
+
+    static const QHash<QString, Configuration::JournalMode> journalModes = {
+        {"delete", Configuration::JournalMode::Delete},
+        {"truncate", Configuration::JournalMode::Truncate},
+        {"persist", Configuration::JournalMode::Persist},
+        {"memory", Configuration::JournalMode::Memory},
+        {"wal", Configuration::JournalMode::Wal},
+        {"off", Configuration::JournalMode::Off}};
+
+    static const QHash<QString, Configuration::Synchronous> synchronousModes = {
+        {"off", Configuration::Synchronous::Off},
+        {"normal", Configuration::Synchronous::Normal},
+        {"full", Configuration::Synchronous::Full},
+        {"extra", Configuration::Synchronous::Extra}};
+
+    static const QHash<QString, Configuration::TempStore> tempStores = {
+        {"default", Configuration::TempStore::Default},
+        {"file", Configuration::TempStore::File},
+        {"memory", Configuration::TempStore::Memory}};
+
+    // The preset comes first so that the individual settings can override it
+    if (auto preset = _json_enum_value(object, "performancePreset", presets))
+        sqlConfiguration.applyPerformancePreset(*preset);
+
+    if (auto journalMode = _json_enum_value(object, "journalMode", journalModes))
+        sqlConfiguration.setJournalMode(journalMode);
+
+    if (auto synchronous = _json_enum_value(object, "synchronous", synchronousModes))
+        sqlConfiguration.setSynchronous(synchronous);
+
+    if (auto tempStore = _json_enum_value(object, "tempStore", tempStores))
+        sqlConfiguration.setTempStore(tempStore);
+
+    if (auto cacheSize = _json_integer_value(object, "cacheSize"))
+        sqlConfiguration.setCacheSize(static_cast<int>(*cacheSize));
+
+    if (auto mmapSize = _json_integer_value(object, "mmapSize"))
+        sqlConfiguration.setMmapSize(mmapSize);
+
+    if (auto pageSize = _json_integer_value(object, "pageSize"))
+        sqlConfiguration.setPageSize(static_cast<int>(*pageSize));
+
+    if (auto walAutocheckpoint = _json_integer_value(object, "walAutocheckpoint"))
+        sqlConfiguration.setWalAutocheckpoint(static_cast<int>(*walAutocheckpoint));
+
+    if (auto busyTimeout = _json_integer_value(object, "busyTimeout"))
+        sqlConfiguration.setBusyTimeout(static_cast<int>(*busyTimeout));
+}
+
 static QOrmSqliteConfiguration _build_json_sqlite_configuration(const QJsonObject& object)
 {
     QOrmSqliteConfiguration sqlConfiguration;
@@ -59,6 +151,11 @@ static QOrmSqliteConfiguration _build_json_sqlite_configuration(const QJsonObjec
     sqlConfiguration.setDatabaseName(object["databaseName"].toString());
     sqlConfiguration.setVerbose(object["verbose"].toBool(false));
     sqlConfiguration.setConnectOptions(object["connectOptions"].toString());
+    sqlConfiguration.setSlowQueryThreshold(object["slowQueryThreshold"].toInt(-1));
+    sqlConfiguration.setRedactSlowQueryParameters(
+        object["redactSlowQueryParameters"].toBool(false));
+    sqlConfiguration.setWorkloadLogFile(object["workloadLog"].toString());
+    sqlConfiguration.setForeignKeys(object["foreignKeys"].toBool(false));
 
     QString schemaModeStr = object["schemaMode"].toString("validate").toLower();
 
@@ -81,6 +178,8 @@ static QOrmSqliteConfiguration _build_json_sqlite_configuration(const QJsonObjec
         sqlConfiguration.setSchemaMode(QOrmSqliteConfiguration::SchemaMode::Validate);
     }
 
+    _apply_json_sqlite_performance(object, sqlConfiguration);
+
     return sqlConfiguration;
 }
 
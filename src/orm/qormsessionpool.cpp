@@ -0,0 +1,655 @@
+/*
+ * Copyright (C) 2019 Dmitriy Purgin <dmitriy.purgin@sequality.at>
+ * Copyright (C) 2019 sequality software engineering e.U. <office@sequality.at>
+ *
+ * This file is part of QtOrm library.
+ *
+ * QtOrm is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QtOrm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QtOrm.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "qormsessionpool.h"
+
+#include "qormabstractprovider.h"
+#include "qormglobal_p.h"
+#include "qormmetadatacache.h"
+#include "qormsession.h"
+#include "qormsessionconfiguration.h"
+#include "qormsqliteconfiguration.h"
+#include "qormsqliteprovider.h"
+
+#include <QtCore/qdeadlinetimer.h>
+#include <QtCore/qelapsedtimer.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qpointer.h>
+#include <QtCore/qthread.h>
+#include <QtCore/qwaitcondition.h>
+#include <QtSql/qsqldatabase.h>
+#include <QtSql/qsqlquery.h>
+
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+#include <memory>
+#include <utility>
+#include <vector>
+
+QT_BEGIN_NAMESPACE
+
+class QOrmSessionPoolPrivate : public std::enable_shared_from_this<QOrmSessionPoolPrivate>
+{
+public:
+    // A connection is only closed by the thread that opened it, or by any thread once that one has
+    // finished
+    struct Connection
+    {
+        std::unique_ptr<QOrmSession> session;
+        QPointer<QThread> thread;
+        bool isReadOnly{false};
+        QElapsedTimer idleTimer;
+    };
+
+    struct WatchedThread
+    {
+        QPointer<QThread> thread;
+        QMetaObject::Connection finished;
+    };
+
+    explicit QOrmSessionPoolPrivate(const QOrmSqliteConfiguration& configuration);
+
+    [[nodiscard]] QOrmPooledSession checkout(bool isReadOnly);
+    void release(QOrmSession* session, bool isReadOnly);
+
+    [[nodiscard]] QOrmSqliteConfiguration connectionConfiguration(bool isReadOnly) const;
+    [[nodiscard]] QOrmError open(Connection& connection);
+    [[nodiscard]] static bool isHealthy(QOrmSession* session);
+
+    // Must be called with the mutex locked. The discarded connections that the current thread can
+    // close are closed after unlocking, the others are retired.
+    void takeExpired(std::vector<Connection>& discarded);
+    void discard(Connection&& connection, std::vector<Connection>& discarded);
+    void takeRetired(QThread* thread, std::vector<Connection>& discarded);
+    void forget(const Connection& connection);
+    void watchThread(QThread* thread);
+    [[nodiscard]] static bool canClose(const Connection& connection, QThread* thread);
+
+    // Must be called with the mutex unlocked. The connections count against the limits until
+    // they are closed.
+    void close(std::vector<Connection>& discarded);
+
+    // Closes the idle and retired connections of the thread, which must be the current one
+    void closeIdle(QThread* thread);
+
+    const QOrmSqliteConfiguration m_configuration;
+    const std::shared_ptr<QOrmMetadataCache> m_metadataCache{
+        std::make_shared<QOrmMetadataCache>()};
+
+    mutable QMutex m_mutex;
+    QWaitCondition m_released;
+    std::vector<Connection> m_idle;
+    std::vector<Connection> m_active;
+    // Connections discarded by other threads. They are closed when their thread uses the pool
+    // again or finishes, or by the next checkout of any thread once their thread has finished.
+    std::vector<Connection> m_retired;
+    std::vector<WatchedThread> m_watchedThreads;
+
+    // Open connections: idle, checked out and retired ones
+    int m_readerCount{0};
+    int m_writerCount{0};
+    bool m_isWriterCheckedOut{false};
+    // The first writer connection has created the database and switched it to WAL mode
+    std::atomic<bool> m_isDatabaseInitialized{false};
+
+    int m_maxReaderCount{QThread::idealThreadCount()};
+    int m_idleTimeout{60000};
+    int m_checkoutTimeout{30000};
+};
+
+QOrmSessionPoolPrivate::QOrmSessionPoolPrivate(const QOrmSqliteConfiguration& configuration)
+    : m_configuration{configuration}
+{
+    if (m_configuration.journalMode().has_value() &&
+        *m_configuration.journalMode() != QOrmSqliteConfiguration::JournalMode::Wal)
+    {
+        qCWarning(qtorm) << "The session pool requires the WAL journal mode. Ignoring the"
+                         << "configured journal mode";
+    }
+}
+
+QOrmPooledSession QOrmSessionPoolPrivate::checkout(bool isReadOnly)
+{
+    // Read-only connections can neither create the database nor change its journal mode
+    if (isReadOnly && !m_isDatabaseInitialized)
+    {
+        QOrmPooledSession writer = checkout(false);
+
+        if (!writer)
+            return writer;
+    }
+
+    std::vector<Connection> discarded;
+    Connection connection;
+
+    {
+        QMutexLocker locker{&m_mutex};
+        QDeadlineTimer deadline = m_checkoutTimeout < 0 ? QDeadlineTimer{QDeadlineTimer::Forever}
+                                                        : QDeadlineTimer{m_checkoutTimeout};
+
+        for (;;)
+        {
+            takeRetired(QThread::currentThread(), discarded);
+            takeExpired(discarded);
+
+            if (isReadOnly || !m_isWriterCheckedOut)
+            {
+                auto isSameKind = [isReadOnly](const Connection& idle) {
+                    return idle.isReadOnly == isReadOnly;
+                };
+
+                auto it = std::find_if(std::begin(m_idle),
+                                       std::end(m_idle),
+                                       [isSameKind](const Connection& idle) {
+                                           return isSameKind(idle) &&
+                                                  idle.thread == QThread::currentThread();
+                                       });
+
+                if (it != std::end(m_idle))
+                {
+                    connection = std::move(*it);
+                    m_idle.erase(it);
+                    break;
+                }
+
+                int& count = isReadOnly ? m_readerCount : m_writerCount;
+                const int limit = isReadOnly ? m_maxReaderCount : 1;
+
+                if (count < limit)
+                {
+                    ++count;
+                    break;
+                }
+
+                // The connections are confined to the thread that opened them. An idle connection
+                // of another thread is retired to make room for a connection of this thread. It
+                // counts against the limits until its thread closes it.
+                it = std::find_if(std::begin(m_idle), std::end(m_idle), isSameKind);
+
+                if (it != std::end(m_idle))
+                {
+                    discard(std::move(*it), discarded);
+                    m_idle.erase(it);
+                }
+            }
+
+            // The connections this thread has discarded make room once they are closed
+            if (!discarded.empty())
+            {
+                locker.unlock();
+                close(discarded);
+                locker.relock();
+                continue;
+            }
+
+            if (!m_released.wait(&m_mutex, deadline))
+            {
+                return QOrmPooledSession{
+                    QOrmError{QOrm::ErrorType::Other,
+                              QStringLiteral("Timed out waiting for a %1 session")
+                                  .arg(isReadOnly ? QStringLiteral("reader")
+                                                  : QStringLiteral("writer"))}};
+            }
+        }
+
+        if (!isReadOnly)
+            m_isWriterCheckedOut = true;
+    }
+
+    close(discarded);
+
+    if (connection.session != nullptr && !isHealthy(connection.session.get()))
+        connection.session.reset();
+
+    if (connection.session == nullptr)
+    {
+        connection.isReadOnly = isReadOnly;
+        QOrmError error = open(connection);
+
+        if (error != QOrm::ErrorType::None)
+        {
+            QMutexLocker locker{&m_mutex};
+
+            forget(connection);
+
+            if (!isReadOnly)
+                m_isWriterCheckedOut = false;
+
+            m_released.wakeAll();
+
+            return QOrmPooledSession{error};
+        }
+    }
+
+    QOrmSession* session = connection.session.get();
+
+    QMutexLocker locker{&m_mutex};
+    watchThread(connection.thread);
+    m_active.push_back(std::move(connection));
+
+    return QOrmPooledSession{this, session, isReadOnly};
+}
+
+void QOrmSessionPoolPrivate::release(QOrmSession* session, bool isReadOnly)
+{
+    std::vector<Connection> discarded;
+    QMutexLocker locker{&m_mutex};
+
+    takeRetired(QThread::currentThread(), discarded);
+
+    auto it = std::find_if(std::begin(m_active),
+                           std::end(m_active),
+                           [session](const Connection& active) {
+                               return active.session.get() == session;
+                           });
+
+    if (it == std::end(m_active))
+        Q_ORM_UNEXPECTED_STATE;
+
+    Connection connection = std::move(*it);
+    m_active.erase(it);
+
+    if (!isReadOnly)
+        m_isWriterCheckedOut = false;
+
+    if (session->isTransactionActive())
+    {
+        qCWarning(qtorm) << "Session returned to the pool with an active transaction. Closing its"
+                         << "connection";
+
+        discard(std::move(connection), discarded);
+    }
+    else if (!session->configuration().provider()->isConnectedToBackend())
+    {
+        discard(std::move(connection), discarded);
+    }
+    else
+    {
+        connection.idleTimer.start();
+        m_idle.push_back(std::move(connection));
+    }
+
+    takeExpired(discarded);
+    m_released.wakeAll();
+
+    locker.unlock();
+    close(discarded);
+}
+
+QOrmSqliteConfiguration QOrmSessionPoolPrivate::connectionConfiguration(bool isReadOnly) const
+{
+    QOrmSqliteConfiguration configuration = m_configuration;
+    configuration.setJournalMode(QOrmSqliteConfiguration::JournalMode::Wal);
+
+    if (isReadOnly)
+    {
+        QString connectOptions = configuration.connectOptions();
+
+        if (!connectOptions.isEmpty())
+            connectOptions += QLatin1Char(';');
+
+        configuration.setConnectOptions(connectOptions + QStringLiteral("QSQLITE_OPEN_READONLY"));
+        configuration.setSchemaMode(QOrmSqliteConfiguration::SchemaMode::Bypass);
+    }
+    // Writers opened later must not drop the data of the first one
+    else if (m_isDatabaseInitialized &&
+             configuration.schemaMode() == QOrmSqliteConfiguration::SchemaMode::Recreate)
+    {
+        configuration.setSchemaMode(QOrmSqliteConfiguration::SchemaMode::Update);
+    }
+
+    return configuration;
+}
+
+QOrmError QOrmSessionPoolPrivate::open(Connection& connection)
+{
+    auto provider = new QOrmSqliteProvider{connectionConfiguration(connection.isReadOnly)};
+
+    connection.session = std::make_unique<QOrmSession>(
+        QOrmSessionConfiguration{provider, m_configuration.verbose()}, m_metadataCache);
+    connection.thread = QThread::currentThread();
+
+    QOrmError error = provider->connectToBackend();
+
+    if (error != QOrm::ErrorType::None)
+    {
+        connection.session.reset();
+        return error;
+    }
+
+    if (!connection.isReadOnly)
+        m_isDatabaseInitialized = true;
+
+    return error;
+}
+
+bool QOrmSessionPoolPrivate::isHealthy(QOrmSession* session)
+{
+    auto provider = static_cast<QOrmSqliteProvider*>(session->configuration().provider());
+
+    if (!provider->isConnectedToBackend())
+        return false;
+
+    QSqlQuery query{provider->database()};
+
+    return query.exec(QStringLiteral("SELECT 1")) && query.next();
+}
+
+void QOrmSessionPoolPrivate::takeExpired(std::vector<Connection>& discarded)
+{
+    if (m_idleTimeout < 0)
+        return;
+
+    auto expired = std::stable_partition(std::begin(m_idle),
+                                         std::end(m_idle),
+                                         [this](const Connection& idle) {
+                                             return !idle.idleTimer.hasExpired(m_idleTimeout);
+                                         });
+
+    for (auto it = expired; it != std::end(m_idle); ++it)
+        discard(std::move(*it), discarded);
+
+    m_idle.erase(expired, std::end(m_idle));
+}
+
+void QOrmSessionPoolPrivate::discard(Connection&& connection, std::vector<Connection>& discarded)
+{
+    if (canClose(connection, QThread::currentThread()))
+        discarded.push_back(std::move(connection));
+    else
+        m_retired.push_back(std::move(connection));
+}
+
+// Takes the retired connections of the thread and the ones of finished threads, e.g. adopted
+// threads that have exited without the pool noticing
+void QOrmSessionPoolPrivate::takeRetired(QThread* thread, std::vector<Connection>& discarded)
+{
+    auto retired = std::stable_partition(std::begin(m_retired),
+                                         std::end(m_retired),
+                                         [thread](const Connection& connection) {
+                                             return !canClose(connection, thread);
+                                         });
+
+    std::move(retired, std::end(m_retired), std::back_inserter(discarded));
+    m_retired.erase(retired, std::end(m_retired));
+}
+
+void QOrmSessionPoolPrivate::forget(const Connection& connection)
+{
+    if (connection.isReadOnly)
+        --m_readerCount;
+    else
+        --m_writerCount;
+}
+
+bool QOrmSessionPoolPrivate::canClose(const Connection& connection, QThread* thread)
+{
+    return connection.thread == thread || connection.thread.isNull() ||
+           connection.thread->isFinished();
+}
+
+void QOrmSessionPoolPrivate::close(std::vector<Connection>& discarded)
+{
+    if (discarded.empty())
+        return;
+
+    std::vector<Connection> closed = std::move(discarded);
+    discarded.clear();
+
+    for (Connection& connection : closed)
+        connection.session.reset();
+
+    QMutexLocker locker{&m_mutex};
+
+    for (const Connection& connection : closed)
+        forget(connection);
+
+    m_released.wakeAll();
+}
+
+// The connections of a thread are closed by the thread itself when it finishes
+void QOrmSessionPoolPrivate::watchThread(QThread* thread)
+{
+    m_watchedThreads.erase(std::remove_if(std::begin(m_watchedThreads),
+                                          std::end(m_watchedThreads),
+                                          [](const WatchedThread& watched) {
+                                              return watched.thread.isNull();
+                                          }),
+                           std::end(m_watchedThreads));
+
+    bool isWatched = std::any_of(std::begin(m_watchedThreads),
+                                 std::end(m_watchedThreads),
+                                 [thread](const WatchedThread& watched) {
+                                     return watched.thread == thread;
+                                 });
+
+    if (isWatched)
+        return;
+
+    // QThread::finished is emitted by the finishing thread
+    std::weak_ptr<QOrmSessionPoolPrivate> pool = weak_from_this();
+    QMetaObject::Connection finished =
+        QObject::connect(thread, &QThread::finished, [pool, thread]() {
+            if (std::shared_ptr<QOrmSessionPoolPrivate> d = pool.lock())
+                d->closeIdle(thread);
+        });
+
+    m_watchedThreads.push_back(WatchedThread{thread, finished});
+}
+
+void QOrmSessionPoolPrivate::closeIdle(QThread* thread)
+{
+    std::vector<Connection> discarded;
+    QMutexLocker locker{&m_mutex};
+
+    takeRetired(thread, discarded);
+
+    auto closed = std::stable_partition(std::begin(m_idle),
+                                        std::end(m_idle),
+                                        [thread](const Connection& idle) {
+                                            return idle.thread != thread;
+                                        });
+
+    std::move(closed, std::end(m_idle), std::back_inserter(discarded));
+    m_idle.erase(closed, std::end(m_idle));
+
+    locker.unlock();
+    close(discarded);
+}
+
+QOrmPooledSession::QOrmPooledSession(QOrmSessionPoolPrivate* pool,
+                                     QOrmSession* session,
+                                     bool isReadOnly)
+    : m_pool{pool}
+    , m_session{session}
+    , m_isReadOnly{isReadOnly}
+{
+}
+
+QOrmPooledSession::QOrmPooledSession(QOrmError error)
+    : m_error{std::move(error)}
+{
+}
+
+QOrmPooledSession::QOrmPooledSession(QOrmPooledSession&& other) noexcept
+    : m_pool{std::exchange(other.m_pool, nullptr)}
+    , m_session{std::exchange(other.m_session, nullptr)}
+    , m_isReadOnly{other.m_isReadOnly}
+    , m_error{std::move(other.m_error)}
+{
+}
+
+QOrmPooledSession::~QOrmPooledSession()
+{
+    release();
+}
+
+QOrmPooledSession& QOrmPooledSession::operator=(QOrmPooledSession&& other) noexcept
+{
+    if (this != &other)
+    {
+        release();
+
+        m_pool = std::exchange(other.m_pool, nullptr);
+        m_session = std::exchange(other.m_session, nullptr);
+        m_isReadOnly = other.m_isReadOnly;
+        m_error = std::move(other.m_error);
+    }
+
+    return *this;
+}
+
+void QOrmPooledSession::release()
+{
+    if (m_pool != nullptr)
+        m_pool->release(m_session, m_isReadOnly);
+
+    m_pool = nullptr;
+    m_session = nullptr;
+}
+
+QOrmSessionPool::QOrmSessionPool(const QOrmSqliteConfiguration& configuration)
+    : d{std::make_shared<QOrmSessionPoolPrivate>(configuration)}
+{
+}
+
+QOrmSessionPool::~QOrmSessionPool()
+{
+    using Connection = QOrmSessionPoolPrivate::Connection;
+
+    std::vector<Connection> discarded;
+    std::vector<Connection> retired;
+
+    {
+        QMutexLocker locker{&d->m_mutex};
+
+        if (!d->m_active.empty())
+        {
+            qFatal("QtOrm: session pool destroyed while %d sessions are checked out",
+                   static_cast<int>(d->m_active.size()));
+        }
+
+        for (const QOrmSessionPoolPrivate::WatchedThread& watched : d->m_watchedThreads)
+            QObject::disconnect(watched.finished);
+
+        d->takeRetired(QThread::currentThread(), discarded);
+
+        for (Connection& idle : d->m_idle)
+            d->discard(std::move(idle), discarded);
+
+        d->m_idle.clear();
+        retired = std::move(d->m_retired);
+    }
+
+    // The connections of other running threads outlive the pool until their thread finishes
+    while (!retired.empty())
+    {
+        QPointer<QThread> thread = retired.front().thread;
+
+        auto others = std::stable_partition(std::begin(retired),
+                                            std::end(retired),
+                                            [&thread](const Connection& connection) {
+                                                return connection.thread != thread;
+                                            });
+
+        auto connections = std::make_shared<std::vector<Connection>>();
+        std::move(others, std::end(retired), std::back_inserter(*connections));
+        retired.erase(others, std::end(retired));
+
+        // A thread that has finished meanwhile no longer uses its connections
+        if (!thread.isNull() && !thread->isFinished())
+            QObject::connect(thread, &QThread::finished, [connections]() { connections->clear(); });
+    }
+}
+
+QOrmPooledSession QOrmSessionPool::reader()
+{
+    return d->checkout(true);
+}
+
+QOrmPooledSession QOrmSessionPool::writer()
+{
+    return d->checkout(false);
+}
+
+int QOrmSessionPool::maxReaderCount() const
+{
+    QMutexLocker locker{&d->m_mutex};
+    return d->m_maxReaderCount;
+}
+
+void QOrmSessionPool::setMaxReaderCount(int maxReaderCount)
+{
+    Q_ASSERT(maxReaderCount > 0);
+
+    QMutexLocker locker{&d->m_mutex};
+    d->m_maxReaderCount = maxReaderCount;
+    d->m_released.wakeAll();
+}
+
+int QOrmSessionPool::idleTimeout() const
+{
+    QMutexLocker locker{&d->m_mutex};
+    return d->m_idleTimeout;
+}
+
+void QOrmSessionPool::setIdleTimeout(int idleTimeout)
+{
+    QMutexLocker locker{&d->m_mutex};
+    d->m_idleTimeout = idleTimeout;
+}
+
+int QOrmSessionPool::checkoutTimeout() const
+{
+    QMutexLocker locker{&d->m_mutex};
+    return d->m_checkoutTimeout;
+}
+
+void QOrmSessionPool::setCheckoutTimeout(int checkoutTimeout)
+{
+    QMutexLocker locker{&d->m_mutex};
+    d->m_checkoutTimeout = checkoutTimeout;
+}
+
+int QOrmSessionPool::activeSessionCount() const
+{
+    QMutexLocker locker{&d->m_mutex};
+    return static_cast<int>(d->m_active.size());
+}
+
+int QOrmSessionPool::idleSessionCount() const
+{
+    QMutexLocker locker{&d->m_mutex};
+    return static_cast<int>(d->m_idle.size());
+}
+
+void QOrmSessionPool::closeIdleSessions()
+{
+    d->closeIdle(QThread::currentThread());
+}
+
+std::shared_ptr<QOrmMetadataCache> QOrmSessionPool::metadataCache() const
+{
+    return d->m_metadataCache;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2019 Dmitriy Purgin <dmitriy.purgin@sequality.at>
+ * Copyright (C) 2019 sequality software engineering e.U. <office@sequality.at>
+ *
+ * This file is part of QtOrm library.
+ *
+ * QtOrm is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QtOrm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QtOrm.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef QORMSESSIONPOOL_H
+#define QORMSESSIONPOOL_H
+
+#include <QtOrm/qormerror.h>
+#include <QtOrm/qormglobal.h>
+
+#include <memory>
+
+QT_BEGIN_NAMESPACE
+
+class QOrmMetadataCache;
+class QOrmSession;
+class QOrmSessionPoolPrivate;
+class QOrmSqliteConfiguration;
+
+// Session checked out of a QOrmSessionPool. The session is returned to the pool when the handle is
+// destroyed or released. It must only be used in the thread that checked it out.
+class Q_ORM_EXPORT QOrmPooledSession
+{
+    Q_DISABLE_COPY(QOrmPooledSession)
+
+public:
+    QOrmPooledSession() = default;
+    QOrmPooledSession(QOrmPooledSession&& other) noexcept;
+    ~QOrmPooledSession();
+
+    QOrmPooledSession& operator=(QOrmPooledSession&& other) noexcept;
+
+    [[nodiscard]] QOrmSession* session() const { return m_session; }
+    [[nodiscard]] bool isReadOnly() const { return m_isReadOnly; }
+
+    // Reason why the checkout failed
+    [[nodiscard]] QOrmError error() const { return m_error; }
+
+    QOrmSession* operator->() const { return m_session; }
+    QOrmSession& operator*() const { return *m_session; }
+    explicit operator bool() const { return m_session != nullptr; }
+
+    void release();
+
+private:
+    friend class QOrmSessionPoolPrivate;
+
+    QOrmPooledSession(QOrmSessionPoolPrivate* pool, QOrmSession* session, bool isReadOnly);
+    explicit QOrmPooledSession(QOrmError error);
+
+    QOrmSessionPoolPrivate* m_pool{nullptr};
+    QOrmSession* m_session{nullptr};
+    bool m_isReadOnly{false};
+    QOrmError m_error;
+};
+
+// Hands out sessions backed by connections of their own to the same SQLite database in WAL mode.
+// There is at most one writer session at a time; reader sessions use read-only connections and run
+// concurrently with the writer. All sessions share one metadata cache.
+class Q_ORM_EXPORT QOrmSessionPool
+{
+    Q_DISABLE_COPY(QOrmSessionPool)
+
+public:
+    explicit QOrmSessionPool(const QOrmSqliteConfiguration& configuration);
+    // All sessions must have been returned before the pool is destroyed
+    ~QOrmSessionPool();
+
+    // Check out a session, waiting up to checkoutTimeout() for one to become available
+    [[nodiscard]] QOrmPooledSession reader();
+    [[nodiscard]] QOrmPooledSession writer();
+
+    // Maximum number of open reader connections
+    [[nodiscard]] int maxReaderCount() const;
+    void setMaxReaderCount(int maxReaderCount);
+
+    // Milliseconds after which an unused connection is closed. A negative value keeps the
+    // connections open.
+    [[nodiscard]] int idleTimeout() const;
+    void setIdleTimeout(int idleTimeout);
+
+    // Milliseconds. A negative value waits forever.
+    [[nodiscard]] int checkoutTimeout() const;
+    void setCheckoutTimeout(int checkoutTimeout);
+
+    [[nodiscard]] int activeSessionCount() const;
+    [[nodiscard]] int idleSessionCount() const;
+
+    // Closes the unused connections opened by the current thread
+    void closeIdleSessions();
+
+    [[nodiscard]] std::shared_ptr<QOrmMetadataCache> metadataCache() const;
+
+private:
+    std::shared_ptr<QOrmSessionPoolPrivate> d;
+};
+
+QT_END_NAMESPACE
+
+#endif // QORMSESSIONPOOL_H
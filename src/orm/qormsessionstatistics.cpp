@@ -0,0 +1,849 @@
+/*
+ * Copyright (C) 2019 Dmitriy Purgin <dmitriy.purgin@sequality.at>
+ * Copyright (C) 2019 sequality software engineering e.U. <office@sequality.at>
+ *
+ * This file is part of QtOrm library.
+ *
+ * QtOrm is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QtOrm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QtOrm.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "qormsessionstatistics.h"
+#include "qormsessionstatistics_p.h"
+
+#include "qormglobal_p.h"
+#include "qormmetadata.h"
+#include "qormpropertymapping.h"
+
+#include <QtCore/qalgorithms.h>
+#include <QtCore/qdebug.h>
+
+#include <cmath>
+#include <numeric>
+#include <utility>
+
+QT_BEGIN_NAMESPACE
+
+namespace
+{
+    const char* operationName(QOrm::Operation operation)
+    {
+        switch (operation)
+        {
+            case QOrm::Operation::Create:
+                return "create";
+            case QOrm::Operation::Read:
+                return "read";
+            case QOrm::Operation::Update:
+                return "update";
+            case QOrm::Operation::Delete:
+                return "delete";
+            case QOrm::Operation::Merge:
+                return "merge";
+        }
+
+        Q_UNREACHABLE();
+    }
+
+    void resetCounter(std::atomic<qint64>& counter)
+    {
+        counter.store(0, std::memory_order_relaxed);
+    }
+
+    qint64 loadCounter(const std::atomic<qint64>& counter)
+    {
+        return counter.load(std::memory_order_relaxed);
+    }
+
+    // The generations of the statement shapes are unique across all statistics, so that a thread
+    // never mistakes the shapes of a destroyed statistics for the ones of a new one.
+    std::atomic<quint64> statementShapesGeneration{0};
+
+    quint64 nextStatementShapesGeneration()
+    {
+        return statementShapesGeneration.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+
+    struct ThreadStatementShapes
+    {
+        quint64 generation{0};
+        QHash<QString, int> counts;
+    };
+
+    // A thread keeps the shapes of that many statistics before starting over
+    constexpr int MaxThreadStatementShapes = 8;
+} // namespace
+
+namespace QOrmPrivate
+{
+    int LatencyHistogram::bucketIndex(qint64 nsecs)
+    {
+        if (nsecs < SubBucketCount)
+            return nsecs < 0 ? 0 : static_cast<int>(nsecs);
+
+        // the two bits following the most significant one select the bucket within the octave
+        int msb = 63 - qCountLeadingZeroBits(static_cast<quint64>(nsecs));
+        int octave = msb - 1;
+        int subBucket = static_cast<int>((nsecs >> (msb - 2)) & (SubBucketCount - 1));
+
+        return qMin(octave * SubBucketCount + subBucket, BucketCount - 1);
+    }
+
+    qint64 LatencyHistogram::bucketLowerBound(int index)
+    {
+        if (index < SubBucketCount)
+            return index;
+
+        int octave = index / SubBucketCount;
+        int subBucket = index % SubBucketCount;
+
+        return static_cast<qint64>(SubBucketCount + subBucket) << (octave - 1);
+    }
+
+    qint64 LatencyHistogram::bucketUpperBound(int index)
+    {
+        return index < SubBucketCount ? index + 1 : bucketLowerBound(index + 1);
+    }
+
+    void LatencyHistogram::reset()
+    {
+        for (std::atomic<qint64>& bucket : m_buckets)
+            resetCounter(bucket);
+    }
+
+    QVector<qint64> LatencyHistogram::snapshot() const
+    {
+        QVector<qint64> result(BucketCount);
+
+        for (int i = 0; i < BucketCount; ++i)
+            result[i] = loadCounter(m_buckets[i]);
+
+        return result;
+    }
+
+    void StatementCounters::record(const StatementStatus& status)
+    {
+        increment(executions);
+        increment(fullScanSteps, status.fullScanSteps);
+        increment(sorts, status.sorts);
+        increment(autoIndexRows, status.autoIndexRows);
+        increment(vmSteps, status.vmSteps);
+        increment(reprepares, status.reprepares);
+
+        qint64 memoryUsed = maxMemoryUsed.load(std::memory_order_relaxed);
+
+        while (status.memoryUsed > memoryUsed &&
+               !maxMemoryUsed.compare_exchange_weak(
+                   memoryUsed, status.memoryUsed, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    void StatementCounters::reset()
+    {
+        resetCounter(executions);
+        resetCounter(fullScanSteps);
+        resetCounter(sorts);
+        resetCounter(autoIndexRows);
+        resetCounter(vmSteps);
+        resetCounter(reprepares);
+        resetCounter(maxMemoryUsed);
+    }
+} // namespace QOrmPrivate
+
+qint64 QOrmOperationStatistics::percentileNsecs(double percentile) const
+{
+    using QOrmPrivate::LatencyHistogram;
+
+    qint64 count = std::accumulate(std::cbegin(m_latencyHistogram),
+                                   std::cend(m_latencyHistogram),
+                                   qint64{0});
+
+    if (count == 0)
+        return 0;
+
+    qint64 rank = qBound(qint64{1},
+                         static_cast<qint64>(std::ceil(percentile / 100.0 * count)),
+                         count);
+
+    for (int i = 0; i < m_latencyHistogram.size(); ++i)
+    {
+        rank -= m_latencyHistogram[i];
+
+        if (rank <= 0)
+        {
+            return (LatencyHistogram::bucketLowerBound(i) + LatencyHistogram::bucketUpperBound(i)) /
+                   2;
+        }
+    }
+
+    Q_UNREACHABLE();
+}
+
+QVariantMap QOrmOperationStatistics::toVariantMap() const
+{
+    return {{"statementCount", m_statementCount},
+            {"rowsRead", m_rowsRead},
+            {"rowsWritten", m_rowsWritten},
+            {"totalTimeNsecs", m_totalTimeNsecs},
+            {"p50Nsecs", percentileNsecs(50)},
+            {"p95Nsecs", percentileNsecs(95)},
+            {"p99Nsecs", percentileNsecs(99)}};
+}
+
+QOrmOperationStatistics& QOrmOperationStatistics::operator+=(const QOrmOperationStatistics& other)
+{
+    m_statementCount += other.m_statementCount;
+    m_rowsRead += other.m_rowsRead;
+    m_rowsWritten += other.m_rowsWritten;
+    m_totalTimeNsecs += other.m_totalTimeNsecs;
+
+    if (m_latencyHistogram.isEmpty())
+    {
+        m_latencyHistogram = other.m_latencyHistogram;
+    }
+    else
+    {
+        for (int i = 0; i < other.m_latencyHistogram.size(); ++i)
+            m_latencyHistogram[i] += other.m_latencyHistogram[i];
+    }
+
+    return *this;
+}
+
+QVariantMap QOrmStatementStatistics::toVariantMap() const
+{
+    return {{"executions", m_executions},
+            {"fullScanSteps", m_fullScanSteps},
+            {"sorts", m_sorts},
+            {"autoIndexRows", m_autoIndexRows},
+            {"vmSteps", m_vmSteps},
+            {"reprepares", m_reprepares},
+            {"maxMemoryUsed", m_maxMemoryUsed}};
+}
+
+QOrmOperationStatistics QOrmEntityStatistics::operation(QOrm::Operation operation) const
+{
+    return m_operations.value(static_cast<int>(operation));
+}
+
+QOrmOperationStatistics QOrmEntityStatistics::total() const
+{
+    QOrmOperationStatistics result;
+
+    for (const QOrmOperationStatistics& operation : m_operations)
+        result += operation;
+
+    return result;
+}
+
+QVariantMap QOrmEntityStatistics::toVariantMap() const
+{
+    QVariantMap operations;
+
+    for (int i = 0; i < m_operations.size(); ++i)
+    {
+        if (m_operations[i].statementCount() > 0)
+        {
+            operations.insert(operationName(static_cast<QOrm::Operation>(i)),
+                              m_operations[i].toVariantMap());
+        }
+    }
+
+    return {{"hydratedInstances", m_hydratedInstances},
+            {"hydrationTimeNsecs", m_hydrationTimeNsecs},
+            {"cacheHits", m_cacheHits},
+            {"cacheMisses", m_cacheMisses},
+            {"operations", operations}};
+}
+
+QOrmSessionStatisticsPrivate::QOrmSessionStatisticsPrivate(QOrmSessionStatistics* parent)
+    : q_ptr{parent}
+    , m_statementShapesGeneration{nextStatementShapesGeneration()}
+{
+}
+
+QOrmSessionStatisticsPrivate::~QOrmSessionStatisticsPrivate()
+{
+    QOrmPrivate::EntityCounters* counters = m_entities.load(std::memory_order_acquire);
+
+    while (counters != nullptr)
+        delete std::exchange(counters, counters->next);
+
+    QOrmPrivate::StatementCounters* statements = m_statements.load(std::memory_order_acquire);
+
+    while (statements != nullptr)
+        delete std::exchange(statements, statements->next);
+}
+
+QOrmPrivate::EntityCounters& QOrmSessionStatisticsPrivate::entity(const QOrmMetadata& metadata)
+{
+    using QOrmPrivate::EntityCounters;
+
+    const QMetaObject* qMetaObject = &metadata.qMetaObject();
+    EntityCounters* head = m_entities.load(std::memory_order_acquire);
+
+    for (EntityCounters* counters = head; counters != nullptr; counters = counters->next)
+    {
+        if (counters->qMetaObject == qMetaObject)
+            return *counters;
+    }
+
+    auto* counters = new EntityCounters{qMetaObject, metadata.className()};
+    counters->next = head;
+
+    while (!m_entities.compare_exchange_weak(counters->next,
+                                             counters,
+                                             std::memory_order_acq_rel,
+                                             std::memory_order_acquire))
+    {
+        // Entities were registered concurrently: the same one might be among them
+        for (EntityCounters* other = counters->next; other != head; other = other->next)
+        {
+            if (other->qMetaObject == qMetaObject)
+            {
+                delete counters;
+                return *other;
+            }
+        }
+
+        head = counters->next;
+    }
+
+    return *counters;
+}
+
+void QOrmSessionStatisticsPrivate::recordStatement(const QOrmMetadata& metadata,
+                                                   QOrm::Operation operation,
+                                                   qint64 nsecs,
+                                                   qint64 rowsRead,
+                                                   qint64 rowsWritten)
+{
+    QOrmPrivate::OperationCounters& counters =
+        entity(metadata).operations[static_cast<size_t>(operation)];
+
+    QOrmPrivate::increment(counters.statementCount);
+    QOrmPrivate::increment(counters.rowsRead, rowsRead);
+    QOrmPrivate::increment(counters.rowsWritten, rowsWritten);
+    QOrmPrivate::increment(counters.totalTimeNsecs, nsecs);
+    counters.latency.record(nsecs);
+}
+
+void QOrmSessionStatisticsPrivate::recordHydration(const QOrmMetadata& metadata, qint64 nsecs)
+{
+    QOrmPrivate::EntityCounters& counters = entity(metadata);
+
+    QOrmPrivate::increment(counters.hydratedInstances);
+    QOrmPrivate::increment(counters.hydrationTimeNsecs, nsecs);
+}
+
+void QOrmSessionStatisticsPrivate::recordCacheLookup(const QOrmMetadata& metadata, bool hit)
+{
+    QOrmPrivate::EntityCounters& counters = entity(metadata);
+
+    QOrmPrivate::increment(hit ? counters.cacheHits : counters.cacheMisses);
+}
+
+void QOrmSessionStatisticsPrivate::recordReadStatement(const QString& statement,
+                                                       const QOrmPropertyMapping* reference)
+{
+    int threshold = m_nPlusOneThreshold.load(std::memory_order_relaxed);
+
+    if (threshold <= 0)
+        return;
+
+    // Without a transaction, the shapes are collected until control returns to the event loop
+    // of the thread of the statistics
+    if (!m_statementShapesResetPending.load(std::memory_order_relaxed) &&
+        !m_statementShapesResetPending.exchange(true))
+    {
+        QMetaObject::invokeMethod(
+            q_ptr, [this]() { resetStatementShapes(); }, Qt::QueuedConnection);
+    }
+
+    // The shapes are counted per thread so that reads do not contend
+    thread_local QHash<const QOrmSessionStatisticsPrivate*, ThreadStatementShapes> threadShapes;
+
+    auto it = threadShapes.find(this);
+
+    if (it == std::end(threadShapes))
+    {
+        if (threadShapes.size() >= MaxThreadStatementShapes)
+            threadShapes.clear();
+
+        it = threadShapes.insert(this, ThreadStatementShapes{});
+    }
+
+    quint64 generation = m_statementShapesGeneration.load(std::memory_order_relaxed);
+
+    if (it->generation != generation)
+    {
+        it->generation = generation;
+        it->counts.clear();
+    }
+
+    int count = ++it->counts[statement];
+
+    if (count != threshold + 1)
+        return;
+
+    QOrmPrivate::increment(m_nPlusOneDetections);
+
+    if (reference != nullptr)
+    {
+        QString path = reference->enclosingEntity().className() + "::" +
+                       reference->classPropertyName();
+
+        qCWarning(qtorm).noquote().nospace()
+            << "Possible N+1 query: the statement was executed more than " << threshold
+            << " times while resolving " << path << ": " << statement
+            << "\n  Consider prefetching " << path << " by reading the "
+            << reference->referencedEntity()->className()
+            << " instances with a single query before reading "
+            << reference->enclosingEntity().className();
+    }
+    else
+    {
+        qCWarning(qtorm).noquote().nospace()
+            << "Possible N+1 query: the statement was executed more than " << threshold
+            << " times in one transaction or event loop turn: " << statement
+            << "\n  Consider reading the instances with a single query";
+    }
+}
+
+void QOrmSessionStatisticsPrivate::resetStatementShapes()
+{
+    m_statementShapesGeneration.store(nextStatementShapesGeneration(), std::memory_order_relaxed);
+    m_statementShapesResetPending.store(false, std::memory_order_relaxed);
+}
+
+QOrmPrivate::StatementCounters* QOrmSessionStatisticsPrivate::statement(const QString& statement)
+{
+    QMutexLocker locker{&m_statementRegistryMutex};
+
+    auto it = m_statementRegistry.find(statement);
+
+    if (it != m_statementRegistry.end())
+        return *it;
+
+    if (m_statementRegistry.size() >= MaxStatementStatistics)
+        return nullptr;
+
+    auto* counters = new QOrmPrivate::StatementCounters{statement};
+    counters->next = m_statements.load(std::memory_order_relaxed);
+    m_statements.store(counters, std::memory_order_release);
+    m_statementRegistry.insert(statement, counters);
+
+    return counters;
+}
+
+void QOrmSessionStatisticsPrivate::recordStatementStatus(QOrmPrivate::StatementCounters* counters,
+                                                         const QOrmPrivate::StatementStatus& status)
+{
+    m_statementTotals.record(status);
+
+    if (counters != nullptr)
+        counters->record(status);
+}
+
+void QOrmSessionStatisticsPrivate::recordDatabaseStatus(qint64 pageCacheHits,
+                                                        qint64 pageCacheMisses,
+                                                        qint64 pageCacheUsed)
+{
+    m_pageCacheHits.fetch_add(pageCacheHits, std::memory_order_relaxed);
+    m_pageCacheMisses.fetch_add(pageCacheMisses, std::memory_order_relaxed);
+    m_pageCacheUsed.fetch_add(pageCacheUsed, std::memory_order_relaxed);
+}
+
+QOrmEntityStatistics QOrmSessionStatisticsPrivate::snapshot(
+    const QOrmPrivate::EntityCounters& counters)
+{
+    QOrmEntityStatistics result;
+    result.m_className = counters.className;
+    result.m_hydratedInstances = loadCounter(counters.hydratedInstances);
+    result.m_hydrationTimeNsecs = loadCounter(counters.hydrationTimeNsecs);
+    result.m_cacheHits = loadCounter(counters.cacheHits);
+    result.m_cacheMisses = loadCounter(counters.cacheMisses);
+
+    for (const QOrmPrivate::OperationCounters& operationCounters : counters.operations)
+    {
+        QOrmOperationStatistics operation;
+        operation.m_statementCount = loadCounter(operationCounters.statementCount);
+        operation.m_rowsRead = loadCounter(operationCounters.rowsRead);
+        operation.m_rowsWritten = loadCounter(operationCounters.rowsWritten);
+        operation.m_totalTimeNsecs = loadCounter(operationCounters.totalTimeNsecs);
+        operation.m_latencyHistogram = operationCounters.latency.snapshot();
+
+        result.m_operations.push_back(operation);
+    }
+
+    return result;
+}
+
+QOrmStatementStatistics QOrmSessionStatisticsPrivate::snapshot(
+    const QOrmPrivate::StatementCounters& counters)
+{
+    QOrmStatementStatistics result;
+    result.m_statement = counters.statement;
+    result.m_executions = loadCounter(counters.executions);
+    result.m_fullScanSteps = loadCounter(counters.fullScanSteps);
+    result.m_sorts = loadCounter(counters.sorts);
+    result.m_autoIndexRows = loadCounter(counters.autoIndexRows);
+    result.m_vmSteps = loadCounter(counters.vmSteps);
+    result.m_reprepares = loadCounter(counters.reprepares);
+    result.m_maxMemoryUsed = loadCounter(counters.maxMemoryUsed);
+
+    return result;
+}
+
+QOrmSessionStatistics::QOrmSessionStatistics(QObject* parent)
+    : QObject{parent}
+    , d_ptr{new QOrmSessionStatisticsPrivate{this}}
+{
+    connect(&d_ptr->m_updateTimer, &QTimer::timeout, this, &QOrmSessionStatistics::refresh);
+}
+
+QOrmSessionStatistics::~QOrmSessionStatistics() = default;
+
+qint64 QOrmSessionStatistics::statementCount() const
+{
+    qint64 result = 0;
+
+    for (const QOrmEntityStatistics& entity : entityStatistics())
+        result += entity.total().statementCount();
+
+    return result;
+}
+
+qint64 QOrmSessionStatistics::rowsRead() const
+{
+    qint64 result = 0;
+
+    for (const QOrmEntityStatistics& entity : entityStatistics())
+        result += entity.total().rowsRead();
+
+    return result;
+}
+
+qint64 QOrmSessionStatistics::rowsWritten() const
+{
+    qint64 result = 0;
+
+    for (const QOrmEntityStatistics& entity : entityStatistics())
+        result += entity.total().rowsWritten();
+
+    return result;
+}
+
+qint64 QOrmSessionStatistics::totalTimeNsecs() const
+{
+    qint64 result = 0;
+
+    for (const QOrmEntityStatistics& entity : entityStatistics())
+        result += entity.total().totalTimeNsecs();
+
+    return result;
+}
+
+qint64 QOrmSessionStatistics::cacheHits() const
+{
+    qint64 result = 0;
+
+    for (const QOrmEntityStatistics& entity : entityStatistics())
+        result += entity.cacheHits();
+
+    return result;
+}
+
+qint64 QOrmSessionStatistics::cacheMisses() const
+{
+    qint64 result = 0;
+
+    for (const QOrmEntityStatistics& entity : entityStatistics())
+        result += entity.cacheMisses();
+
+    return result;
+}
+
+qint64 QOrmSessionStatistics::schemaSyncChecks() const
+{
+    Q_D(const QOrmSessionStatistics);
+    return loadCounter(d->m_schemaSyncChecks);
+}
+
+qint64 QOrmSessionStatistics::statementsPrepared() const
+{
+    Q_D(const QOrmSessionStatistics);
+    return loadCounter(d->m_statementsPrepared);
+}
+
+qint64 QOrmSessionStatistics::slowStatements() const
+{
+    Q_D(const QOrmSessionStatistics);
+    return loadCounter(d->m_slowStatements);
+}
+
+qint64 QOrmSessionStatistics::transactionsBegun() const
+{
+    Q_D(const QOrmSessionStatistics);
+    return loadCounter(d->m_transactionsBegun);
+}
+
+qint64 QOrmSessionStatistics::transactionsCommitted() const
+{
+    Q_D(const QOrmSessionStatistics);
+    return loadCounter(d->m_transactionsCommitted);
+}
+
+qint64 QOrmSessionStatistics::transactionsRolledBack() const
+{
+    Q_D(const QOrmSessionStatistics);
+    return loadCounter(d->m_transactionsRolledBack);
+}
+
+qint64 QOrmSessionStatistics::nPlusOneDetections() const
+{
+    Q_D(const QOrmSessionStatistics);
+    return loadCounter(d->m_nPlusOneDetections);
+}
+
+qint64 QOrmSessionStatistics::fullScanSteps() const
+{
+    Q_D(const QOrmSessionStatistics);
+    return loadCounter(d->m_statementTotals.fullScanSteps);
+}
+
+qint64 QOrmSessionStatistics::sorts() const
+{
+    Q_D(const QOrmSessionStatistics);
+    return loadCounter(d->m_statementTotals.sorts);
+}
+
+qint64 QOrmSessionStatistics::autoIndexRows() const
+{
+    Q_D(const QOrmSessionStatistics);
+    return loadCounter(d->m_statementTotals.autoIndexRows);
+}
+
+qint64 QOrmSessionStatistics::vmSteps() const
+{
+    Q_D(const QOrmSessionStatistics);
+    return loadCounter(d->m_statementTotals.vmSteps);
+}
+
+qint64 QOrmSessionStatistics::pageCacheHits() const
+{
+    Q_D(const QOrmSessionStatistics);
+    return loadCounter(d->m_pageCacheHits) - loadCounter(d->m_pageCacheHitsBaseline);
+}
+
+qint64 QOrmSessionStatistics::pageCacheMisses() const
+{
+    Q_D(const QOrmSessionStatistics);
+    return loadCounter(d->m_pageCacheMisses) - loadCounter(d->m_pageCacheMissesBaseline);
+}
+
+qint64 QOrmSessionStatistics::pageCacheUsed() const
+{
+    Q_D(const QOrmSessionStatistics);
+    return loadCounter(d->m_pageCacheUsed);
+}
+
+QVector<QOrmStatementStatistics> QOrmSessionStatistics::statementStatistics() const
+{
+    Q_D(const QOrmSessionStatistics);
+
+    QVector<QOrmStatementStatistics> result;
+
+    for (auto* counters = d->m_statements.load(std::memory_order_acquire); counters != nullptr;
+         counters = counters->next)
+    {
+        // Shapes stay registered after a reset
+        if (loadCounter(counters->executions) > 0)
+            result.push_back(QOrmSessionStatisticsPrivate::snapshot(*counters));
+    }
+
+    return result;
+}
+
+QVector<QOrmEntityStatistics> QOrmSessionStatistics::entityStatistics() const
+{
+    Q_D(const QOrmSessionStatistics);
+
+    QVector<QOrmEntityStatistics> result;
+
+    for (auto* counters = d->m_entities.load(std::memory_order_acquire); counters != nullptr;
+         counters = counters->next)
+    {
+        result.push_back(QOrmSessionStatisticsPrivate::snapshot(*counters));
+    }
+
+    return result;
+}
+
+QOrmEntityStatistics QOrmSessionStatistics::entityStatistics(const QString& className) const
+{
+    Q_D(const QOrmSessionStatistics);
+
+    for (auto* counters = d->m_entities.load(std::memory_order_acquire); counters != nullptr;
+         counters = counters->next)
+    {
+        if (counters->className == className)
+            return QOrmSessionStatisticsPrivate::snapshot(*counters);
+    }
+
+    QOrmEntityStatistics result;
+    result.m_className = className;
+    return result;
+}
+
+int QOrmSessionStatistics::updateInterval() const
+{
+    Q_D(const QOrmSessionStatistics);
+    return d->m_updateTimer.isActive() ? d->m_updateTimer.interval() : 0;
+}
+
+void QOrmSessionStatistics::setUpdateInterval(int updateInterval)
+{
+    Q_D(QOrmSessionStatistics);
+
+    if (this->updateInterval() == updateInterval)
+        return;
+
+    if (updateInterval > 0)
+        d->m_updateTimer.start(updateInterval);
+    else
+        d->m_updateTimer.stop();
+
+    emit updateIntervalChanged();
+}
+
+int QOrmSessionStatistics::nPlusOneThreshold() const
+{
+    Q_D(const QOrmSessionStatistics);
+    return d->m_nPlusOneThreshold.load(std::memory_order_relaxed);
+}
+
+void QOrmSessionStatistics::setNPlusOneThreshold(int nPlusOneThreshold)
+{
+    Q_D(QOrmSessionStatistics);
+
+    nPlusOneThreshold = qMax(nPlusOneThreshold, 0);
+
+    if (d->m_nPlusOneThreshold.load(std::memory_order_relaxed) == nPlusOneThreshold)
+        return;
+
+    d->m_nPlusOneThreshold.store(nPlusOneThreshold, std::memory_order_relaxed);
+    d->resetStatementShapes();
+
+    emit nPlusOneThresholdChanged();
+}
+
+QVariantMap QOrmSessionStatistics::toVariantMap() const
+{
+    QVariantMap entities;
+
+    for (const QOrmEntityStatistics& entity : entityStatistics())
+        entities.insert(entity.className(), entity.toVariantMap());
+
+    QVariantMap statements;
+
+    for (const QOrmStatementStatistics& statement : statementStatistics())
+        statements.insert(statement.statement(), statement.toVariantMap());
+
+    return {{"statementCount", statementCount()},
+            {"rowsRead", rowsRead()},
+            {"rowsWritten", rowsWritten()},
+            {"totalTimeNsecs", totalTimeNsecs()},
+            {"cacheHits", cacheHits()},
+            {"cacheMisses", cacheMisses()},
+            {"schemaSyncChecks", schemaSyncChecks()},
+            {"statementsPrepared", statementsPrepared()},
+            {"slowStatements", slowStatements()},
+            {"transactionsBegun", transactionsBegun()},
+            {"transactionsCommitted", transactionsCommitted()},
+            {"transactionsRolledBack", transactionsRolledBack()},
+            {"nPlusOneDetections", nPlusOneDetections()},
+            {"fullScanSteps", fullScanSteps()},
+            {"sorts", sorts()},
+            {"autoIndexRows", autoIndexRows()},
+            {"vmSteps", vmSteps()},
+            {"pageCacheHits", pageCacheHits()},
+            {"pageCacheMisses", pageCacheMisses()},
+            {"pageCacheUsed", pageCacheUsed()},
+            {"entities", entities},
+            {"statements", statements}};
+}
+
+// Resets the counters. Operations running concurrently may be partially accounted for.
+void QOrmSessionStatistics::reset()
+{
+    Q_D(QOrmSessionStatistics);
+
+    for (auto* counters = d->m_entities.load(std::memory_order_acquire); counters != nullptr;
+         counters = counters->next)
+    {
+        for (QOrmPrivate::OperationCounters& operation : counters->operations)
+        {
+            resetCounter(operation.statementCount);
+            resetCounter(operation.rowsRead);
+            resetCounter(operation.rowsWritten);
+            resetCounter(operation.totalTimeNsecs);
+            operation.latency.reset();
+        }
+
+        resetCounter(counters->hydratedInstances);
+        resetCounter(counters->hydrationTimeNsecs);
+        resetCounter(counters->cacheHits);
+        resetCounter(counters->cacheMisses);
+    }
+
+    resetCounter(d->m_schemaSyncChecks);
+    resetCounter(d->m_statementsPrepared);
+    resetCounter(d->m_slowStatements);
+    resetCounter(d->m_transactionsBegun);
+    resetCounter(d->m_transactionsCommitted);
+    resetCounter(d->m_transactionsRolledBack);
+    resetCounter(d->m_nPlusOneDetections);
+    d->resetStatementShapes();
+
+    d->m_statementTotals.reset();
+
+    for (auto* counters = d->m_statements.load(std::memory_order_acquire); counters != nullptr;
+         counters = counters->next)
+    {
+        counters->reset();
+    }
+
+    // The page cache counters of the connection are cumulative and cannot be reset here
+    d->m_pageCacheHitsBaseline.store(loadCounter(d->m_pageCacheHits), std::memory_order_relaxed);
+    d->m_pageCacheMissesBaseline.store(loadCounter(d->m_pageCacheMisses),
+                                       std::memory_order_relaxed);
+
+    emit changed();
+}
+
+void QOrmSessionStatistics::refresh()
+{
+    emit changed();
+}
+
+QDebug operator<<(QDebug dbg, const QOrmSessionStatistics& statistics)
+{
+    QDebugStateSaver saver{dbg};
+    dbg.nospace() << "QOrmSessionStatistics(" << statistics.toVariantMap() << ")";
+    return dbg;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,233 @@
+/*
+ * Copyright (C) 2019 Dmitriy Purgin <dmitriy.purgin@sequality.at>
+ * Copyright (C) 2019 sequality software engineering e.U. <office@sequality.at>
+ *
+ * This file is part of QtOrm library.
+ *
+ * QtOrm is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QtOrm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QtOrm.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef QORMSESSIONSTATISTICS_H
+#define QORMSESSIONSTATISTICS_H
+
+#include <QtOrm/qormglobal.h>
+
+#include <QtCore/qobject.h>
+#include <QtCore/qstring.h>
+#include <QtCore/qvariant.h>
+#include <QtCore/qvector.h>
+
+QT_BEGIN_NAMESPACE
+
+class QDebug;
+class QOrmSessionStatisticsPrivate;
+
+class Q_ORM_EXPORT QOrmOperationStatistics
+{
+public:
+    [[nodiscard]] qint64 statementCount() const { return m_statementCount; }
+    [[nodiscard]] qint64 rowsRead() const { return m_rowsRead; }
+    [[nodiscard]] qint64 rowsWritten() const { return m_rowsWritten; }
+    [[nodiscard]] qint64 totalTimeNsecs() const { return m_totalTimeNsecs; }
+
+    // Estimates the given percentile (0..100) of the statement execution times. The estimate is
+    // within 12.5% of the actual value.
+    [[nodiscard]] qint64 percentileNsecs(double percentile) const;
+
+    [[nodiscard]] QVariantMap toVariantMap() const;
+
+    QOrmOperationStatistics& operator+=(const QOrmOperationStatistics& other);
+
+private:
+    friend class QOrmSessionStatisticsPrivate;
+
+    qint64 m_statementCount{0};
+    qint64 m_rowsRead{0};
+    qint64 m_rowsWritten{0};
+    qint64 m_totalTimeNsecs{0};
+    QVector<qint64> m_latencyHistogram;
+};
+
+// SQLite engine counters of one statement shape, summed over its executions. They are only
+// collected if QtOrm is built against the SQLite library.
+class Q_ORM_EXPORT QOrmStatementStatistics
+{
+public:
+    [[nodiscard]] QString statement() const { return m_statement; }
+    [[nodiscard]] qint64 executions() const { return m_executions; }
+
+    // Rows stepped through in full table scans
+    [[nodiscard]] qint64 fullScanSteps() const { return m_fullScanSteps; }
+    [[nodiscard]] qint64 sorts() const { return m_sorts; }
+    // Rows inserted into automatic indexes
+    [[nodiscard]] qint64 autoIndexRows() const { return m_autoIndexRows; }
+    [[nodiscard]] qint64 vmSteps() const { return m_vmSteps; }
+    [[nodiscard]] qint64 reprepares() const { return m_reprepares; }
+    // Largest amount of memory used by a prepared statement of this shape
+    [[nodiscard]] qint64 maxMemoryUsed() const { return m_maxMemoryUsed; }
+
+    [[nodiscard]] QVariantMap toVariantMap() const;
+
+private:
+    friend class QOrmSessionStatisticsPrivate;
+
+    QString m_statement;
+    qint64 m_executions{0};
+    qint64 m_fullScanSteps{0};
+    qint64 m_sorts{0};
+    qint64 m_autoIndexRows{0};
+    qint64 m_vmSteps{0};
+    qint64 m_reprepares{0};
+    qint64 m_maxMemoryUsed{0};
+};
+
+class Q_ORM_EXPORT QOrmEntityStatistics
+{
+public:
+    [[nodiscard]] QString className() const { return m_className; }
+
+    [[nodiscard]] QOrmOperationStatistics operation(QOrm::Operation operation) const;
+    [[nodiscard]] QOrmOperationStatistics total() const;
+
+    // Time spent constructing and filling entity instances from the result rows, including the
+    // resolution of their references
+    [[nodiscard]] qint64 hydratedInstances() const { return m_hydratedInstances; }
+    [[nodiscard]] qint64 hydrationTimeNsecs() const { return m_hydrationTimeNsecs; }
+
+    // Lookups of read rows and referenced rows in the entity instance cache
+    [[nodiscard]] qint64 cacheHits() const { return m_cacheHits; }
+    [[nodiscard]] qint64 cacheMisses() const { return m_cacheMisses; }
+
+    [[nodiscard]] QVariantMap toVariantMap() const;
+
+private:
+    friend class QOrmSessionStatistics;
+    friend class QOrmSessionStatisticsPrivate;
+
+    QString m_className;
+    QVector<QOrmOperationStatistics> m_operations;
+    qint64 m_hydratedInstances{0};
+    qint64 m_hydrationTimeNsecs{0};
+    qint64 m_cacheHits{0};
+    qint64 m_cacheMisses{0};
+};
+
+// Counters of the work done by a session and its provider. The counters are updated lock-free and
+// can be read from any thread while the session is in use. Reading them is not atomic as a whole:
+// a snapshot may be taken in the middle of an operation.
+class Q_ORM_EXPORT QOrmSessionStatistics : public QObject
+{
+    Q_OBJECT
+    Q_DECLARE_PRIVATE(QOrmSessionStatistics)
+
+    Q_PROPERTY(qint64 statementCount READ statementCount NOTIFY changed)
+    Q_PROPERTY(qint64 rowsRead READ rowsRead NOTIFY changed)
+    Q_PROPERTY(qint64 rowsWritten READ rowsWritten NOTIFY changed)
+    Q_PROPERTY(qint64 totalTimeNsecs READ totalTimeNsecs NOTIFY changed)
+    Q_PROPERTY(qint64 cacheHits READ cacheHits NOTIFY changed)
+    Q_PROPERTY(qint64 cacheMisses READ cacheMisses NOTIFY changed)
+    Q_PROPERTY(qint64 schemaSyncChecks READ schemaSyncChecks NOTIFY changed)
+    Q_PROPERTY(qint64 statementsPrepared READ statementsPrepared NOTIFY changed)
+    Q_PROPERTY(qint64 slowStatements READ slowStatements NOTIFY changed)
+    Q_PROPERTY(qint64 transactionsBegun READ transactionsBegun NOTIFY changed)
+    Q_PROPERTY(qint64 transactionsCommitted READ transactionsCommitted NOTIFY changed)
+    Q_PROPERTY(qint64 transactionsRolledBack READ transactionsRolledBack NOTIFY changed)
+    Q_PROPERTY(qint64 nPlusOneDetections READ nPlusOneDetections NOTIFY changed)
+    Q_PROPERTY(qint64 fullScanSteps READ fullScanSteps NOTIFY changed)
+    Q_PROPERTY(qint64 sorts READ sorts NOTIFY changed)
+    Q_PROPERTY(qint64 autoIndexRows READ autoIndexRows NOTIFY changed)
+    Q_PROPERTY(qint64 vmSteps READ vmSteps NOTIFY changed)
+    Q_PROPERTY(qint64 pageCacheHits READ pageCacheHits NOTIFY changed)
+    Q_PROPERTY(qint64 pageCacheMisses READ pageCacheMisses NOTIFY changed)
+    Q_PROPERTY(qint64 pageCacheUsed READ pageCacheUsed NOTIFY changed)
+    Q_PROPERTY(int nPlusOneThreshold READ nPlusOneThreshold WRITE setNPlusOneThreshold NOTIFY
+                   nPlusOneThresholdChanged)
+    Q_PROPERTY(int updateInterval READ updateInterval WRITE setUpdateInterval NOTIFY
+                   updateIntervalChanged)
+
+public:
+    explicit QOrmSessionStatistics(QObject* parent = nullptr);
+    ~QOrmSessionStatistics() override;
+
+    [[nodiscard]] qint64 statementCount() const;
+    [[nodiscard]] qint64 rowsRead() const;
+    [[nodiscard]] qint64 rowsWritten() const;
+    [[nodiscard]] qint64 totalTimeNsecs() const;
+    [[nodiscard]] qint64 cacheHits() const;
+    [[nodiscard]] qint64 cacheMisses() const;
+
+    [[nodiscard]] qint64 schemaSyncChecks() const;
+    [[nodiscard]] qint64 statementsPrepared() const;
+    [[nodiscard]] qint64 slowStatements() const;
+
+    [[nodiscard]] qint64 transactionsBegun() const;
+    [[nodiscard]] qint64 transactionsCommitted() const;
+    [[nodiscard]] qint64 transactionsRolledBack() const;
+
+    // Number of statement shapes that were executed more often than the N+1 threshold within one
+    // transaction or event loop turn
+    [[nodiscard]] qint64 nPlusOneDetections() const;
+
+    // SQLite engine counters summed over all statements
+    [[nodiscard]] qint64 fullScanSteps() const;
+    [[nodiscard]] qint64 sorts() const;
+    [[nodiscard]] qint64 autoIndexRows() const;
+    [[nodiscard]] qint64 vmSteps() const;
+
+    // SQLite page caches of the connections of the session, including the one of the
+    // asynchronous worker. pageCacheUsed() is their current size in bytes.
+    [[nodiscard]] qint64 pageCacheHits() const;
+    [[nodiscard]] qint64 pageCacheMisses() const;
+    [[nodiscard]] qint64 pageCacheUsed() const;
+
+    [[nodiscard]] QVector<QOrmStatementStatistics> statementStatistics() const;
+    [[nodiscard]] QVector<QOrmEntityStatistics> entityStatistics() const;
+    [[nodiscard]] QOrmEntityStatistics entityStatistics(const QString& className) const;
+
+    template<typename T>
+    [[nodiscard]] QOrmEntityStatistics entityStatistics() const
+    {
+        return entityStatistics(QString::fromUtf8(T::staticMetaObject.className()));
+    }
+
+    // Interval in milliseconds at which changed() is emitted. 0 disables the periodic updates.
+    [[nodiscard]] int updateInterval() const;
+    void setUpdateInterval(int updateInterval);
+
+    // Maximum number of executions of the same read statement by one thread within one transaction
+    // or event loop turn before a possible N+1 query is reported. 0 disables the detection.
+    [[nodiscard]] int nPlusOneThreshold() const;
+    void setNPlusOneThreshold(int nPlusOneThreshold);
+
+    Q_INVOKABLE QVariantMap toVariantMap() const;
+
+public Q_SLOTS:
+    void reset();
+    void refresh();
+
+Q_SIGNALS:
+    void changed();
+    void updateIntervalChanged();
+    void nPlusOneThresholdChanged();
+
+private:
+    QScopedPointer<QOrmSessionStatisticsPrivate> d_ptr;
+};
+
+extern Q_ORM_EXPORT QDebug operator<<(QDebug dbg, const QOrmSessionStatistics& statistics);
+
+QT_END_NAMESPACE
+
+#endif // QORMSESSIONSTATISTICS_H
@@ -0,0 +1,222 @@
+/*
+ * Copyright (C) 2019 Dmitriy Purgin <dmitriy.purgin@sequality.at>
+ * Copyright (C) 2019 sequality software engineering e.U. <office@sequality.at>
+ *
+ * This file is part of QtOrm library.
+ *
+ * QtOrm is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QtOrm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QtOrm.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef QORMSESSIONSTATISTICS_P_H
+#define QORMSESSIONSTATISTICS_P_H
+
+#include <QtOrm/qormglobal.h>
+#include <QtOrm/qormsessionstatistics.h>
+
+#include <QtCore/qhash.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qtimer.h>
+
+#include <array>
+#include <atomic>
+
+QT_BEGIN_NAMESPACE
+
+class QOrmMetadata;
+class QOrmPropertyMapping;
+
+namespace QOrmPrivate
+{
+    // Log-linear histogram of durations in nanoseconds: every power of two is divided into four
+    // buckets.
+    class LatencyHistogram
+    {
+    public:
+        static constexpr int SubBucketCount = 4;
+        static constexpr int OctaveCount = 42;
+        static constexpr int BucketCount = SubBucketCount * OctaveCount;
+
+        [[nodiscard]] static int bucketIndex(qint64 nsecs);
+        [[nodiscard]] static qint64 bucketLowerBound(int index);
+        [[nodiscard]] static qint64 bucketUpperBound(int index);
+
+        void record(qint64 nsecs)
+        {
+            m_buckets[bucketIndex(nsecs)].fetch_add(1, std::memory_order_relaxed);
+        }
+
+        void reset();
+        [[nodiscard]] QVector<qint64> snapshot() const;
+
+    private:
+        std::array<std::atomic<qint64>, BucketCount> m_buckets{};
+    };
+
+    struct OperationCounters
+    {
+        std::atomic<qint64> statementCount{0};
+        std::atomic<qint64> rowsRead{0};
+        std::atomic<qint64> rowsWritten{0};
+        std::atomic<qint64> totalTimeNsecs{0};
+        LatencyHistogram latency;
+    };
+
+    // One set of counters per QOrm::Operation
+    constexpr int OperationCount = static_cast<int>(QOrm::Operation::Merge) + 1;
+
+    struct EntityCounters
+    {
+        EntityCounters(const QMetaObject* qMetaObject, QString className)
+            : qMetaObject{qMetaObject}
+            , className{std::move(className)}
+        {
+        }
+
+        const QMetaObject* const qMetaObject;
+        const QString className;
+
+        std::array<OperationCounters, OperationCount> operations;
+        std::atomic<qint64> hydratedInstances{0};
+        std::atomic<qint64> hydrationTimeNsecs{0};
+        std::atomic<qint64> cacheHits{0};
+        std::atomic<qint64> cacheMisses{0};
+
+        EntityCounters* next{nullptr};
+    };
+
+    struct StatementStatus
+    {
+        qint64 fullScanSteps{0};
+        qint64 sorts{0};
+        qint64 autoIndexRows{0};
+        qint64 vmSteps{0};
+        qint64 reprepares{0};
+        qint64 memoryUsed{0};
+    };
+
+    inline void increment(std::atomic<qint64>& counter, qint64 value = 1)
+    {
+        counter.fetch_add(value, std::memory_order_relaxed);
+    }
+
+    // Counters of one statement shape. Connections keep a pointer to them so that the shape is
+    // looked up in the shared registry only once per connection.
+    struct StatementCounters
+    {
+        explicit StatementCounters(QString statement)
+            : statement{std::move(statement)}
+        {
+        }
+
+        const QString statement;
+
+        std::atomic<qint64> executions{0};
+        std::atomic<qint64> fullScanSteps{0};
+        std::atomic<qint64> sorts{0};
+        std::atomic<qint64> autoIndexRows{0};
+        std::atomic<qint64> vmSteps{0};
+        std::atomic<qint64> reprepares{0};
+        std::atomic<qint64> maxMemoryUsed{0};
+
+        StatementCounters* next{nullptr};
+
+        void record(const StatementStatus& status);
+        void reset();
+    };
+} // namespace QOrmPrivate
+
+class QOrmSessionStatisticsPrivate
+{
+    Q_DECLARE_PUBLIC(QOrmSessionStatistics)
+    QOrmSessionStatistics* q_ptr{nullptr};
+
+public:
+    explicit QOrmSessionStatisticsPrivate(QOrmSessionStatistics* parent);
+    ~QOrmSessionStatisticsPrivate();
+
+    static QOrmSessionStatisticsPrivate* get(QOrmSessionStatistics* statistics)
+    {
+        return statistics != nullptr ? statistics->d_func() : nullptr;
+    }
+
+    // Returns the counters of the entity, registering it on first use. Counters are never removed
+    // so that concurrent readers can traverse the list without locking.
+    [[nodiscard]] QOrmPrivate::EntityCounters& entity(const QOrmMetadata& metadata);
+
+    void recordStatement(const QOrmMetadata& metadata,
+                         QOrm::Operation operation,
+                         qint64 nsecs,
+                         qint64 rowsRead,
+                         qint64 rowsWritten);
+    void recordHydration(const QOrmMetadata& metadata, qint64 nsecs);
+    void recordCacheLookup(const QOrmMetadata& metadata, bool hit);
+
+    // Counts the executions of the statement by the current thread in the current transaction or
+    // event loop turn and warns once it exceeds the N+1 threshold. The reference is the property
+    // being resolved by the statement, if any.
+    void recordReadStatement(const QString& statement, const QOrmPropertyMapping* reference);
+    void resetStatementShapes();
+
+    // Returns the counters of the statement shape, registering it on first use, or nullptr if
+    // there are too many shapes. Counters are never removed.
+    [[nodiscard]] QOrmPrivate::StatementCounters* statement(const QString& statement);
+    // The counters may be nullptr, then only the totals are updated
+    void recordStatementStatus(QOrmPrivate::StatementCounters* counters,
+                               const QOrmPrivate::StatementStatus& status);
+    // Adds the increases of the page cache counters of a connection since its last report
+    void recordDatabaseStatus(qint64 pageCacheHits, qint64 pageCacheMisses, qint64 pageCacheUsed);
+
+    std::atomic<QOrmPrivate::EntityCounters*> m_entities{nullptr};
+
+    std::atomic<qint64> m_schemaSyncChecks{0};
+    std::atomic<qint64> m_statementsPrepared{0};
+    std::atomic<qint64> m_slowStatements{0};
+    std::atomic<qint64> m_transactionsBegun{0};
+    std::atomic<qint64> m_transactionsCommitted{0};
+    std::atomic<qint64> m_transactionsRolledBack{0};
+    std::atomic<qint64> m_nPlusOneDetections{0};
+
+    std::atomic<int> m_nPlusOneThreshold{0};
+    // Every thread counts the statement shapes it executes on its own. A reset starts a new
+    // generation, which the threads pick up with their next read.
+    std::atomic<quint64> m_statementShapesGeneration{0};
+    std::atomic<bool> m_statementShapesResetPending{false};
+
+    // Statements beyond that many distinct shapes are not tracked individually
+    static constexpr int MaxStatementStatistics = 1024;
+
+    // Guards the registration of statement shapes. The counters are updated without locking.
+    QMutex m_statementRegistryMutex;
+    QHash<QString, QOrmPrivate::StatementCounters*> m_statementRegistry;
+    std::atomic<QOrmPrivate::StatementCounters*> m_statements{nullptr};
+    QOrmPrivate::StatementCounters m_statementTotals{QString{}};
+
+    std::atomic<qint64> m_pageCacheHits{0};
+    std::atomic<qint64> m_pageCacheMisses{0};
+    std::atomic<qint64> m_pageCacheUsed{0};
+    std::atomic<qint64> m_pageCacheHitsBaseline{0};
+    std::atomic<qint64> m_pageCacheMissesBaseline{0};
+
+    QTimer m_updateTimer;
+
+private:
+    [[nodiscard]] static QOrmEntityStatistics snapshot(const QOrmPrivate::EntityCounters& counters);
+    [[nodiscard]] static QOrmStatementStatistics snapshot(
+        const QOrmPrivate::StatementCounters& counters);
+};
+
+QT_END_NAMESPACE
+
+#endif // QORMSESSIONSTATISTICS_P_H
@@ -62,4 +62,158 @@ void QOrmSqliteConfiguration::setSchemaMode(SchemaMode schemaMode)
     m_schemaMode = schemaMode;
 }
 
+int QOrmSqliteConfiguration::slowQueryThreshold() const
+{
+    return m_slowQueryThreshold;
+}
+
+void QOrmSqliteConfiguration::setSlowQueryThreshold(int slowQueryThreshold)
+{
+    m_slowQueryThreshold = slowQueryThreshold;
+}
+
+bool QOrmSqliteConfiguration::redactSlowQueryParameters() const
+{
+    return m_redactSlowQueryParameters;
+}
+
+void QOrmSqliteConfiguration::setRedactSlowQueryParameters(bool redactSlowQueryParameters)
+{
+    m_redactSlowQueryParameters = redactSlowQueryParameters;
+}
+
+QString QOrmSqliteConfiguration::workloadLogFile() const
+{
+    return m_workloadLogFile;
+}
+
+void QOrmSqliteConfiguration::setWorkloadLogFile(const QString& workloadLogFile)
+{
+    m_workloadLogFile = workloadLogFile;
+}
+
+bool QOrmSqliteConfiguration::foreignKeys() const
+{
+    return m_foreignKeys;
+}
+
+void QOrmSqliteConfiguration::setForeignKeys(bool foreignKeys)
+{
+    m_foreignKeys = foreignKeys;
+}
+
+std::optional<QOrmSqliteConfiguration::JournalMode> QOrmSqliteConfiguration::journalMode() const
+{
+    return m_journalMode;
+}
+
+void QOrmSqliteConfiguration::setJournalMode(std::optional<JournalMode> journalMode)
+{
+    m_journalMode = journalMode;
+}
+
+std::optional<QOrmSqliteConfiguration::Synchronous> QOrmSqliteConfiguration::synchronous() const
+{
+    return m_synchronous;
+}
+
+void QOrmSqliteConfiguration::setSynchronous(std::optional<Synchronous> synchronous)
+{
+    m_synchronous = synchronous;
+}
+
+std::optional<int> QOrmSqliteConfiguration::cacheSize() const
+{
+    return m_cacheSize;
+}
+
+void QOrmSqliteConfiguration::setCacheSize(std::optional<int> cacheSize)
+{
+    m_cacheSize = cacheSize;
+}
+
+std::optional<qint64> QOrmSqliteConfiguration::mmapSize() const
+{
+    return m_mmapSize;
+}
+
+void QOrmSqliteConfiguration::setMmapSize(std::optional<qint64> mmapSize)
+{
+    m_mmapSize = mmapSize;
+}
+
+std::optional<QOrmSqliteConfiguration::TempStore> QOrmSqliteConfiguration::tempStore() const
+{
+    return m_tempStore;
+}
+
+void QOrmSqliteConfiguration::setTempStore(std::optional<TempStore> tempStore)
+{
+    m_tempStore = tempStore;
+}
+
+std::optional<int> QOrmSqliteConfiguration::pageSize() const
+{
+    return m_pageSize;
+}
+
+void QOrmSqliteConfiguration::setPageSize(std::optional<int> pageSize)
+{
+    m_pageSize = pageSize;
+}
+
+std::optional<int> QOrmSqliteConfiguration::walAutocheckpoint() const
+{
+    return m_walAutocheckpoint;
+}
+
+void QOrmSqliteConfiguration::setWalAutocheckpoint(std::optional<int> walAutocheckpoint)
+{
+    m_walAutocheckpoint = walAutocheckpoint;
+}
+
+std::optional<int> QOrmSqliteConfiguration::busyTimeout() const
+{
+    return m_busyTimeout;
+}
+
+void QOrmSqliteConfiguration::setBusyTimeout(std::optional<int> busyTimeout)
+{
+    m_busyTimeout = busyTimeout;
+}
+
+void QOrmSqliteConfiguration::applyPerformancePreset(PerformancePreset preset)
+{
+    m_journalMode = JournalMode::Wal;
+    m_busyTimeout = 5000;
+    m_pageSize.reset();
+
+    switch (preset)
+    {
+        case PerformancePreset::Durable:
+            m_synchronous = Synchronous::Full;
+            m_cacheSize.reset();
+            m_mmapSize.reset();
+            m_tempStore.reset();
+            m_walAutocheckpoint.reset();
+            break;
+
+        case PerformancePreset::Throughput:
+            m_synchronous = Synchronous::Normal;
+            m_cacheSize = -64 * 1024;
+            m_mmapSize = Q_INT64_C(256) * 1024 * 1024;
+            m_tempStore = TempStore::Memory;
+            m_walAutocheckpoint = 10000;
+            break;
+
+        case PerformancePreset::ReadMostly:
+            m_synchronous = Synchronous::Normal;
+            m_cacheSize = -128 * 1024;
+            m_mmapSize = Q_INT64_C(1024) * 1024 * 1024;
+            m_tempStore = TempStore::Memory;
+            m_walAutocheckpoint.reset();
+            break;
+    }
+}
+
 QT_END_NAMESPACE
@@ -24,6 +24,8 @@
 #include <QtCore/qstring.h>
 #include <QtOrm/qormglobal.h>
 
+#include <optional>
+
 QT_BEGIN_NAMESPACE
 
 class Q_ORM_EXPORT QOrmSqliteConfiguration
@@ -38,6 +40,45 @@ public:
         Append
     };
 
+    enum class JournalMode
+    {
+        Delete,
+        Truncate,
+        Persist,
+        Memory,
+        Wal,
+        Off
+    };
+
+    enum class Synchronous
+    {
+        Off,
+        Normal,
+        Full,
+        Extra
+    };
+
+    enum class TempStore
+    {
+        Default,
+        File,
+        Memory
+    };
+
+    // Sets of the performance settings below:
+    //  * Durable: WAL journal, synchronous FULL
+    //  * Throughput: WAL journal, synchronous NORMAL, 64 MiB page cache, 256 MiB memory map,
+    //    temporary tables in memory, less frequent checkpoints
+    //  * ReadMostly: WAL journal, synchronous NORMAL, 128 MiB page cache, 1 GiB memory map,
+    //    temporary tables in memory
+    // All presets wait up to 5 seconds for locks.
+    enum class PerformancePreset
+    {
+        Durable,
+        Throughput,
+        ReadMostly
+    };
+
 public:
     Q_REQUIRED_RESULT
     QString connectOptions() const;
@@ -55,11 +96,87 @@ public:
     SchemaMode schemaMode() const;
     void setSchemaMode(SchemaMode schemaMode);
 
+    // Statements running longer than the threshold in milliseconds are logged together with
+    // their query plan. A negative threshold disables the slow query log.
+    Q_REQUIRED_RESULT
+    int slowQueryThreshold() const;
+    void setSlowQueryThreshold(int slowQueryThreshold);
+
+    Q_REQUIRED_RESULT
+    bool redactSlowQueryParameters() const;
+    void setRedactSlowQueryParameters(bool redactSlowQueryParameters);
+
+    // If set, the executed statements and transaction boundaries are recorded into this file to
+    // be replayed with qtorm-replay.
+    Q_REQUIRED_RESULT
+    QString workloadLogFile() const;
+    void setWorkloadLogFile(const QString& workloadLogFile);
+
+    // If set, reference columns are declared with REFERENCES and the connection enforces the
+    // foreign key constraints.
+    Q_REQUIRED_RESULT
+    bool foreignKeys() const;
+    void setForeignKeys(bool foreignKeys);
+
+    // The performance settings are applied with PRAGMA statements whenever the provider connects.
+    // Unset values keep the SQLite defaults.
+    Q_REQUIRED_RESULT
+    std::optional<JournalMode> journalMode() const;
+    void setJournalMode(std::optional<JournalMode> journalMode);
+
+    Q_REQUIRED_RESULT
+    std::optional<Synchronous> synchronous() const;
+    void setSynchronous(std::optional<Synchronous> synchronous);
+
+    // Pages if positive, KiB if negative
+    Q_REQUIRED_RESULT
+    std::optional<int> cacheSize() const;
+    void setCacheSize(std::optional<int> cacheSize);
+
+    // Bytes
+    Q_REQUIRED_RESULT
+    std::optional<qint64> mmapSize() const;
+    void setMmapSize(std::optional<qint64> mmapSize);
+
+    Q_REQUIRED_RESULT
+    std::optional<TempStore> tempStore() const;
+    void setTempStore(std::optional<TempStore> tempStore);
+
+    // Bytes. Only applied to new databases.
+    Q_REQUIRED_RESULT
+    std::optional<int> pageSize() const;
+    void setPageSize(std::optional<int> pageSize);
+
+    // Pages
+    Q_REQUIRED_RESULT
+    std::optional<int> walAutocheckpoint() const;
+    void setWalAutocheckpoint(std::optional<int> walAutocheckpoint);
+
+    // Milliseconds
+    Q_REQUIRED_RESULT
+    std::optional<int> busyTimeout() const;
+    void setBusyTimeout(std::optional<int> busyTimeout);
+
+    // Overwrites the performance settings with the ones of the preset
+    void applyPerformancePreset(PerformancePreset preset);
+
 private:
     QString m_connectOptions;
     QString m_databaseName;
     bool m_verbose{false};
     SchemaMode m_schemaMode;
+    int m_slowQueryThreshold{-1};
+    bool m_redactSlowQueryParameters{false};
+    QString m_workloadLogFile;
+    bool m_foreignKeys{false};
+    std::optional<JournalMode> m_journalMode;
+    std::optional<Synchronous> m_synchronous;
+    std::optional<int> m_cacheSize;
+    std::optional<qint64> m_mmapSize;
+    std::optional<TempStore> m_tempStore;
+    std::optional<int> m_pageSize;
+    std::optional<int> m_walAutocheckpoint;
+    std::optional<int> m_busyTimeout;
 };
 
 QT_END_NAMESPACE
@@ -22,10 +22,12 @@
 #include "qormsqliteprovider.h"
 
 #include "qormclassproperty.h"
+#include "qormcursor.h"
 #include "qormentityinstancecache.h"
 #include "qormerror.h"
 #include "qormfilter.h"
 #include "qormfilterexpression.h"
+#include "qormindex.h"
 #include "qormmetadatacache.h"
 #include "qormorder.h"
 #include "qormpropertymapping.h"
@@ -33,26 +35,56 @@
 #include "qormqueryresult.h"
 #include "qormrelation.h"
 #include "qormsqliteconfiguration.h"
+#include "qormsessionstatistics_p.h"
 
 #include "qormglobal_p.h"
 #include "qormsqlitestatementgenerator_p.h"
+#include "qormtracer_p.h"
+#include "qormworkloadlog_p.h"
 
+#include <QtCore/qcryptographichash.h>
 #include <QtCore/qdebug.h>
+#include <QtCore/qelapsedtimer.h>
+#include <QtCore/qhash.h>
 #include <QtCore/qmetaobject.h>
 #include <QtCore/qobject.h>
+#include <QtCore/qpointer.h>
+#include <QtCore/qregularexpression.h>
 #include <QtCore/qscopeguard.h>
+#include <QtCore/qthread.h>
 #include <QtCore/quuid.h>
 #include <QtSql/qsqldatabase.h>
+#include <QtSql/qsqldriver.h>
 #include <QtSql/qsqlerror.h>
 #include <QtSql/qsqlfield.h>
 #include <QtSql/qsqlquery.h>
 #include <QtSql/qsqlrecord.h>
+#include <QtSql/qsqlresult.h>
+
+#include <algorithm>
+#include <memory>
+#include <optional>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#ifdef QTORM_HAVE_SQLITE3
+#include <sqlite3.h>
+#endif
 
 QT_BEGIN_NAMESPACE
 
+namespace QOrmPrivate
+{
+    std::atomic<bool> nativeSqliteApiDisabled{false};
+} // namespace QOrmPrivate
+
+class QOrmSqliteCursor;
+
 class QOrmSqliteProviderPrivate
 {
     Q_DECLARE_PUBLIC(QOrmSqliteProvider)
+    friend class QOrmSqliteCursor;
 
     explicit QOrmSqliteProviderPrivate(const QOrmSqliteConfiguration& configuration,
                                        QOrmSqliteProvider* parent)
@@ -60,16 +92,98 @@ class QOrmSqliteProviderPrivate
         , m_sqlConfiguration{configuration}
     {
         detectSqliteCapabilities();
+
+        if (m_sqlConfiguration.foreignKeys())
+        {
+            m_statementGenerator.setOptions(m_statementGenerator.options() |
+                                            QOrmSqliteStatementGenerator::WithForeignKeys);
+        }
     }
 
     QOrmSqliteProvider* q_ptr{nullptr};
-    QSqlDatabase m_database{QSqlDatabase::addDatabase("QSQLITE", "QtOrm")};
+    // Every provider has a connection of its own. The connection is added when connecting and can
+    // only be used by the thread that connected, or by any thread once that one has finished.
+    const QString m_connectionName{
+        QStringLiteral("QtOrm-%1").arg(QUuid::createUuid().toString(QUuid::WithoutBraces))};
+    QSqlDatabase m_database;
+    QPointer<QThread> m_connectionThread;
     QOrmSqliteConfiguration m_sqlConfiguration;
     QSet<QString> m_schemaSyncCache;
+    struct SchemaIndex
+    {
+        QString tableName;
+        QString statement;
+    };
+
+    struct SchemaSnapshot
+    {
+        QHash<QString, QSqlRecord> tables;
+        // Indexes created with CREATE INDEX, by index name
+        QHash<QString, SchemaIndex> indexes;
+        // Tables referenced by the columns of a table. Only read if foreign keys are enabled.
+        QHash<QString, QHash<QString, QString>> foreignKeys;
+    };
+
+    // Tables and indexes as seen by this connection. Loaded by the first schema check and kept up
+    // to date by the schema changes of the provider.
+    std::optional<SchemaSnapshot> m_schemaSnapshot;
+    // Fingerprints of the mappings the tables have last been synchronized with, by table name
+    std::optional<QHash<QString, QByteArray>> m_schemaFingerprints;
+    bool m_schemaFingerprintTableExists{false};
     int m_transactionCounter{0};
     QOrmSqliteStatementGenerator m_statementGenerator;
     QOrmSqliteProvider::SqliteCapabilities m_capabilities{QOrmSqliteProvider::NoCapabilities};
 
+    QOrmAbstractProvider::ChangeHandler m_changeHandler;
+    std::vector<std::optional<QOrmChange>> m_pendingChanges;
+    QHash<QPair<QString, qint64>, size_t> m_pendingChangeIndex;
+    QOrmChangeSet m_committedChanges;
+
+    QOrmSessionStatisticsPrivate* m_statistics{nullptr};
+    // Counters of the statement shapes executed by this connection
+    QHash<QString, QOrmPrivate::StatementCounters*> m_statementCounters;
+    // Page cache counters of the connection as last added to m_statistics. The statistics are
+    // shared with the connections of other threads and only receive the increases.
+    qint64 m_pageCacheHits{0};
+    qint64 m_pageCacheMisses{0};
+    qint64 m_pageCacheUsed{0};
+
+    // Rows inserted by insertRows() are reported by a single change instead of one per row
+    bool m_bulkInsertActive{false};
+
+    // The reference property being resolved by the nested reads of fillEntityInstance()
+    const QOrmPropertyMapping* m_resolvedReference{nullptr};
+
+    // The instances cached while a cursor reads a row, see QOrmSqliteCursor
+    struct RowInstances
+    {
+        std::vector<QObject*> created;
+        // A cached instance has been refilled and may refer to the created ones
+        bool hasOverwrittenCachedInstance{false};
+    };
+
+    RowInstances* m_rowInstances{nullptr};
+    // Open cursors are invalidated when disconnecting
+    QSet<QOrmSqliteCursor*> m_cursors;
+
+    // Upper bound of the rows inserted by one statement in insertRows()
+    static constexpr int MaxBulkInsertRowCount = 500;
+
+    // Full table scans in slow statements are reported for tables having at least that many rows
+    static constexpr qint64 LargeTableRowCount = 10000;
+
+    struct QueryPlan
+    {
+        QStringList details;
+        QStringList largeTableScans;
+    };
+
+    QHash<QString, QueryPlan> m_queryPlans;
+
+    // Shared with the other providers recording into the same file
+    std::shared_ptr<QOrmPrivate::WorkloadLogWriter> m_workloadLog;
+    quint32 m_workloadLogConnection{0};
+
     Q_REQUIRED_RESULT
     QString toSqlType(QVariant::Type type);
     [[nodiscard]] bool canConvertFromSqliteToQProperty(QVariant::Type fromSqlType,
@@ -77,22 +191,58 @@ class QOrmSqliteProviderPrivate
 
     Q_REQUIRED_RESULT
     QOrmError lastDatabaseError() const;
+    [[nodiscard]] QOrmError checkConnectionThread() const;
+    void removeConnection();
 
     Q_REQUIRED_RESULT
     QSqlQuery prepareAndExecute(const QString& statement, const QVariantMap& parameters);
+    void recordSqliteStatus(const QString& statement, const QSqlQuery& query);
+    void checkSlowStatement(const QString& statement,
+                            const QVariantMap& parameters,
+                            qint64 nsecs,
+                            qint64 rows);
+    [[nodiscard]] QueryPlan explainQueryPlan(const QString& statement,
+                                             const QVariantMap& parameters);
 
     Q_REQUIRED_RESULT
     QOrmPrivate::Expected<QObject*, QOrmError> makeEntityInstance(
         const QOrmMetadata& entityMetadata,
         const QSqlRecord& record,
         QOrmEntityInstanceCache& entityInstanceCache);
+    // Makes an instance of the selected columns only which is not put into the cache
+    Q_REQUIRED_RESULT
+    QOrmPrivate::Expected<QObject*, QOrmError> makePartialEntityInstance(
+        const QOrmQuery& query,
+        const QSqlRecord& record,
+        QOrmEntityInstanceCache& entityInstanceCache);
     QOrmError fillEntityInstance(const QOrmMetadata& entityMetadata,
                                  QObject* entityInstance,
                                  const QSqlRecord& record,
                                  QOrmEntityInstanceCache& entityInstanceCache,
-                                 const QFlags<QOrm::QueryFlags>& queryFlags);
+                                 const QFlags<QOrm::QueryFlags>& queryFlags,
+                                 const std::vector<QOrmPropertyMapping>& columns = {});
+    // Returns the entity instance of a row read by the query, the cached one if possible
+    [[nodiscard]] QOrmPrivate::Expected<QObject*, QOrmError> rowInstance(
+        const QOrmQuery& query,
+        const QSqlRecord& record,
+        QOrmEntityInstanceCache& entityInstanceCache);
+    void invalidateCursors();
 
     QOrmError ensureSchemaSynchronized(const QOrmRelation& entityMetadata);
+    void collectUnsynchronizedEntities(const QOrmMetadata& entity,
+                                       std::vector<const QOrmMetadata*>& entities);
+    QOrmError synchronizeSchema(const QOrmMetadata& entity);
+    QOrmError loadSchemaSnapshot();
+    void loadSchemaFingerprints();
+    void storeSchemaFingerprint(const QString& tableName, const QByteArray& fingerprint);
+    [[nodiscard]] QByteArray schemaFingerprint(const QOrmMetadata& entity);
+    void refreshTableSchema(const QString& tableName);
+    [[nodiscard]] bool hasTable(const QString& tableName) const;
+    [[nodiscard]] QSqlRecord tableRecord(const QString& tableName) const;
+    [[nodiscard]] QHash<QString, SchemaIndex> tableIndexes(const QString& tableName) const;
+    [[nodiscard]] QHash<QString, QString> readForeignKeys(const QString& tableName);
+    [[nodiscard]] QString foreignKeyMismatch(const QOrmMetadata& entity) const;
+    QOrmError synchronizeIndexes(const QOrmMetadata& entity, bool dropObsoleteIndexes);
     QOrmError recreateSchema(const QOrmRelation& entityMetadata);
     QOrmError updateSchema(const QOrmRelation& entityMetadata);
     QOrmError validateSchema(const QOrmRelation& entityMetadata);
@@ -100,7 +250,16 @@ class QOrmSqliteProviderPrivate
 
     QOrmQueryResult<QObject> read(const QOrmQuery& query,
                                   QOrmEntityInstanceCache& entityInstanceCache);
+    void recordRead(const QOrmQuery& query,
+                    const QString& statement,
+                    const QVariantMap& boundParameters,
+                    qint64 executionTime,
+                    qint64 rowsRead,
+                    const QSqlQuery& sqlQuery);
     QOrmQueryResult<QObject> merge(const QOrmQuery& query);
+    QOrmError insertRows(const QOrmMetadata& relation,
+                         const std::vector<const QOrmPropertyMapping*>& columns,
+                         const QOrmAbstractProvider::RowSource& nextRow);
     QOrmQueryResult<QObject> remove(const QOrmQuery& query,
                                     QOrmEntityInstanceCache& entityInstanceCache);
 
@@ -108,6 +267,35 @@ class QOrmSqliteProviderPrivate
     [[nodiscard]] QOrmError setForeignKeysEnabled(bool enabled);
     [[nodiscard]] QOrmError checkForeignKeys();
     void detectSqliteCapabilities();
+
+    void applyPerformanceSettings();
+    void applyPragma(const QString& name, const QVariant& value);
+
+    void registerHooks();
+    void unregisterHooks();
+    // Withdraws the page cache of the connection from m_statistics
+    void resetDatabaseStatus();
+    void recordChange(const QString& tableName, QOrm::Operation operation, qint64 rowId);
+    void recordBulkInsert(const QString& tableName, qint64 rowCount);
+    void commitPendingChanges();
+    void discardPendingChanges();
+    void publishCommittedChanges();
+
+#ifdef QTORM_HAVE_SQLITE3
+    // Set if the QSQLITE driver uses the SQLite library QtOrm is linked against
+    bool m_hasNativeApi{false};
+
+    [[nodiscard]] bool checkNativeApi();
+    [[nodiscard]] sqlite3* sqliteHandle() const;
+
+    static void onUpdate(void* context,
+                         int operation,
+                         const char* databaseName,
+                         const char* tableName,
+                         sqlite3_int64 rowId);
+    static int onCommit(void* context);
+    static void onRollback(void* context);
+#endif
 };
 
 // Returns whether the data type stored in the database column is compatible with its QProperty
@@ -135,6 +323,29 @@ bool QOrmSqliteProviderPrivate::canConvertFromSqliteToQProperty(QVariant::Type f
     return QVariant{fromSqlType}.canConvert(toQPropertyType);
 }
 
+QOrmError QOrmSqliteProviderPrivate::checkConnectionThread() const
+{
+    if (m_database.isOpen() && m_connectionThread != QThread::currentThread() &&
+        !m_connectionThread.isNull() && !m_connectionThread->isFinished())
+    {
+        return QOrmError{QOrm::ErrorType::Provider,
+                         QStringLiteral("The connection %1 belongs to another thread")
+                             .arg(m_connectionName)};
+    }
+
+    return QOrmError{QOrm::ErrorType::None, {}};
+}
+
+void QOrmSqliteProviderPrivate::removeConnection()
+{
+    // The handle must be released before the connection is removed
+    m_database = QSqlDatabase{};
+    m_connectionThread = nullptr;
+
+    if (QSqlDatabase::contains(m_connectionName))
+        QSqlDatabase::removeDatabase(m_connectionName);
+}
+
 QOrmError QOrmSqliteProviderPrivate::lastDatabaseError() const
 {
     return QOrmError{QOrm::ErrorType::Provider, m_database.lastError().text()};
@@ -143,11 +354,21 @@ QOrmError QOrmSqliteProviderPrivate::lastDatabaseError() const
 QSqlQuery QOrmSqliteProviderPrivate::prepareAndExecute(const QString& statement,
                                                        const QVariantMap& parameters = {})
 {
+    QOrmPrivate::TraceSpan span{"QOrmSqliteProvider::prepareAndExecute"};
+
+    QElapsedTimer executionTimer;
+    executionTimer.start();
+
     QSqlQuery query{m_database};
+    // The rows are only stepped through forward: do not let the driver cache them
+    query.setForwardOnly(true);
 
     if (m_sqlConfiguration.verbose())
         qCDebug(qtorm).noquote() << "Executing:" << statement;
 
+    if (m_statistics != nullptr)
+        QOrmPrivate::increment(m_statistics->m_statementsPrepared);
+
     if (!query.prepare(statement))
         return query;
 
@@ -160,16 +381,201 @@ QSqlQuery QOrmSqliteProviderPrivate::prepareAndExecute(const QString& statement,
             query.bindValue(it.key(), it.value());
     }
 
-    query.exec();
+    // The rows of a SELECT are stepped through by the caller which checks the statement itself
+    if (query.exec() && !query.isSelect())
+    {
+        span.setRows(query.numRowsAffected());
+        qint64 nsecs = executionTimer.nsecsElapsed();
+
+        recordSqliteStatus(statement, query);
+        checkSlowStatement(statement, parameters, nsecs, query.numRowsAffected());
+
+        if (m_workloadLog != nullptr)
+        {
+            m_workloadLog->writeStatement(
+                m_workloadLogConnection, statement, parameters, {}, nsecs, query.numRowsAffected());
+        }
+    }
 
     return query;
 }
 
+// Collects the SQLite engine counters of the executed statement and of the connection
+void QOrmSqliteProviderPrivate::recordSqliteStatus(const QString& statement, const QSqlQuery& query)
+{
+#ifdef QTORM_HAVE_SQLITE3
+    if (m_statistics == nullptr || !m_hasNativeApi)
+        return;
+
+    // See https://doc.qt.io/qt-5/qsqlresult.html#handle
+    QVariant statementHandle = query.result()->handle();
+
+    if (statementHandle.isValid() && qstrcmp(statementHandle.typeName(), "sqlite3_stmt*") == 0)
+    {
+        if (auto* handle = *static_cast<sqlite3_stmt* const*>(statementHandle.data()))
+        {
+            QOrmPrivate::StatementStatus status;
+            status.fullScanSteps =
+                sqlite3_stmt_status(handle, SQLITE_STMTSTATUS_FULLSCAN_STEP, 0);
+            status.sorts = sqlite3_stmt_status(handle, SQLITE_STMTSTATUS_SORT, 0);
+            status.autoIndexRows = sqlite3_stmt_status(handle, SQLITE_STMTSTATUS_AUTOINDEX, 0);
+            status.vmSteps = sqlite3_stmt_status(handle, SQLITE_STMTSTATUS_VM_STEP, 0);
+#ifdef SQLITE_STMTSTATUS_MEMUSED
+            status.reprepares = sqlite3_stmt_status(handle, SQLITE_STMTSTATUS_REPREPARE, 0);
+            status.memoryUsed = sqlite3_stmt_status(handle, SQLITE_STMTSTATUS_MEMUSED, 0);
+#endif
+
+            auto counters = m_statementCounters.find(statement);
+
+            if (counters == std::end(m_statementCounters))
+            {
+                // Shapes beyond the limit are only counted in the totals
+                QOrmPrivate::StatementCounters* shape = m_statistics->statement(statement);
+
+                if (shape != nullptr)
+                    counters = m_statementCounters.insert(statement, shape);
+            }
+
+            m_statistics->recordStatementStatus(
+                counters != std::end(m_statementCounters) ? *counters : nullptr, status);
+        }
+    }
+
+    if (sqlite3* handle = sqliteHandle())
+    {
+        int pageCacheHits = 0;
+        int pageCacheMisses = 0;
+        int pageCacheUsed = 0;
+        int highwater = 0;
+
+        sqlite3_db_status(handle, SQLITE_DBSTATUS_CACHE_HIT, &pageCacheHits, &highwater, 0);
+        sqlite3_db_status(handle, SQLITE_DBSTATUS_CACHE_MISS, &pageCacheMisses, &highwater, 0);
+        sqlite3_db_status(handle, SQLITE_DBSTATUS_CACHE_USED, &pageCacheUsed, &highwater, 0);
+
+        m_statistics->recordDatabaseStatus(pageCacheHits - m_pageCacheHits,
+                                           pageCacheMisses - m_pageCacheMisses,
+                                           pageCacheUsed - m_pageCacheUsed);
+
+        m_pageCacheHits = pageCacheHits;
+        m_pageCacheMisses = pageCacheMisses;
+        m_pageCacheUsed = pageCacheUsed;
+    }
+#else
+    Q_UNUSED(statement)
+    Q_UNUSED(query)
+#endif
+}
+
+void QOrmSqliteProviderPrivate::checkSlowStatement(const QString& statement,
+                                                   const QVariantMap& parameters,
+                                                   qint64 nsecs,
+                                                   qint64 rows)
+{
+    int threshold = m_sqlConfiguration.slowQueryThreshold();
+
+    if (threshold < 0 || nsecs < threshold * qint64{1000000})
+        return;
+
+    if (m_statistics != nullptr)
+        QOrmPrivate::increment(m_statistics->m_slowStatements);
+
+    // statements are generated with bound parameters: the statement text identifies its shape
+    auto plan = m_queryPlans.find(statement);
+
+    if (plan == std::end(m_queryPlans))
+        plan = m_queryPlans.insert(statement, explainQueryPlan(statement, parameters));
+
+    QString message;
+
+    {
+        QDebug dbg{&message};
+        dbg.noquote().nospace() << "Slow statement (" << nsecs / 1000000.0 << " ms, " << rows
+                                << " rows): " << statement;
+
+        if (!parameters.isEmpty())
+        {
+            dbg << "\n  Bound parameters: ";
+
+            if (m_sqlConfiguration.redactSlowQueryParameters())
+                dbg << QStringList{parameters.keys()}.join(", ") << " (values redacted)";
+            else
+                dbg << parameters;
+        }
+
+        if (!plan->details.isEmpty())
+            dbg << "\n  Query plan:\n    " << plan->details.join("\n    ");
+
+        for (const QString& tableScan : qAsConst(plan->largeTableScans))
+            dbg << "\n  Full scan of a large table: " << tableScan;
+    }
+
+    qCWarning(qtorm).noquote() << message;
+}
+
+QOrmSqliteProviderPrivate::QueryPlan QOrmSqliteProviderPrivate::explainQueryPlan(
+    const QString& statement,
+    const QVariantMap& parameters)
+{
+    static const QRegularExpression explainableStatement{
+        R"(^\s*(SELECT|INSERT|UPDATE|DELETE|WITH)\b)",
+        QRegularExpression::CaseInsensitiveOption};
+
+    // "SCAN TABLE Town" before SQLite 3.36, "SCAN Town" since then. Scans using an index are not
+    // full table scans.
+    static const QRegularExpression fullTableScan{R"(^SCAN (?:TABLE )?(\S+)(?: AS \S+)?$)"};
+
+    QueryPlan plan;
+
+    if (!explainableStatement.match(statement).hasMatch())
+        return plan;
+
+    QSqlQuery query{m_database};
+
+    if (!query.prepare(QStringLiteral("EXPLAIN QUERY PLAN ") + statement))
+        return plan;
+
+    for (auto it = parameters.begin(); it != parameters.end(); ++it)
+        query.bindValue(it.key(), it.value());
+
+    if (!query.exec())
+        return plan;
+
+    while (query.next())
+    {
+        QString detail = query.value("detail").toString();
+        plan.details.push_back(detail);
+
+        QRegularExpressionMatch match = fullTableScan.match(detail);
+
+        if (!match.hasMatch())
+            continue;
+
+        // max(rowid) is a cheap estimate of the row count
+        QSqlQuery rowCountQuery = m_database.exec(
+            QStringLiteral(R"(SELECT max(rowid) FROM "%1")").arg(match.captured(1)));
+
+        qint64 rowCount = rowCountQuery.next() ? rowCountQuery.value(0).toLongLong() : 0;
+
+        if (rowCount >= LargeTableRowCount)
+            plan.largeTableScans.push_back(QStringLiteral("%1 (~%2 rows)")
+                                               .arg(match.captured(1))
+                                               .arg(rowCount));
+    }
+
+    return plan;
+}
+
 QOrmPrivate::Expected<QObject*, QOrmError> QOrmSqliteProviderPrivate::makeEntityInstance(
     const QOrmMetadata& entityMetadata,
     const QSqlRecord& record,
     QOrmEntityInstanceCache& entityInstanceCache)
 {
+    QOrmPrivate::TraceSpan span{"QOrmSqliteProvider::makeEntityInstance"};
+    span.setEntity(entityMetadata);
+
+    QElapsedTimer hydrationTimer;
+    hydrationTimer.start();
+
     QObject* entityInstance = entityMetadata.qMetaObject().newInstance();
     Q_ASSERT(entityInstance != nullptr);
 
@@ -185,6 +591,9 @@ QOrmPrivate::Expected<QObject*, QOrmError> QOrmSqliteProviderPrivate::makeEntity
 
     entityInstanceCache.insert(entityMetadata, entityInstance);
 
+    if (m_rowInstances != nullptr)
+        m_rowInstances->created.push_back(entityInstance);
+
     // fill the rest of the properties
     QOrmError fillError = fillEntityInstance(
         entityMetadata, entityInstance, record, entityInstanceCache, QOrm::QueryFlags::None);
@@ -194,18 +603,81 @@ QOrmPrivate::Expected<QObject*, QOrmError> QOrmSqliteProviderPrivate::makeEntity
 
     entityInstanceCache.finalize(entityMetadata, entityInstance);
 
+    if (m_statistics != nullptr)
+        m_statistics->recordHydration(entityMetadata, hydrationTimer.nsecsElapsed());
+
     return entityInstance;
 }
 
+QOrmPrivate::Expected<QObject*, QOrmError> QOrmSqliteProviderPrivate::makePartialEntityInstance(
+    const QOrmQuery& query,
+    const QSqlRecord& record,
+    QOrmEntityInstanceCache& entityInstanceCache)
+{
+    const QOrmMetadata& entityMetadata = *query.projection();
+
+    QOrmPrivate::TraceSpan span{"QOrmSqliteProvider::makePartialEntityInstance"};
+    span.setEntity(entityMetadata);
+
+    QElapsedTimer hydrationTimer;
+    hydrationTimer.start();
+
+    std::unique_ptr<QObject> entityInstance{entityMetadata.qMetaObject().newInstance()};
+    Q_ASSERT(entityInstance != nullptr);
+
+    if (entityMetadata.objectIdMapping() != nullptr &&
+        !QOrmPrivate::setPropertyValue(entityInstance.get(),
+                                       entityMetadata.objectIdMapping()->classPropertyName(),
+                                       record.value(
+                                           entityMetadata.objectIdMapping()->tableFieldName())))
+    {
+        Q_ORM_UNEXPECTED_STATE;
+    }
+
+    QOrmError fillError = fillEntityInstance(entityMetadata,
+                                             entityInstance.get(),
+                                             record,
+                                             entityInstanceCache,
+                                             query.flags(),
+                                             query.columns());
+
+    if (fillError != QOrm::ErrorType::None)
+        return QOrmPrivate::makeUnexpected(fillError);
+
+    QStringList classProperties;
+
+    for (const QOrmPropertyMapping& column : query.columns())
+        classProperties.push_back(column.classPropertyName());
+
+    QOrmPrivate::markPartialInstance(entityInstance.get(), classProperties);
+
+    if (m_statistics != nullptr)
+        m_statistics->recordHydration(entityMetadata, hydrationTimer.nsecsElapsed());
+
+    return entityInstance.release();
+}
+
 QOrmError QOrmSqliteProviderPrivate::fillEntityInstance(
     const QOrmMetadata& entityMetadata,
     QObject* entityInstance,
     const QSqlRecord& record,
     QOrmEntityInstanceCache& entityInstanceCache,
-    const QFlags<QOrm::QueryFlags>& queryFlags)
+    const QFlags<QOrm::QueryFlags>& queryFlags,
+    const std::vector<QOrmPropertyMapping>& columns)
 {
     for (const QOrmPropertyMapping& mapping : entityMetadata.propertyMappings())
     {
+        // partial instance: fill only the selected columns, the object ID is already set
+        if (!columns.empty() &&
+            std::none_of(std::cbegin(columns),
+                         std::cend(columns),
+                         [&mapping](const QOrmPropertyMapping& column) {
+                             return column.classPropertyName() == mapping.classPropertyName();
+                         }))
+        {
+            continue;
+        }
+
         // if this property is a reference, retrieve referenced entity instances and assign
         if (mapping.isReference())
         {
@@ -236,7 +708,10 @@ QOrmError QOrmSqliteProviderPrivate::fillEntityInstance(
                                 {},
                                 queryFlags};
 
+                const QOrmPropertyMapping* resolvedReference =
+                    std::exchange(m_resolvedReference, &mapping);
                 QOrmQueryResult<QObject> result = read(query, entityInstanceCache);
+                m_resolvedReference = resolvedReference;
 
                 // error during read: return this error and do not continue
                 if (result.error().type() != QOrm::ErrorType::None)
@@ -280,6 +755,12 @@ QOrmError QOrmSqliteProviderPrivate::fillEntityInstance(
                 QObject* referencedEntityInstance =
                     entityInstanceCache.get(*mapping.referencedEntity(), referencedObjectId);
 
+                if (m_statistics != nullptr)
+                {
+                    m_statistics->recordCacheLookup(*mapping.referencedEntity(),
+                                                    referencedEntityInstance != nullptr);
+                }
+
                 // referenced instance is in cache: check that it wasn't modified and assign to the
                 // corresponding property
                 if (referencedEntityInstance != nullptr)
@@ -312,7 +793,10 @@ QOrmError QOrmSqliteProviderPrivate::fillEntityInstance(
                                     {},
                                     queryFlags};
 
+                    const QOrmPropertyMapping* resolvedReference =
+                        std::exchange(m_resolvedReference, &mapping);
                     QOrmQueryResult<QObject> result = read(query, entityInstanceCache);
+                    m_resolvedReference = resolvedReference;
 
                     // error during read: return this error and do not continue
                     if (result.error().type() != QOrm::ErrorType::None)
@@ -365,175 +849,622 @@ QOrmError QOrmSqliteProviderPrivate::fillEntityInstance(
     return QOrmError{QOrm::ErrorType::None, {}};
 }
 
-QOrmError QOrmSqliteProviderPrivate::ensureSchemaSynchronized(const QOrmRelation& relation)
+// Mirrors the column type mapping of QSQLiteDriver::record()
+static QVariant::Type sqliteColumnType(const QString& declaredType)
 {
-    switch (relation.type())
-    {
-        case QOrm::RelationType::Mapping:
-        {
-            Q_ASSERT(relation.mapping() != nullptr);
+    QString typeName = declaredType.toLower();
 
-            if (m_schemaSyncCache.contains(relation.mapping()->className()))
-                return {QOrm::ErrorType::None, ""};
+    if (typeName == QLatin1String("integer") || typeName == QLatin1String("int"))
+        return QVariant::Int;
 
-            QOrmError error{QOrm::ErrorType::None, {}};
+    if (typeName == QLatin1String("double") || typeName == QLatin1String("float") ||
+        typeName == QLatin1String("real") || typeName.startsWith(QLatin1String("numeric")))
+    {
+        return QVariant::Double;
+    }
 
-            QOrmSqliteConfiguration::SchemaMode effectiveSchemaMode =
-                m_sqlConfiguration.schemaMode();
+    if (typeName == QLatin1String("blob"))
+        return QVariant::ByteArray;
 
-            if (relation.mapping()->userMetadata().contains(QOrm::Keyword::Schema))
-            {
-                static QMap<QString, QOrmSqliteConfiguration::SchemaMode> schemaModes{
-                    {"recreate", QOrmSqliteConfiguration::SchemaMode::Recreate},
-                    {"update", QOrmSqliteConfiguration::SchemaMode::Update},
-                    {"validate", QOrmSqliteConfiguration::SchemaMode::Validate},
-                    {"bypass", QOrmSqliteConfiguration::SchemaMode::Bypass},
-                    {"append", QOrmSqliteConfiguration::SchemaMode::Append}};
+    if (typeName == QLatin1String("boolean") || typeName == QLatin1String("bool"))
+        return QVariant::Bool;
 
-                QString schemaModeValue =
-                    relation.mapping()->userMetadata().value(QOrm::Keyword::Schema).toString();
+    return QVariant::String;
+}
 
-                if (!schemaModes.contains(schemaModeValue))
-                {
-                    qFatal("QtOrm: Unsupported schema mode in %s: Q_ORM_CLASS(SCHEMA %s)",
-                           qPrintable(relation.mapping()->className()),
-                           qPrintable(schemaModeValue));
-                }
-                else
-                {
-                    effectiveSchemaMode = schemaModes.value(schemaModeValue);
-                }
-            }
+// Indexes with this prefix are created from the entity metadata and dropped in update mode once
+// they are no longer declared
+static const QString OwnIndexPrefix = QStringLiteral("qtorm_");
 
-            switch (effectiveSchemaMode)
-            {
-                case QOrmSqliteConfiguration::SchemaMode::Recreate:
-                    error = recreateSchema(relation);
-                    break;
+// Whitespace may differ between the generated statement and the one stored by SQLite
+static bool isSameIndexStatement(const QString& lhs, const QString& rhs)
+{
+    return lhs.simplified() == rhs.simplified();
+}
 
-                case QOrmSqliteConfiguration::SchemaMode::Update:
-                    error = updateSchema(relation);
-                    break;
+// Reads the columns of all tables with a single query instead of enumerating the catalogue and
+// reading every table separately.
+QOrmError QOrmSqliteProviderPrivate::loadSchemaSnapshot()
+{
+    if (m_schemaSnapshot.has_value())
+        return QOrmError{QOrm::ErrorType::None, {}};
 
-                case QOrmSqliteConfiguration::SchemaMode::Validate:
-                    error = validateSchema(relation);
-                    break;
+    QOrmPrivate::TraceSpan span{"QOrmSqliteProvider::loadSchemaSnapshot"};
 
-                case QOrmSqliteConfiguration::SchemaMode::Bypass:
-                    // no error
-                    break;
+    SchemaSnapshot snapshot;
+    QHash<QString, QSqlRecord>& tables = snapshot.tables;
 
-                case QOrmSqliteConfiguration::SchemaMode::Append:
-                    error = appendSchema(relation);
-                    break;
-            }
+    QSqlQuery query = prepareAndExecute(
+        R"(SELECT m."name", p."name", p."type" FROM "sqlite_master" AS m )"
+        R"(JOIN pragma_table_info(m."name") AS p WHERE m."type" = 'table' )"
+        R"(ORDER BY m."name", p."cid")");
 
-            if (error.type() == QOrm::ErrorType::None)
-            {
-                m_schemaSyncCache.insert(relation.mapping()->className());
+    if (query.isActive())
+    {
+        while (query.next())
+        {
+            tables[query.value(0).toString()].append(
+                QSqlField{query.value(1).toString(), sqliteColumnType(query.value(2).toString())});
+        }
+    }
+    else
+    {
+        // Table-valued pragma functions are available since SQLite 3.16
+        for (const QString& tableName : m_database.tables())
+            tables.insert(tableName, m_database.record(tableName));
 
-                for (const QOrmPropertyMapping& propertyMapping :
-                     relation.mapping()->propertyMappings())
-                {
-                    if (propertyMapping.isReference())
-                    {
-                        QOrmError referencedError = ensureSchemaSynchronized(
-                            QOrmRelation{*propertyMapping.referencedEntity()});
+        if (m_database.lastError().type() != QSqlError::NoError)
+            return QOrmError{QOrm::ErrorType::UnsynchronizedSchema, m_database.lastError().text()};
+    }
 
-                        if (referencedError.type() != QOrm::ErrorType::None)
-                            return referencedError;
-                    }
-                }
-            }
+    if (m_sqlConfiguration.foreignKeys())
+    {
+        query = prepareAndExecute(
+            R"(SELECT m."name", f."from", f."table" FROM "sqlite_master" AS m )"
+            R"(JOIN pragma_foreign_key_list(m."name") AS f WHERE m."type" = 'table')");
 
-            return error;
+        if (query.isActive())
+        {
+            while (query.next())
+            {
+                snapshot.foreignKeys[query.value(0).toString()].insert(query.value(1).toString(),
+                                                                       query.value(2).toString());
+            }
+        }
+        else
+        {
+            for (auto it = tables.begin(); it != tables.end(); ++it)
+                snapshot.foreignKeys.insert(it.key(), readForeignKeys(it.key()));
         }
+    }
 
-        case QOrm::RelationType::Query:
-            Q_ASSERT(relation.query() != nullptr);
-            return ensureSchemaSynchronized(relation.query()->relation());
+    // Indexes backing PRIMARY KEY and UNIQUE constraints have no statement
+    query = prepareAndExecute(R"(SELECT "name", "tbl_name", "sql" FROM "sqlite_master" )"
+                              R"(WHERE "type" = 'index' AND "sql" IS NOT NULL)");
+
+    if (!query.isActive())
+        return QOrmError{QOrm::ErrorType::UnsynchronizedSchema, query.lastError().text()};
+
+    while (query.next())
+    {
+        snapshot.indexes.insert(query.value(0).toString(),
+                                SchemaIndex{query.value(1).toString(), query.value(2).toString()});
     }
 
-    Q_ORM_UNEXPECTED_STATE;
+    span.setRows(tables.size());
+    m_schemaSnapshot = std::move(snapshot);
+
+    return QOrmError{QOrm::ErrorType::None, {}};
 }
 
-QOrmError QOrmSqliteProviderPrivate::recreateSchema(const QOrmRelation& relation)
+// Bump whenever the way the mappings are turned into tables changes
+static constexpr int SchemaFingerprintVersion = 1;
+static const QString SchemaFingerprintTable = QStringLiteral("qtorm_schema");
+
+QByteArray QOrmSqliteProviderPrivate::schemaFingerprint(const QOrmMetadata& entity)
 {
-    Q_ASSERT(m_database.isOpen());
-    Q_ASSERT(relation.type() == QOrm::RelationType::Mapping);
-    Q_ASSERT(relation.mapping() != nullptr);
+    QString definition = QString::number(SchemaFingerprintVersion) + QLatin1Char('\n') +
+                         m_statementGenerator.generateCreateTableStatement(entity);
 
-    if (m_database.tables().contains(relation.mapping()->tableName()))
+    for (const QOrmIndex& index : entity.indexes())
     {
-        QString statement = m_statementGenerator.generateDropTableStatement(*relation.mapping());
+        definition += QLatin1Char('\n') +
+                      m_statementGenerator.generateCreateIndexStatement(entity, index);
+    }
 
-        QSqlQuery query = prepareAndExecute(statement);
+    return QCryptographicHash::hash(definition.toUtf8(), QCryptographicHash::Sha1).toHex();
+}
 
-        if (query.lastError().type() != QSqlError::NoError)
-            return QOrmError{QOrm::ErrorType::UnsynchronizedSchema, query.lastError().text()};
-    }
+void QOrmSqliteProviderPrivate::loadSchemaFingerprints()
+{
+    if (m_schemaFingerprints.has_value())
+        return;
 
-    QString statement = m_statementGenerator.generateCreateTableStatement(*relation.mapping());
+    QOrmPrivate::TraceSpan span{"QOrmSqliteProvider::loadSchemaFingerprints"};
 
-    QSqlQuery query = prepareAndExecute(statement);
+    QHash<QString, QByteArray> fingerprints;
 
-    if (query.lastError().type() != QSqlError::NoError)
-        return QOrmError{QOrm::ErrorType::UnsynchronizedSchema, query.lastError().text()};
+    QSqlQuery query =
+        prepareAndExecute(QStringLiteral(R"(SELECT "tableName", "fingerprint" FROM %1)")
+                              .arg(m_statementGenerator.escapeIdentifier(SchemaFingerprintTable)));
+
+    // The table does not exist until the first fingerprint is stored
+    m_schemaFingerprintTableExists = query.isActive();
+
+    while (query.next())
+        fingerprints.insert(query.value(0).toString(), query.value(1).toByteArray());
 
-    return QOrmError{QOrm::ErrorType::None, ""};
+    span.setRows(fingerprints.size());
+    m_schemaFingerprints = std::move(fingerprints);
 }
 
-QOrmError QOrmSqliteProviderPrivate::updateSchema(const QOrmRelation& relation)
+void QOrmSqliteProviderPrivate::storeSchemaFingerprint(const QString& tableName,
+                                                        const QByteArray& fingerprint)
 {
-    Q_ASSERT(m_database.isOpen());
-    Q_ASSERT(relation.type() == QOrm::RelationType::Mapping);
-    Q_ASSERT(relation.mapping() != nullptr);
+    Q_ASSERT(m_schemaFingerprints.has_value());
 
-    Q_Q(QOrmSqliteProvider);
+    QString escapedTableName = m_statementGenerator.escapeIdentifier(SchemaFingerprintTable);
 
-    // Create table if it does not exist.
-    if (!m_database.tables().contains(relation.mapping()->tableName()))
+    if (!m_schemaFingerprintTableExists)
     {
-        q->beginTransaction();
-
-        QString statement = m_statementGenerator.generateCreateTableStatement(*relation.mapping());
-        QSqlQuery query = prepareAndExecute(statement);
+        QSqlQuery query = prepareAndExecute(
+            QStringLiteral(R"(CREATE TABLE IF NOT EXISTS %1)"
+                           R"(("tableName" TEXT PRIMARY KEY, "fingerprint" TEXT NOT NULL))")
+                .arg(escapedTableName));
 
         if (query.lastError().type() != QSqlError::NoError)
         {
-            q->rollbackTransaction();
-            return QOrmError{QOrm::ErrorType::UnsynchronizedSchema, query.lastError().text()};
+            qCWarning(qtorm) << "Unable to store the schema fingerprint of" << tableName << ":"
+                             << query.lastError().text();
+            return;
         }
 
-        q->commitTransaction();
+        m_schemaFingerprintTableExists = true;
     }
-    // If the table exists, check if an update is needed. An update is needed if not all columns
-    // appear in both the database and the entity metadata, or if their data types are not
-    // compatible.
-    else
+
+    QSqlQuery query = prepareAndExecute(
+        QStringLiteral(R"(INSERT OR REPLACE INTO %1("tableName", "fingerprint") )"
+                       R"(VALUES(:tableName, :fingerprint))")
+            .arg(escapedTableName),
+        {{":tableName", tableName}, {":fingerprint", QString::fromLatin1(fingerprint)}});
+
+    if (query.lastError().type() != QSqlError::NoError)
     {
-        bool updateNeeded = false;
-        QSqlRecord record = m_database.record(relation.mapping()->tableName());
+        qCWarning(qtorm) << "Unable to store the schema fingerprint of" << tableName << ":"
+                         << query.lastError().text();
+        return;
+    }
 
-        // Check if all table columns are mapped by non-transient class properties, and there data
-        // types are compatible.
-        for (int i = 0; i < record.count() && !updateNeeded; ++i)
-        {
-            QSqlField field = record.field(i);
+    m_schemaFingerprints->insert(tableName, fingerprint);
+}
 
-            const QOrmPropertyMapping* mapping =
-                relation.mapping()->tableFieldMapping(field.name());
+void QOrmSqliteProviderPrivate::refreshTableSchema(const QString& tableName)
+{
+    if (!m_schemaSnapshot.has_value())
+        return;
 
-            if (mapping == nullptr)
-            {
-                qCDebug(qtorm).noquote().nospace()
-                    << "updating table " << relation.mapping()->tableName() << ": field "
-                    << field.name() << " has no mapping in entity "
-                    << relation.mapping()->className();
-                updateNeeded = true;
-            }
-            else if (mapping->isTransient())
-            {
+    QSqlRecord record = m_database.record(tableName);
+
+    if (record.isEmpty())
+        m_schemaSnapshot->tables.remove(tableName);
+    else
+        m_schemaSnapshot->tables.insert(tableName, record);
+
+    if (m_sqlConfiguration.foreignKeys())
+        m_schemaSnapshot->foreignKeys.insert(tableName, readForeignKeys(tableName));
+
+    for (auto it = m_schemaSnapshot->indexes.begin(); it != m_schemaSnapshot->indexes.end();)
+    {
+        if (it->tableName == tableName)
+            it = m_schemaSnapshot->indexes.erase(it);
+        else
+            ++it;
+    }
+
+    QSqlQuery query = prepareAndExecute(R"(SELECT "name", "sql" FROM "sqlite_master" )"
+                                        R"(WHERE "type" = 'index' AND "sql" IS NOT NULL )"
+                                        R"(AND "tbl_name" = :tableName)",
+                                        {{":tableName", tableName}});
+
+    while (query.next())
+    {
+        m_schemaSnapshot->indexes.insert(query.value(0).toString(),
+                                         SchemaIndex{tableName, query.value(1).toString()});
+    }
+}
+
+bool QOrmSqliteProviderPrivate::hasTable(const QString& tableName) const
+{
+    Q_ASSERT(m_schemaSnapshot.has_value());
+
+    return m_schemaSnapshot->tables.contains(tableName);
+}
+
+QSqlRecord QOrmSqliteProviderPrivate::tableRecord(const QString& tableName) const
+{
+    Q_ASSERT(m_schemaSnapshot.has_value());
+
+    return m_schemaSnapshot->tables.value(tableName);
+}
+
+QHash<QString, QOrmSqliteProviderPrivate::SchemaIndex> QOrmSqliteProviderPrivate::tableIndexes(
+    const QString& tableName) const
+{
+    Q_ASSERT(m_schemaSnapshot.has_value());
+
+    QHash<QString, SchemaIndex> result;
+
+    for (auto it = m_schemaSnapshot->indexes.begin(); it != m_schemaSnapshot->indexes.end(); ++it)
+    {
+        if (it->tableName == tableName)
+            result.insert(it.key(), it.value());
+    }
+
+    return result;
+}
+
+QHash<QString, QString> QOrmSqliteProviderPrivate::readForeignKeys(const QString& tableName)
+{
+    QHash<QString, QString> foreignKeys;
+
+    QSqlQuery query = prepareAndExecute(
+        QStringLiteral("PRAGMA foreign_key_list(%1)")
+            .arg(m_statementGenerator.escapeIdentifier(tableName)));
+
+    while (query.next())
+        foreignKeys.insert(query.value("from").toString(), query.value("table").toString());
+
+    return foreignKeys;
+}
+
+// Describes the first reference column of the entity that lacks its foreign key constraint, if
+// foreign keys are enabled
+QString QOrmSqliteProviderPrivate::foreignKeyMismatch(const QOrmMetadata& entity) const
+{
+    Q_ASSERT(m_schemaSnapshot.has_value());
+
+    if (!m_sqlConfiguration.foreignKeys())
+        return {};
+
+    QHash<QString, QString> foreignKeys = m_schemaSnapshot->foreignKeys.value(entity.tableName());
+
+    for (const QOrmPropertyMapping& mapping : entity.propertyMappings())
+    {
+        if (!mapping.isReference() || mapping.isTransient())
+            continue;
+
+        if (foreignKeys.value(mapping.tableFieldName()) != mapping.referencedEntity()->tableName())
+        {
+            return QStringLiteral("field %1.%2 does not reference table %3")
+                .arg(entity.tableName(),
+                     mapping.tableFieldName(),
+                     mapping.referencedEntity()->tableName());
+        }
+    }
+
+    return {};
+}
+
+// Creates the declared indexes that are missing. In update mode, indexes that differ from their
+// declaration are recreated and indexes that are no longer declared are dropped.
+QOrmError QOrmSqliteProviderPrivate::synchronizeIndexes(const QOrmMetadata& entity,
+                                                        bool dropObsoleteIndexes)
+{
+    Q_Q(QOrmSqliteProvider);
+
+    QHash<QString, SchemaIndex> existingIndexes = tableIndexes(entity.tableName());
+    QStringList statements;
+
+    for (const QOrmIndex& index : entity.indexes())
+    {
+        QString statement = m_statementGenerator.generateCreateIndexStatement(entity, index);
+        auto it = existingIndexes.find(index.name());
+
+        if (it != existingIndexes.end())
+        {
+            bool isUpToDate = isSameIndexStatement(it->statement, statement);
+            existingIndexes.erase(it);
+
+            if (isUpToDate || !dropObsoleteIndexes)
+                continue;
+
+            statements.push_back(m_statementGenerator.generateDropIndexStatement(index.name()));
+        }
+
+        statements.push_back(statement);
+    }
+
+    if (dropObsoleteIndexes)
+    {
+        for (auto it = existingIndexes.begin(); it != existingIndexes.end(); ++it)
+        {
+            if (it.key().startsWith(OwnIndexPrefix))
+                statements.push_back(m_statementGenerator.generateDropIndexStatement(it.key()));
+        }
+    }
+
+    if (statements.isEmpty())
+        return QOrmError{QOrm::ErrorType::None, {}};
+
+    QOrmError error = q->beginTransaction();
+
+    if (error.type() != QOrm::ErrorType::None)
+        return QOrmError{QOrm::ErrorType::UnsynchronizedSchema, error.text()};
+
+    for (const QString& statement : statements)
+    {
+        QSqlQuery query = prepareAndExecute(statement);
+
+        if (query.lastError().type() != QSqlError::NoError)
+        {
+            q->rollbackTransaction();
+            return QOrmError{QOrm::ErrorType::UnsynchronizedSchema, query.lastError().text()};
+        }
+    }
+
+    error = q->commitTransaction();
+
+    if (error.type() != QOrm::ErrorType::None)
+        return QOrmError{QOrm::ErrorType::UnsynchronizedSchema, error.text()};
+
+    refreshTableSchema(entity.tableName());
+
+    return QOrmError{QOrm::ErrorType::None, {}};
+}
+
+// Collects the entity and the entities reachable through its references, unless they have been
+// synchronized already
+void QOrmSqliteProviderPrivate::collectUnsynchronizedEntities(
+    const QOrmMetadata& entity,
+    std::vector<const QOrmMetadata*>& entities)
+{
+    if (m_schemaSyncCache.contains(entity.className()) ||
+        std::any_of(entities.begin(), entities.end(), [&entity](const QOrmMetadata* collected) {
+            return collected->className() == entity.className();
+        }))
+    {
+        return;
+    }
+
+    entities.push_back(&entity);
+
+    for (const QOrmPropertyMapping& propertyMapping : entity.propertyMappings())
+    {
+        if (propertyMapping.isReference())
+            collectUnsynchronizedEntities(*propertyMapping.referencedEntity(), entities);
+    }
+}
+
+QOrmError QOrmSqliteProviderPrivate::ensureSchemaSynchronized(const QOrmRelation& relation)
+{
+    if (m_statistics != nullptr)
+        QOrmPrivate::increment(m_statistics->m_schemaSyncChecks);
+
+    switch (relation.type())
+    {
+        case QOrm::RelationType::Mapping:
+        {
+            Q_ASSERT(relation.mapping() != nullptr);
+
+            if (m_schemaSyncCache.contains(relation.mapping()->className()))
+                return {QOrm::ErrorType::None, ""};
+
+            QOrmPrivate::TraceSpan span{"QOrmSqliteProvider::ensureSchemaSynchronized"};
+            span.setEntity(*relation.mapping());
+
+            // The entity and its referenced entities are checked in one pass against the same
+            // snapshot of the schema
+            std::vector<const QOrmMetadata*> entities;
+            collectUnsynchronizedEntities(*relation.mapping(), entities);
+
+            loadSchemaFingerprints();
+
+            QOrmError error{QOrm::ErrorType::None, {}};
+
+            for (const QOrmMetadata* entity : entities)
+            {
+                error = synchronizeSchema(*entity);
+
+                if (error.type() != QOrm::ErrorType::None)
+                {
+                    // A failed schema change may have been rolled back partially
+                    m_schemaSnapshot.reset();
+                    return error;
+                }
+
+                m_schemaSyncCache.insert(entity->className());
+            }
+
+            return error;
+        }
+
+        case QOrm::RelationType::Query:
+            Q_ASSERT(relation.query() != nullptr);
+            return ensureSchemaSynchronized(relation.query()->relation());
+    }
+
+    Q_ORM_UNEXPECTED_STATE;
+}
+
+QOrmError QOrmSqliteProviderPrivate::synchronizeSchema(const QOrmMetadata& entity)
+{
+    QOrmSqliteConfiguration::SchemaMode effectiveSchemaMode = m_sqlConfiguration.schemaMode();
+
+    if (entity.userMetadata().contains(QOrm::Keyword::Schema))
+    {
+        static QMap<QString, QOrmSqliteConfiguration::SchemaMode> schemaModes{
+            {"recreate", QOrmSqliteConfiguration::SchemaMode::Recreate},
+            {"update", QOrmSqliteConfiguration::SchemaMode::Update},
+            {"validate", QOrmSqliteConfiguration::SchemaMode::Validate},
+            {"bypass", QOrmSqliteConfiguration::SchemaMode::Bypass},
+            {"append", QOrmSqliteConfiguration::SchemaMode::Append}};
+
+        QString schemaModeValue = entity.userMetadata().value(QOrm::Keyword::Schema).toString();
+
+        if (!schemaModes.contains(schemaModeValue))
+        {
+            qFatal("QtOrm: Unsupported schema mode in %s: Q_ORM_CLASS(SCHEMA %s)",
+                   qPrintable(entity.className()),
+                   qPrintable(schemaModeValue));
+        }
+        else
+        {
+            effectiveSchemaMode = schemaModes.value(schemaModeValue);
+        }
+    }
+
+    if (effectiveSchemaMode == QOrmSqliteConfiguration::SchemaMode::Bypass)
+        return QOrmError{QOrm::ErrorType::None, {}};
+
+    Q_ASSERT(m_schemaFingerprints.has_value());
+
+    QByteArray fingerprint = schemaFingerprint(entity);
+
+    // The table has been synchronized with this very mapping before: skip the inspection
+    if (effectiveSchemaMode != QOrmSqliteConfiguration::SchemaMode::Recreate &&
+        m_schemaFingerprints->value(entity.tableName()) == fingerprint)
+    {
+        return QOrmError{QOrm::ErrorType::None, {}};
+    }
+
+    QOrmError error = loadSchemaSnapshot();
+
+    if (error.type() != QOrm::ErrorType::None)
+        return error;
+
+    QOrmRelation relation{entity};
+
+    switch (effectiveSchemaMode)
+    {
+        case QOrmSqliteConfiguration::SchemaMode::Recreate:
+            error = recreateSchema(relation);
+            break;
+
+        case QOrmSqliteConfiguration::SchemaMode::Update:
+            error = updateSchema(relation);
+            break;
+
+        case QOrmSqliteConfiguration::SchemaMode::Validate:
+            // Validation does not write to the database
+            return validateSchema(relation);
+
+        case QOrmSqliteConfiguration::SchemaMode::Bypass:
+            Q_ORM_UNEXPECTED_STATE;
+
+        case QOrmSqliteConfiguration::SchemaMode::Append:
+            error = appendSchema(relation);
+            break;
+    }
+
+    if (error.type() == QOrm::ErrorType::None)
+        storeSchemaFingerprint(entity.tableName(), fingerprint);
+
+    return error;
+}
+
+QOrmError QOrmSqliteProviderPrivate::recreateSchema(const QOrmRelation& relation)
+{
+    Q_ASSERT(m_database.isOpen());
+    Q_ASSERT(relation.type() == QOrm::RelationType::Mapping);
+    Q_ASSERT(relation.mapping() != nullptr);
+
+    if (hasTable(relation.mapping()->tableName()))
+    {
+        // The referencing tables are recreated after the referenced ones: dropping the latter must
+        // not trip the foreign key constraints of the former.
+        bool withForeignKeys = foreignKeysEnabled();
+
+        if (withForeignKeys)
+        {
+            QOrmError error = setForeignKeysEnabled(false);
+
+            if (error.type() != QOrm::ErrorType::None)
+                return {QOrm::ErrorType::UnsynchronizedSchema, error.text()};
+        }
+
+        QString statement = m_statementGenerator.generateDropTableStatement(*relation.mapping());
+
+        QSqlQuery query = prepareAndExecute(statement);
+
+        if (withForeignKeys)
+        {
+            QOrmError error = setForeignKeysEnabled(true);
+
+            if (error.type() != QOrm::ErrorType::None)
+                return {QOrm::ErrorType::UnsynchronizedSchema, error.text()};
+        }
+
+        if (query.lastError().type() != QSqlError::NoError)
+            return QOrmError{QOrm::ErrorType::UnsynchronizedSchema, query.lastError().text()};
+    }
+
+    QString statement = m_statementGenerator.generateCreateTableStatement(*relation.mapping());
+
+    QSqlQuery query = prepareAndExecute(statement);
+
+    if (query.lastError().type() != QSqlError::NoError)
+        return QOrmError{QOrm::ErrorType::UnsynchronizedSchema, query.lastError().text()};
+
+    refreshTableSchema(relation.mapping()->tableName());
+
+    return synchronizeIndexes(*relation.mapping(), true);
+}
+
+QOrmError QOrmSqliteProviderPrivate::updateSchema(const QOrmRelation& relation)
+{
+    Q_ASSERT(m_database.isOpen());
+    Q_ASSERT(relation.type() == QOrm::RelationType::Mapping);
+    Q_ASSERT(relation.mapping() != nullptr);
+
+    Q_Q(QOrmSqliteProvider);
+
+    // Create table if it does not exist.
+    if (!hasTable(relation.mapping()->tableName()))
+    {
+        QOrmError error = q->beginTransaction();
+
+        if (error.type() != QOrm::ErrorType::None)
+            return QOrmError{QOrm::ErrorType::UnsynchronizedSchema, error.text()};
+
+        QString statement = m_statementGenerator.generateCreateTableStatement(*relation.mapping());
+        QSqlQuery query = prepareAndExecute(statement);
+
+        if (query.lastError().type() != QSqlError::NoError)
+        {
+            q->rollbackTransaction();
+            return QOrmError{QOrm::ErrorType::UnsynchronizedSchema, query.lastError().text()};
+        }
+
+        q->commitTransaction();
+        refreshTableSchema(relation.mapping()->tableName());
+    }
+    // If the table exists, check if an update is needed. An update is needed if not all columns
+    // appear in both the database and the entity metadata, or if their data types are not
+    // compatible.
+    else
+    {
+        bool updateNeeded = false;
+        QSqlRecord record = tableRecord(relation.mapping()->tableName());
+
+        // Check if all table columns are mapped by non-transient class properties, and there data
+        // types are compatible.
+        for (int i = 0; i < record.count() && !updateNeeded; ++i)
+        {
+            QSqlField field = record.field(i);
+
+            const QOrmPropertyMapping* mapping =
+                relation.mapping()->tableFieldMapping(field.name());
+
+            if (mapping == nullptr)
+            {
+                qCDebug(qtorm).noquote().nospace()
+                    << "updating table " << relation.mapping()->tableName() << ": field "
+                    << field.name() << " has no mapping in entity "
+                    << relation.mapping()->className();
+                updateNeeded = true;
+            }
+            else if (mapping->isTransient())
+            {
                 qCDebug(qtorm).noquote().nospace()
                     << "updating table " << relation.mapping()->tableName() << ": field "
                     << field.name() << " is mapped to a transient property "
@@ -566,6 +1497,19 @@ QOrmError QOrmSqliteProviderPrivate::updateSchema(const QOrmRelation& relation)
             }
         }
 
+        // Check if the foreign key constraints are in place
+        if (!updateNeeded)
+        {
+            QString mismatch = foreignKeyMismatch(*relation.mapping());
+
+            if (!mismatch.isEmpty())
+            {
+                qCDebug(qtorm).noquote().nospace()
+                    << "updating table " << relation.mapping()->tableName() << ": " << mismatch;
+                updateNeeded = true;
+            }
+        }
+
         if (updateNeeded)
         {
             qCInfo(qtorm).noquote() << "Updating schema for" << relation.mapping()->className()
@@ -586,16 +1530,38 @@ QOrmError QOrmSqliteProviderPrivate::updateSchema(const QOrmRelation& relation)
             }
 
             // 2. Start a transaction.
-            q->beginTransaction();
+            error = q->beginTransaction();
+
+            if (error.type() != QOrm::ErrorType::None)
+                return {QOrm::ErrorType::UnsynchronizedSchema, error.text()};
 
             // 3. Remember the format of all indexes, triggers, and views associated with table X.
             //
-            // QtOrm does not support indexes, triggers, and views yet.
+            // The declared indexes are created from the metadata, other indexes are restored as
+            // they were. QtOrm does not support triggers and views yet.
+            QStringList indexStatements;
+
+            for (const QOrmIndex& index : relation.mapping()->indexes())
+            {
+                indexStatements.push_back(
+                    m_statementGenerator.generateCreateIndexStatement(*relation.mapping(), index));
+            }
+
+            int declaredIndexCount = indexStatements.size();
+            QHash<QString, SchemaIndex> existingIndexes =
+                tableIndexes(relation.mapping()->tableName());
+
+            for (auto it = existingIndexes.begin(); it != existingIndexes.end(); ++it)
+            {
+                if (!it.key().startsWith(OwnIndexPrefix))
+                    indexStatements.push_back(it->statement);
+            }
 
             // 4. Use CREATE TABLE to construct a new table "new_X" that is in the desired revised
             // format of table X
-            QString newTableName = QString{"%1_%2"}.arg(relation.mapping()->tableName(),
-                                                        QUuid::createUuid().toString(QUuid::Id128));
+            // The prefix keeps the copied rows out of the change notifications
+            QString newTableName = QString{"qtorm_%1_%2"}.arg(
+                relation.mapping()->tableName(), QUuid::createUuid().toString(QUuid::Id128));
             QString statement =
                 m_statementGenerator.generateCreateTableStatement(*relation.mapping(),
                                                                   newTableName);
@@ -649,10 +1615,26 @@ QOrmError QOrmSqliteProviderPrivate::updateSchema(const QOrmRelation& relation)
                 return {QOrm::ErrorType::UnsynchronizedSchema, query.lastError().text()};
             }
 
-            // 8. Use CREATE INDEX, CREATE TRIGGER, and CREATE VIEW to reconstruct indexes,
-            // triggers, and views associated with table X.
-            //
-            // QtOrm does not support indexes, triggers, and views yet.
+            // 8. Use CREATE INDEX, CREATE TRIGGER, and CREATE VIEW to reconstruct indexes,
+            // triggers, and views associated with table X.
+            for (int i = 0; i < indexStatements.size(); ++i)
+            {
+                query = prepareAndExecute(indexStatements[i]);
+
+                if (query.lastError().type() == QSqlError::NoError)
+                    continue;
+
+                if (i < declaredIndexCount)
+                {
+                    q->rollbackTransaction();
+                    return {QOrm::ErrorType::UnsynchronizedSchema, query.lastError().text()};
+                }
+
+                // An index on a removed column cannot be restored
+                qCWarning(qtorm).noquote()
+                    << "Dropping index of" << relation.mapping()->tableName() << ":"
+                    << indexStatements[i] << ":" << query.lastError().text();
+            }
 
             // 9. If any views refer to table X in a way that is affected by the schema change, then
             // drop those views using DROP VIEW and recreate them with whatever changes are
@@ -675,7 +1657,12 @@ QOrmError QOrmSqliteProviderPrivate::updateSchema(const QOrmRelation& relation)
             }
 
             // 11. Commit the transaction started in step 2.
-            m_database.commit();
+            error = q->commitTransaction();
+
+            if (error.type() != QOrm::ErrorType::None)
+                return {QOrm::ErrorType::UnsynchronizedSchema, error.text()};
+
+            refreshTableSchema(relation.mapping()->tableName());
 
             // 12. If foreign keys constraints were originally enabled, reenable them now.
             if (withForeignKeys)
@@ -683,22 +1670,88 @@ QOrmError QOrmSqliteProviderPrivate::updateSchema(const QOrmRelation& relation)
                 error = setForeignKeysEnabled(true);
 
                 if (error.type() != QOrm::ErrorType::None)
-                {
-                    q->rollbackTransaction();
                     return {QOrm::ErrorType::UnsynchronizedSchema, error.text()};
-                }
             }
         }
     }
 
-    return QOrmError{QOrm::ErrorType::None, {}};
+    return synchronizeIndexes(*relation.mapping(), true);
 }
 
 QOrmError QOrmSqliteProviderPrivate::validateSchema(const QOrmRelation& relation)
 {
-    Q_UNUSED(relation)
-    Q_ORM_NOT_IMPLEMENTED;
-    return {QOrm::ErrorType::Other, "Not implemented"};
+    Q_ASSERT(m_database.isOpen());
+    Q_ASSERT(relation.type() == QOrm::RelationType::Mapping);
+    Q_ASSERT(relation.mapping() != nullptr);
+
+    const QOrmMetadata& entity = *relation.mapping();
+
+    if (!hasTable(entity.tableName()))
+    {
+        return QOrmError{QOrm::ErrorType::UnsynchronizedSchema,
+                         QStringLiteral("Table %1 of entity %2 does not exist")
+                             .arg(entity.tableName(), entity.className())};
+    }
+
+    QSqlRecord record = tableRecord(entity.tableName());
+
+    for (const QOrmPropertyMapping& mapping : entity.propertyMappings())
+    {
+        if (mapping.isTransient())
+            continue;
+
+        if (!record.contains(mapping.tableFieldName()))
+        {
+            return QOrmError{QOrm::ErrorType::UnsynchronizedSchema,
+                             QStringLiteral("Table %1 has no field %2 mapped by %3::%4")
+                                 .arg(entity.tableName(),
+                                      mapping.tableFieldName(),
+                                      entity.className(),
+                                      mapping.classPropertyName())};
+        }
+
+        QVariant::Type dataType = mapping.isReference()
+                                      ? mapping.referencedEntity()->objectIdMapping()->dataType()
+                                      : mapping.dataType();
+
+        if (!canConvertFromSqliteToQProperty(record.field(mapping.tableFieldName()).type(),
+                                             dataType))
+        {
+            return QOrmError{QOrm::ErrorType::UnsynchronizedSchema,
+                             QStringLiteral("Data types of field %1.%2 and %3::%4 are incompatible")
+                                 .arg(entity.tableName(),
+                                      mapping.tableFieldName(),
+                                      entity.className(),
+                                      mapping.classPropertyName())};
+        }
+    }
+
+    QString mismatch = foreignKeyMismatch(entity);
+
+    if (!mismatch.isEmpty())
+    {
+        return QOrmError{QOrm::ErrorType::UnsynchronizedSchema,
+                         QStringLiteral("Foreign key constraint is missing: %1").arg(mismatch)};
+    }
+
+    QHash<QString, SchemaIndex> existingIndexes = tableIndexes(entity.tableName());
+
+    for (const QOrmIndex& index : entity.indexes())
+    {
+        auto it = existingIndexes.find(index.name());
+
+        if (it == existingIndexes.end() ||
+            !isSameIndexStatement(it->statement,
+                                  m_statementGenerator.generateCreateIndexStatement(entity, index)))
+        {
+            return QOrmError{QOrm::ErrorType::UnsynchronizedSchema,
+                             QStringLiteral("Index %1 of table %2 is missing or differs from its "
+                                            "declaration in %3")
+                                 .arg(index.name(), entity.tableName(), entity.className())};
+        }
+    }
+
+    return QOrmError{QOrm::ErrorType::None, {}};
 }
 
 QOrmError QOrmSqliteProviderPrivate::appendSchema(const QOrmRelation& relation)
@@ -709,10 +1762,15 @@ QOrmError QOrmSqliteProviderPrivate::appendSchema(const QOrmRelation& relation)
 
     Q_Q(QOrmSqliteProvider);
 
-    q->beginTransaction();
+    QOrmError beginError = q->beginTransaction();
+
+    if (beginError.type() != QOrm::ErrorType::None)
+        return QOrmError{QOrm::ErrorType::UnsynchronizedSchema, beginError.text()};
+
+    bool schemaChanged = false;
 
     // Create table if it does not exist.
-    if (!m_database.tables().contains(relation.mapping()->tableName()))
+    if (!hasTable(relation.mapping()->tableName()))
     {
         QString statement = m_statementGenerator.generateCreateTableStatement(*relation.mapping());
         QSqlQuery query = prepareAndExecute(statement);
@@ -722,11 +1780,13 @@ QOrmError QOrmSqliteProviderPrivate::appendSchema(const QOrmRelation& relation)
             q->rollbackTransaction();
             return QOrmError{QOrm::ErrorType::UnsynchronizedSchema, query.lastError().text()};
         }
+
+        schemaChanged = true;
     }
     // If the table exists, add missing columns, if any.
     else
     {
-        QSqlRecord record = m_database.record(relation.mapping()->tableName());
+        QSqlRecord record = tableRecord(relation.mapping()->tableName());
 
         for (const QOrmPropertyMapping& mapping : relation.mapping()->propertyMappings())
         {
@@ -744,13 +1804,83 @@ QOrmError QOrmSqliteProviderPrivate::appendSchema(const QOrmRelation& relation)
                     return QOrmError{QOrm::ErrorType::UnsynchronizedSchema,
                                      query.lastError().text()};
                 }
+
+                schemaChanged = true;
             }
         }
     }
 
     q->commitTransaction();
 
-    return QOrmError{QOrm::ErrorType::None, {}};
+    if (schemaChanged)
+        refreshTableSchema(relation.mapping()->tableName());
+
+    return synchronizeIndexes(*relation.mapping(), false);
+}
+
+QOrmPrivate::Expected<QObject*, QOrmError> QOrmSqliteProviderPrivate::rowInstance(
+    const QOrmQuery& query,
+    const QSqlRecord& record,
+    QOrmEntityInstanceCache& entityInstanceCache)
+{
+    // Partial instances are never looked up in the cache: a cached instance has all properties
+    if (!query.columns().empty())
+        return makePartialEntityInstance(query, record, entityInstanceCache);
+
+    const QOrmPropertyMapping* objectIdMapping = query.projection()->objectIdMapping();
+
+    // If there is an object ID, compare the cached entities with the ones read from the
+    // backend. If there is an inconsistency, it will be reported.
+    // All read entities are replaced with their cached versions if found.
+    if (objectIdMapping != nullptr)
+    {
+        QVariant objectId = record.value(objectIdMapping->tableFieldName());
+
+        QObject* cachedInstance = entityInstanceCache.get(*query.projection(), objectId);
+
+        if (m_statistics != nullptr)
+            m_statistics->recordCacheLookup(*query.projection(), cachedInstance != nullptr);
+
+        // cached instance: check if consistent
+        if (cachedInstance != nullptr)
+        {
+            // If inconsistent, return an error. Already cached instances remain in the cache
+            if (entityInstanceCache.isModified(cachedInstance) &&
+                !query.flags().testFlag(QOrm::QueryFlags::OverwriteCachedInstances))
+            {
+                QString errorString;
+                QDebug dbg{&errorString};
+                dbg << "Entity instance" << cachedInstance
+                    << "was read from the database but has unsaved changes in the "
+                       "OR-mapper. "
+                       "Merge this instance or discard changes before reading.";
+
+                return QOrmPrivate::makeUnexpected(
+                    QOrmError{QOrm::ErrorType::UnsynchronizedEntity, errorString});
+            }
+            else if (query.flags().testFlag(QOrm::QueryFlags::OverwriteCachedInstances))
+            {
+                QOrmError error = fillEntityInstance(*query.projection(),
+                                                     cachedInstance,
+                                                     record,
+                                                     entityInstanceCache,
+                                                     query.flags());
+
+                if (error != QOrm::ErrorType::None)
+                    return QOrmPrivate::makeUnexpected(error);
+
+                entityInstanceCache.markUnmodified(cachedInstance);
+
+                if (m_rowInstances != nullptr)
+                    m_rowInstances->hasOverwrittenCachedInstance = true;
+            }
+
+            return cachedInstance;
+        }
+    }
+
+    // new instance: it will be cached in makeEntityInstance
+    return makeEntityInstance(*query.projection(), record, entityInstanceCache);
 }
 
 QOrmQueryResult<QObject> QOrmSqliteProviderPrivate::read(
@@ -761,8 +1891,37 @@ QOrmQueryResult<QObject> QOrmSqliteProviderPrivate::read(
 
     auto [statement, boundParameters] = m_statementGenerator.generate(query);
 
+    if (m_statistics != nullptr)
+        m_statistics->recordReadStatement(statement, m_resolvedReference);
+
+    QElapsedTimer executionTimer;
+    executionTimer.start();
+
     QSqlQuery sqlQuery = prepareAndExecute(statement, boundParameters);
 
+    qint64 executionTime = executionTimer.nsecsElapsed();
+    qint64 rowsRead = 0;
+
+    // The execution time includes stepping through the rows but not the hydration of the entity
+    // instances which may read referenced entities.
+    auto nextRow = [&sqlQuery, &executionTime, &rowsRead]() {
+        QElapsedTimer stepTimer;
+        stepTimer.start();
+
+        bool hasRow = sqlQuery.next();
+
+        executionTime += stepTimer.nsecsElapsed();
+        rowsRead += hasRow ? 1 : 0;
+
+        return hasRow;
+    };
+
+    auto statisticsGuard = qScopeGuard(
+        [this, &query, &statement = statement, &boundParameters = boundParameters, &executionTime,
+         &rowsRead, &sqlQuery]() {
+            recordRead(query, statement, boundParameters, executionTime, rowsRead, sqlQuery);
+        });
+
     if (sqlQuery.lastError().type() != QSqlError::NoError)
     {
         return QOrmQueryResult<QObject>{QOrmError{QOrm::ErrorType::Provider,
@@ -772,133 +1931,421 @@ QOrmQueryResult<QObject> QOrmSqliteProviderPrivate::read(
 
     QVector<QObject*> resultSet;
 
-    const QOrmPropertyMapping* objectIdMapping = query.projection()->objectIdMapping();
+    while (nextRow())
+    {
+        QOrmPrivate::Expected<QObject*, QOrmError> entityInstance =
+            rowInstance(query, sqlQuery.record(), entityInstanceCache);
 
-    // If there is an object ID, compare the cached entities with the ones read from the
-    // backend. If there is an inconsistency, it will be reported.
-    // All read entities are replaced with their cached versions if found.
-    if (objectIdMapping != nullptr)
+        if (!entityInstance)
+        {
+            // if error occurred without an object ID or with partial instances, delete everything
+            // that was read from the database since no caching was involved
+            if (query.projection()->objectIdMapping() == nullptr || !query.columns().empty())
+                qDeleteAll(resultSet);
+
+            return QOrmQueryResult<QObject>{entityInstance.error()};
+        }
+
+        resultSet.push_back(entityInstance.value());
+    }
+
+    if (query.invokableFilter().has_value())
     {
-        while (sqlQuery.next())
+        auto it = std::stable_partition(std::begin(resultSet),
+                                        std::end(resultSet),
+                                        [&query](const QObject* value)
+                                        { return (*query.invokableFilter()->invokable())(value); });
+
+        // partial instances are not cached and belong to nobody else
+        if (!query.columns().empty())
+            std::for_each(it, std::end(resultSet), [](QObject* value) { delete value; });
+
+        resultSet.erase(it, std::end(resultSet));
+    }
+
+    return QOrmQueryResult<QObject>{resultSet, resultSet.size()};
+}
+
+void QOrmSqliteProviderPrivate::recordRead(const QOrmQuery& query,
+                                           const QString& statement,
+                                           const QVariantMap& boundParameters,
+                                           qint64 executionTime,
+                                           qint64 rowsRead,
+                                           const QSqlQuery& sqlQuery)
+{
+    if (sqlQuery.isActive())
+        recordSqliteStatus(statement, sqlQuery);
+
+    checkSlowStatement(statement, boundParameters, executionTime, rowsRead);
+
+    if (m_workloadLog != nullptr)
+    {
+        m_workloadLog->writeStatement(
+            m_workloadLogConnection, statement, boundParameters, {}, executionTime, rowsRead);
+    }
+
+    if (m_statistics != nullptr)
+    {
+        m_statistics->recordStatement(
+            *query.projection(), QOrm::Operation::Read, executionTime, rowsRead, 0);
+    }
+}
+
+// Steps through the rows of a read statement and creates the entity instances one at a time
+class QOrmSqliteCursor : public QOrmAbstractCursor
+{
+public:
+    QOrmSqliteCursor(QOrmSqliteProviderPrivate* provider,
+                     QOrmQuery query,
+                     QOrmEntityInstanceCache& entityInstanceCache,
+                     QOrmError error);
+    ~QOrmSqliteCursor() override;
+
+    QObject* next() override;
+    QOrmError error() const override { return m_error; }
+
+    // Called when the provider disconnects: the entity instance cache may be gone afterwards
+    void invalidate();
+
+private:
+    void releaseRowInstances();
+    void finish();
+
+    QOrmSqliteProviderPrivate* m_provider{nullptr};
+    QOrmQuery m_query;
+    QOrmEntityInstanceCache& m_entityInstanceCache;
+    QOrmError m_error;
+    QString m_statement;
+    QVariantMap m_boundParameters;
+    QSqlQuery m_sqlQuery;
+    qint64 m_executionTime{0};
+    qint64 m_rowsRead{0};
+    bool m_releasesRowInstances{false};
+    QOrmSqliteProviderPrivate::RowInstances m_rowInstances;
+    std::unique_ptr<QObject> m_partialInstance;
+    bool m_isFinished{false};
+};
+
+QOrmSqliteCursor::QOrmSqliteCursor(QOrmSqliteProviderPrivate* provider,
+                                   QOrmQuery query,
+                                   QOrmEntityInstanceCache& entityInstanceCache,
+                                   QOrmError error)
+    : m_provider{provider}
+    , m_query{std::move(query)}
+    , m_entityInstanceCache{entityInstanceCache}
+    , m_error{std::move(error)}
+    , m_releasesRowInstances{
+          m_query.flags().testFlag(QOrm::QueryFlags::ReleaseConsumedInstances)}
+{
+    Q_ASSERT(m_query.projection().has_value());
+
+    m_provider->m_cursors.insert(this);
+
+    if (m_error.type() != QOrm::ErrorType::None)
+    {
+        m_isFinished = true;
+        return;
+    }
+
+    std::tie(m_statement, m_boundParameters) = m_provider->m_statementGenerator.generate(m_query);
+
+    if (m_provider->m_statistics != nullptr)
+        m_provider->m_statistics->recordReadStatement(m_statement, nullptr);
+
+    QElapsedTimer executionTimer;
+    executionTimer.start();
+
+    m_sqlQuery = m_provider->prepareAndExecute(m_statement, m_boundParameters);
+    m_executionTime = executionTimer.nsecsElapsed();
+
+    if (m_sqlQuery.lastError().type() != QSqlError::NoError)
+    {
+        m_error = QOrmError{QOrm::ErrorType::Provider, m_sqlQuery.lastError().text()};
+        finish();
+    }
+}
+
+QOrmSqliteCursor::~QOrmSqliteCursor()
+{
+    if (m_provider != nullptr)
+    {
+        releaseRowInstances();
+        finish();
+        m_provider->m_cursors.remove(this);
+    }
+}
+
+QObject* QOrmSqliteCursor::next()
+{
+    releaseRowInstances();
+
+    while (!m_isFinished)
+    {
+        QElapsedTimer stepTimer;
+        stepTimer.start();
+
+        bool hasRow = m_sqlQuery.next();
+
+        m_executionTime += stepTimer.nsecsElapsed();
+
+        if (!hasRow)
         {
-            QVariant objectId = sqlQuery.value(objectIdMapping->tableFieldName());
+            finish();
+            break;
+        }
 
-            QObject* cachedInstance = entityInstanceCache.get(*query.projection(), objectId);
+        ++m_rowsRead;
 
-            // cached instance: check if consistent
-            if (cachedInstance != nullptr)
-            {
-                // If inconsistent, return an error. Already cached instances remain in the cache
-                if (entityInstanceCache.isModified(cachedInstance) &&
-                    !query.flags().testFlag(QOrm::QueryFlags::OverwriteCachedInstances))
-                {
-                    QString errorString;
-                    QDebug dbg{&errorString};
-                    dbg << "Entity instance" << cachedInstance
-                        << "was read from the database but has unsaved changes in the "
-                           "OR-mapper. "
-                           "Merge this instance or discard changes before reading.";
-
-                    return QOrmQueryResult<QObject>{
-                        QOrmError{QOrm::ErrorType::UnsynchronizedEntity, errorString}};
-                }
-                else if (query.flags().testFlag(QOrm::QueryFlags::OverwriteCachedInstances))
-                {
-                    QOrmError error = fillEntityInstance(*query.projection(),
-                                                         cachedInstance,
-                                                         sqlQuery.record(),
-                                                         entityInstanceCache,
-                                                         query.flags());
+        QOrmSqliteProviderPrivate::RowInstances* rowInstances = std::exchange(
+            m_provider->m_rowInstances, m_releasesRowInstances ? &m_rowInstances : nullptr);
+        QOrmPrivate::Expected<QObject*, QOrmError> entityInstance =
+            m_provider->rowInstance(m_query, m_sqlQuery.record(), m_entityInstanceCache);
+        m_provider->m_rowInstances = rowInstances;
 
-                    if (error != QOrm::ErrorType::None)
-                    {
-                        return QOrmQueryResult<QObject>{error};
-                    }
+        if (!entityInstance)
+        {
+            m_error = entityInstance.error();
+            finish();
+            break;
+        }
 
-                    entityInstanceCache.markUnmodified(cachedInstance);
-                }
+        // partial instances are not cached
+        if (!m_query.columns().empty() && m_releasesRowInstances)
+            m_partialInstance.reset(entityInstance.value());
 
-                resultSet.push_back(cachedInstance);
-            }
-            // new instance: it will be cached in makeEntityInstance
-            else
-            {
-                QOrmPrivate::Expected<QObject*, QOrmError> entityInstance =
-                    makeEntityInstance(*query.projection(), sqlQuery.record(), entityInstanceCache);
+        if (m_query.invokableFilter().has_value() &&
+            !(*m_query.invokableFilter()->invokable())(entityInstance.value()))
+        {
+            if (!m_query.columns().empty() && !m_releasesRowInstances)
+                delete entityInstance.value();
 
-                if (entityInstance)
-                {
-                    resultSet.push_back(entityInstance.value());
-                }
-                else
-                {
-                    return QOrmQueryResult<QObject>{entityInstance.error()};
-                }
-            }
+            releaseRowInstances();
+            continue;
         }
+
+        return entityInstance.value();
     }
-    // No object ID in this projection: cannot cache, just return the results
-    else
+
+    return nullptr;
+}
+
+void QOrmSqliteCursor::invalidate()
+{
+    if (!m_isFinished)
     {
-        while (sqlQuery.next())
-        {
-            QOrmPrivate::Expected<QObject*, QOrmError> entityInstance =
-                makeEntityInstance(*query.projection(), sqlQuery.record(), entityInstanceCache);
+        m_error = QOrmError{QOrm::ErrorType::Provider,
+                            QStringLiteral("The provider of the cursor has been disconnected")};
+    }
 
-            if (entityInstance)
-            {
-                resultSet.push_back(entityInstance.value());
-            }
-            else
+    releaseRowInstances();
+    finish();
+    m_provider = nullptr;
+}
+
+// The instances cached for a row are released together, since they may refer to each other, e.g.
+// a province read for a town refers to the town through its list of towns. They are kept if
+// anything outside of them may refer to them: an instance taken from the cache by the caller, or a
+// cached instance refilled for the row.
+void QOrmSqliteCursor::releaseRowInstances()
+{
+    m_partialInstance.reset();
+
+    QOrmSqliteProviderPrivate::RowInstances rowInstances = std::exchange(m_rowInstances, {});
+
+    if (m_provider == nullptr || rowInstances.hasOverwrittenCachedInstance)
+        return;
+
+    if (std::any_of(std::cbegin(rowInstances.created),
+                    std::cend(rowInstances.created),
+                    [this](const QObject* instance) {
+                        return !m_entityInstanceCache.contains(instance);
+                    }))
+    {
+        return;
+    }
+
+    for (QObject* instance : rowInstances.created)
+        delete m_entityInstanceCache.take(instance);
+}
+
+void QOrmSqliteCursor::finish()
+{
+    if (m_isFinished)
+        return;
+
+    m_isFinished = true;
+
+    m_provider->recordRead(
+        m_query, m_statement, m_boundParameters, m_executionTime, m_rowsRead, m_sqlQuery);
+
+    // Releases the read lock of the statement
+    m_sqlQuery.finish();
+}
+
+void QOrmSqliteProviderPrivate::invalidateCursors()
+{
+    for (QOrmSqliteCursor* cursor : std::exchange(m_cursors, {}))
+        cursor->invalidate();
+}
+
+QOrmQueryResult<QObject> QOrmSqliteProviderPrivate::merge(const QOrmQuery& query)
+{
+    Q_ASSERT(query.relation().type() == QOrm::RelationType::Mapping);
+    Q_ASSERT(query.entityInstance() != nullptr);
+
+    if (query.invokableFilter().has_value())
+    {
+        qFatal("qtorm: Invokable filter is unsupported for merge operation.");
+    }
+
+    auto [statement, boundParameters] = m_statementGenerator.generate(query);
+
+    QElapsedTimer executionTimer;
+    executionTimer.start();
+
+    QSqlQuery sqlQuery = prepareAndExecute(statement, boundParameters);
+
+    if (m_statistics != nullptr)
+    {
+        m_statistics->recordStatement(*query.relation().mapping(),
+                                      query.operation(),
+                                      executionTimer.nsecsElapsed(),
+                                      0,
+                                      qMax(sqlQuery.numRowsAffected(), 0));
+    }
+
+    if (sqlQuery.lastError().type() != QSqlError::NoError)
+    {
+        return QOrmQueryResult<QObject>{{QOrm::ErrorType::Provider, sqlQuery.lastError().text()},
+                                        sqlQuery.numRowsAffected()};
+    }
+
+    if (sqlQuery.numRowsAffected() != 1)
+    {
+        return QOrmQueryResult<QObject>{{QOrm::ErrorType::UnsynchronizedEntity,
+                                         "Unexpected number of rows affected"},
+                                        sqlQuery.numRowsAffected()};
+    }
+
+    return QOrmQueryResult<QObject>{sqlQuery.lastInsertId(), sqlQuery.numRowsAffected()};
+}
+
+// Inserts the rows with multi-row INSERT statements. The statement is prepared once and executed
+// for as many rows as SQLite allows bound parameters; only the last chunk needs its own statement.
+QOrmError QOrmSqliteProviderPrivate::insertRows(
+    const QOrmMetadata& relation,
+    const std::vector<const QOrmPropertyMapping*>& columns,
+    const QOrmAbstractProvider::RowSource& nextRow)
+{
+    QOrmPrivate::TraceSpan span{"QOrmSqliteProvider::insertRows"};
+    span.setEntity(relation);
+    span.setOperation(QOrm::Operation::Create);
+
+    int maxParameterCount = 999;
+
+#ifdef QTORM_HAVE_SQLITE3
+    if (sqlite3* handle = sqliteHandle())
+        maxParameterCount = sqlite3_limit(handle, SQLITE_LIMIT_VARIABLE_NUMBER, -1);
+#endif
+
+    const int columnCount = static_cast<int>(columns.size());
+    const int chunkRowCount = qBound(1, maxParameterCount / columnCount, MaxBulkInsertRowCount);
+
+    QString chunkStatement =
+        m_statementGenerator.generateBulkInsertStatement(relation, columns, chunkRowCount);
+    QSqlQuery chunkQuery{m_database};
+
+    if (m_statistics != nullptr)
+        QOrmPrivate::increment(m_statistics->m_statementsPrepared);
+
+    if (!chunkQuery.prepare(chunkStatement))
+        return QOrmError{QOrm::ErrorType::Provider, chunkQuery.lastError().text()};
+
+    QVariantList row;
+    QVariantList values;
+    values.reserve(chunkRowCount * columnCount);
+
+    qint64 insertedRowCount = 0;
+    bool hasMoreRows = true;
+
+    m_bulkInsertActive = true;
+    auto bulkInsertGuard = qScopeGuard([this]() { m_bulkInsertActive = false; });
+
+    while (hasMoreRows)
+    {
+        values.clear();
+        int rowCount = 0;
+
+        while (rowCount < chunkRowCount && (hasMoreRows = nextRow(row)))
+        {
+            if (row.size() != columnCount)
             {
-                // if error occurred, delete everything that was read from the database since no
-                // caching was involved
-                qDeleteAll(resultSet);
-                return QOrmQueryResult<QObject>{entityInstance.error()};
+                return QOrmError{QOrm::ErrorType::Other,
+                                 QStringLiteral("Expected %1 values per row, got %2")
+                                     .arg(columnCount)
+                                     .arg(row.size())};
             }
+
+            values.append(row);
+            row.clear();
+            ++rowCount;
+        }
+
+        if (rowCount == 0)
+            break;
+
+        QString statement = chunkStatement;
+        QSqlQuery lastChunkQuery{m_database};
+        QSqlQuery* query = &chunkQuery;
+
+        if (rowCount < chunkRowCount)
+        {
+            statement =
+                m_statementGenerator.generateBulkInsertStatement(relation, columns, rowCount);
+            query = &lastChunkQuery;
+
+            if (m_statistics != nullptr)
+                QOrmPrivate::increment(m_statistics->m_statementsPrepared);
+
+            if (!query->prepare(statement))
+                return QOrmError{QOrm::ErrorType::Provider, query->lastError().text()};
         }
-    }
 
-    if (query.invokableFilter().has_value())
-    {
-        auto it = std::remove_if(std::begin(resultSet),
-                                 std::end(resultSet),
-                                 [&query](const QObject* value)
-                                 { return !(*query.invokableFilter()->invokable())(value); });
-        resultSet.erase(it, std::end(resultSet));
-    }
+        QElapsedTimer executionTimer;
+        executionTimer.start();
 
-    return QOrmQueryResult<QObject>{resultSet, resultSet.size()};
-}
+        for (const QVariant& value : qAsConst(values))
+            query->addBindValue(value);
 
-QOrmQueryResult<QObject> QOrmSqliteProviderPrivate::merge(const QOrmQuery& query)
-{
-    Q_ASSERT(query.relation().type() == QOrm::RelationType::Mapping);
-    Q_ASSERT(query.entityInstance() != nullptr);
+        if (!query->exec())
+            return QOrmError{QOrm::ErrorType::Provider, query->lastError().text()};
 
-    if (query.invokableFilter().has_value())
-    {
-        qFatal("qtorm: Invokable filter is unsupported for merge operation.");
-    }
+        qint64 nsecs = executionTimer.nsecsElapsed();
 
-    auto [statement, boundParameters] = m_statementGenerator.generate(query);
+        if (m_statistics != nullptr)
+        {
+            m_statistics->recordStatement(relation, QOrm::Operation::Create, nsecs, 0, rowCount);
+            recordSqliteStatus(statement, *query);
+        }
 
-    QSqlQuery sqlQuery = prepareAndExecute(statement, boundParameters);
+        if (m_workloadLog != nullptr)
+        {
+            m_workloadLog->writeStatement(
+                m_workloadLogConnection, statement, {}, values, nsecs, rowCount);
+        }
 
-    if (sqlQuery.lastError().type() != QSqlError::NoError)
-    {
-        return QOrmQueryResult<QObject>{{QOrm::ErrorType::Provider, sqlQuery.lastError().text()},
-                                        sqlQuery.numRowsAffected()};
+        insertedRowCount += rowCount;
     }
 
-    if (sqlQuery.numRowsAffected() != 1)
+    span.setRows(insertedRowCount);
+
+    if (m_capabilities.testFlag(QOrmSqliteProvider::SupportsChangeNotifications) &&
+        insertedRowCount > 0)
     {
-        return QOrmQueryResult<QObject>{{QOrm::ErrorType::UnsynchronizedEntity,
-                                         "Unexpected number of rows affected"},
-                                        sqlQuery.numRowsAffected()};
+        recordBulkInsert(relation.tableName(), insertedRowCount);
     }
 
-    return QOrmQueryResult<QObject>{sqlQuery.lastInsertId(), sqlQuery.numRowsAffected()};
+    return QOrmError{QOrm::ErrorType::None, {}};
 }
 
 QOrmQueryResult<QObject> QOrmSqliteProviderPrivate::remove(
@@ -912,8 +2359,20 @@ QOrmQueryResult<QObject> QOrmSqliteProviderPrivate::remove(
 
     auto [statement, boundParameters] = m_statementGenerator.generate(query);
 
+    QElapsedTimer executionTimer;
+    executionTimer.start();
+
     QSqlQuery sqlQuery = prepareAndExecute(statement, boundParameters);
 
+    if (m_statistics != nullptr && query.relation().mapping() != nullptr)
+    {
+        m_statistics->recordStatement(*query.relation().mapping(),
+                                      QOrm::Operation::Delete,
+                                      executionTimer.nsecsElapsed(),
+                                      0,
+                                      qMax(sqlQuery.numRowsAffected(), 0));
+    }
+
     if (sqlQuery.lastError().type() != QSqlError::NoError)
     {
         return QOrmQueryResult<QObject>{{QOrm::ErrorType::Provider, sqlQuery.lastError().text()},
@@ -970,6 +2429,76 @@ QOrmError QOrmSqliteProviderPrivate::setForeignKeysEnabled(bool enabled)
     return {QOrm::ErrorType::None, {}};
 }
 
+// Applies the performance settings of the configuration to the connection
+void QOrmSqliteProviderPrivate::applyPerformanceSettings()
+{
+    // Busy timeout first, as switching the journal mode may wait for other connections. The page
+    // size must be set before the first table is created, and before switching to WAL mode.
+    if (auto busyTimeout = m_sqlConfiguration.busyTimeout())
+        applyPragma(QStringLiteral("busy_timeout"), *busyTimeout);
+
+    if (auto pageSize = m_sqlConfiguration.pageSize())
+    {
+        QSqlQuery query = m_database.exec(QStringLiteral("PRAGMA page_count"));
+
+        if (query.next() && query.value(0).toLongLong() == 0)
+            applyPragma(QStringLiteral("page_size"), *pageSize);
+    }
+
+    if (auto journalMode = m_sqlConfiguration.journalMode())
+    {
+        // In the order of QOrmSqliteConfiguration::JournalMode
+        static const QString journalModes[] = {QStringLiteral("delete"),
+                                               QStringLiteral("truncate"),
+                                               QStringLiteral("persist"),
+                                               QStringLiteral("memory"),
+                                               QStringLiteral("wal"),
+                                               QStringLiteral("off")};
+
+        applyPragma(QStringLiteral("journal_mode"),
+                    journalModes[static_cast<int>(*journalMode)]);
+    }
+
+    if (auto synchronous = m_sqlConfiguration.synchronous())
+        applyPragma(QStringLiteral("synchronous"), static_cast<int>(*synchronous));
+
+    if (auto cacheSize = m_sqlConfiguration.cacheSize())
+        applyPragma(QStringLiteral("cache_size"), *cacheSize);
+
+    if (auto mmapSize = m_sqlConfiguration.mmapSize())
+        applyPragma(QStringLiteral("mmap_size"), *mmapSize);
+
+    if (auto tempStore = m_sqlConfiguration.tempStore())
+        applyPragma(QStringLiteral("temp_store"), static_cast<int>(*tempStore));
+
+    if (auto walAutocheckpoint = m_sqlConfiguration.walAutocheckpoint())
+        applyPragma(QStringLiteral("wal_autocheckpoint"), *walAutocheckpoint);
+}
+
+// Sets the pragma and reads it back: SQLite silently ignores values it cannot apply, e.g. WAL
+// mode for in-memory databases or memory maps beyond its compile-time limit.
+void QOrmSqliteProviderPrivate::applyPragma(const QString& name, const QVariant& value)
+{
+    QSqlQuery query = m_database.exec(QStringLiteral("PRAGMA %1 = %2")
+                                          .arg(name, m_statementGenerator.generateLiteral(value)));
+
+    if (query.lastError().type() != QSqlError::NoError)
+    {
+        qCWarning(qtorm).noquote() << "Unable to set PRAGMA" << name << "to" << value.toString()
+                                   << ":" << query.lastError().text();
+        return;
+    }
+
+    query = m_database.exec(QStringLiteral("PRAGMA %1").arg(name));
+
+    if (!query.next() ||
+        query.value(0).toString().compare(value.toString(), Qt::CaseInsensitive) != 0)
+    {
+        qCWarning(qtorm).noquote() << "SQLite ignored PRAGMA" << name << "=" << value.toString()
+                                   << ", the value is" << query.value(0).toString();
+    }
+}
+
 QOrmError QOrmSqliteProviderPrivate::checkForeignKeys()
 {
     QSqlQuery query = prepareAndExecute("PRAGMA foreign_keys_check");
@@ -1037,6 +2566,239 @@ void QOrmSqliteProviderPrivate::detectSqliteCapabilities()
     inMemoryDatabase.close();
 }
 
+void QOrmSqliteProviderPrivate::registerHooks()
+{
+#ifdef QTORM_HAVE_SQLITE3
+    m_hasNativeApi = checkNativeApi();
+
+    if (sqlite3* handle = sqliteHandle())
+    {
+        sqlite3_update_hook(handle, &QOrmSqliteProviderPrivate::onUpdate, this);
+        sqlite3_commit_hook(handle, &QOrmSqliteProviderPrivate::onCommit, this);
+        sqlite3_rollback_hook(handle, &QOrmSqliteProviderPrivate::onRollback, this);
+
+        m_capabilities.setFlag(QOrmSqliteProvider::SupportsChangeNotifications);
+        m_capabilities.setFlag(QOrmSqliteProvider::SupportsEngineStatistics);
+    }
+#endif
+}
+
+void QOrmSqliteProviderPrivate::unregisterHooks()
+{
+#ifdef QTORM_HAVE_SQLITE3
+    if (sqlite3* handle = sqliteHandle())
+    {
+        sqlite3_update_hook(handle, nullptr, nullptr);
+        sqlite3_commit_hook(handle, nullptr, nullptr);
+        sqlite3_rollback_hook(handle, nullptr, nullptr);
+    }
+
+    m_hasNativeApi = false;
+#endif
+
+    m_capabilities.setFlag(QOrmSqliteProvider::SupportsChangeNotifications, false);
+    m_capabilities.setFlag(QOrmSqliteProvider::SupportsEngineStatistics, false);
+    discardPendingChanges();
+    m_committedChanges.clear();
+    resetDatabaseStatus();
+}
+
+void QOrmSqliteProviderPrivate::resetDatabaseStatus()
+{
+    if (m_statistics != nullptr)
+        m_statistics->recordDatabaseStatus(0, 0, -m_pageCacheUsed);
+
+    m_pageCacheHits = 0;
+    m_pageCacheMisses = 0;
+    m_pageCacheUsed = 0;
+}
+
+// Coalesces the changes of a row within a transaction so that every row is reported at most once
+// with its net effect.
+void QOrmSqliteProviderPrivate::recordChange(const QString& tableName,
+                                             QOrm::Operation operation,
+                                             qint64 rowId)
+{
+    // The rows inserted in bulk are not known individually. Together with the rows changed later,
+    // they are reported as an update of the whole table.
+    auto bulkInsert = m_pendingChangeIndex.find(qMakePair(tableName, qint64{0}));
+
+    if (bulkInsert != std::end(m_pendingChangeIndex))
+    {
+        m_pendingChanges[bulkInsert.value()] =
+            QOrmChange{tableName, QOrm::Operation::Update, 0, 0};
+        return;
+    }
+
+    auto key = qMakePair(tableName, rowId);
+    auto it = m_pendingChangeIndex.find(key);
+
+    if (it == std::end(m_pendingChangeIndex))
+    {
+        m_pendingChangeIndex.insert(key, m_pendingChanges.size());
+        m_pendingChanges.emplace_back(QOrmChange{tableName, operation, rowId});
+        return;
+    }
+
+    std::optional<QOrmChange>& pending = m_pendingChanges[it.value()];
+
+    if (!pending.has_value())
+    {
+        // created and deleted earlier in this transaction
+        pending = QOrmChange{tableName, operation, rowId};
+    }
+    else if (pending->operation() == QOrm::Operation::Create)
+    {
+        // an updated new row is still new; a deleted new row has never existed
+        if (operation == QOrm::Operation::Delete)
+            pending.reset();
+    }
+    else if (pending->operation() == QOrm::Operation::Delete &&
+             operation == QOrm::Operation::Create)
+    {
+        pending = QOrmChange{tableName, QOrm::Operation::Update, rowId};
+    }
+    else
+    {
+        pending = QOrmChange{tableName, operation, rowId};
+    }
+}
+
+// Registered without a row ID. Bulk inserts into the same table within a transaction add up.
+void QOrmSqliteProviderPrivate::recordBulkInsert(const QString& tableName, qint64 rowCount)
+{
+    auto key = qMakePair(tableName, qint64{0});
+    auto it = m_pendingChangeIndex.find(key);
+
+    if (it == std::end(m_pendingChangeIndex))
+    {
+        m_pendingChangeIndex.insert(key, m_pendingChanges.size());
+        m_pendingChanges.emplace_back(QOrmChange{tableName, QOrm::Operation::Create, 0, rowCount});
+        return;
+    }
+
+    std::optional<QOrmChange>& pending = m_pendingChanges[it.value()];
+
+    if (pending->operation() == QOrm::Operation::Create)
+    {
+        pending =
+            QOrmChange{tableName, QOrm::Operation::Create, 0, pending->rowCount() + rowCount};
+    }
+}
+
+void QOrmSqliteProviderPrivate::commitPendingChanges()
+{
+    for (const std::optional<QOrmChange>& change : m_pendingChanges)
+    {
+        if (change.has_value())
+            m_committedChanges.push_back(*change);
+    }
+
+    discardPendingChanges();
+}
+
+void QOrmSqliteProviderPrivate::discardPendingChanges()
+{
+    m_pendingChanges.clear();
+    m_pendingChangeIndex.clear();
+}
+
+void QOrmSqliteProviderPrivate::publishCommittedChanges()
+{
+    if (m_committedChanges.isEmpty())
+        return;
+
+    QOrmChangeSet changes;
+    std::swap(changes, m_committedChanges);
+
+    if (m_changeHandler)
+        m_changeHandler(changes);
+}
+
+#ifdef QTORM_HAVE_SQLITE3
+// The handle of the driver must not be passed to another copy of SQLite, e.g. if Qt uses its bundled
+// SQLite. Two copies built from the same sources are compatible.
+bool QOrmSqliteProviderPrivate::checkNativeApi()
+{
+    if (QOrmPrivate::nativeSqliteApiDisabled.load(std::memory_order_relaxed))
+        return false;
+
+    QSqlQuery query{m_database};
+
+    if (!query.exec(QStringLiteral("SELECT sqlite_source_id()")) || !query.next())
+        return false;
+
+    QByteArray driverSourceId = query.value(0).toString().toUtf8();
+
+    if (driverSourceId != sqlite3_sourceid())
+    {
+        qCWarning(qtorm) << "QtOrm is linked against SQLite" << sqlite3_libversion()
+                         << "but the QSQLITE driver uses another SQLite library:" << driverSourceId
+                         << ". Change notifications and engine statistics are disabled.";
+        return false;
+    }
+
+    return true;
+}
+
+sqlite3* QOrmSqliteProviderPrivate::sqliteHandle() const
+{
+    if (!m_hasNativeApi)
+        return nullptr;
+
+    // See https://doc.qt.io/qt-5/qsqldriver.html#handle
+    QVariant handle = m_database.driver()->handle();
+
+    if (!handle.isValid() || qstrcmp(handle.typeName(), "sqlite3*") != 0)
+        return nullptr;
+
+    return *static_cast<sqlite3* const*>(handle.data());
+}
+
+// Tables of QtOrm, like the schema fingerprints and the copies made while rebuilding a table, and
+// of SQLite itself
+static bool isInternalTable(const char* tableName)
+{
+    return qstrncmp(tableName, "qtorm_", 6) == 0 || qstrncmp(tableName, "sqlite_", 7) == 0;
+}
+
+void QOrmSqliteProviderPrivate::onUpdate(void* context,
+                                         int operation,
+                                         const char* databaseName,
+                                         const char* tableName,
+                                         sqlite3_int64 rowId)
+{
+    Q_UNUSED(databaseName)
+
+    static const QHash<int, QOrm::Operation> operations = {
+        {SQLITE_INSERT, QOrm::Operation::Create},
+        {SQLITE_UPDATE, QOrm::Operation::Update},
+        {SQLITE_DELETE, QOrm::Operation::Delete}};
+
+    Q_ASSERT(operations.contains(operation));
+
+    auto* d = static_cast<QOrmSqliteProviderPrivate*>(context);
+
+    if (d->m_bulkInsertActive || isInternalTable(tableName))
+        return;
+
+    d->recordChange(QString::fromUtf8(tableName), operations.value(operation), rowId);
+}
+
+// The commit hook is invoked right before the commit. The changes are published after the
+// statement or the COMMIT has returned successfully.
+int QOrmSqliteProviderPrivate::onCommit(void* context)
+{
+    static_cast<QOrmSqliteProviderPrivate*>(context)->commitPendingChanges();
+    return 0;
+}
+
+void QOrmSqliteProviderPrivate::onRollback(void* context)
+{
+    static_cast<QOrmSqliteProviderPrivate*>(context)->discardPendingChanges();
+}
+#endif
+
 QOrmSqliteProvider::QOrmSqliteProvider(const QOrmSqliteConfiguration& sqlConfiguration)
     : QOrmAbstractProvider{}
     , d_ptr{new QOrmSqliteProviderPrivate{sqlConfiguration, this}}
@@ -1045,23 +2807,70 @@ QOrmSqliteProvider::QOrmSqliteProvider(const QOrmSqliteConfiguration& sqlConfigu
 
 QOrmSqliteProvider::~QOrmSqliteProvider()
 {
+    QString connectionName = d_ptr->m_connectionName;
+
+    d_ptr->invalidateCursors();
     delete d_ptr;
 
-    QSqlDatabase::removeDatabase("QtOrm");
+    // After the last handle of the connection has been destroyed
+    if (QSqlDatabase::contains(connectionName))
+        QSqlDatabase::removeDatabase(connectionName);
 }
 
 QOrmError QOrmSqliteProvider::connectToBackend()
 {
     Q_D(QOrmSqliteProvider);
 
-    if (!d->m_database.isOpen())
-    {        
-        d->m_database.setConnectOptions(d->m_sqlConfiguration.connectOptions());
-        d->m_database.setDatabaseName(d->m_sqlConfiguration.databaseName());
+    if (d->m_database.isOpen())
+        return d->checkConnectionThread();
+
+    // QSqlDatabase connections must be created in the thread that uses them
+    d->m_database = QSqlDatabase::addDatabase("QSQLITE", d->m_connectionName);
+    d->m_connectionThread = QThread::currentThread();
+
+    d->m_database.setConnectOptions(d->m_sqlConfiguration.connectOptions());
+    d->m_database.setDatabaseName(d->m_sqlConfiguration.databaseName());
+
+    if (!d->m_database.open())
+    {
+        QOrmError error = d->lastDatabaseError();
+        d->removeConnection();
+        return error;
+    }
+
+    d->applyPerformanceSettings();
+
+    if (d->m_sqlConfiguration.foreignKeys())
+    {
+        QOrmError error = d->setForeignKeysEnabled(true);
+
+        if (error.type() != QOrm::ErrorType::None)
+        {
+            d->m_database.close();
+            d->removeConnection();
+            return error;
+        }
+    }
+
+    d->registerHooks();
+    d->m_schemaSnapshot.reset();
+    d->m_schemaFingerprints.reset();
 
-        if (!d->m_database.open())
+    QString workloadLogFile = d->m_sqlConfiguration.workloadLogFile();
+
+    if (!workloadLogFile.isEmpty())
+    {
+        QString errorString;
+        d->m_workloadLog = QOrmPrivate::WorkloadLogWriter::open(workloadLogFile, errorString);
+
+        if (d->m_workloadLog != nullptr)
+        {
+            d->m_workloadLogConnection = d->m_workloadLog->addConnection();
+        }
+        else
         {
-            return d->lastDatabaseError();
+            qCWarning(qtorm) << "Unable to record the workload into" << workloadLogFile << ":"
+                             << errorString;
         }
     }
 
@@ -1072,7 +2881,22 @@ QOrmError QOrmSqliteProvider::disconnectFromBackend()
 {
     Q_D(QOrmSqliteProvider);
 
+    QOrmError error = d->checkConnectionThread();
+
+    if (error.type() != QOrm::ErrorType::None)
+        return error;
+
+    d->invalidateCursors();
+
+    if (d->m_database.isOpen())
+        d->unregisterHooks();
+
+    d->m_workloadLog.reset();
+
     d->m_database.close();
+    d->removeConnection();
+    d->m_schemaSnapshot.reset();
+    d->m_schemaFingerprints.reset();
 
     return QOrmError{QOrm::ErrorType::None, {}};
 }
@@ -1092,6 +2916,7 @@ QOrmError QOrmSqliteProvider::beginTransaction()
     {
         if (!d->m_database.transaction())
         {
+            d->m_transactionCounter = 0;
             QSqlError error = d->m_database.lastError();
 
             if (error.type() != QSqlError::NoError)
@@ -1100,6 +2925,12 @@ QOrmError QOrmSqliteProvider::beginTransaction()
                 return QOrmError{QOrm::ErrorType::Other,
                                  QStringLiteral("Unable to start transaction")};
         }
+
+        if (d->m_workloadLog != nullptr)
+        {
+            d->m_workloadLog->writeTransaction(d->m_workloadLogConnection,
+                                               QOrmPrivate::WorkloadEvent::Type::BeginTransaction);
+        }
     }
 
     return QOrmError{QOrm::ErrorType::None, {}};
@@ -1113,6 +2944,8 @@ QOrmError QOrmSqliteProvider::commitTransaction()
     {
         if (!d->m_database.commit())
         {
+            d->m_committedChanges.clear();
+
             QSqlError error = d->m_database.lastError();
 
             if (error.type() != QSqlError::NoError)
@@ -1121,6 +2954,14 @@ QOrmError QOrmSqliteProvider::commitTransaction()
                 return QOrmError{QOrm::ErrorType::Other,
                                  QStringLiteral("Unable to commit transaction")};
         }
+
+        if (d->m_workloadLog != nullptr)
+        {
+            d->m_workloadLog->writeTransaction(d->m_workloadLogConnection,
+                                               QOrmPrivate::WorkloadEvent::Type::CommitTransaction);
+        }
+
+        d->publishCommittedChanges();
     }
 
     return QOrmError{QOrm::ErrorType::None, {}};
@@ -1142,6 +2983,12 @@ QOrmError QOrmSqliteProvider::rollbackTransaction()
                 return QOrmError{QOrm::ErrorType::Other,
                                  QStringLiteral("Unable to rollback transaction")};
         }
+
+        if (d->m_workloadLog != nullptr)
+        {
+            d->m_workloadLog->writeTransaction(
+                d->m_workloadLogConnection, QOrmPrivate::WorkloadEvent::Type::RollbackTransaction);
+        }
     }
 
     return QOrmError{QOrm::ErrorType::None, {}};
@@ -1152,13 +2999,19 @@ QOrmQueryResult<QObject> QOrmSqliteProvider::execute(const QOrmQuery& query,
 {
     Q_D(QOrmSqliteProvider);
 
-    QOrmError error = d->ensureSchemaSynchronized(query.relation());
+    QOrmError error = d->checkConnectionThread();
+
+    if (error.type() == QOrm::ErrorType::None)
+        error = d->ensureSchemaSynchronized(query.relation());
 
     if (error.type() != QOrm::ErrorType::None)
     {
         return QOrmQueryResult<QObject>{error};
     }
 
+    // Statements executed outside of a transaction are committed immediately
+    auto publishGuard = qScopeGuard([d]() { d->publishCommittedChanges(); });
+
     switch (query.operation())
     {
         case QOrm::Operation::Read:
@@ -1178,12 +3031,116 @@ QOrmQueryResult<QObject> QOrmSqliteProvider::execute(const QOrmQuery& query,
     Q_ORM_UNEXPECTED_STATE;
 }
 
+QOrmAbstractCursor* QOrmSqliteProvider::openCursor(const QOrmQuery& query,
+                                                   QOrmEntityInstanceCache& entityInstanceCache)
+{
+    Q_D(QOrmSqliteProvider);
+
+    Q_ASSERT(query.operation() == QOrm::Operation::Read);
+
+    QOrmError error = d->checkConnectionThread();
+
+    if (error.type() == QOrm::ErrorType::None)
+        error = d->ensureSchemaSynchronized(query.relation());
+
+    return new QOrmSqliteCursor{d, query, entityInstanceCache, error};
+}
+
+QOrmError QOrmSqliteProvider::insertRows(const QOrmMetadata& entity,
+                                         const std::vector<const QOrmPropertyMapping*>& columns,
+                                         const RowSource& nextRow)
+{
+    Q_D(QOrmSqliteProvider);
+
+    if (columns.empty())
+        return QOrmError{QOrm::ErrorType::Other, QStringLiteral("No columns to insert")};
+
+    QOrmError error = d->ensureSchemaSynchronized(QOrmRelation{entity});
+
+    if (error.type() != QOrm::ErrorType::None)
+        return error;
+
+    error = beginTransaction();
+
+    if (error.type() != QOrm::ErrorType::None)
+        return error;
+
+    error = d->insertRows(entity, columns, nextRow);
+
+    if (error.type() != QOrm::ErrorType::None)
+    {
+        QOrmError rollbackError = rollbackTransaction();
+        Q_UNUSED(rollbackError)
+        return error;
+    }
+
+    return commitTransaction();
+}
+
 int QOrmSqliteProvider::capabilities() const
 {
     Q_D(const QOrmSqliteProvider);
     return d->m_capabilities;
 }
 
+void QOrmSqliteProvider::setChangeHandler(ChangeHandler handler)
+{
+    Q_D(QOrmSqliteProvider);
+    d->m_changeHandler = std::move(handler);
+}
+
+void QOrmSqliteProvider::setStatistics(QOrmSessionStatistics* statistics)
+{
+    Q_D(QOrmSqliteProvider);
+    d->resetDatabaseStatus();
+    d->m_statistics = QOrmSessionStatisticsPrivate::get(statistics);
+    d->m_statementCounters.clear();
+}
+
+qint64 QOrmSqliteProvider::memoryUsed() const
+{
+#ifdef QTORM_HAVE_SQLITE3
+    Q_D(const QOrmSqliteProvider);
+
+    if (d->m_hasNativeApi)
+        return sqlite3_memory_used();
+#endif
+
+    return -1;
+}
+
+qint64 QOrmSqliteProvider::memoryHighwater() const
+{
+#ifdef QTORM_HAVE_SQLITE3
+    Q_D(const QOrmSqliteProvider);
+
+    if (d->m_hasNativeApi)
+        return sqlite3_memory_highwater(0);
+#endif
+
+    return -1;
+}
+
+QOrmAbstractProvider* QOrmSqliteProvider::clone() const
+{
+    Q_D(const QOrmSqliteProvider);
+
+    QOrmSqliteConfiguration configuration = d->m_sqlConfiguration;
+
+    if (configuration.databaseName().isEmpty() ||
+        configuration.databaseName() == QLatin1String(":memory:") ||
+        configuration.databaseName().contains(QLatin1String("mode=memory")))
+    {
+        return nullptr;
+    }
+
+    // The tables have been recreated by this provider or will be when it first accesses them
+    if (configuration.schemaMode() == QOrmSqliteConfiguration::SchemaMode::Recreate)
+        configuration.setSchemaMode(QOrmSqliteConfiguration::SchemaMode::Update);
+
+    return new QOrmSqliteProvider{configuration};
+}
+
 QOrmSqliteConfiguration QOrmSqliteProvider::configuration() const
 {
     Q_D(const QOrmSqliteProvider);
@@ -39,7 +39,9 @@ public:
     enum SqliteCapability
     {
         NoCapabilities = 0,
-        SupportsReturningClause = 1
+        SupportsReturningClause = 1,
+        SupportsChangeNotifications = 2,
+        SupportsEngineStatistics = 4
     };
     Q_DECLARE_FLAGS(SqliteCapabilities, SqliteCapability)
 
@@ -57,8 +59,28 @@ public:
     QOrmQueryResult<QObject> execute(const QOrmQuery& query,
                                      QOrmEntityInstanceCache& entityInstanceCache) override;
 
+    // The cursor steps through the rows of a forward-only statement. It must be destroyed before
+    // the provider is disconnected.
+    [[nodiscard]] QOrmAbstractCursor* openCursor(
+        const QOrmQuery& query,
+        QOrmEntityInstanceCache& entityInstanceCache) override;
+
     [[nodiscard]] int capabilities() const override;
 
+    QOrmError insertRows(const QOrmMetadata& entity,
+                         const std::vector<const QOrmPropertyMapping*>& columns,
+                         const RowSource& nextRow) override;
+
+    void setChangeHandler(ChangeHandler handler) override;
+    void setStatistics(QOrmSessionStatistics* statistics) override;
+
+    [[nodiscard]] qint64 memoryUsed() const override;
+    [[nodiscard]] qint64 memoryHighwater() const override;
+
+    // In-memory databases cannot be cloned. The clone does not recreate the schema and records
+    // into the same workload log.
+    [[nodiscard]] QOrmAbstractProvider* clone() const override;
+
     QOrmSqliteConfiguration configuration() const;
     QSqlDatabase database() const;
 
@@ -22,12 +22,15 @@
 #include "qormfilter.h"
 #include "qormfilterexpression.h"
 #include "qormglobal_p.h"
+#include "qormindex.h"
 #include "qormmetadata.h"
 #include "qormmetadatacache.h"
 #include "qormorder.h"
 #include "qormquery.h"
 #include "qormrelation.h"
+#include "qormtracer_p.h"
 
+#include <QtCore/qregularexpression.h>
 #include <QtCore/qstringbuilder.h>
 
 QT_BEGIN_NAMESPACE
@@ -89,6 +92,12 @@ std::pair<QString, QVariantMap> QOrmSqliteStatementGenerator::generate(const QOr
 
 QString QOrmSqliteStatementGenerator::generate(const QOrmQuery& query, QVariantMap& boundParameters)
 {
+    QOrmPrivate::TraceSpan span{"QOrmSqliteStatementGenerator::generate"};
+    span.setOperation(query.operation());
+
+    if (query.relation().mapping() != nullptr)
+        span.setEntity(*query.relation().mapping());
+
     switch (query.operation())
     {
         case QOrm::Operation::Create:
@@ -157,6 +166,32 @@ QString QOrmSqliteStatementGenerator::generateInsertStatement(const QOrmMetadata
     return statement;
 }
 
+QString QOrmSqliteStatementGenerator::generateBulkInsertStatement(
+    const QOrmMetadata& relation,
+    const std::vector<const QOrmPropertyMapping*>& columns,
+    int rowCount)
+{
+    QStringList fieldsList;
+    QStringList parametersList;
+
+    for (const QOrmPropertyMapping* column : columns)
+    {
+        fieldsList.push_back(escapeIdentifier(column->tableFieldName()));
+        parametersList.push_back(QStringLiteral("?"));
+    }
+
+    QString rowStr = QStringLiteral("(%1)").arg(parametersList.join(','));
+
+    QStringList rowsList;
+    rowsList.reserve(rowCount);
+
+    for (int i = 0; i < rowCount; ++i)
+        rowsList.push_back(rowStr);
+
+    return QStringLiteral("INSERT INTO %1(%2) VALUES%3")
+        .arg(escapeIdentifier(relation.tableName()), fieldsList.join(','), rowsList.join(','));
+}
+
 QString QOrmSqliteStatementGenerator::generateInsertIntoStatement(
     const QString& destinationTableName,
     const QStringList& destinationColumns,
@@ -213,7 +248,8 @@ QString QOrmSqliteStatementGenerator::generateSelectStatement(const QOrmQuery& q
 {
     Q_ASSERT(query.operation() == QOrm::Operation::Read);
 
-    QStringList parts = {"SELECT *", generateFromClause(query.relation(), boundParameters)};
+    QStringList parts = {QString{"SELECT %1"}.arg(generateSelectList(query)),
+                         generateFromClause(query.relation(), boundParameters)};
 
     if (query.expressionFilter().has_value())
         parts += generateWhereClause(*query.expressionFilter(), boundParameters);
@@ -225,6 +261,31 @@ QString QOrmSqliteStatementGenerator::generateSelectStatement(const QOrmQuery& q
     return parts.join(QChar{' '});
 }
 
+// The object ID is always read to identify the rows
+QString QOrmSqliteStatementGenerator::generateSelectList(const QOrmQuery& query)
+{
+    if (query.columns().empty() || !query.projection().has_value())
+        return QStringLiteral("*");
+
+    QStringList columns;
+
+    if (query.projection()->objectIdMapping() != nullptr)
+        columns += escapeIdentifier(query.projection()->objectIdMapping()->tableFieldName());
+
+    for (const QOrmPropertyMapping& mapping : query.columns())
+    {
+        if (mapping.isTransient())
+            continue;
+
+        QString column = escapeIdentifier(mapping.tableFieldName());
+
+        if (!columns.contains(column))
+            columns += column;
+    }
+
+    return columns.join(',');
+}
+
 QString QOrmSqliteStatementGenerator::generateDeleteStatement(const QOrmMetadata& relation,
                                                               const QOrmFilter& filter,
                                                               QVariantMap& boundParameters)
@@ -381,7 +442,10 @@ QString QOrmSqliteStatementGenerator::generateCondition(
     if (value.isNull())
     {
         static const QHash<QOrm::Comparison, QString> comparisonOps = {
-            {QOrm::Comparison::Equal, "IS NULL"}, {QOrm::Comparison::NotEqual, "IS NOT NULL"}};
+            {QOrm::Comparison::Equal, "IS NULL"},
+            {QOrm::Comparison::NotEqual, "IS NOT NULL"},
+            {QOrm::Comparison::EqualIgnoreCase, "IS NULL"},
+            {QOrm::Comparison::NotEqualIgnoreCase, "IS NOT NULL"}};
 
         if (!comparisonOps.contains(predicate.comparison()))
         {
@@ -407,7 +471,9 @@ QString QOrmSqliteStatementGenerator::generateCondition(
             {QOrm::Comparison::InList, "IN"},
             {QOrm::Comparison::NotInList, "NOT IN"},
             {QOrm::Comparison::Contains, "LIKE"},
-            {QOrm::Comparison::NotContains, "NOT LIKE"}};
+            {QOrm::Comparison::NotContains, "NOT LIKE"},
+            {QOrm::Comparison::EqualIgnoreCase, "="},
+            {QOrm::Comparison::NotEqualIgnoreCase, "<>"}};
 
         Q_ASSERT(comparisonOps.contains(predicate.comparison()));
 
@@ -445,6 +511,19 @@ QString QOrmSqliteStatementGenerator::generateCondition(
                                                 comparisonOps[predicate.comparison()],
                                                 parameterKey);
         }
+        else if (predicate.comparison() == QOrm::Comparison::EqualIgnoreCase ||
+                 predicate.comparison() == QOrm::Comparison::NotEqualIgnoreCase)
+        {
+            // Matches the key of Q_ORM_CLASS(INDEX (lower(<property>)))
+            QString parameterKey = insertParameter(boundParameters,
+                                                   predicate.propertyMapping()->tableFieldName(),
+                                                   value);
+
+            statement = QString{"lower(%1) %2 lower(%3)"}.arg(
+                escapeIdentifier(predicate.propertyMapping()->tableFieldName()),
+                comparisonOps[predicate.comparison()],
+                parameterKey);
+        }
         else
         {
             QString parameterKey = insertParameter(boundParameters,
@@ -508,10 +587,8 @@ QString QOrmSqliteStatementGenerator::generateCreateTableStatement(
 
         if (mapping.isReference())
         {
-            Q_ASSERT(mapping.referencedEntity()->objectIdMapping() != nullptr);
-
             columnDefs += {escapeIdentifier(mapping.tableFieldName()),
-                           toSqliteType(mapping.referencedEntity()->objectIdMapping()->dataType())};
+                           generateReferenceColumnDefinition(mapping)};
         }
         else
         {
@@ -546,8 +623,7 @@ QString QOrmSqliteStatementGenerator::generateAlterTableAddColumnStatement(
 
     if (propertyMapping.isReference())
     {
-        Q_ASSERT(propertyMapping.referencedEntity()->objectIdMapping() != nullptr);
-        dataType = toSqliteType(propertyMapping.referencedEntity()->objectIdMapping()->dataType());
+        dataType = generateReferenceColumnDefinition(propertyMapping);
     }
     else
     {
@@ -560,11 +636,116 @@ QString QOrmSqliteStatementGenerator::generateAlterTableAddColumnStatement(
              dataType);
 }
 
+// The type of a reference column, followed by its foreign key constraint if enabled
+QString QOrmSqliteStatementGenerator::generateReferenceColumnDefinition(
+    const QOrmPropertyMapping& mapping)
+{
+    Q_ASSERT(mapping.isReference());
+
+    const QOrmMetadata* referencedEntity = mapping.referencedEntity();
+    Q_ASSERT(referencedEntity->objectIdMapping() != nullptr);
+
+    QString definition = toSqliteType(referencedEntity->objectIdMapping()->dataType());
+
+    if (m_options.testFlag(WithForeignKeys))
+    {
+        definition += QStringLiteral(" REFERENCES %1(%2)")
+                          .arg(escapeIdentifier(referencedEntity->tableName()),
+                               escapeIdentifier(
+                                   referencedEntity->objectIdMapping()->tableFieldName()));
+    }
+
+    return definition;
+}
+
+QString QOrmSqliteStatementGenerator::generateLiteral(const QVariant& value)
+{
+    if (value.isNull())
+        return QStringLiteral("NULL");
+
+    switch (value.type())
+    {
+        case QVariant::Bool:
+            return value.toBool() ? QStringLiteral("1") : QStringLiteral("0");
+
+        case QVariant::Int:
+        case QVariant::UInt:
+        case QVariant::LongLong:
+        case QVariant::ULongLong:
+        case QVariant::Double:
+            return value.toString();
+
+        default:
+            return QLatin1Char('\'') %
+                   value.toString().replace(QLatin1Char('\''), QLatin1String("''")) %
+                   QLatin1Char('\'');
+    }
+}
+
 QString QOrmSqliteStatementGenerator::generateDropTableStatement(const QOrmMetadata& entity)
 {
     return QStringLiteral("DROP TABLE %1").arg(escapeIdentifier(entity.tableName()));
 }
 
+QString QOrmSqliteStatementGenerator::generateCreateIndexStatement(const QOrmMetadata& entity,
+                                                                   const QOrmIndex& index)
+{
+    static const QRegularExpression lowerPattern{QStringLiteral(R"(^lower\((.+)\)$)")};
+
+    QStringList columns;
+
+    for (const QString& column : index.columns())
+    {
+        QRegularExpressionMatch lowerMatch = lowerPattern.match(column);
+
+        columns.push_back(lowerMatch.hasMatch()
+                              ? QStringLiteral("lower(%1)").arg(
+                                    escapeIdentifier(lowerMatch.captured(1)))
+                              : escapeIdentifier(column));
+    }
+
+    QString statement = QStringLiteral("CREATE %1INDEX %2 ON %3(%4)")
+                            .arg(index.isUnique() ? QStringLiteral("UNIQUE ") : QString{},
+                                 escapeIdentifier(index.name()),
+                                 escapeIdentifier(entity.tableName()),
+                                 columns.join(','));
+
+    if (index.filter().has_value())
+    {
+        // CREATE INDEX does not accept parameters: the bound values are inlined
+        static const QRegularExpression parameterPattern{QStringLiteral(R"(:\w+)")};
+
+        QVariantMap boundParameters;
+        QString condition = generateCondition(
+            QOrmPrivate::resolvedFilterExpression(QOrmRelation{entity}, *index.filter()),
+            boundParameters);
+
+        QString inlined;
+        int pos = 0;
+
+        for (auto it = parameterPattern.globalMatch(condition); it.hasNext();)
+        {
+            QRegularExpressionMatch match = it.next();
+            Q_ASSERT(boundParameters.contains(match.captured()));
+
+            inlined += condition.midRef(pos, match.capturedStart() - pos) %
+                       generateLiteral(boundParameters.value(match.captured()));
+            pos = match.capturedEnd();
+        }
+
+        inlined += condition.midRef(pos);
+
+        statement += QStringLiteral(" WHERE ") % inlined;
+    }
+
+    return statement;
+}
+
+QString QOrmSqliteStatementGenerator::generateDropIndexStatement(const QString& indexName)
+{
+    return QStringLiteral("DROP INDEX %1").arg(escapeIdentifier(indexName));
+}
+
 QString QOrmSqliteStatementGenerator::generateRenameTableStatement(const QString& oldName,
                                                                    const QString& newName)
 {
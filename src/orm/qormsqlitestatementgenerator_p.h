@@ -39,6 +39,7 @@ class QOrmFilterBinaryPredicate;
 class QOrmFilterExpression;
 class QOrmFilterTerminalPredicate;
 class QOrmFilterUnaryPredicate;
+class QOrmIndex;
 class QOrmMetadata;
 class QOrmOrder;
 class QOrmPropertyMapping;
@@ -51,7 +52,8 @@ public:
     enum Option
     {
         NoOptions = 0x00,
-        WithReturningClause = 0x01
+        WithReturningClause = 0x01,
+        WithForeignKeys = 0x02
     };
     Q_DECLARE_FLAGS(Options, Option);
 
@@ -66,6 +68,12 @@ public:
                                                   const QObject* instance,
                                                   QVariantMap& boundParameters);
 
+    // INSERT of rowCount rows with positional parameters for the columns of every row
+    [[nodiscard]] QString generateBulkInsertStatement(
+        const QOrmMetadata& relation,
+        const std::vector<const QOrmPropertyMapping*>& columns,
+        int rowCount);
+
     [[nodiscard]] QString generateInsertIntoStatement(const QString& destinationTableName,
                                                       const QStringList& destionationColumns,
                                                       const QString& sourceTableName,
@@ -77,6 +85,7 @@ public:
 
     [[nodiscard]] QString generateSelectStatement(const QOrmQuery& query,
                                                   QVariantMap& boundParameters);
+    [[nodiscard]] QString generateSelectList(const QOrmQuery& query);
 
     [[nodiscard]] QString generateDeleteStatement(const QOrmMetadata& relation,
                                                   const QOrmFilter& filter,
@@ -115,6 +124,10 @@ public:
 
     [[nodiscard]] QString generateDropTableStatement(const QOrmMetadata& entity);
 
+    [[nodiscard]] QString generateCreateIndexStatement(const QOrmMetadata& entity,
+                                                       const QOrmIndex& index);
+    [[nodiscard]] QString generateDropIndexStatement(const QString& indexName);
+
     [[nodiscard]] QString generateRenameTableStatement(const QString& oldName,
                                                        const QString& newName);
 
@@ -123,6 +136,9 @@ public:
                                                     QVariantMap& boundParameters);
 
     [[nodiscard]] QString toSqliteType(QVariant::Type type);
+    [[nodiscard]] QString generateReferenceColumnDefinition(const QOrmPropertyMapping& mapping);
+    // SQL literal of a value, for statements that cannot have bound parameters
+    [[nodiscard]] QString generateLiteral(const QVariant& value);
 
     [[nodiscard]] QString escapeIdentifier(const QString& identifier);
 
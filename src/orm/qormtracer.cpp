@@ -0,0 +1,253 @@
+/*
+ * Copyright (C) 2019 Dmitriy Purgin <dmitriy.purgin@sequality.at>
+ * Copyright (C) 2019 sequality software engineering e.U. <office@sequality.at>
+ *
+ * This file is part of QtOrm library.
+ *
+ * QtOrm is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QtOrm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QtOrm.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "qormtracer.h"
+#include "qormtracer_p.h"
+
+#include "qormmetadata.h"
+
+#include <QtCore/qcoreapplication.h>
+#include <QtCore/qdeadlinetimer.h>
+#include <QtCore/qfile.h>
+#include <QtCore/qjsonarray.h>
+#include <QtCore/qjsondocument.h>
+#include <QtCore/qjsonobject.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qthread.h>
+
+#include <vector>
+
+#ifdef Q_OS_LINUX
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+QT_BEGIN_NAMESPACE
+
+namespace
+{
+    const char* operationName(int operation)
+    {
+        switch (static_cast<QOrm::Operation>(operation))
+        {
+            case QOrm::Operation::Create:
+                return "create";
+            case QOrm::Operation::Read:
+                return "read";
+            case QOrm::Operation::Update:
+                return "update";
+            case QOrm::Operation::Delete:
+                return "delete";
+            case QOrm::Operation::Merge:
+                return "merge";
+        }
+
+        return nullptr;
+    }
+
+    qint64 monotonicNsecs()
+    {
+        return QDeadlineTimer::current(Qt::PreciseTimer).deadlineNSecs();
+    }
+
+    quintptr currentThreadId()
+    {
+#ifdef Q_OS_LINUX
+        // The kernel thread ID is what other tracing tools report
+        thread_local const quintptr threadId = static_cast<quintptr>(::syscall(SYS_gettid));
+        return threadId;
+#else
+        return reinterpret_cast<quintptr>(QThread::currentThreadId());
+#endif
+    }
+
+    class TraceBuffer
+    {
+    public:
+        void reset(int capacity)
+        {
+            QMutexLocker locker{&m_mutex};
+
+            m_events.clear();
+            m_events.reserve(static_cast<size_t>(capacity));
+            m_capacity = static_cast<size_t>(capacity);
+            m_next = 0;
+        }
+
+        void clear()
+        {
+            QMutexLocker locker{&m_mutex};
+
+            m_events.clear();
+            m_next = 0;
+        }
+
+        void append(QOrmPrivate::TraceEvent event)
+        {
+            QMutexLocker locker{&m_mutex};
+
+            if (m_capacity == 0)
+                return;
+
+            if (m_events.size() < m_capacity)
+                m_events.push_back(std::move(event));
+            else
+                m_events[m_next] = std::move(event);
+
+            m_next = (m_next + 1) % m_capacity;
+        }
+
+        [[nodiscard]] int size()
+        {
+            QMutexLocker locker{&m_mutex};
+            return static_cast<int>(m_events.size());
+        }
+
+        // Returns the events from the oldest to the newest one
+        [[nodiscard]] std::vector<QOrmPrivate::TraceEvent> snapshot()
+        {
+            QMutexLocker locker{&m_mutex};
+
+            if (m_events.size() < m_capacity)
+                return m_events;
+
+            std::vector<QOrmPrivate::TraceEvent> result;
+            result.reserve(m_events.size());
+            result.insert(result.end(), m_events.begin() + m_next, m_events.end());
+            result.insert(result.end(), m_events.begin(), m_events.begin() + m_next);
+
+            return result;
+        }
+
+    private:
+        QMutex m_mutex;
+        std::vector<QOrmPrivate::TraceEvent> m_events;
+        size_t m_capacity{0};
+        size_t m_next{0};
+    };
+
+    Q_GLOBAL_STATIC(TraceBuffer, traceBuffer)
+} // namespace
+
+namespace QOrmPrivate
+{
+    std::atomic<bool> tracingEnabled{false};
+
+    void TraceSpan::setEntity(const QOrmMetadata& entity)
+    {
+        if (m_active)
+            m_event.entity = entity.className();
+    }
+
+    void TraceSpan::begin(const char* name)
+    {
+        m_active = true;
+        m_event.name = name;
+        m_event.threadId = currentThreadId();
+        m_event.startNsecs = monotonicNsecs();
+    }
+
+    void TraceSpan::end()
+    {
+        m_event.durationNsecs = monotonicNsecs() - m_event.startNsecs;
+
+        // Spans ending after the tracer was stopped are dropped
+        if (isTracingEnabled())
+            traceBuffer->append(std::move(m_event));
+    }
+} // namespace QOrmPrivate
+
+void QOrmTracer::start(int capacity)
+{
+    Q_ASSERT(capacity > 0);
+
+    traceBuffer->reset(capacity);
+    QOrmPrivate::tracingEnabled.store(true, std::memory_order_relaxed);
+}
+
+void QOrmTracer::stop()
+{
+    QOrmPrivate::tracingEnabled.store(false, std::memory_order_relaxed);
+}
+
+bool QOrmTracer::isEnabled()
+{
+    return QOrmPrivate::isTracingEnabled();
+}
+
+void QOrmTracer::clear()
+{
+    traceBuffer->clear();
+}
+
+int QOrmTracer::spanCount()
+{
+    return traceBuffer->size();
+}
+
+QByteArray QOrmTracer::toChromeTraceJson()
+{
+    const qint64 processId = QCoreApplication::applicationPid();
+
+    QJsonArray traceEvents;
+
+    for (const QOrmPrivate::TraceEvent& event : traceBuffer->snapshot())
+    {
+        QJsonObject args;
+
+        if (!event.entity.isEmpty())
+            args.insert("entity", event.entity);
+
+        if (const char* operation = operationName(event.operation))
+            args.insert("operation", QString::fromLatin1(operation));
+
+        if (event.rows >= 0)
+            args.insert("rows", event.rows);
+
+        // Chrome trace timestamps are in microseconds
+        traceEvents.append(QJsonObject{{"name", QString::fromLatin1(event.name)},
+                                       {"cat", "qtorm"},
+                                       {"ph", "X"},
+                                       {"ts", event.startNsecs / 1000.0},
+                                       {"dur", event.durationNsecs / 1000.0},
+                                       {"pid", processId},
+                                       {"tid", static_cast<qint64>(event.threadId)},
+                                       {"args", args}});
+    }
+
+    QJsonObject trace{{"traceEvents", traceEvents}, {"displayTimeUnit", "ms"}};
+
+    return QJsonDocument{trace}.toJson(QJsonDocument::Compact);
+}
+
+bool QOrmTracer::writeChromeTrace(const QString& fileName)
+{
+    QFile file{fileName};
+
+    if (!file.open(QFile::WriteOnly | QFile::Truncate))
+        return false;
+
+    QByteArray json = toChromeTraceJson();
+
+    return file.write(json) == json.size();
+}
+
+QT_END_NAMESPACE
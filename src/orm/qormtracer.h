@@ -0,0 +1,56 @@
+/*
+ * Copyright (C) 2019 Dmitriy Purgin <dmitriy.purgin@sequality.at>
+ * Copyright (C) 2019 sequality software engineering e.U. <office@sequality.at>
+ *
+ * This file is part of QtOrm library.
+ *
+ * QtOrm is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QtOrm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QtOrm.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef QORMTRACER_H
+#define QORMTRACER_H
+
+#include <QtOrm/qormglobal.h>
+
+#include <QtCore/qbytearray.h>
+#include <QtCore/qstring.h>
+
+QT_BEGIN_NAMESPACE
+
+// Records spans of the ORM operations into a process-wide ring buffer and exports them in the
+// Chrome trace event format, which can be opened in Perfetto or chrome://tracing. The timestamps
+// are taken from the monotonic clock so that they line up with other traces of the process.
+// Tracing is disabled by default; a disabled tracer costs one atomic load per span.
+class Q_ORM_EXPORT QOrmTracer
+{
+public:
+    static constexpr int DefaultCapacity = 65536;
+
+    // Starts recording. Once the buffer holds the given number of spans, the oldest ones are
+    // overwritten.
+    static void start(int capacity = DefaultCapacity);
+    static void stop();
+    [[nodiscard]] static bool isEnabled();
+
+    static void clear();
+    [[nodiscard]] static int spanCount();
+
+    [[nodiscard]] static QByteArray toChromeTraceJson();
+    static bool writeChromeTrace(const QString& fileName);
+};
+
+QT_END_NAMESPACE
+
+#endif // QORMTRACER_H
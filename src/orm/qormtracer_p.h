@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2019 Dmitriy Purgin <dmitriy.purgin@sequality.at>
+ * Copyright (C) 2019 sequality software engineering e.U. <office@sequality.at>
+ *
+ * This file is part of QtOrm library.
+ *
+ * QtOrm is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QtOrm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QtOrm.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef QORMTRACER_P_H
+#define QORMTRACER_P_H
+
+#include <QtOrm/qormglobal.h>
+
+#include <QtCore/qstring.h>
+
+#include <atomic>
+
+QT_BEGIN_NAMESPACE
+
+class QOrmMetadata;
+
+namespace QOrmPrivate
+{
+    struct TraceEvent
+    {
+        const char* name{nullptr};
+        QString entity;
+        int operation{-1};
+        qint64 rows{-1};
+        qint64 startNsecs{0};
+        qint64 durationNsecs{0};
+        quintptr threadId{0};
+    };
+
+    Q_ORM_EXPORT extern std::atomic<bool> tracingEnabled;
+
+    [[nodiscard]] inline bool isTracingEnabled()
+    {
+        return tracingEnabled.load(std::memory_order_relaxed);
+    }
+
+    // Records a span from its construction until its destruction if tracing was enabled at
+    // construction. The attributes are only stored for active spans.
+    class Q_ORM_EXPORT TraceSpan
+    {
+    public:
+        explicit TraceSpan(const char* name)
+        {
+            if (Q_UNLIKELY(isTracingEnabled()))
+                begin(name);
+        }
+
+        ~TraceSpan()
+        {
+            if (Q_UNLIKELY(m_active))
+                end();
+        }
+
+        TraceSpan(const TraceSpan&) = delete;
+        TraceSpan& operator=(const TraceSpan&) = delete;
+
+        [[nodiscard]] bool isActive() const { return m_active; }
+
+        void setEntity(const QOrmMetadata& entity);
+        void setOperation(QOrm::Operation operation)
+        {
+            m_event.operation = static_cast<int>(operation);
+        }
+        void setRows(qint64 rows) { m_event.rows = rows; }
+
+    private:
+        void begin(const char* name);
+        void end();
+
+        bool m_active{false};
+        TraceEvent m_event;
+    };
+} // namespace QOrmPrivate
+
+QT_END_NAMESPACE
+
+#endif // QORMTRACER_P_H
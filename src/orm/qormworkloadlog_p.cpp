@@ -0,0 +1,196 @@
+/*
+ * Copyright (C) 2019 Dmitriy Purgin <dmitriy.purgin@sequality.at>
+ * Copyright (C) 2019 sequality software engineering e.U. <office@sequality.at>
+ *
+ * This file is part of QtOrm library.
+ *
+ * QtOrm is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QtOrm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QtOrm.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "qormworkloadlog_p.h"
+
+#include <QtCore/qfileinfo.h>
+
+QT_BEGIN_NAMESPACE
+
+namespace
+{
+    constexpr quint32 Magic = 0x514f574c; // "QOWL"
+    constexpr quint16 Version = 2;
+    constexpr QDataStream::Version StreamVersion = QDataStream::Qt_5_12;
+
+    // Record tags preceding every record
+    constexpr quint8 StatementTextTag = 0;
+    constexpr quint8 EventTag = 1;
+
+    QMutex writersMutex;
+    // Writers by the absolute path of their file
+    QHash<QString, std::weak_ptr<QOrmPrivate::WorkloadLogWriter>> writers;
+} // namespace
+
+namespace QOrmPrivate
+{
+    std::shared_ptr<WorkloadLogWriter> WorkloadLogWriter::open(const QString& fileName,
+                                                               QString& errorString)
+    {
+        QString filePath = QFileInfo{fileName}.absoluteFilePath();
+
+        QMutexLocker locker{&writersMutex};
+
+        std::shared_ptr<WorkloadLogWriter> writer = writers.value(filePath).lock();
+
+        if (writer != nullptr)
+            return writer;
+
+        writer = std::make_shared<WorkloadLogWriter>();
+        writer->m_file.setFileName(filePath);
+
+        if (!writer->m_file.open(QFile::WriteOnly | QFile::Truncate))
+        {
+            errorString = writer->m_file.errorString();
+            writers.remove(filePath);
+            return nullptr;
+        }
+
+        writer->m_stream.setDevice(&writer->m_file);
+        writer->m_stream.setVersion(StreamVersion);
+        writer->m_stream << Magic << Version;
+        writer->m_clock.start();
+
+        writers.insert(filePath, writer);
+
+        return writer;
+    }
+
+    void WorkloadLogWriter::writeStatement(quint32 connection,
+                                           const QString& statement,
+                                           const QVariantMap& parameters,
+                                           const QVariantList& positionalParameters,
+                                           qint64 durationNsecs,
+                                           qint64 rows)
+    {
+        QMutexLocker locker{&m_mutex};
+
+        auto it = m_statementIds.find(statement);
+
+        if (it == m_statementIds.end())
+        {
+            it = m_statementIds.insert(statement, static_cast<quint32>(m_statementIds.size()));
+            m_stream << StatementTextTag << statement;
+        }
+
+        m_stream << EventTag << static_cast<quint8>(WorkloadEvent::Type::Statement)
+                 << m_clock.nsecsElapsed() << connection << it.value() << parameters
+                 << positionalParameters << durationNsecs << rows;
+    }
+
+    void WorkloadLogWriter::writeTransaction(quint32 connection, WorkloadEvent::Type type)
+    {
+        Q_ASSERT(type != WorkloadEvent::Type::Statement);
+
+        QMutexLocker locker{&m_mutex};
+
+        m_stream << EventTag << static_cast<quint8>(type) << m_clock.nsecsElapsed() << connection;
+
+        // The log is complete up to the last transaction if the application terminates
+        if (type != WorkloadEvent::Type::BeginTransaction)
+            m_file.flush();
+    }
+
+    bool WorkloadLogReader::open(const QString& fileName)
+    {
+        m_file.setFileName(fileName);
+
+        if (!m_file.open(QFile::ReadOnly))
+        {
+            m_errorString = m_file.errorString();
+            return false;
+        }
+
+        m_stream.setDevice(&m_file);
+        m_stream.setVersion(StreamVersion);
+
+        quint32 magic = 0;
+        quint16 version = 0;
+        m_stream >> magic >> version;
+
+        if (magic != Magic || version != Version)
+        {
+            m_errorString = QStringLiteral("%1 is not a QtOrm workload log").arg(fileName);
+            return false;
+        }
+
+        m_statements.clear();
+        m_errorString.clear();
+
+        return true;
+    }
+
+    bool WorkloadLogReader::readNext(WorkloadEvent& event)
+    {
+        while (!m_stream.atEnd())
+        {
+            quint8 tag = 0;
+            m_stream >> tag;
+
+            if (tag == StatementTextTag)
+            {
+                QString statement;
+                m_stream >> statement;
+                m_statements.push_back(statement);
+                continue;
+            }
+
+            quint8 type = 0;
+            event = WorkloadEvent{};
+            m_stream >> type >> event.timestampNsecs >> event.connection;
+            event.type = static_cast<WorkloadEvent::Type>(type);
+
+            if (tag != EventTag || type < static_cast<quint8>(WorkloadEvent::Type::Statement) ||
+                type > static_cast<quint8>(WorkloadEvent::Type::RollbackTransaction))
+            {
+                m_errorString = QStringLiteral("The workload log is corrupt");
+                return false;
+            }
+
+            if (event.type == WorkloadEvent::Type::Statement)
+            {
+                quint32 statementId = 0;
+                m_stream >> statementId >> event.parameters >> event.positionalParameters >>
+                    event.durationNsecs >> event.rows;
+
+                if (statementId >= static_cast<quint32>(m_statements.size()))
+                {
+                    m_errorString = QStringLiteral("Unknown statement #%1").arg(statementId);
+                    return false;
+                }
+
+                event.statement = m_statements[statementId];
+            }
+
+            if (m_stream.status() != QDataStream::Ok)
+            {
+                m_errorString = QStringLiteral("The workload log is truncated");
+                return false;
+            }
+
+            return true;
+        }
+
+        return false;
+    }
+} // namespace QOrmPrivate
+
+QT_END_NAMESPACE
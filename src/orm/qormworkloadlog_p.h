@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2019 Dmitriy Purgin <dmitriy.purgin@sequality.at>
+ * Copyright (C) 2019 sequality software engineering e.U. <office@sequality.at>
+ *
+ * This file is part of QtOrm library.
+ *
+ * QtOrm is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QtOrm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QtOrm.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef QORMWORKLOADLOG_P_H
+#define QORMWORKLOADLOG_P_H
+
+#include <QtOrm/qormglobal.h>
+
+#include <QtCore/qdatastream.h>
+#include <QtCore/qelapsedtimer.h>
+#include <QtCore/qfile.h>
+#include <QtCore/qhash.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qstring.h>
+#include <QtCore/qvariant.h>
+#include <QtCore/qvector.h>
+
+#include <atomic>
+#include <memory>
+
+QT_BEGIN_NAMESPACE
+
+namespace QOrmPrivate
+{
+    struct WorkloadEvent
+    {
+        enum class Type : quint8
+        {
+            Statement = 1,
+            BeginTransaction,
+            CommitTransaction,
+            RollbackTransaction
+        };
+
+        Type type{Type::Statement};
+        // Time since the start of the recording
+        qint64 timestampNsecs{0};
+        // Connection that executed the statement or the transaction
+        quint32 connection{0};
+
+        QString statement;
+        QVariantMap parameters;
+        QVariantList positionalParameters;
+        qint64 durationNsecs{0};
+        qint64 rows{0};
+    };
+
+    // Binary workload log: a header followed by the events serialized with QDataStream. The text
+    // of every statement shape is written once and referred to by its index afterwards.
+    //
+    // All the providers recording into the same file share one writer, e.g. the connections of a
+    // session pool or the asynchronous connection of a session. Every event is tagged with the
+    // connection that produced it.
+    class Q_ORM_EXPORT WorkloadLogWriter
+    {
+    public:
+        // Returns the writer recording into fileName. The file is truncated if no writer records
+        // into it yet.
+        [[nodiscard]] static std::shared_ptr<WorkloadLogWriter> open(const QString& fileName,
+                                                                     QString& errorString);
+
+        [[nodiscard]] quint32 addConnection() { return m_connectionCount++; }
+
+        void writeStatement(quint32 connection,
+                            const QString& statement,
+                            const QVariantMap& parameters,
+                            const QVariantList& positionalParameters,
+                            qint64 durationNsecs,
+                            qint64 rows);
+        void writeTransaction(quint32 connection, WorkloadEvent::Type type);
+
+    private:
+        QMutex m_mutex;
+        QFile m_file;
+        QDataStream m_stream;
+        QElapsedTimer m_clock;
+        QHash<QString, quint32> m_statementIds;
+        std::atomic<quint32> m_connectionCount{0};
+    };
+
+    class Q_ORM_EXPORT WorkloadLogReader
+    {
+    public:
+        [[nodiscard]] bool open(const QString& fileName);
+        [[nodiscard]] QString errorString() const { return m_errorString; }
+
+        // Reads the next event. Returns false at the end of the log or if the log is corrupt; in
+        // the latter case, errorString() is set.
+        [[nodiscard]] bool readNext(WorkloadEvent& event);
+
+    private:
+        QFile m_file;
+        QDataStream m_stream;
+        QVector<QString> m_statements;
+        QString m_errorString;
+    };
+} // namespace QOrmPrivate
+
+QT_END_NAMESPACE
+
+#endif // QORMWORKLOADLOG_P_H
@@ -2,8 +2,12 @@ TEMPLATE = subdirs
 
 SUBDIRS += \
     domainclasses \
+    qormdatagenerator \
     qormentityinstancecache \
     qormmetadatacache \
     qormsession \
+    qormsessionpool \
+    qormsessionstatistics \
     qormfilterexpression \
-    qormsqlitestatementgenerator
+    qormsqlitestatementgenerator \
+    qormtracer
@@ -0,0 +1,200 @@
+/*
+ * Copyright (C) 2020-2021 Dmitriy Purgin <dpurgin@gmail.com>
+ * Copyright (C) 2019-2022 Dmitriy Purgin <dmitriy.purgin@sequality.at>
+ * Copyright (C) 2019-2022 sequality software engineering e.U. <office@sequality.at>
+ *
+ * This file is part of QtOrm library.
+ *
+ * QtOrm is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QtOrm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QtOrm.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <QtTest>
+
+#include <QOrmChangeNotifier>
+#include <QOrmDataGenerator>
+#include <QOrmEntityInstanceCache>
+#include <QOrmError>
+#include <QOrmSession>
+#include <QOrmSqliteProvider>
+
+#include "domain/province.h"
+#include "domain/town.h"
+
+class DataGeneratorTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+
+    void testDataGeneratorDeterministicPerSeed();
+    void testDataGeneratorChangesReportedPerTable();
+    void testDataGeneratorChangesCollapsedWithRowChanges();
+    void testDataGeneratorAppendsWithoutCachingInstances();
+};
+
+void DataGeneratorTest::init()
+{
+    for (const QString& fileName : {"testdb.db", "testdb.db-wal", "testdb.db-shm"})
+    {
+        QFile db{fileName};
+
+        if (db.exists())
+            QVERIFY(db.remove());
+    }
+
+    qRegisterOrmEntity<Town, Province>();
+}
+
+void DataGeneratorTest::testDataGeneratorDeterministicPerSeed()
+{
+    auto generate = [](quint64 seed, QVector<qint64> townChunks) {
+        QOrmSession session;
+        QOrmDataGenerator generator{&session, seed};
+
+        generator.setRowCount<Province>(10);
+        generator.setStringPattern(Province::staticMetaObject, "name", "Province %1");
+        generator.setStringLength(Town::staticMetaObject, "name", 4, 8);
+        generator.setReferenceDistribution(Town::staticMetaObject,
+                                           "province",
+                                           QOrmDataGenerator::Distribution::Sequential);
+
+        for (qint64 townCount : townChunks)
+        {
+            generator.setRowCount<Town>(townCount);
+
+            if (generator.generate().type() != QOrm::ErrorType::None)
+                return QStringList{};
+
+            generator.setRowCount<Province>(0);
+        }
+
+        QStringList rows;
+        QHash<int, int> townsPerProvince;
+
+        for (const Town* town : session.from<Town>().select().toVector())
+        {
+            rows.push_back(QStringLiteral("%1 %2 %3")
+                               .arg(town->id())
+                               .arg(town->name(), town->province()->name()));
+            ++townsPerProvince[town->province()->id()];
+        }
+
+        // Sequential references spread the towns evenly
+        if (townsPerProvince.size() != 10 ||
+            std::any_of(townsPerProvince.cbegin(), townsPerProvince.cend(), [](int count) {
+                return count != 100;
+            }))
+        {
+            return QStringList{};
+        }
+
+        return rows;
+    };
+
+    QStringList rows = generate(42, {1000});
+    QCOMPARE(rows.size(), 1000);
+    QCOMPARE(rows.first().section(' ', 2), QString{"Province 1"});
+
+    // The values only depend on the seed and the row, not on the generate() calls
+    QCOMPARE(generate(42, {400, 600}), rows);
+    QVERIFY(generate(43, {1000}) != rows);
+}
+
+void DataGeneratorTest::testDataGeneratorChangesReportedPerTable()
+{
+    QOrmSession session;
+    QSignalSpy spy{session.changeNotifier(), &QOrmChangeNotifier::changesCommitted};
+
+    QOrmDataGenerator generator{&session, 42};
+    generator.setRowCount<Province>(10);
+    // More rows than a single bulk INSERT statement takes
+    generator.setRowCount<Town>(1200);
+
+    QCOMPARE(generator.generate().type(), QOrm::ErrorType::None);
+
+    if (!(session.configuration().provider()->capabilities() &
+          QOrmSqliteProvider::SupportsChangeNotifications))
+    {
+        QSKIP("QtOrm has been built without the native SQLite API");
+    }
+
+    QCOMPARE(spy.count(), 1);
+
+    QOrmChangeSet changes = spy.takeFirst().first().value<QOrmChangeSet>();
+    QCOMPARE(changes.size(), 2);
+    QCOMPARE(changes[0].tableName(), QString{"Province"});
+    QCOMPARE(changes[0].operation(), QOrm::Operation::Create);
+    QCOMPARE(changes[0].rowId(), qint64{0});
+    QCOMPARE(changes[0].rowCount(), qint64{10});
+    QCOMPARE(changes[1].tableName(), QString{"Town"});
+    QCOMPARE(changes[1].rowCount(), qint64{1200});
+}
+
+void DataGeneratorTest::testDataGeneratorChangesCollapsedWithRowChanges()
+{
+    QOrmSession session;
+    QVERIFY(session.merge(new Province(QString::fromUtf8("Oberösterreich"))));
+
+    if (!(session.configuration().provider()->capabilities() &
+          QOrmSqliteProvider::SupportsChangeNotifications))
+    {
+        QSKIP("QtOrm has been built without the native SQLite API");
+    }
+
+    QSignalSpy spy{session.changeNotifier(), &QOrmChangeNotifier::changesCommitted};
+
+    QVERIFY(session.beginTransaction());
+
+    QOrmDataGenerator generator{&session, 42};
+    generator.setRowCount<Town>(10);
+    QCOMPARE(generator.generate().type(), QOrm::ErrorType::None);
+
+    QVector<Town*> towns = session.from<Town>().select().toVector();
+    QCOMPARE(towns.size(), 10);
+    QVERIFY(session.remove(towns.front()));
+
+    QVERIFY(session.commitTransaction());
+
+    // The deleted row cannot be told apart from the ones inserted in bulk
+    QCOMPARE(spy.count(), 1);
+
+    QOrmChangeSet changes = spy.takeFirst().first().value<QOrmChangeSet>();
+    QCOMPARE(changes.size(), 1);
+    QCOMPARE(changes[0].tableName(), QString{"Town"});
+    QCOMPARE(changes[0].operation(), QOrm::Operation::Update);
+    QCOMPARE(changes[0].rowId(), qint64{0});
+    QCOMPARE(changes[0].rowCount(), qint64{0});
+}
+
+void DataGeneratorTest::testDataGeneratorAppendsWithoutCachingInstances()
+{
+    QOrmSession session;
+
+    QOrmDataGenerator generator{&session, 42};
+    generator.setRowCount<Province>(10);
+    QCOMPARE(generator.generate().type(), QOrm::ErrorType::None);
+
+    // The next object ID is read from the table without keeping the last row in the session
+    generator.setRowCount<Province>(5);
+    QCOMPARE(generator.generate().type(), QOrm::ErrorType::None);
+    QVERIFY(session.entityInstanceCache()->instances().isEmpty());
+
+    QVector<Province*> provinces = session.from<Province>().select().toVector();
+    QCOMPARE(provinces.size(), 15);
+}
+
+QTEST_GUILESS_MAIN(DataGeneratorTest)
+
+#include "tst_datagenerator.moc"
@@ -1,4 +1,4 @@
-QT = core testlib orm
+QT = core sql testlib orm
 
 CONFIG += testcase warn_on silent c++17
 
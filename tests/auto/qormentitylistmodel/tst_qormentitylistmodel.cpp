@@ -21,13 +21,122 @@
 
 #include <QtTest>
 
+#include <QOrmDataGenerator>
 #include <QOrmEntityListModel>
+#include <QOrmError>
 #include <QOrmSession>
 #include <QOrmSessionConfiguration>
+#include <QOrmSqliteProvider>
+#include <QSqlQuery>
 
 #include "domain/province.h"
 #include "domain/town.h"
 
+class Village;
+
+class District : public QObject
+{
+    Q_OBJECT
+
+    Q_PROPERTY(int id READ id WRITE setId NOTIFY idChanged)
+    Q_PROPERTY(QSet<Village*> villages READ villages WRITE setVillages NOTIFY villagesChanged)
+
+public:
+    Q_INVOKABLE explicit District(QObject* parent = nullptr)
+        : QObject{parent}
+    {
+    }
+
+    int id() const { return m_id; }
+    void setId(int id)
+    {
+        if (m_id != id)
+        {
+            m_id = id;
+            emit idChanged();
+        }
+    }
+
+    QSet<Village*> villages() const { return m_villages; }
+    void setVillages(const QSet<Village*>& villages)
+    {
+        if (m_villages != villages)
+        {
+            m_villages = villages;
+            emit villagesChanged();
+        }
+    }
+
+signals:
+    void idChanged();
+    void villagesChanged();
+
+private:
+    int m_id{0};
+    QSet<Village*> m_villages;
+};
+
+class Village : public QObject
+{
+    Q_OBJECT
+
+    Q_PROPERTY(int id READ id WRITE setId NOTIFY idChanged)
+    Q_PROPERTY(QString name READ name WRITE setName NOTIFY nameChanged)
+    Q_PROPERTY(District* district READ district WRITE setDistrict NOTIFY districtChanged)
+
+public:
+    Q_INVOKABLE explicit Village(QObject* parent = nullptr)
+        : QObject{parent}
+    {
+    }
+
+    Village(const QString& name, District* district)
+        : m_name{name}
+        , m_district{district}
+    {
+    }
+
+    int id() const { return m_id; }
+    void setId(int id)
+    {
+        if (m_id != id)
+        {
+            m_id = id;
+            emit idChanged();
+        }
+    }
+
+    QString name() const { return m_name; }
+    void setName(const QString& name)
+    {
+        if (m_name != name)
+        {
+            m_name = name;
+            emit nameChanged();
+        }
+    }
+
+    District* district() const { return m_district; }
+    void setDistrict(District* district)
+    {
+        if (m_district != district)
+        {
+            m_district = district;
+            emit districtChanged();
+        }
+    }
+
+signals:
+    void idChanged();
+    void nameChanged();
+    void districtChanged();
+
+private:
+    int m_id{0};
+    QString m_name;
+    District* m_district{nullptr};
+};
+
 class EntityListModelTest : public QObject
 {
     Q_OBJECT
@@ -36,11 +145,17 @@ private slots:
     void initTestCase();
 
     void testQVectorTInData();
+    void testQSetTInData();
+    void testDataWithCollectionCaching();
+    void testCollectionCacheFollowsRows();
+    void testFilterChangeUpdatesRowsIncrementally();
+    void testReadReportsChangedRows();
+    void testGeneratedRows();
 };
 
 void EntityListModelTest::initTestCase()
 {
-    qRegisterOrmEntity<Province, Town>();
+    qRegisterOrmEntity<Province, Town, District, Village>();
 }
 
 // Source: https://github.com/dpurgin/qtorm/issues/15
@@ -88,6 +203,224 @@ void EntityListModelTest::testQVectorTInData()
     QCOMPARE(hagenberg->name(), QString::fromUtf8("Hagenberg"));
 }
 
+void EntityListModelTest::testQSetTInData()
+{
+    QOrmSession session;
+
+    {
+        District* district = new District;
+        Village* hagenberg = new Village(QString::fromUtf8("Hagenberg"), district);
+        Village* pregarten = new Village(QString::fromUtf8("Pregarten"), district);
+        district->setVillages({hagenberg, pregarten});
+
+        QVERIFY(session.merge(hagenberg, pregarten, district));
+    }
+
+    QOrmEntityListModel<District> districts{session};
+    QCOMPARE(districts.rowCount(), 1);
+
+    // District::id: UserRole
+    // District::villages: UserRole+1
+    QVariant villages = districts.data(districts.index(0), Qt::UserRole + 1);
+    QCOMPARE(villages.type(), QVariant::List);
+
+    QStringList names;
+
+    for (const QVariant& village : villages.toList())
+    {
+        QVERIFY(qobject_cast<Village*>(village.value<QObject*>()) != nullptr);
+        names.push_back(qobject_cast<Village*>(village.value<QObject*>())->name());
+    }
+
+    names.sort();
+    QCOMPARE(names, (QStringList{"Hagenberg", "Pregarten"}));
+}
+
+void EntityListModelTest::testDataWithCollectionCaching()
+{
+    QOrmSession session;
+
+    {
+        Province* upperAustria = new Province(QString::fromUtf8("Oberösterreich"));
+        Town* hagenberg = new Town(QString::fromUtf8("Hagenberg"), upperAustria);
+        upperAustria->setTowns({hagenberg});
+
+        QVERIFY(session.merge(hagenberg, upperAustria));
+    }
+
+    QOrmEntityListModel<Province> provinces{session};
+    QCOMPARE(provinces.rowCount(), 1);
+
+    // Roles outside of the generated range yield an invalid value
+    QVERIFY(!provinces.data(provinces.index(0), Qt::DisplayRole).isValid());
+    QVERIFY(!provinces.data(provinces.index(0), Qt::UserRole + 3).isValid());
+
+    provinces.setCollectionCachingEnabled(true);
+    QVERIFY(provinces.isCollectionCachingEnabled());
+
+    QCOMPARE(provinces.data(provinces.index(0), Qt::UserRole + 2).toList().size(), 1);
+    QCOMPARE(provinces.data(provinces.index(0), Qt::UserRole + 2).toList().size(), 1);
+
+    Province* upperAustria = qobject_cast<Province*>(provinces.at(0));
+    QVERIFY(upperAustria != nullptr);
+
+    Town* pregarten = new Town(QString::fromUtf8("Pregarten"), upperAustria);
+    upperAustria->setTowns({upperAustria->towns().first(), pregarten});
+    QVERIFY(session.merge(pregarten));
+
+    // Updating through the model invalidates the cached container
+    QVERIFY(provinces.update(upperAustria));
+    QCOMPARE(provinces.data(provinces.index(0), Qt::UserRole + 2).toList().size(), 2);
+}
+
+void EntityListModelTest::testCollectionCacheFollowsRows()
+{
+    QOrmSession session;
+
+    {
+        Province* upperAustria = new Province(QString::fromUtf8("Oberösterreich"));
+        Province* lowerAustria = new Province(QString::fromUtf8("Niederösterreich"));
+
+        Town* hagenberg = new Town(QString::fromUtf8("Hagenberg"), upperAustria);
+        Town* pregarten = new Town(QString::fromUtf8("Pregarten"), upperAustria);
+        Town* melk = new Town(QString::fromUtf8("Melk"), lowerAustria);
+
+        upperAustria->setTowns({hagenberg, pregarten});
+        lowerAustria->setTowns({melk});
+
+        QVERIFY(session.merge(hagenberg, pregarten, melk, upperAustria, lowerAustria));
+    }
+
+    QOrmEntityListModel<Province> provinces{session};
+    provinces.setCollectionCachingEnabled(true);
+    provinces.setOrder({QString{"name"}});
+
+    // Niederösterreich, Oberösterreich
+    QCOMPARE(provinces.data(provinces.index(0), Qt::UserRole + 2).toList().size(), 1);
+    QCOMPARE(provinces.data(provinces.index(1), Qt::UserRole + 2).toList().size(), 2);
+
+    // The cached collections move with their rows
+    provinces.setOrder({QVariantMap{{"name", Qt::DescendingOrder}}});
+    QCOMPARE(provinces.data(provinces.index(0), Qt::UserRole + 2).toList().size(), 2);
+    QCOMPARE(provinces.data(provinces.index(1), Qt::UserRole + 2).toList().size(), 1);
+
+    // and are dropped together with them
+    provinces.setFilter({{"name", QString::fromUtf8("Niederösterreich")}});
+    QCOMPARE(provinces.rowCount(), 1);
+    QCOMPARE(provinces.data(provinces.index(0), Qt::UserRole + 2).toList().size(), 1);
+}
+
+void EntityListModelTest::testFilterChangeUpdatesRowsIncrementally()
+{
+    QOrmSession session;
+
+    {
+        Province* upperAustria = new Province(QString::fromUtf8("Oberösterreich"));
+        Province* lowerAustria = new Province(QString::fromUtf8("Niederösterreich"));
+        Province* tirol = new Province(QString::fromUtf8("Tirol"));
+
+        QVERIFY(session.merge(upperAustria, lowerAustria, tirol));
+    }
+
+    QOrmEntityListModel<Province> provinces{session};
+    QCOMPARE(provinces.rowCount(), 3);
+
+    QObject* tirol = provinces.at(2);
+    QCOMPARE(provinces.indexOf(tirol), 2);
+
+    QSignalSpy resetSpy{&provinces, &QAbstractItemModel::modelReset};
+    QSignalSpy removedSpy{&provinces, &QAbstractItemModel::rowsRemoved};
+    QSignalSpy insertedSpy{&provinces, &QAbstractItemModel::rowsInserted};
+
+    provinces.setFilter({{"name", QString::fromUtf8("Tirol")}});
+
+    QCOMPARE(provinces.rowCount(), 1);
+    QCOMPARE(provinces.at(0), tirol);
+    QCOMPARE(provinces.indexOf(tirol), 0);
+    QCOMPARE(removedSpy.count(), 1);
+    QCOMPARE(insertedSpy.count(), 0);
+
+    provinces.setFilter({});
+
+    QCOMPARE(provinces.rowCount(), 3);
+    QCOMPARE(provinces.at(2), tirol);
+    QCOMPARE(provinces.indexOf(tirol), 2);
+    QCOMPARE(removedSpy.count(), 1);
+    QCOMPARE(insertedSpy.count(), 1);
+    QCOMPARE(resetSpy.count(), 0);
+
+    QSignalSpy movedSpy{&provinces, &QAbstractItemModel::rowsMoved};
+
+    provinces.setOrder({QVariantMap{{"name", Qt::DescendingOrder}}});
+
+    // Tirol, Oberösterreich, Niederösterreich
+    QCOMPARE(provinces.at(0), tirol);
+    QCOMPARE(provinces.indexOf(tirol), 0);
+    QCOMPARE(movedSpy.count(), 1);
+    QCOMPARE(resetSpy.count(), 0);
+}
+
+void EntityListModelTest::testReadReportsChangedRows()
+{
+    QOrmSession session;
+
+    QVERIFY(session.merge(new Province(QString::fromUtf8("Oberösterreich")),
+                          new Province(QString::fromUtf8("Niederösterreich"))));
+
+    QOrmEntityListModel<Province> provinces{session};
+    provinces.setOrder({QString{"id"}});
+    QCOMPARE(provinces.rowCount(), 2);
+
+    QObject* upperAustria = provinces.at(0);
+
+    {
+        QSqlQuery query{
+            static_cast<QOrmSqliteProvider*>(session.configuration().provider())->database()};
+        QVERIFY(query.exec("UPDATE Province SET name = 'Upper Austria' WHERE id = 1"));
+    }
+
+    QSignalSpy resetSpy{&provinces, &QAbstractItemModel::modelReset};
+    QSignalSpy changedSpy{&provinces, &QAbstractItemModel::dataChanged};
+
+    provinces.read();
+
+    QCOMPARE(provinces.at(0), upperAustria);
+    QCOMPARE(provinces.data(provinces.index(0), Qt::UserRole + 1).toString(),
+             QString{"Upper Austria"});
+    QCOMPARE(resetSpy.count(), 0);
+    QCOMPARE(changedSpy.count(), 1);
+    QCOMPARE(changedSpy.first().at(0).value<QModelIndex>(), provinces.index(0));
+    QCOMPARE(changedSpy.first().at(1).value<QModelIndex>(), provinces.index(1));
+}
+
+void EntityListModelTest::testGeneratedRows()
+{
+    QOrmSession session;
+
+    QOrmDataGenerator generator{&session, 42};
+    generator.setRowCount<Province>(20);
+    generator.setRowCount<Town>(2000);
+    generator.setStringPattern(Town::staticMetaObject, "name", "Town %1");
+    generator.setReferenceDistribution(Town::staticMetaObject,
+                                       "province",
+                                       QOrmDataGenerator::Distribution::Sequential);
+
+    QCOMPARE(generator.generate().type(), QOrm::ErrorType::None);
+    QCOMPARE(generator.generatedRowCount<Town>(), qint64{2000});
+
+    QOrmEntityListModel<Town> towns{session};
+    QCOMPARE(towns.rowCount(), 2000);
+
+    towns.setFilter({{"name", QString{"Town 1000"}}});
+    QCOMPARE(towns.rowCount(), 1);
+
+    Town* town = qobject_cast<Town*>(towns.at(0));
+    QVERIFY(town != nullptr);
+    QCOMPARE(town->id(), 1000);
+    QVERIFY(town->province() != nullptr);
+    QCOMPARE(town->province()->id(), 20);
+}
+
 QTEST_GUILESS_MAIN(EntityListModelTest)
 
 #include "tst_qormentitylistmodel.moc"
@@ -48,6 +48,9 @@ private slots:
 
     void testEnumColumn();
     void testColumnWithNamespacedReference();
+
+    void testIndexes();
+    void testReferenceIndexes();
 };
 
 MetadataCacheTest::MetadataCacheTest()
@@ -359,6 +362,96 @@ void MetadataCacheTest::testColumnWithNamespacedReference()
     QCOMPARE(myNamespacedClassMapping->isTransient(), false);
 }
 
+class IndexedEntity : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(int id READ id WRITE setId NOTIFY idChanged)
+    Q_PROPERTY(QString name READ name WRITE setName NOTIFY nameChanged)
+    Q_PROPERTY(QString code READ code WRITE setCode NOTIFY codeChanged)
+    Q_PROPERTY(int category READ category WRITE setCategory NOTIFY categoryChanged)
+
+    Q_ORM_CLASS(INDEX (category, name) UNIQUE (category, code) INDEX (name)
+                    INDEX (name) WHERE (category == 1) INDEX (name) WHERE (category == 2))
+    Q_ORM_PROPERTY(name INDEX)
+    Q_ORM_PROPERTY(code UNIQUE COLUMN code_value)
+
+public:
+    Q_INVOKABLE IndexedEntity() = default;
+
+    int id() const { return m_id; }
+    void setId(int id) { m_id = id; }
+
+    QString name() const { return m_name; }
+    void setName(const QString& name) { m_name = name; }
+
+    QString code() const { return m_code; }
+    void setCode(const QString& code) { m_code = code; }
+
+    int category() const { return m_category; }
+    void setCategory(int category) { m_category = category; }
+
+signals:
+    void idChanged();
+    void nameChanged();
+    void codeChanged();
+    void categoryChanged();
+
+private:
+    int m_id{0};
+    QString m_name;
+    QString m_code;
+    int m_category{0};
+};
+
+void MetadataCacheTest::testIndexes()
+{
+    qRegisterOrmEntity<IndexedEntity>();
+
+    QOrmMetadataCache cache;
+    QOrmMetadata meta = cache.get<IndexedEntity>();
+
+    QCOMPARE(meta.classPropertyMapping("code")->tableFieldName(), "code_value");
+
+    // The duplicate INDEX (name) is ignored
+    const std::vector<QOrmIndex>& indexes = meta.indexes();
+    QCOMPARE(indexes.size(), size_t{6});
+
+    QCOMPARE(indexes[0].name(), "qtorm_IndexedEntity_name_idx");
+    QCOMPARE(indexes[0].columns(), QStringList{"name"});
+    QCOMPARE(indexes[0].isUnique(), false);
+
+    QCOMPARE(indexes[1].name(), "qtorm_IndexedEntity_code_value_key");
+    QCOMPARE(indexes[1].columns(), QStringList{"code_value"});
+    QCOMPARE(indexes[1].isUnique(), true);
+
+    QCOMPARE(indexes[2].name(), "qtorm_IndexedEntity_category_name_idx");
+    QCOMPARE(indexes[2].columns(), (QStringList{"category", "name"}));
+    QCOMPARE(indexes[2].isUnique(), false);
+
+    QCOMPARE(indexes[3].name(), "qtorm_IndexedEntity_category_code_value_key");
+    QCOMPARE(indexes[3].columns(), (QStringList{"category", "code_value"}));
+    QCOMPARE(indexes[3].isUnique(), true);
+
+    // Partial indexes of the same columns with different predicates are numbered
+    QCOMPARE(indexes[4].name(), "qtorm_IndexedEntity_name_partial_idx");
+    QCOMPARE(indexes[5].name(), "qtorm_IndexedEntity_name_partial_2_idx");
+    QCOMPARE(indexes[5].columns(), QStringList{"name"});
+}
+
+void MetadataCacheTest::testReferenceIndexes()
+{
+    QOrmMetadataCache cache;
+
+    // Back references have no column and are not indexed
+    QCOMPARE(cache.get<Town>().indexes().size(), size_t{0});
+
+    const std::vector<QOrmIndex>& indexes = cache.get<Person>().indexes();
+    QCOMPARE(indexes.size(), size_t{1});
+    QCOMPARE(indexes[0].name(), "qtorm_Person_town_id_idx");
+    QCOMPARE(indexes[0].columns(), QStringList{"town_id"});
+    QCOMPARE(indexes[0].isUnique(), false);
+}
+
 QTEST_APPLESS_MAIN(MetadataCacheTest)
 
 #include "tst_metadatacachetest.moc"
@@ -21,12 +21,17 @@
 
 #include <QtTest>
 
+#include <QOrmAsyncTransaction>
+#include <QOrmChangeNotifier>
 #include <QOrmEntityInstanceCache>
 #include <QOrmError>
 #include <QOrmMetadataCache>
 #include <QOrmSession>
+#include <QOrmSessionStatistics>
 #include <QOrmSqliteConfiguration>
 #include <QOrmSqliteProvider>
+#include <QOrmTask>
+#include <QOrmTracer>
 #include <QSqlDatabase>
 #include <QSqlError>
 #include <QSqlQuery>
@@ -37,6 +42,16 @@
 #include "domain/town.h"
 
 #include "private/qormglobal_p.h"
+#include "private/qormworkloadlog_p.h"
+
+#include <array>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#if defined(QTORM_TEST_REQUIRE_COROUTINES) && !defined(QTORM_HAVE_COROUTINES)
+#error "The compiler does not support the coroutines of C++20"
+#endif
 
 class SqliteSessionTest : public QObject
 {
@@ -63,6 +78,9 @@ private slots:
     void testSelectFromNestedSelect();
     void testSelectWithListFilter();
     void testSelectWithLimitOffset();
+    void testSelectWithKeyset();
+    void testSelectWithKeysetSearchesIndex();
+    void testSelectWithColumns();
     void testSelectWithOverwriteCachedInstances();
 
     void testMergeFailsWithInconsistentReferences();
@@ -75,10 +93,29 @@ private slots:
 
     void testTransactionRollback();
 
+    void testChangeNotificationsCoalescedPerTransaction();
+
+    void testMemoryReportCountsCachedAndTrackedInstances();
+    void testMemoryReportWithoutNativeApi();
+    void testWorkloadRecordedIntoLog();
+
     void testSchemaCreatedForReferencedEntities();
     void testSchemaAppendCreatesTablesAndAddsColumns();
     void testSchemaUpdateCreatesTablesAndAddsColumns();
     void testSchemaUpdateRemovesColumns();
+    void testSchemaSnapshotLoadedOncePerConnection();
+    void testSchemaFingerprintSkipsInspection();
+    void testSchemaValidate();
+    void testSchemaIndexes();
+    void testSchemaForeignKeys();
+    void testCaseInsensitiveIndex();
+    void testPerformanceSettings();
+    void testConcurrentProviders();
+    void testAsyncSelectAndMerge();
+    void testAsyncTransaction();
+    void testAsyncWorkloadRecordedIntoSharedLog();
+    void testCoroutines();
+    void testStream();
 };
 
 SqliteSessionTest::SqliteSessionTest()
@@ -91,10 +128,13 @@ SqliteSessionTest::~SqliteSessionTest()
 
 void SqliteSessionTest::init()
 {
-    QFile db{"testdb.db"};
+    for (const QString& fileName : {"testdb.db", "testdb.db-wal", "testdb.db-shm"})
+    {
+        QFile db{fileName};
 
-    if (db.exists())
-        QVERIFY(db.remove());
+        if (db.exists())
+            QVERIFY(db.remove());
+    }
 
     qRegisterOrmEntity<Town, Province, Person>();
 }
@@ -525,6 +565,206 @@ void SqliteSessionTest::testSelectWithLimitOffset()
     }
 }
 
+void SqliteSessionTest::testSelectWithKeyset()
+{
+    QOrmSession session;
+
+    auto tirol = new Province(QString::fromUtf8("Tirol"));
+    auto salzburg = new Province(QString::fromUtf8("Salzburg"));
+    auto burgenland = new Province(QString::fromUtf8("Burgenland"));
+    auto otherSalzburg = new Province(QString::fromUtf8("Salzburg"));
+    auto kaernten = new Province(QString::fromUtf8("Kärnten"));
+    QVERIFY(session.merge(tirol, salzburg, burgenland, otherSalzburg, kaernten));
+
+    // The object ID orders the rows with the same name
+    auto firstPage = session.from<Province>()
+                         .order(Q_ORM_CLASS_PROPERTY(name), Qt::DescendingOrder)
+                         .limit(2)
+                         .select()
+                         .toVector();
+    QCOMPARE(firstPage, (QVector<Province*>{tirol, salzburg}));
+
+    auto secondPage = session.from<Province>()
+                          .order(Q_ORM_CLASS_PROPERTY(name), Qt::DescendingOrder)
+                          .after(firstPage.last())
+                          .limit(2)
+                          .select()
+                          .toVector();
+    QCOMPARE(secondPage, (QVector<Province*>{otherSalzburg, kaernten}));
+
+    auto previousPage = session.from<Province>()
+                            .order(Q_ORM_CLASS_PROPERTY(name), Qt::DescendingOrder)
+                            .before(secondPage.first())
+                            .limit(2)
+                            .select()
+                            .toVector();
+    QCOMPARE(previousPage, firstPage);
+
+    QString pageToken = session.from<Province>()
+                            .order(Q_ORM_CLASS_PROPERTY(name), Qt::DescendingOrder)
+                            .pageToken(kaernten);
+
+    auto lastPage = session.from<Province>()
+                        .order(Q_ORM_CLASS_PROPERTY(name), Qt::DescendingOrder)
+                        .after(pageToken)
+                        .select()
+                        .toVector();
+    QCOMPARE(lastPage, QVector<Province*>{burgenland});
+
+    // A token only fits the query it was made for
+    auto result =
+        session.from<Province>().order(Q_ORM_CLASS_PROPERTY(name)).after(pageToken).select();
+    QCOMPARE(result.error().type(), QOrm::ErrorType::Other);
+
+    // A malformed token is reported by the query, which is not executed
+    QOrmQuery query = session.from<Province>()
+                          .order(Q_ORM_CLASS_PROPERTY(name))
+                          .after(QString{"not a token"})
+                          .build(QOrm::Operation::Read);
+    QCOMPARE(query.error().type(), QOrm::ErrorType::Other);
+    QCOMPARE(session.execute(query).error().type(), QOrm::ErrorType::Other);
+
+    QOrmCursor<Province> cursor = session.from<Province>()
+                                      .order(Q_ORM_CLASS_PROPERTY(name))
+                                      .after(QString{"not a token"})
+                                      .stream();
+    QVERIFY(cursor.next() == nullptr);
+    QCOMPARE(cursor.error().type(), QOrm::ErrorType::Other);
+
+    // NULL sorts before the other values
+    auto linz = new Town(QString::fromUtf8("Linz"), nullptr);
+    auto wels = new Town(QString::fromUtf8("Wels"), nullptr);
+    auto lienz = new Town(QString::fromUtf8("Lienz"), tirol);
+    auto zell = new Town(QString::fromUtf8("Zell am See"), salzburg);
+    QVERIFY(session.merge(linz, wels, lienz, zell));
+
+    for (Qt::SortOrder direction : {Qt::AscendingOrder, Qt::DescendingOrder})
+    {
+        QVector<Town*> towns = session.from<Town>()
+                                   .order(Q_ORM_CLASS_PROPERTY(province), direction)
+                                   .select()
+                                   .toVector();
+        QCOMPARE(towns.size(), 4);
+
+        QVector<Town*> pagedTowns{towns.first()};
+
+        while (pagedTowns.size() < towns.size())
+        {
+            auto page = session.from<Town>()
+                            .order(Q_ORM_CLASS_PROPERTY(province), direction)
+                            .after(pagedTowns.last())
+                            .limit(1)
+                            .select()
+                            .toVector();
+            QCOMPARE(page.size(), 1);
+            pagedTowns.push_back(page.first());
+        }
+
+        QCOMPARE(pagedTowns, towns);
+
+        auto previousTowns = session.from<Town>()
+                                 .order(Q_ORM_CLASS_PROPERTY(province), direction)
+                                 .before(towns.last())
+                                 .select()
+                                 .toVector();
+        QCOMPARE(previousTowns, towns.mid(0, 3));
+    }
+}
+
+void SqliteSessionTest::testSelectWithKeysetSearchesIndex()
+{
+    QOrmSqliteConfiguration sqliteConfiguration{};
+    sqliteConfiguration.setSchemaMode(QOrmSqliteConfiguration::SchemaMode::Recreate);
+    sqliteConfiguration.setDatabaseName("testdb.db");
+    sqliteConfiguration.setSlowQueryThreshold(0);
+    QOrmSqliteProvider* sqliteProvider = new QOrmSqliteProvider{sqliteConfiguration};
+    QOrmSession session{QOrmSessionConfiguration{sqliteProvider, true}};
+
+    auto tirol = new Province(QString::fromUtf8("Tirol"));
+    auto lienz = new Town(QString::fromUtf8("Lienz"), tirol);
+    QVERIFY(session.merge(lienz, new Town(QString::fromUtf8("Kufstein"), tirol)));
+
+    // The reference column is indexed. The seek is a search of that index, without a scan of the
+    // table or a sort.
+    QTest::ignoreMessage(QtWarningMsg,
+                         QRegularExpression{R"(^Slow statement \(.+\): SELECT [\s\S]*"Town")"
+                                            R"([\s\S]*>=[\s\S]*\n  Query plan:\n)"
+                                            R"(    SEARCH [^\n]*INDEX [^\n]*$)"});
+
+    auto page = session.from<Town>()
+                    .order(Q_ORM_CLASS_PROPERTY(province))
+                    .after(lienz)
+                    .limit(1)
+                    .select()
+                    .toVector();
+    QCOMPARE(page.size(), 1);
+    QCOMPARE(page.first()->name(), QString::fromUtf8("Kufstein"));
+}
+
+void SqliteSessionTest::testSelectWithColumns()
+{
+    QOrmSession session;
+
+    auto upperAustria = new Province(QString::fromUtf8("Oberösterreich"));
+    auto hagenberg = new Town(QString::fromUtf8("Hagenberg"), upperAustria);
+    QVERIFY(session.merge(hagenberg));
+
+    // Partial instances are never taken from the cache
+    auto towns = session.from<Town>().columns(Q_ORM_CLASS_PROPERTY(name)).select().toVector();
+    QCOMPARE(towns.size(), 1);
+
+    Town* partialTown = towns.front();
+    QVERIFY(partialTown != hagenberg);
+    QVERIFY(!session.entityInstanceCache()->contains(partialTown));
+    QCOMPARE(partialTown->id(), hagenberg->id());
+    QCOMPARE(partialTown->name(), QString::fromUtf8("Hagenberg"));
+    QCOMPARE(partialTown->province(), nullptr);
+
+    // A partial instance cannot be merged over the full row
+    partialTown->setName(QString::fromUtf8("Pregarten"));
+    QVERIFY(!session.merge(partialTown));
+    QCOMPARE(session.lastError().type(), QOrm::ErrorType::Other);
+    delete partialTown;
+
+    // References are resolved to the instances of the session
+    towns = session.from<Town>()
+                .columns(Q_ORM_CLASS_PROPERTY(name), Q_ORM_CLASS_PROPERTY(province))
+                .select()
+                .toVector();
+    QCOMPARE(towns.size(), 1);
+    QCOMPARE(towns.front()->province(), upperAustria);
+    qDeleteAll(towns);
+
+    // Seeking needs the values of the order properties
+    auto seekResult = session.from<Town>()
+                          .columns(Q_ORM_CLASS_PROPERTY(province))
+                          .order(Q_ORM_CLASS_PROPERTY(name))
+                          .after(hagenberg)
+                          .select();
+    QCOMPARE(seekResult.error().type(), QOrm::ErrorType::Other);
+
+    seekResult = session.from<Town>()
+                     .columns(Q_ORM_CLASS_PROPERTY(name))
+                     .order(Q_ORM_CLASS_PROPERTY(name))
+                     .after(hagenberg)
+                     .select();
+    QVERIFY(!seekResult.hasError());
+    QVERIFY(seekResult.toVector().isEmpty());
+
+    towns = session.from<Town>().columns(Q_ORM_CLASS_PROPERTY(province)).select().toVector();
+    QCOMPARE(towns.size(), 1);
+
+    seekResult =
+        session.from<Town>().order(Q_ORM_CLASS_PROPERTY(name)).after(towns.front()).select();
+    QCOMPARE(seekResult.error().type(), QOrm::ErrorType::Other);
+    QVERIFY(
+        session.from<Town>().order(Q_ORM_CLASS_PROPERTY(name)).pageToken(towns.front()).isEmpty());
+    qDeleteAll(towns);
+
+    QCOMPARE(session.from<Town>().select().toVector(), QVector<Town*>{hagenberg});
+    QCOMPARE(hagenberg->name(), QString::fromUtf8("Hagenberg"));
+}
+
 void SqliteSessionTest::testSelectWithOverwriteCachedInstances()
 {
     QOrmSession session;
@@ -692,6 +932,172 @@ void SqliteSessionTest::testTransactionRollback()
     QCOMPARE(upperAustria->name(), QString::fromUtf8("Oberösterreich"));
 }
 
+void SqliteSessionTest::testChangeNotificationsCoalescedPerTransaction()
+{
+    QOrmSession session;
+    QSignalSpy spy{session.changeNotifier(), &QOrmChangeNotifier::changesCommitted};
+
+    Province* upperAustria = new Province(QString::fromUtf8("Oberösterreich"));
+    QVERIFY(session.merge(upperAustria));
+
+    if (!(session.configuration().provider()->capabilities() &
+          QOrmSqliteProvider::SupportsChangeNotifications))
+    {
+        QSKIP("QtOrm has been built without the native SQLite API");
+    }
+
+    QCOMPARE(spy.count(), 1);
+
+    QOrmChangeSet changes = spy.takeFirst().first().value<QOrmChangeSet>();
+    QCOMPARE(changes.size(), 1);
+    QCOMPARE(changes[0].tableName(), QString{"Province"});
+    QCOMPARE(changes[0].operation(), QOrm::Operation::Create);
+    QCOMPARE(changes[0].rowId(), qint64{1});
+
+    {
+        auto token = session.declareTransaction(QOrm::TransactionPropagation::Require,
+                                                QOrm::TransactionAction::Commit);
+
+        Province* lowerAustria = new Province(QString::fromUtf8("Niederösterreich"));
+        QVERIFY(session.merge(lowerAustria));
+
+        lowerAustria->setName(QString::fromUtf8("Lower Austria"));
+        QVERIFY(session.merge(lowerAustria));
+
+        upperAustria->setName(QString::fromUtf8("Upper Austria"));
+        QVERIFY(session.merge(upperAustria));
+
+        // nothing is published until the transaction is committed
+        QCOMPARE(spy.count(), 0);
+    }
+
+    QCOMPARE(spy.count(), 1);
+
+    changes = spy.takeFirst().first().value<QOrmChangeSet>();
+    QCOMPARE(changes.size(), 2);
+    QCOMPARE(changes[0].operation(), QOrm::Operation::Create);
+    QCOMPARE(changes[0].rowId(), qint64{2});
+    QCOMPARE(changes[1].operation(), QOrm::Operation::Update);
+    QCOMPARE(changes[1].rowId(), qint64{1});
+}
+
+void SqliteSessionTest::testMemoryReportCountsCachedAndTrackedInstances()
+{
+    QOrmSession session;
+
+    Province* upperAustria = new Province(QString::fromUtf8("Oberösterreich"));
+    QVERIFY(session.merge(upperAustria,
+                          new Town(QString::fromUtf8("Hagenberg"), upperAustria),
+                          new Town(QString::fromUtf8("Pregarten"), upperAustria)));
+
+    QOrmMemoryReport report = session.memoryReport();
+
+    QOrmEntityMemoryUsage towns = report.entity<Town>();
+    QCOMPARE(towns.cachedInstances(), 2);
+    QVERIFY(towns.bytesPerInstance() > static_cast<qint64>(sizeof(QObject)));
+    QVERIFY(towns.identityMapBytes() > 0);
+    QCOMPARE(towns.trackedInstances(), 0);
+    QCOMPARE(report.entity<Province>().cachedInstances(), 1);
+    QCOMPARE(report.entity<Person>().cachedInstances(), 0);
+    QVERIFY(report.totalBytes() >= towns.totalBytes() + report.entity<Province>().totalBytes());
+
+    // A longer name takes more memory
+    upperAustria->setName(upperAustria->name().repeated(100));
+    QVERIFY(session.memoryReport().entity<Province>().bytesPerInstance() >
+            report.entity<Province>().bytesPerInstance());
+
+    QVERIFY(session.beginTransaction());
+    QVERIFY(session.merge(upperAustria));
+    QCOMPARE(session.memoryReport().entity<Province>().trackedInstances(), 1);
+    QVERIFY(session.memoryReport().trackedInstanceBytes() > 0);
+    QVERIFY(session.commitTransaction());
+
+    if (session.configuration().provider()->capabilities() &
+        QOrmSqliteProvider::SupportsEngineStatistics)
+    {
+        QVERIFY(report.backendMemoryUsed() > 0);
+        QVERIFY(report.backendMemoryHighwater() >= report.backendMemoryUsed());
+    }
+    else
+    {
+        QCOMPARE(report.backendMemoryUsed(), qint64{-1});
+    }
+}
+
+void SqliteSessionTest::testMemoryReportWithoutNativeApi()
+{
+    QOrmPrivate::nativeSqliteApiDisabled = true;
+    auto nativeApiGuard = qScopeGuard([]() { QOrmPrivate::nativeSqliteApiDisabled = false; });
+
+    QOrmSession session;
+    QVERIFY(session.merge(new Province(QString::fromUtf8("Oberösterreich"))));
+
+    // The memory of the SQLite library of QtOrm says nothing about the one of the driver
+    QOrmMemoryReport report = session.memoryReport();
+    QCOMPARE(report.entity<Province>().cachedInstances(), 1);
+    QCOMPARE(report.backendMemoryUsed(), qint64{-1});
+    QCOMPARE(report.backendMemoryHighwater(), qint64{-1});
+}
+
+void SqliteSessionTest::testWorkloadRecordedIntoLog()
+{
+    QTemporaryDir temporaryDir;
+    QVERIFY(temporaryDir.isValid());
+
+    QString logFileName = temporaryDir.filePath("workload.qtormlog");
+
+    {
+        QOrmSqliteConfiguration sqliteConfiguration{};
+        sqliteConfiguration.setSchemaMode(QOrmSqliteConfiguration::SchemaMode::Recreate);
+        sqliteConfiguration.setDatabaseName("testdb.db");
+        sqliteConfiguration.setWorkloadLogFile(logFileName);
+        QOrmSqliteProvider* sqliteProvider = new QOrmSqliteProvider{sqliteConfiguration};
+        QOrmSession session{QOrmSessionConfiguration{sqliteProvider, true}};
+
+        QVERIFY(session.merge(new Province(QString::fromUtf8("Oberösterreich"))));
+        QCOMPARE(session.from<Province>()
+                     .filter(Q_ORM_CLASS_PROPERTY(name) == QString::fromUtf8("Oberösterreich"))
+                     .select()
+                     .toVector()
+                     .size(),
+                 1);
+    }
+
+    QOrmPrivate::WorkloadLogReader reader;
+    QVERIFY2(reader.open(logFileName), qPrintable(reader.errorString()));
+
+    using QOrmPrivate::WorkloadEvent;
+
+    QVector<WorkloadEvent> events;
+    WorkloadEvent event;
+
+    while (reader.readNext(event))
+        events.push_back(event);
+
+    QVERIFY2(reader.errorString().isEmpty(), qPrintable(reader.errorString()));
+
+    auto begin = std::find_if(events.begin(), events.end(), [](const WorkloadEvent& event) {
+        return event.type == WorkloadEvent::Type::BeginTransaction;
+    });
+    auto commit = std::find_if(begin, events.end(), [](const WorkloadEvent& event) {
+        return event.type == WorkloadEvent::Type::CommitTransaction;
+    });
+    QVERIFY(commit != events.end());
+
+    // The merge and the schema synchronization it triggers are recorded within the transaction
+    QVERIFY(std::any_of(begin, commit, [](const WorkloadEvent& event) {
+        return event.statement.startsWith("INSERT INTO");
+    }));
+
+    const WorkloadEvent& select = events.back();
+    QCOMPARE(select.type, WorkloadEvent::Type::Statement);
+    QVERIFY(select.statement.startsWith("SELECT"));
+    QCOMPARE(select.parameters.value(":name").toString(), QString::fromUtf8("Oberösterreich"));
+    QCOMPARE(select.rows, qint64{1});
+    QVERIFY(select.durationNsecs > 0);
+    QVERIFY(select.timestampNsecs >= commit->timestampNsecs);
+}
+
 void SqliteSessionTest::testSchemaCreatedForReferencedEntities()
 {
     {
@@ -1016,6 +1422,866 @@ void SqliteSessionTest::testRemoveWithFilter()
     }
 }
 
+void SqliteSessionTest::testSchemaSnapshotLoadedOncePerConnection()
+{
+    {
+        QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE");
+        db.setDatabaseName("testdb.db");
+        QVERIFY(db.open());
+
+        QSqlQuery query = db.exec("CREATE TABLE Town(id INTEGER PRIMARY KEY AUTOINCREMENT)");
+        QCOMPARE(query.lastError().type(), QSqlError::NoError);
+
+        db.close();
+        QSqlDatabase::removeDatabase(QSqlDatabase::defaultConnection);
+    }
+
+    QOrmSession session{QOrmSessionConfiguration::fromFile(":/qtorm_update_schema.json")};
+
+    QOrmTracer::start();
+    auto tracerGuard = qScopeGuard([]() {
+        QOrmTracer::stop();
+        QOrmTracer::clear();
+    });
+
+    // Person references Town and Town references Province: all of them are synchronized in one
+    // pass, with the altered Town table read back after the rebuild
+    QCOMPARE(session.from<Person>().select().error().type(), QOrm::ErrorType::None);
+    QCOMPARE(session.from<Town>().select().error().type(), QOrm::ErrorType::None);
+    QVERIFY(session.merge(new Province(QString::fromUtf8("Oberösterreich"))));
+
+    QOrmTracer::stop();
+
+    QJsonDocument trace = QJsonDocument::fromJson(QOrmTracer::toChromeTraceJson());
+    int snapshotLoads = 0;
+
+    for (const QJsonValue& value : trace.object().value("traceEvents").toArray())
+    {
+        if (value.toObject().value("name").toString() == "QOrmSqliteProvider::loadSchemaSnapshot")
+            ++snapshotLoads;
+    }
+
+    QCOMPARE(snapshotLoads, 1);
+}
+
+void SqliteSessionTest::testSchemaFingerprintSkipsInspection()
+{
+    {
+        QOrmSession session{QOrmSessionConfiguration::fromFile(":/qtorm_update_schema.json")};
+        QCOMPARE(session.from<Person>().select().error().type(), QOrm::ErrorType::None);
+    }
+
+    {
+        QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE");
+        db.setDatabaseName("testdb.db");
+        QVERIFY(db.open());
+
+        QSqlQuery query = db.exec("SELECT tableName FROM qtorm_schema ORDER BY tableName");
+        QStringList tables;
+
+        while (query.next())
+            tables.push_back(query.value(0).toString());
+
+        QCOMPARE(tables, (QStringList{"Person", "Province", "Town"}));
+
+        // A stale fingerprint makes the provider inspect the table again
+        query = db.exec("UPDATE qtorm_schema SET fingerprint = 'stale' WHERE tableName = 'Town'");
+        QCOMPARE(query.lastError().type(), QSqlError::NoError);
+
+        db.close();
+        QSqlDatabase::removeDatabase(QSqlDatabase::defaultConnection);
+    }
+
+    auto snapshotLoads = []() {
+        QOrmTracer::stop();
+        QJsonDocument trace = QJsonDocument::fromJson(QOrmTracer::toChromeTraceJson());
+        QOrmTracer::clear();
+
+        int count = 0;
+
+        for (const QJsonValue& value : trace.object().value("traceEvents").toArray())
+        {
+            if (value.toObject().value("name").toString() ==
+                "QOrmSqliteProvider::loadSchemaSnapshot")
+            {
+                ++count;
+            }
+        }
+
+        return count;
+    };
+
+    {
+        QOrmSession session{QOrmSessionConfiguration::fromFile(":/qtorm_update_schema.json")};
+
+        QOrmTracer::start();
+        QCOMPARE(session.from<Province>().select().error().type(), QOrm::ErrorType::None);
+        QCOMPARE(snapshotLoads(), 0);
+
+        QOrmTracer::start();
+        QCOMPARE(session.from<Town>().select().error().type(), QOrm::ErrorType::None);
+        QCOMPARE(snapshotLoads(), 1);
+    }
+
+    {
+        QOrmSession session{QOrmSessionConfiguration::fromFile(":/qtorm_update_schema.json")};
+
+        QOrmTracer::start();
+        QCOMPARE(session.from<Person>().select().error().type(), QOrm::ErrorType::None);
+        QCOMPARE(snapshotLoads(), 0);
+    }
+}
+
+void SqliteSessionTest::testSchemaValidate()
+{
+    QOrmSqliteConfiguration sqliteConfiguration{};
+    sqliteConfiguration.setSchemaMode(QOrmSqliteConfiguration::SchemaMode::Validate);
+    sqliteConfiguration.setDatabaseName("testdb.db");
+
+    {
+        QOrmSessionConfiguration sessionConfiguration{new QOrmSqliteProvider{sqliteConfiguration},
+                                                      true};
+        QOrmSession session{sessionConfiguration};
+        QCOMPARE(session.from<Province>().select().error().type(),
+                 QOrm::ErrorType::UnsynchronizedSchema);
+    }
+
+    {
+        QOrmSession session{QOrmSessionConfiguration::fromFile(":/qtorm_update_schema.json")};
+        QCOMPARE(session.from<Person>().select().error().type(), QOrm::ErrorType::None);
+    }
+
+    {
+        QOrmSessionConfiguration sessionConfiguration{new QOrmSqliteProvider{sqliteConfiguration},
+                                                      true};
+        QOrmSession session{sessionConfiguration};
+        QCOMPARE(session.from<Person>().select().error().type(), QOrm::ErrorType::None);
+    }
+}
+
+class TownWithIndexes : public Town
+{
+    Q_OBJECT
+
+    Q_ORM_CLASS(TABLE Town INDEX (province, name))
+    Q_ORM_PROPERTY(name UNIQUE)
+
+public:
+    Q_INVOKABLE explicit TownWithIndexes(QObject* parent = nullptr)
+        : Town{parent}
+    {
+    }
+};
+
+static QStringList indexNames(QSqlDatabase& db)
+{
+    QSqlQuery query = db.exec("SELECT name FROM sqlite_master WHERE type = 'index' AND "
+                              "tbl_name = 'Town' AND sql IS NOT NULL ORDER BY name");
+    QStringList result;
+
+    while (query.next())
+        result.push_back(query.value(0).toString());
+
+    return result;
+}
+
+void SqliteSessionTest::testSchemaIndexes()
+{
+    qRegisterOrmEntity<TownWithIndexes>();
+
+    {
+        QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE");
+        db.setDatabaseName("testdb.db");
+        QVERIFY(db.open());
+
+        QStringList statements{"CREATE TABLE Town(id INTEGER PRIMARY KEY AUTOINCREMENT"
+                               ", postalCode INTEGER"
+                               ", name TEXT"
+                               ", province_id INTEGER)",
+                               "CREATE INDEX town_by_postal_code ON Town(postalCode)",
+                               "CREATE INDEX town_by_province ON Town(province_id)",
+                               "INSERT INTO Town(postalCode, name) VALUES(4232, 'Hagenberg')"};
+
+        for (const QString& statement : statements)
+        {
+            QSqlQuery query = db.exec(statement);
+            QCOMPARE(query.lastError().type(), QSqlError::NoError);
+        }
+
+        db.close();
+        QSqlDatabase::removeDatabase(QSqlDatabase::defaultConnection);
+    }
+
+    // The table is rebuilt without postalCode: the index on it is lost, the other one is restored
+    {
+        QOrmSession session{QOrmSessionConfiguration::fromFile(":/qtorm_update_schema.json")};
+        QCOMPARE(session.from<TownWithIndexes>().select().error().type(), QOrm::ErrorType::None);
+
+        // The name is unique now
+        TownWithIndexes* town = new TownWithIndexes;
+        town->setName("Hagenberg");
+        QVERIFY(!session.merge(town));
+    }
+
+    {
+        QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE");
+        db.setDatabaseName("testdb.db");
+        QVERIFY(db.open());
+
+        QCOMPARE(indexNames(db),
+                 (QStringList{"qtorm_Town_name_key",
+                              "qtorm_Town_province_id_name_idx",
+                              "town_by_province"}));
+
+        QSqlQuery query = db.exec("DROP INDEX qtorm_Town_province_id_name_idx");
+        QCOMPARE(query.lastError().type(), QSqlError::NoError);
+
+        db.close();
+        QSqlDatabase::removeDatabase(QSqlDatabase::defaultConnection);
+    }
+
+    QOrmSqliteConfiguration sqliteConfiguration{};
+    sqliteConfiguration.setSchemaMode(QOrmSqliteConfiguration::SchemaMode::Validate);
+    sqliteConfiguration.setDatabaseName("testdb.db");
+
+    // The fingerprint still matches: the table is not inspected
+    {
+        QOrmSessionConfiguration sessionConfiguration{new QOrmSqliteProvider{sqliteConfiguration},
+                                                      true};
+        QOrmSession session{sessionConfiguration};
+        QCOMPARE(session.from<TownWithIndexes>().select().error().type(), QOrm::ErrorType::None);
+    }
+
+    {
+        QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE");
+        db.setDatabaseName("testdb.db");
+        QVERIFY(db.open());
+
+        QSqlQuery query = db.exec("DELETE FROM qtorm_schema");
+        QCOMPARE(query.lastError().type(), QSqlError::NoError);
+
+        db.close();
+        QSqlDatabase::removeDatabase(QSqlDatabase::defaultConnection);
+    }
+
+    {
+        QOrmSessionConfiguration sessionConfiguration{new QOrmSqliteProvider{sqliteConfiguration},
+                                                      true};
+        QOrmSession session{sessionConfiguration};
+        QCOMPARE(session.from<TownWithIndexes>().select().error().type(),
+                 QOrm::ErrorType::UnsynchronizedSchema);
+    }
+
+    // Append mode creates the missing index
+    sqliteConfiguration.setSchemaMode(QOrmSqliteConfiguration::SchemaMode::Append);
+
+    {
+        QOrmSessionConfiguration sessionConfiguration{new QOrmSqliteProvider{sqliteConfiguration},
+                                                      true};
+        QOrmSession session{sessionConfiguration};
+        QCOMPARE(session.from<TownWithIndexes>().select().error().type(), QOrm::ErrorType::None);
+    }
+
+    {
+        QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE");
+        db.setDatabaseName("testdb.db");
+        QVERIFY(db.open());
+
+        QVERIFY(indexNames(db).contains("qtorm_Town_province_id_name_idx"));
+
+        db.close();
+        QSqlDatabase::removeDatabase(QSqlDatabase::defaultConnection);
+    }
+}
+
+void SqliteSessionTest::testSchemaForeignKeys()
+{
+    {
+        QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE");
+        db.setDatabaseName("testdb.db");
+        QVERIFY(db.open());
+
+        QStringList statements{
+            "CREATE TABLE Province(id INTEGER PRIMARY KEY AUTOINCREMENT, name TEXT)",
+            "CREATE TABLE Town(id INTEGER PRIMARY KEY AUTOINCREMENT, name TEXT, "
+            "province_id INTEGER)",
+            "INSERT INTO Province(name) VALUES('Upper Austria')",
+            "INSERT INTO Town(name, province_id) VALUES('Hagenberg', 1)"};
+
+        for (const QString& statement : statements)
+        {
+            QSqlQuery query = db.exec(statement);
+            QCOMPARE(query.lastError().type(), QSqlError::NoError);
+        }
+
+        db.close();
+        QSqlDatabase::removeDatabase(QSqlDatabase::defaultConnection);
+    }
+
+    QOrmSqliteConfiguration sqliteConfiguration{};
+    sqliteConfiguration.setSchemaMode(QOrmSqliteConfiguration::SchemaMode::Validate);
+    sqliteConfiguration.setForeignKeys(true);
+    sqliteConfiguration.setDatabaseName("testdb.db");
+
+    {
+        QOrmSessionConfiguration sessionConfiguration{new QOrmSqliteProvider{sqliteConfiguration},
+                                                      true};
+        QOrmSession session{sessionConfiguration};
+        QCOMPARE(session.from<Town>().select().error().type(),
+                 QOrm::ErrorType::UnsynchronizedSchema);
+    }
+
+    // The table is rebuilt with the foreign key constraint and the index on the reference column
+    sqliteConfiguration.setSchemaMode(QOrmSqliteConfiguration::SchemaMode::Update);
+
+    {
+        QOrmSessionConfiguration sessionConfiguration{new QOrmSqliteProvider{sqliteConfiguration},
+                                                      true};
+        QOrmSession session{sessionConfiguration};
+
+        QOrmQueryResult<Province> provinces = session.from<Province>().select();
+        QCOMPARE(provinces.error().type(), QOrm::ErrorType::None);
+        QCOMPARE(provinces.toVector().size(), 1);
+
+        QOrmQueryResult<Town> towns = session.from<Town>().select();
+        QCOMPARE(towns.error().type(), QOrm::ErrorType::None);
+        QCOMPARE(towns.toVector().size(), 1);
+
+        // The province is still referenced by the town
+        QVERIFY(session.remove(provinces.toVector().first()) == nullptr);
+    }
+
+    {
+        QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE");
+        db.setDatabaseName("testdb.db");
+        QVERIFY(db.open());
+
+        QSqlQuery query = db.exec("PRAGMA foreign_key_list(Town)");
+        QVERIFY(query.next());
+        QCOMPARE(query.value("from").toString(), "province_id");
+        QCOMPARE(query.value("table").toString(), "Province");
+
+        QVERIFY(indexNames(db).contains("qtorm_Town_province_id_idx"));
+
+        db.close();
+        QSqlDatabase::removeDatabase(QSqlDatabase::defaultConnection);
+    }
+
+    sqliteConfiguration.setSchemaMode(QOrmSqliteConfiguration::SchemaMode::Validate);
+
+    {
+        QOrmSessionConfiguration sessionConfiguration{new QOrmSqliteProvider{sqliteConfiguration},
+                                                      true};
+        QOrmSession session{sessionConfiguration};
+        QCOMPARE(session.from<Town>().select().error().type(), QOrm::ErrorType::None);
+    }
+}
+
+class TownWithLowerCaseIndex : public Town
+{
+    Q_OBJECT
+
+    Q_ORM_CLASS(TABLE Town INDEX (lower(name)) INDEX (name) WHERE (province != null))
+
+public:
+    Q_INVOKABLE explicit TownWithLowerCaseIndex(QObject* parent = nullptr)
+        : Town{parent}
+    {
+    }
+};
+
+void SqliteSessionTest::testCaseInsensitiveIndex()
+{
+    qRegisterOrmEntity<TownWithLowerCaseIndex>();
+
+    QOrmSqliteConfiguration sqliteConfiguration{};
+    sqliteConfiguration.setSchemaMode(QOrmSqliteConfiguration::SchemaMode::Recreate);
+    sqliteConfiguration.setDatabaseName("testdb.db");
+
+    {
+        QOrmSessionConfiguration sessionConfiguration{new QOrmSqliteProvider{sqliteConfiguration},
+                                                      true};
+        QOrmSession session{sessionConfiguration};
+
+        TownWithLowerCaseIndex* town = new TownWithLowerCaseIndex;
+        town->setName("Hagenberg");
+        QVERIFY(session.merge(town));
+
+        auto result = session.from<TownWithLowerCaseIndex>()
+                          .filter(Q_ORM_CLASS_PROPERTY(name).equalsIgnoreCase("HAGENBERG"))
+                          .select()
+                          .toVector();
+        QCOMPARE(result.size(), 1);
+        QCOMPARE(result.first(), town);
+
+        QCOMPARE(session.from<TownWithLowerCaseIndex>()
+                     .filter(Q_ORM_CLASS_PROPERTY(name) == QString{"HAGENBERG"})
+                     .select()
+                     .toVector()
+                     .size(),
+                 0);
+    }
+
+    {
+        QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE");
+        db.setDatabaseName("testdb.db");
+        QVERIFY(db.open());
+
+        QCOMPARE(indexNames(db),
+                 (QStringList{"qtorm_Town_lower_name_idx",
+                              "qtorm_Town_name_partial_idx",
+                              "qtorm_Town_province_id_idx"}));
+
+        QSqlQuery query =
+            db.exec(R"(EXPLAIN QUERY PLAN SELECT * FROM "Town" WHERE lower("name") = lower('x'))");
+        QVERIFY(query.next());
+        QVERIFY(query.value("detail").toString().contains("qtorm_Town_lower_name_idx"));
+
+        db.close();
+        QSqlDatabase::removeDatabase(QSqlDatabase::defaultConnection);
+    }
+}
+
+void SqliteSessionTest::testPerformanceSettings()
+{
+    QOrmSqliteConfiguration sqliteConfiguration{};
+    sqliteConfiguration.setSchemaMode(QOrmSqliteConfiguration::SchemaMode::Recreate);
+    sqliteConfiguration.setDatabaseName("testdb.db");
+    sqliteConfiguration.applyPerformancePreset(
+        QOrmSqliteConfiguration::PerformancePreset::Throughput);
+    sqliteConfiguration.setCacheSize(-2000);
+    sqliteConfiguration.setPageSize(8192);
+
+    QOrmSqliteProvider* provider = new QOrmSqliteProvider{sqliteConfiguration};
+    QOrmSessionConfiguration sessionConfiguration{provider, true};
+    QOrmSession session{sessionConfiguration};
+
+    auto pragma = [provider](const QString& name) {
+        QSqlQuery query = provider->database().exec("PRAGMA " + name);
+        return query.next() ? query.value(0).toString() : QString{};
+    };
+
+    QCOMPARE(session.from<Province>().select().error().type(), QOrm::ErrorType::None);
+
+    QCOMPARE(pragma("journal_mode"), "wal");
+    QCOMPARE(pragma("synchronous"), "1");
+    QCOMPARE(pragma("cache_size"), "-2000");
+    QCOMPARE(pragma("temp_store"), "2");
+    QCOMPARE(pragma("busy_timeout"), "5000");
+    QCOMPARE(pragma("page_size"), "8192");
+
+    // The settings are applied again on reconnect
+    QCOMPARE(provider->disconnectFromBackend().type(), QOrm::ErrorType::None);
+    QCOMPARE(provider->connectToBackend().type(), QOrm::ErrorType::None);
+
+    QCOMPARE(pragma("cache_size"), "-2000");
+    QCOMPARE(pragma("synchronous"), "1");
+}
+
+void SqliteSessionTest::testConcurrentProviders()
+{
+    constexpr int ProviderCount = 4;
+    constexpr int ProvinceCount = 100;
+
+    auto databaseName = [](int i) { return QString{"testdb_%1.db"}.arg(i); };
+
+    // Two providers in one thread do not share a connection
+    {
+        QOrmSqliteConfiguration sqliteConfiguration{};
+        sqliteConfiguration.setSchemaMode(QOrmSqliteConfiguration::SchemaMode::Recreate);
+
+        sqliteConfiguration.setDatabaseName(databaseName(0));
+        QOrmSession first{QOrmSessionConfiguration{new QOrmSqliteProvider{sqliteConfiguration},
+                                                   true}};
+
+        sqliteConfiguration.setDatabaseName(databaseName(1));
+        QOrmSession second{QOrmSessionConfiguration{new QOrmSqliteProvider{sqliteConfiguration},
+                                                    true}};
+
+        QVERIFY(first.merge(new Province{"Upper Austria"}));
+        QVERIFY(second.merge(new Province{"Lower Austria"}, new Province{"Salzburg"}));
+
+        QCOMPARE(first.from<Province>().select().toVector().size(), 1);
+        QCOMPARE(second.from<Province>().select().toVector().size(), 2);
+    }
+
+    std::array<int, ProviderCount> counts{};
+    std::vector<std::unique_ptr<QThread>> threads;
+
+    for (int i = 0; i < ProviderCount; ++i)
+    {
+        threads.emplace_back(QThread::create([i, &counts, &databaseName]() {
+            QOrmSqliteConfiguration sqliteConfiguration{};
+            sqliteConfiguration.setSchemaMode(QOrmSqliteConfiguration::SchemaMode::Recreate);
+            sqliteConfiguration.setDatabaseName(databaseName(i));
+
+            QOrmSession session{
+                QOrmSessionConfiguration{new QOrmSqliteProvider{sqliteConfiguration}, true}};
+
+            for (int j = 0; j < ProvinceCount; ++j)
+            {
+                if (!session.merge(new Province{QString::number(j)}))
+                    return;
+            }
+
+            counts[static_cast<size_t>(i)] = session.from<Province>().select().toVector().size();
+        }));
+
+        threads.back()->start();
+    }
+
+    for (const std::unique_ptr<QThread>& thread : threads)
+        QVERIFY(thread->wait(60000));
+
+    for (int i = 0; i < ProviderCount; ++i)
+    {
+        QCOMPARE(counts[static_cast<size_t>(i)], ProvinceCount);
+        QVERIFY(QFile::remove(databaseName(i)));
+    }
+}
+
+void SqliteSessionTest::testAsyncSelectAndMerge()
+{
+    QOrmSqliteConfiguration sqliteConfiguration{};
+    sqliteConfiguration.setSchemaMode(QOrmSqliteConfiguration::SchemaMode::Recreate);
+    sqliteConfiguration.setDatabaseName("testdb.db");
+
+    QOrmSession session{
+        QOrmSessionConfiguration{new QOrmSqliteProvider{sqliteConfiguration}, true}};
+
+    auto upperAustria = new Province{"Upper Austria"};
+    QVERIFY(session.merge(upperAustria));
+
+    auto lowerAustria = new Province{"Lower Austria"};
+    QFuture<QOrmQueryResult<Province>> merged = session.mergeAsync(lowerAustria);
+
+    QTRY_VERIFY(merged.isFinished());
+    QVERIFY(!merged.result().hasError());
+    QCOMPARE(merged.result().toVector(), QVector<Province*>{lowerAustria});
+    QVERIFY(lowerAustria->id() != 0);
+    QVERIFY(session.entityInstanceCache()->contains(lowerAustria));
+
+    // The instances read in the database thread are adopted by the session
+    QFuture<QOrmQueryResult<Province>> selected =
+        session.from<Province>().order(Q_ORM_CLASS_PROPERTY(name)).selectAsync();
+
+    QTRY_VERIFY(selected.isFinished());
+    QCOMPARE(selected.result().toVector(), (QVector<Province*>{lowerAustria, upperAustria}));
+
+    QObject receiver;
+    QVector<Province*> received;
+
+    session.from<Province>()
+        .filter(Q_ORM_CLASS_PROPERTY(name) == QString{"Lower Austria"})
+        .selectAsync(&receiver, [&received](const QOrmQueryResult<Province>& result) {
+            received = result.toVector();
+        });
+
+    QTRY_COMPARE(received, QVector<Province*>{lowerAustria});
+
+    // Rows that are not cached yet become instances of the session thread
+    {
+        QSqlQuery query{static_cast<QOrmSqliteProvider*>(session.configuration().provider())
+                            ->database()};
+        QVERIFY(query.exec("INSERT INTO Province(name) VALUES('Salzburg')"));
+    }
+
+    selected = session.from<Province>()
+                   .filter(Q_ORM_CLASS_PROPERTY(name) == QString{"Salzburg"})
+                   .selectAsync();
+
+    QTRY_VERIFY(selected.isFinished());
+    QCOMPARE(selected.result().toVector().size(), 1);
+
+    Province* salzburg = selected.result().toVector().first();
+    QCOMPARE(salzburg->thread(), QThread::currentThread());
+    QVERIFY(session.entityInstanceCache()->contains(salzburg));
+}
+
+void SqliteSessionTest::testAsyncTransaction()
+{
+    QOrmSqliteConfiguration sqliteConfiguration{};
+    sqliteConfiguration.setSchemaMode(QOrmSqliteConfiguration::SchemaMode::Recreate);
+    sqliteConfiguration.setDatabaseName("testdb.db");
+
+    QOrmSession session{
+        QOrmSessionConfiguration{new QOrmSqliteProvider{sqliteConfiguration}, true}};
+
+    QFuture<QOrmError> committed = session.commitTransactionAsync();
+    QTRY_VERIFY(committed.isFinished());
+    QCOMPARE(committed.result().type(), QOrm::ErrorType::TransactionNotActive);
+
+    std::unique_ptr<Province> tyrol = std::make_unique<Province>("Tyrol");
+
+    {
+        QOrmAsyncTransaction transaction{&session};
+
+        QFuture<QOrmQueryResult<Province>> merged = session.mergeAsync(tyrol.get());
+        QTRY_VERIFY(merged.isFinished());
+        QVERIFY(!merged.result().hasError());
+        QVERIFY(session.entityInstanceCache()->contains(tyrol.get()));
+
+        QFuture<QOrmError> rolledBack = transaction.rollback();
+        QVERIFY(!transaction.isActive());
+        QTRY_VERIFY(rolledBack.isFinished());
+        QCOMPARE(rolledBack.result().type(), QOrm::ErrorType::None);
+    }
+
+    QVERIFY(!session.entityInstanceCache()->contains(tyrol.get()));
+    QVERIFY(session.from<Province>().select().toVector().isEmpty());
+
+    {
+        QOrmAsyncTransaction transaction{&session};
+
+        QFuture<QOrmQueryResult<Province>> merged = session.mergeAsync(tyrol.get());
+        committed = transaction.commit();
+
+        QTRY_VERIFY(committed.isFinished());
+        QVERIFY(!merged.result().hasError());
+        QCOMPARE(committed.result().type(), QOrm::ErrorType::None);
+    }
+
+    QVERIFY(session.entityInstanceCache()->contains(tyrol.get()));
+    QCOMPARE(session.from<Province>().select().toVector(), QVector<Province*>{tyrol.release()});
+
+    std::unique_ptr<QOrmAsyncTransaction> abandoned;
+
+    {
+        QOrmSession shortLivedSession{
+            QOrmSessionConfiguration{new QOrmSqliteProvider{sqliteConfiguration}, true}};
+        abandoned = std::make_unique<QOrmAsyncTransaction>(&shortLivedSession);
+    }
+
+    committed = abandoned->commit();
+    QVERIFY(committed.isCanceled());
+    abandoned.reset();
+}
+
+void SqliteSessionTest::testAsyncWorkloadRecordedIntoSharedLog()
+{
+    QTemporaryDir temporaryDir;
+    QVERIFY(temporaryDir.isValid());
+
+    QString logFileName = temporaryDir.filePath("workload.qtormlog");
+
+    {
+        QOrmSqliteConfiguration sqliteConfiguration{};
+        sqliteConfiguration.setSchemaMode(QOrmSqliteConfiguration::SchemaMode::Recreate);
+        sqliteConfiguration.setDatabaseName("testdb.db");
+        sqliteConfiguration.setWorkloadLogFile(logFileName);
+
+        QOrmSession session{
+            QOrmSessionConfiguration{new QOrmSqliteProvider{sqliteConfiguration}, true}};
+
+        QVERIFY(session.merge(new Province{"Upper Austria"}));
+
+        qint64 statementCount = session.statistics()->statementCount();
+
+        QFuture<QOrmQueryResult<Province>> merged =
+            session.mergeAsync(new Province{"Lower Austria"});
+
+        QTRY_VERIFY(merged.isFinished());
+        QVERIFY(!merged.result().hasError());
+
+        // The statements executed by the worker thread are counted by the session
+        QVERIFY(session.statistics()->statementCount() > statementCount);
+    }
+
+    QOrmPrivate::WorkloadLogReader reader;
+    QVERIFY2(reader.open(logFileName), qPrintable(reader.errorString()));
+
+    QOrmPrivate::WorkloadEvent event;
+    QSet<quint32> insertingConnections;
+
+    while (reader.readNext(event))
+    {
+        if (event.statement.startsWith("INSERT INTO"))
+            insertingConnections.insert(event.connection);
+    }
+
+    QVERIFY2(reader.errorString().isEmpty(), qPrintable(reader.errorString()));
+    QCOMPARE(insertingConnections.size(), 2);
+}
+
+#ifdef QTORM_HAVE_COROUTINES
+namespace
+{
+    QOrmTask<> mergeAndSelect(QOrmSession& session,
+                              Province* province,
+                              QVector<Province*>& provinces)
+    {
+        QOrmAsyncTransaction transaction{&session};
+
+        QOrmQueryResult<Province> merged = co_await session.mergeAsync(province);
+
+        if (merged.hasError())
+            co_return;
+
+        QOrmError committed = co_await transaction.commit();
+
+        if (committed.type() != QOrm::ErrorType::None)
+            co_return;
+
+        QOrmQueryResult<Province> selected =
+            co_await session.from<Province>().order(Q_ORM_CLASS_PROPERTY(name)).selectAsync();
+
+        provinces = selected.toVector();
+    }
+} // namespace
+#endif
+
+void SqliteSessionTest::testCoroutines()
+{
+#ifdef QTORM_HAVE_COROUTINES
+    QOrmSqliteConfiguration sqliteConfiguration{};
+    sqliteConfiguration.setSchemaMode(QOrmSqliteConfiguration::SchemaMode::Recreate);
+    sqliteConfiguration.setDatabaseName("testdb.db");
+
+    QOrmSession session{
+        QOrmSessionConfiguration{new QOrmSqliteProvider{sqliteConfiguration}, true}};
+
+    auto upperAustria = new Province{"Upper Austria"};
+    QVERIFY(session.merge(upperAustria));
+
+    auto lowerAustria = new Province{"Lower Austria"};
+    QVector<Province*> provinces;
+
+    QOrmTask<> task = mergeAndSelect(session, lowerAustria, provinces);
+    QVERIFY(!task.isDone());
+
+    QTRY_VERIFY(task.isDone());
+    QCOMPARE(provinces, (QVector<Province*>{lowerAustria, upperAustria}));
+#else
+    QSKIP("QtOrm is not used from C++20 code");
+#endif
+}
+
+void SqliteSessionTest::testStream()
+{
+    QOrmSqliteConfiguration sqliteConfiguration{};
+    sqliteConfiguration.setSchemaMode(QOrmSqliteConfiguration::SchemaMode::Recreate);
+    sqliteConfiguration.setDatabaseName("testdb.db");
+
+    QOrmSession session{
+        QOrmSessionConfiguration{new QOrmSqliteProvider{sqliteConfiguration}, true}};
+
+    auto upperAustria = new Province{"Upper Austria"};
+    auto lowerAustria = new Province{"Lower Austria"};
+    QVERIFY(session.merge(upperAustria, lowerAustria));
+
+    // Rows that are not cached yet
+    {
+        QSqlQuery query{static_cast<QOrmSqliteProvider*>(session.configuration().provider())
+                            ->database()};
+        QVERIFY(query.exec("INSERT INTO Province(name) VALUES('Salzburg'), ('Tyrol'), ('Vienna')"));
+    }
+
+    QOrmCursor<Province> cursor = session.from<Province>()
+                                      .order(Q_ORM_CLASS_PROPERTY(name))
+                                      .stream(QOrm::QueryFlags::ReleaseConsumedInstances);
+
+    // Instances cached before streaming are kept, so are the ones taken from the cache
+    QCOMPARE(cursor.next(), lowerAustria);
+
+    Province* salzburg = cursor.next();
+    QVERIFY(salzburg != nullptr);
+    QCOMPARE(salzburg->name(), QString{"Salzburg"});
+    std::unique_ptr<QObject> takenSalzburg{session.entityInstanceCache()->take(salzburg)};
+
+    QPointer<Province> tyrol = cursor.next();
+    QVERIFY(!tyrol.isNull());
+    QCOMPARE(tyrol->name(), QString{"Tyrol"});
+    QVERIFY(session.entityInstanceCache()->contains(tyrol));
+
+    QCOMPARE(cursor.next(), upperAustria);
+    QVERIFY(tyrol.isNull());
+
+    QPointer<Province> vienna = cursor.next();
+    QVERIFY(!vienna.isNull());
+    QVERIFY(cursor.next() == nullptr);
+    QVERIFY(vienna.isNull());
+    QVERIFY(!cursor.hasError());
+
+    QVERIFY(!session.entityInstanceCache()->contains(salzburg));
+    QCOMPARE(salzburg->name(), QString{"Salzburg"});
+
+    QStringList names;
+
+    for (Province* province : session.from<Province>()
+                                  .filter(Q_ORM_CLASS_PROPERTY(name) != QString{"Tyrol"})
+                                  .order(Q_ORM_CLASS_PROPERTY(name))
+                                  .stream())
+    {
+        names.push_back(province->name());
+    }
+
+    QCOMPARE(names, (QStringList{"Lower Austria", "Salzburg", "Upper Austria", "Vienna"}));
+
+    // The province read for a town refers to all of its towns: the row releases all of them
+    QVERIFY(session.from<Town>().select().toVector().isEmpty());
+
+    {
+        QSqlQuery query{static_cast<QOrmSqliteProvider*>(session.configuration().provider())
+                            ->database()};
+
+        for (const QString& name : {"Innsbruck", "Kufstein", "Lienz"})
+        {
+            QVERIFY(query.prepare("INSERT INTO Town(name, province_id) "
+                                  "SELECT :name, id FROM Province WHERE name = 'Tyrol'"));
+            query.bindValue(":name", name);
+            QVERIFY(query.exec());
+        }
+    }
+
+    int cachedInstanceCount = session.entityInstanceCache()->instances().size();
+
+    QOrmCursor<Town> towns = session.from<Town>()
+                                 .order(Q_ORM_CLASS_PROPERTY(name))
+                                 .stream(QOrm::QueryFlags::ReleaseConsumedInstances);
+
+    QPointer<Town> innsbruck = towns.next();
+    QVERIFY(!innsbruck.isNull());
+    QPointer<Province> tyrolOfInnsbruck = innsbruck->province();
+    QVERIFY(!tyrolOfInnsbruck.isNull());
+    QVERIFY(tyrolOfInnsbruck->towns().contains(innsbruck.data()));
+
+    QPointer<Town> kufstein = towns.next();
+    QVERIFY(!kufstein.isNull());
+    QVERIFY(innsbruck.isNull());
+    QVERIFY(tyrolOfInnsbruck.isNull());
+    QCOMPARE(kufstein->province()->towns().size(), 3);
+    QCOMPARE(session.entityInstanceCache()->instances().size(), cachedInstanceCount + 4);
+
+    // The other instances of the row may refer to a taken instance, so they are kept as well
+    std::unique_ptr<QObject> takenKufstein{session.entityInstanceCache()->take(kufstein)};
+    QPointer<Province> tyrolOfKufstein = kufstein->province();
+
+    Town* lienz = towns.next();
+    QVERIFY(lienz != nullptr);
+    QVERIFY(!tyrolOfKufstein.isNull());
+    QCOMPARE(lienz->province(), tyrolOfKufstein.data());
+    QVERIFY(towns.next() == nullptr);
+    QVERIFY(!towns.hasError());
+
+    // A cursor outliving its session returns no more rows
+    std::optional<QOrmCursor<Province>> orphanedCursor;
+
+    {
+        QOrmSqliteConfiguration memoryConfiguration{};
+        memoryConfiguration.setDatabaseName(":memory:");
+
+        QOrmSession shortLivedSession{
+            QOrmSessionConfiguration{new QOrmSqliteProvider{memoryConfiguration}, true}};
+        QVERIFY(shortLivedSession.merge(new Province{"Carinthia"}, new Province{"Styria"}));
+
+        orphanedCursor.emplace(shortLivedSession.from<Province>().stream());
+        QVERIFY(orphanedCursor->next() != nullptr);
+    }
+
+    QVERIFY(orphanedCursor->next() == nullptr);
+    QVERIFY(orphanedCursor->hasError());
+}
+
 QTEST_GUILESS_MAIN(SqliteSessionTest)
 
 #include "tst_ormsession.moc"
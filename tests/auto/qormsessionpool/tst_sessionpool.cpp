@@ -0,0 +1,215 @@
+/*
+ * Copyright (C) 2020-2021 Dmitriy Purgin <dpurgin@gmail.com>
+ * Copyright (C) 2019-2022 Dmitriy Purgin <dmitriy.purgin@sequality.at>
+ * Copyright (C) 2019-2022 sequality software engineering e.U. <office@sequality.at>
+ *
+ * This file is part of QtOrm library.
+ *
+ * QtOrm is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QtOrm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QtOrm.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <QtTest>
+
+#include <QOrmError>
+#include <QOrmSession>
+#include <QOrmSessionPool>
+#include <QOrmSqliteConfiguration>
+
+#include "domain/province.h"
+#include "domain/town.h"
+
+#include <array>
+#include <memory>
+#include <thread>
+#include <vector>
+
+class SessionPoolTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+
+    void testSessionPool();
+    void testRetiredConnections();
+};
+
+void SessionPoolTest::init()
+{
+    for (const QString& fileName : {"testdb.db", "testdb.db-wal", "testdb.db-shm"})
+    {
+        QFile db{fileName};
+
+        if (db.exists())
+            QVERIFY(db.remove());
+    }
+
+    qRegisterOrmEntity<Town, Province>();
+}
+
+void SessionPoolTest::testSessionPool()
+{
+    constexpr int ReaderCount = 4;
+
+    QOrmSqliteConfiguration sqliteConfiguration{};
+    sqliteConfiguration.setSchemaMode(QOrmSqliteConfiguration::SchemaMode::Recreate);
+    sqliteConfiguration.setDatabaseName("testdb.db");
+
+    QOrmSessionPool pool{sqliteConfiguration};
+    pool.setMaxReaderCount(ReaderCount);
+    pool.setCheckoutTimeout(100);
+
+    {
+        QOrmPooledSession writer = pool.writer();
+        QVERIFY(writer);
+        QVERIFY(!writer.isReadOnly());
+        QCOMPARE(writer->metadataCache(), pool.metadataCache().get());
+
+        QVERIFY(writer->merge(new Province{"Upper Austria"}, new Province{"Lower Austria"}));
+        QCOMPARE(writer->from<Town>().select().toVector().size(), 0);
+
+        // There is only one writer
+        QOrmPooledSession second = pool.writer();
+        QVERIFY(!second);
+        QCOMPARE(second.error().type(), QOrm::ErrorType::Other);
+    }
+
+    QCOMPARE(pool.activeSessionCount(), 0);
+    QCOMPARE(pool.idleSessionCount(), 1);
+
+    QOrmSession* readerSession = nullptr;
+
+    {
+        QOrmPooledSession reader = pool.reader();
+        QVERIFY(reader);
+        QVERIFY(reader.isReadOnly());
+        QCOMPARE(reader->metadataCache(), pool.metadataCache().get());
+        QCOMPARE(reader->from<Province>().select().toVector().size(), 2);
+
+        auto province = std::make_unique<Province>("Salzburg");
+        QVERIFY(!reader->merge(province));
+        QCOMPARE(reader->lastError().type(), QOrm::ErrorType::Provider);
+
+        readerSession = reader.session();
+    }
+
+    // The idle connection of the thread is reused
+    {
+        QOrmPooledSession reader = pool.reader();
+        QCOMPARE(reader.session(), readerSession);
+    }
+
+    // Readers see the last committed state while the writer is in a transaction
+    QOrmPooledSession writer = pool.writer();
+    QVERIFY(writer->beginTransaction());
+    QVERIFY(writer->merge(new Province{"Salzburg"}));
+
+    // Make room for the readers of the other threads
+    pool.closeIdleSessions();
+    QCOMPARE(pool.idleSessionCount(), 0);
+
+    std::array<int, ReaderCount> counts{};
+    std::vector<std::unique_ptr<QThread>> threads;
+
+    for (int i = 0; i < ReaderCount; ++i)
+    {
+        threads.emplace_back(QThread::create([i, &counts, &pool]() {
+            QOrmPooledSession reader = pool.reader();
+
+            if (reader)
+            {
+                counts[static_cast<size_t>(i)] =
+                    reader->from<Province>().select().toVector().size();
+            }
+        }));
+
+        threads.back()->start();
+    }
+
+    for (const std::unique_ptr<QThread>& thread : threads)
+        QVERIFY(thread->wait(60000));
+
+    for (int count : counts)
+        QCOMPARE(count, 2);
+
+    QVERIFY(writer->commitTransaction());
+    writer.release();
+
+    // The finished threads have closed their connections themselves
+    QCOMPARE(pool.idleSessionCount(), 0);
+
+    {
+        QOrmPooledSession reader = pool.reader();
+        QVERIFY(reader);
+        QCOMPARE(reader->from<Province>().select().toVector().size(), 3);
+    }
+
+    QCOMPARE(pool.idleSessionCount(), 1);
+}
+
+void SessionPoolTest::testRetiredConnections()
+{
+    QOrmSqliteConfiguration sqliteConfiguration{};
+    sqliteConfiguration.setSchemaMode(QOrmSqliteConfiguration::SchemaMode::Recreate);
+    sqliteConfiguration.setDatabaseName("testdb.db");
+
+    QOrmSessionPool pool{sqliteConfiguration};
+    pool.setMaxReaderCount(1);
+    pool.setCheckoutTimeout(100);
+
+    QVERIFY(pool.writer());
+    QVERIFY(pool.reader());
+    QCOMPARE(pool.idleSessionCount(), 2);
+
+    bool hasWriter = false;
+    bool hasReader = false;
+    auto checkout = [&pool, &hasWriter, &hasReader]() {
+        hasWriter = static_cast<bool>(pool.writer());
+        hasReader = static_cast<bool>(pool.reader());
+    };
+
+    // The idle connections of this thread are retired but still count against the limits
+    std::unique_ptr<QThread> thread{QThread::create(checkout)};
+    thread->start();
+    QVERIFY(thread->wait(60000));
+
+    QVERIFY(!hasWriter);
+    QVERIFY(!hasReader);
+    QCOMPARE(pool.idleSessionCount(), 0);
+
+    // This thread closes its retired connections
+    pool.closeIdleSessions();
+
+    thread.reset(QThread::create(checkout));
+    thread->start();
+    QVERIFY(thread->wait(60000));
+
+    QVERIFY(hasWriter);
+    QVERIFY(hasReader);
+
+    // The connections of a thread not started by QThread are closed by the next checkout at the
+    // latest
+    hasReader = false;
+    std::thread adopted{[&pool, &hasReader]() { hasReader = static_cast<bool>(pool.reader()); }};
+    adopted.join();
+    QVERIFY(hasReader);
+
+    QOrmPooledSession reader = pool.reader();
+    QVERIFY(reader);
+    QCOMPARE(pool.activeSessionCount(), 1);
+}
+
+QTEST_GUILESS_MAIN(SessionPoolTest)
+
+#include "tst_sessionpool.moc"
@@ -0,0 +1,15 @@
+QT = core testlib orm orm-private
+
+CONFIG += testcase warn_on silent c++17
+
+TARGET = tst_sessionstatistics
+
+SOURCES +=  tst_sessionstatistics.cpp \
+    domain/province.cpp \
+    domain/town.cpp \
+
+HEADERS += \
+    domain/province.h \
+    domain/town.h \
+
+RESOURCES += sessionstatistics.qrc
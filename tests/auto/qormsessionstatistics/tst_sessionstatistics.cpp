@@ -0,0 +1,276 @@
+/*
+ * Copyright (C) 2020-2021 Dmitriy Purgin <dpurgin@gmail.com>
+ * Copyright (C) 2019-2022 Dmitriy Purgin <dmitriy.purgin@sequality.at>
+ * Copyright (C) 2019-2022 sequality software engineering e.U. <office@sequality.at>
+ *
+ * This file is part of QtOrm library.
+ *
+ * QtOrm is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QtOrm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QtOrm.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <QtTest>
+
+#include <QOrmError>
+#include <QOrmSession>
+#include <QOrmSessionStatistics>
+#include <QOrmSqliteConfiguration>
+#include <QOrmSqliteProvider>
+
+#include "domain/province.h"
+#include "domain/town.h"
+
+#include "private/qormglobal_p.h"
+
+class SessionStatisticsTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+
+    void testStatisticsCountedPerEntityAndOperation();
+    void testSlowStatementsLoggedWithQueryPlan();
+    void testNPlusOneReferenceReadsDetected();
+    void testEngineStatisticsCollectedPerStatement();
+    void testEngineStatisticsSkippedWithoutNativeApi();
+    void testPageCacheSummedOverConnections();
+};
+
+void SessionStatisticsTest::init()
+{
+    for (const QString& fileName : {"testdb.db", "testdb.db-wal", "testdb.db-shm"})
+    {
+        QFile db{fileName};
+
+        if (db.exists())
+            QVERIFY(db.remove());
+    }
+
+    qRegisterOrmEntity<Town, Province>();
+}
+
+void SessionStatisticsTest::testStatisticsCountedPerEntityAndOperation()
+{
+    QOrmSession session;
+    QOrmSessionStatistics* statistics = session.statistics();
+
+    Province* upperAustria = new Province(QString::fromUtf8("Oberösterreich"));
+    Town* hagenberg = new Town(QString::fromUtf8("Hagenberg"), upperAustria);
+    Town* pregarten = new Town(QString::fromUtf8("Pregarten"), upperAustria);
+
+    QVERIFY(session.merge(upperAustria, hagenberg, pregarten));
+
+    QCOMPARE(statistics->entityStatistics<Province>()
+                 .operation(QOrm::Operation::Create)
+                 .statementCount(),
+             qint64{1});
+    QCOMPARE(statistics->entityStatistics<Town>().operation(QOrm::Operation::Create).rowsWritten(),
+             qint64{2});
+    QCOMPARE(statistics->transactionsBegun(), qint64{1});
+    QCOMPARE(statistics->transactionsCommitted(), qint64{1});
+    QCOMPARE(statistics->transactionsRolledBack(), qint64{0});
+
+    QOrmQueryResult<Town> towns = session.from<Town>().select();
+    QCOMPARE(towns.toVector().size(), 2);
+
+    QOrmEntityStatistics townStatistics = statistics->entityStatistics<Town>();
+    QCOMPARE(townStatistics.operation(QOrm::Operation::Read).statementCount(), qint64{1});
+    QCOMPARE(townStatistics.operation(QOrm::Operation::Read).rowsRead(), qint64{2});
+    QVERIFY(townStatistics.operation(QOrm::Operation::Read).percentileNsecs(50) > 0);
+    QCOMPARE(townStatistics.cacheHits(), qint64{2});
+    QCOMPARE(townStatistics.cacheMisses(), qint64{0});
+    QCOMPARE(statistics->statementCount(), qint64{4});
+
+    QSignalSpy changedSpy{statistics, &QOrmSessionStatistics::changed};
+    statistics->reset();
+
+    QCOMPARE(changedSpy.count(), 1);
+    QCOMPARE(statistics->statementCount(), qint64{0});
+    QCOMPARE(statistics->transactionsBegun(), qint64{0});
+    QCOMPARE(statistics->entityStatistics<Town>().cacheHits(), qint64{0});
+}
+
+void SessionStatisticsTest::testSlowStatementsLoggedWithQueryPlan()
+{
+    QOrmSqliteConfiguration sqliteConfiguration{};
+    sqliteConfiguration.setVerbose(false);
+    sqliteConfiguration.setSchemaMode(QOrmSqliteConfiguration::SchemaMode::Recreate);
+    sqliteConfiguration.setDatabaseName("testdb.db");
+    sqliteConfiguration.setSlowQueryThreshold(0);
+    sqliteConfiguration.setRedactSlowQueryParameters(true);
+    QOrmSqliteProvider* sqliteProvider = new QOrmSqliteProvider{sqliteConfiguration};
+    QOrmSession session{QOrmSessionConfiguration{sqliteProvider, true}};
+
+    QVERIFY(session.merge(new Province(QString::fromUtf8("Oberösterreich"))));
+
+    QTest::ignoreMessage(
+        QtWarningMsg,
+        QRegularExpression{R"(^Slow statement \(.+ ms, 1 rows\): SELECT [\s\S]*"Province")"
+                           R"([\s\S]*\n  Bound parameters: :name \(values redacted\))"
+                           R"(\n  Query plan:\n    SCAN)"});
+
+    QOrmQueryResult<Province> result =
+        session.from<Province>()
+            .filter(Q_ORM_CLASS_PROPERTY(name) == QString::fromUtf8("Oberösterreich"))
+            .select();
+    QCOMPARE(result.toVector().size(), 1);
+
+    QVERIFY(session.statistics()->slowStatements() > 0);
+}
+
+void SessionStatisticsTest::testNPlusOneReferenceReadsDetected()
+{
+    {
+        QOrmSession session;
+
+        for (const char* name : {"Oberösterreich", "Niederösterreich", "Steiermark"})
+        {
+            Province* province = new Province(QString::fromUtf8(name));
+            QVERIFY(session.merge(province, new Town(QString::fromUtf8(name), province)));
+        }
+    }
+
+    QOrmSession session{QOrmSessionConfiguration::fromFile(":/qtorm_bypass_schema.json")};
+    session.statistics()->setNPlusOneThreshold(2);
+
+    // Every town reads its province by ID, and every province reads its towns
+    QTest::ignoreMessage(QtWarningMsg,
+                         QRegularExpression{"^Possible N\\+1 query: .* while resolving "
+                                            "Town::province: SELECT [\\s\\S]*"
+                                            "Consider prefetching Town::province"});
+    QTest::ignoreMessage(QtWarningMsg,
+                         QRegularExpression{"^Possible N\\+1 query: .* while resolving "
+                                            "Province::towns: SELECT "});
+
+    QOrmQueryResult<Town> towns = session.from<Town>().select();
+    QCOMPARE(towns.toVector().size(), 3);
+    QCOMPARE(session.statistics()->nPlusOneDetections(), qint64{2});
+
+    session.statistics()->reset();
+    QCOMPARE(session.statistics()->nPlusOneDetections(), qint64{0});
+}
+
+void SessionStatisticsTest::testEngineStatisticsCollectedPerStatement()
+{
+    QOrmSession session;
+
+    QVERIFY(session.merge(new Province(QString::fromUtf8("Oberösterreich")),
+                          new Province(QString::fromUtf8("Niederösterreich"))));
+
+    if (!(session.configuration().provider()->capabilities() &
+          QOrmSqliteProvider::SupportsEngineStatistics))
+    {
+        QSKIP("QtOrm has been built without the native SQLite API");
+    }
+
+    QOrmSessionStatistics* statistics = session.statistics();
+    statistics->reset();
+
+    // No index on name: a full scan and a sort
+    QOrmQueryResult<Province> result =
+        session.from<Province>()
+            .filter(Q_ORM_CLASS_PROPERTY(name) != QString::fromUtf8("Wien"))
+            .order(Q_ORM_CLASS_PROPERTY(name))
+            .select();
+    QCOMPARE(result.toVector().size(), 2);
+
+    QVector<QOrmStatementStatistics> statements = statistics->statementStatistics();
+    QCOMPARE(statements.size(), 1);
+    QVERIFY(statements.front().statement().startsWith("SELECT"));
+    QCOMPARE(statements.front().executions(), qint64{1});
+    QCOMPARE(statements.front().sorts(), qint64{1});
+    QVERIFY(statements.front().fullScanSteps() > 0);
+    QVERIFY(statements.front().vmSteps() > 0);
+
+    QCOMPARE(statistics->sorts(), qint64{1});
+    QVERIFY(statistics->pageCacheHits() + statistics->pageCacheMisses() > 0);
+    QVERIFY(statistics->pageCacheUsed() > 0);
+}
+
+void SessionStatisticsTest::testEngineStatisticsSkippedWithoutNativeApi()
+{
+    QOrmPrivate::nativeSqliteApiDisabled = true;
+    auto nativeApiGuard = qScopeGuard([]() { QOrmPrivate::nativeSqliteApiDisabled = false; });
+
+    QOrmSession session;
+
+    QVERIFY(session.merge(new Province(QString::fromUtf8("Oberösterreich")),
+                          new Province(QString::fromUtf8("Niederösterreich"))));
+
+    QVERIFY(!(session.configuration().provider()->capabilities() &
+              QOrmSqliteProvider::SupportsEngineStatistics));
+
+    QOrmSessionStatistics* statistics = session.statistics();
+    statistics->reset();
+
+    QOrmQueryResult<Province> result =
+        session.from<Province>()
+            .filter(Q_ORM_CLASS_PROPERTY(name) != QString::fromUtf8("Wien"))
+            .order(Q_ORM_CLASS_PROPERTY(name))
+            .select();
+    QCOMPARE(result.toVector().size(), 2);
+
+    // Only the counters of QtOrm itself are collected
+    QCOMPARE(statistics->entityStatistics<Province>()
+                 .operation(QOrm::Operation::Read)
+                 .statementCount(),
+             qint64{1});
+    QCOMPARE(statistics->sorts(), qint64{0});
+    QCOMPARE(statistics->pageCacheHits() + statistics->pageCacheMisses(), qint64{0});
+    QCOMPARE(statistics->pageCacheUsed(), qint64{0});
+}
+
+void SessionStatisticsTest::testPageCacheSummedOverConnections()
+{
+    QOrmSession session;
+
+    QVERIFY(session.merge(new Province(QString::fromUtf8("Oberösterreich")),
+                          new Province(QString::fromUtf8("Niederösterreich"))));
+
+    if (!(session.configuration().provider()->capabilities() &
+          QOrmSqliteProvider::SupportsEngineStatistics))
+    {
+        QSKIP("QtOrm has been built without the native SQLite API");
+    }
+
+    QOrmSessionStatistics* statistics = session.statistics();
+    statistics->reset();
+
+    auto pageReads = [statistics]() {
+        return statistics->pageCacheHits() + statistics->pageCacheMisses();
+    };
+
+    QCOMPARE(session.from<Province>().select().toVector().size(), 2);
+
+    qint64 sessionPageReads = pageReads();
+    qint64 sessionPageCacheUsed = statistics->pageCacheUsed();
+    QVERIFY(sessionPageReads > 0);
+    QVERIFY(sessionPageCacheUsed > 0);
+
+    // The asynchronous worker reads through a fresh connection with counters of its own
+    QFuture<QOrmQueryResult<Province>> selected = session.from<Province>().selectAsync();
+    QTRY_VERIFY(selected.isFinished());
+    QCOMPARE(selected.result().toVector().size(), 2);
+
+    qint64 workerPageReads = pageReads();
+    QVERIFY(workerPageReads > sessionPageReads);
+    QVERIFY(statistics->pageCacheUsed() > sessionPageCacheUsed);
+
+    QCOMPARE(session.from<Province>().select().toVector().size(), 2);
+    QVERIFY(pageReads() > workerPageReads);
+}
+
+QTEST_GUILESS_MAIN(SessionStatisticsTest)
+
+#include "tst_sessionstatistics.moc"
@@ -36,8 +36,10 @@ class Community : public QObject
     Q_PROPERTY(bool hasLargePopulation READ hasLargePopulation STORED false)
     Q_PROPERTY(bool hasSmallPopulation READ hasSmallPopulation)
 
-    Q_ORM_CLASS(TABLE communities)
+    Q_ORM_CLASS(TABLE communities INDEX (province, name)
+                    INDEX (lower(name)) WHERE (population >= 1000 && province != null))
     Q_ORM_PROPERTY(communityId COLUMN community_id IDENTITY)
+    Q_ORM_PROPERTY(name UNIQUE)
     Q_ORM_PROPERTY(hasSmallPopulation TRANSIENT)
 
 public:
@@ -55,6 +55,7 @@ private slots:
     void testFilterWithReferenceExplicitId();
     void testFilterWithNull();
     void testFilterWithList();
+    void testFilterIgnoreCase();
 
     void testUpdateWithManyToOne();
     void testUpdateWithOneToMany();
@@ -64,6 +65,7 @@ private slots:
     void testDeleteWhereWithReturning();
 
     void testCreateTableWithReference();
+    void testCreateTableWithForeignKey();
     void testCreateTableWithManyToOne();
     void testCreateTableWithLong();
     void testCreateTableForCustomizedEntity();
@@ -73,9 +75,13 @@ private slots:
 
     void testAlterTableAddColumn();
     void testAlterTableAddColumnWithReference();
+    void testAlterTableAddColumnWithForeignKey();
+
+    void testCreateIndex();
 
     void testSelectWithLimitOffset();
     void testSelectWithNamespace();
+    void testSelectWithColumns();
     void testLimitOffset();
     void testLimitOffset_data();
 };
@@ -285,6 +291,35 @@ void SqliteStatementGenerator::testFilterWithList()
     }
 }
 
+void SqliteStatementGenerator::testFilterIgnoreCase()
+{
+    QOrmSqliteStatementGenerator generator;
+    QOrmMetadataCache cache;
+
+    {
+        QOrmFilter filter{QOrmPrivate::resolvedFilterExpression(
+            QOrmRelation{cache.get<Town>()},
+            Q_ORM_CLASS_PROPERTY(name).equalsIgnoreCase("Hagenberg"))};
+
+        QVariantMap boundParameters;
+        QString statement = generator.generateWhereClause(filter, boundParameters);
+
+        QCOMPARE(statement, R"(WHERE lower("name") = lower(:name))");
+        QCOMPARE(boundParameters[":name"], "Hagenberg");
+    }
+
+    {
+        QOrmFilter filter{QOrmPrivate::resolvedFilterExpression(
+            QOrmRelation{cache.get<Town>()},
+            Q_ORM_CLASS_PROPERTY(name).notEqualsIgnoreCase("Hagenberg"))};
+
+        QVariantMap boundParameters;
+        QString statement = generator.generateWhereClause(filter, boundParameters);
+
+        QCOMPARE(statement, R"(WHERE lower("name") <> lower(:name))");
+    }
+}
+
 void SqliteStatementGenerator::testUpdateWithManyToOne()
 {
     QOrmSqliteStatementGenerator generator;
@@ -381,6 +416,16 @@ void SqliteStatementGenerator::testCreateTableWithReference()
         R"(CREATE TABLE "Town"("id" INTEGER PRIMARY KEY AUTOINCREMENT,"name" TEXT,"province_id" INTEGER))");
 }
 
+void SqliteStatementGenerator::testCreateTableWithForeignKey()
+{
+    QOrmMetadataCache cache;
+    QOrmSqliteStatementGenerator generator{QOrmSqliteStatementGenerator::WithForeignKeys};
+
+    QCOMPARE(
+        generator.generateCreateTableStatement(cache.get<Town>()),
+        R"(CREATE TABLE "Town"("id" INTEGER PRIMARY KEY AUTOINCREMENT,"name" TEXT,"province_id" INTEGER REFERENCES "Province"("id")))");
+}
+
 void SqliteStatementGenerator::testCreateTableWithManyToOne()
 {
     QOrmMetadataCache cache;
@@ -447,6 +492,40 @@ void SqliteStatementGenerator::testAlterTableAddColumnWithReference()
     QCOMPARE(actual, R"(ALTER TABLE "Town" ADD COLUMN "province_id" INTEGER)");
 }
 
+void SqliteStatementGenerator::testAlterTableAddColumnWithForeignKey()
+{
+    QOrmMetadataCache cache;
+    QOrmSqliteStatementGenerator generator{QOrmSqliteStatementGenerator::WithForeignKeys};
+    QString actual = generator.generateAlterTableAddColumnStatement(
+        cache.get<Town>(), *cache.get<Town>().classPropertyMapping("province"));
+
+    QCOMPARE(actual,
+             R"(ALTER TABLE "Town" ADD COLUMN "province_id" INTEGER REFERENCES "Province"("id"))");
+}
+
+void SqliteStatementGenerator::testCreateIndex()
+{
+    QOrmMetadataCache cache;
+    const QOrmMetadata& community = cache.get<Community>();
+
+    QCOMPARE(community.indexes().size(), size_t{3});
+    QCOMPARE(
+        QOrmSqliteStatementGenerator{}.generateCreateIndexStatement(community,
+                                                                    community.indexes()[0]),
+        R"(CREATE UNIQUE INDEX "qtorm_communities_name_key" ON "communities"("name"))");
+    QCOMPARE(
+        QOrmSqliteStatementGenerator{}.generateCreateIndexStatement(community,
+                                                                    community.indexes()[1]),
+        R"(CREATE INDEX "qtorm_communities_province_id_name_idx" ON "communities"("province_id","name"))");
+    QCOMPARE(
+        QOrmSqliteStatementGenerator{}.generateCreateIndexStatement(community,
+                                                                    community.indexes()[2]),
+        R"(CREATE INDEX "qtorm_communities_lower_name_partial_idx" ON "communities"(lower("name")) WHERE ("population" >= 1000) AND ("province_id" IS NOT NULL))");
+    QCOMPARE(
+        QOrmSqliteStatementGenerator{}.generateDropIndexStatement("qtorm_communities_name_key"),
+        R"(DROP INDEX "qtorm_communities_name_key")");
+}
+
 void SqliteStatementGenerator::testSelectWithLimitOffset()
 {
     QOrmMetadataCache cache;
@@ -497,6 +576,28 @@ void SqliteStatementGenerator::testSelectWithNamespace()
     QCOMPARE(actual, R"(SELECT * FROM "MyNamespace_WithNamespace")");
 }
 
+void SqliteStatementGenerator::testSelectWithColumns()
+{
+    QOrmMetadataCache cache;
+
+    const QOrmMetadata& town = cache.get<Town>();
+
+    QOrmQuery query{QOrm::Operation::Read,
+                    QOrmRelation{town},
+                    town,
+                    std::nullopt,
+                    std::nullopt,
+                    {},
+                    QOrm::QueryFlags::None};
+    query.setColumns({*town.classPropertyMapping("province"), *town.classPropertyMapping("name")});
+
+    QVariantMap boundParameters;
+    QString actual{QOrmSqliteStatementGenerator{}
+                       .generateSelectStatement(query, boundParameters)
+                       .simplified()};
+    QCOMPARE(actual, R"(SELECT "id","province_id","name" FROM "Town")");
+}
+
 void SqliteStatementGenerator::testLimitOffset()
 {
     QFETCH(QVariant, limit);
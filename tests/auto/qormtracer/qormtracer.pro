@@ -0,0 +1,15 @@
+QT = core testlib orm
+
+CONFIG += testcase warn_on silent c++17
+
+TARGET = tst_tracer
+
+SOURCES +=  tst_tracer.cpp \
+    domain/province.cpp \
+    domain/town.cpp \
+
+HEADERS += \
+    domain/province.h \
+    domain/town.h \
+
+RESOURCES += tracer.qrc
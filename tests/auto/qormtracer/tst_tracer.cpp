@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2020-2021 Dmitriy Purgin <dpurgin@gmail.com>
+ * Copyright (C) 2019-2022 Dmitriy Purgin <dmitriy.purgin@sequality.at>
+ * Copyright (C) 2019-2022 sequality software engineering e.U. <office@sequality.at>
+ *
+ * This file is part of QtOrm library.
+ *
+ * QtOrm is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QtOrm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QtOrm.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <QtTest>
+
+#include <QOrmSession>
+#include <QOrmTracer>
+
+#include "domain/province.h"
+#include "domain/town.h"
+
+class TracerTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+
+    void testTraceSpansExportedAsChromeTrace();
+};
+
+void TracerTest::init()
+{
+    for (const QString& fileName : {"testdb.db", "testdb.db-wal", "testdb.db-shm"})
+    {
+        QFile db{fileName};
+
+        if (db.exists())
+            QVERIFY(db.remove());
+    }
+
+    qRegisterOrmEntity<Town, Province>();
+}
+
+void TracerTest::testTraceSpansExportedAsChromeTrace()
+{
+    QOrmSession session;
+
+    QVERIFY(!QOrmTracer::isEnabled());
+    QVERIFY(session.merge(new Province(QString::fromUtf8("Oberösterreich"))));
+    QCOMPARE(QOrmTracer::spanCount(), 0);
+
+    QOrmTracer::start();
+    auto tracerGuard = qScopeGuard([]() {
+        QOrmTracer::stop();
+        QOrmTracer::clear();
+    });
+
+    QVERIFY(session.merge(new Province(QString::fromUtf8("Niederösterreich"))));
+    QCOMPARE(session.from<Province>().select().toVector().size(), 2);
+
+    QOrmTracer::stop();
+
+    QJsonDocument trace = QJsonDocument::fromJson(QOrmTracer::toChromeTraceJson());
+    QJsonArray traceEvents = trace.object().value("traceEvents").toArray();
+    QCOMPARE(traceEvents.size(), QOrmTracer::spanCount());
+
+    QSet<QString> names;
+
+    for (const QJsonValue& value : traceEvents)
+    {
+        QJsonObject event = value.toObject();
+        QCOMPARE(event.value("ph").toString(), QString{"X"});
+        QVERIFY(event.value("dur").toDouble() >= 0);
+
+        names.insert(event.value("name").toString());
+
+        if (event.value("name").toString() == "QOrmSession::execute" &&
+            event.value("args").toObject().value("operation").toString() == "read")
+        {
+            QCOMPARE(event.value("args").toObject().value("entity").toString(),
+                     QString{"Province"});
+            QCOMPARE(event.value("args").toObject().value("rows").toInt(), 2);
+        }
+    }
+
+    QVERIFY(names.contains("QOrmSession::execute"));
+    QVERIFY(names.contains("QOrmSession::doMerge"));
+    QVERIFY(names.contains("QOrmSession::commitTransaction"));
+    QVERIFY(names.contains("QOrmSqliteStatementGenerator::generate"));
+    QVERIFY(names.contains("QOrmSqliteProvider::prepareAndExecute"));
+
+    // The ring buffer keeps the most recent spans
+    QOrmTracer::start(2);
+    QVERIFY(session.merge(new Province(QString::fromUtf8("Steiermark"))));
+    QCOMPARE(QOrmTracer::spanCount(), 2);
+}
+
+QTEST_GUILESS_MAIN(TracerTest)
+
+#include "tst_tracer.moc"
@@ -0,0 +1,9 @@
+TEMPLATE = subdirs
+
+# "make benchmark" runs all benchmarks. Pass TESTARGS="-json <file>" to write the results as JSON.
+SUBDIRS += \
+    datagen \
+    qormentitylistmodel \
+    qormmetadatacache \
+    qormsession \
+    qormsqlitestatementgenerator
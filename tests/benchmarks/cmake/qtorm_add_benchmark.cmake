@@ -0,0 +1,13 @@
+function(qtorm_add_benchmark)
+    set(OPTIONS)
+    set(ONE_VALUE_ARGS NAME)
+    set(MULTI_VALUE_ARGS SOURCES LINK_LIBRARIES)
+
+    cmake_parse_arguments(QTORM_ADD_BENCHMARK "${OPTIONS}" "${ONE_VALUE_ARGS}" "${MULTI_VALUE_ARGS}" ${ARGN})
+
+    add_executable(${QTORM_ADD_BENCHMARK_NAME} ${QTORM_ADD_BENCHMARK_SOURCES})
+    target_include_directories(${QTORM_ADD_BENCHMARK_NAME} PRIVATE ${QTORM_BENCHMARKS_SOURCE_DIR})
+    target_link_libraries(${QTORM_ADD_BENCHMARK_NAME} Qt5::Test qtorm ${QTORM_ADD_BENCHMARK_LINK_LIBRARIES})
+
+    set_property(GLOBAL APPEND PROPERTY QTORM_BENCHMARKS ${QTORM_ADD_BENCHMARK_NAME})
+endfunction()
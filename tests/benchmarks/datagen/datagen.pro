@@ -0,0 +1,17 @@
+QT = core orm
+
+CONFIG += console warn_on c++17
+CONFIG -= app_bundle
+
+TARGET = qtorm-datagen
+TEMPLATE = app
+
+INCLUDEPATH += $$PWD/..
+
+SOURCES += main.cpp \
+    ../domain/province.cpp \
+    ../domain/town.cpp \
+
+HEADERS += \
+    ../domain/province.h \
+    ../domain/town.h \
@@ -0,0 +1,136 @@
+/*
+ * Copyright (C) 2019 Dmitriy Purgin <dmitriy.purgin@sequality.at>
+ * Copyright (C) 2019 sequality software engineering e.U. <office@sequality.at>
+ *
+ * This file is part of QtOrm library.
+ *
+ * QtOrm is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QtOrm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QtOrm.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <QOrmDataGenerator>
+#include <QOrmError>
+#include <QOrmSession>
+#include <QOrmSqliteConfiguration>
+#include <QOrmSqliteProvider>
+#include <QtCore/qcommandlineparser.h>
+#include <QtCore/qcoreapplication.h>
+#include <QtCore/qelapsedtimer.h>
+#include <QtCore/qtextstream.h>
+
+#include "domain/province.h"
+#include "domain/town.h"
+
+namespace
+{
+    QTextStream& out()
+    {
+        static QTextStream stream{stdout, QIODevice::WriteOnly};
+        return stream;
+    }
+
+    QTextStream& err()
+    {
+        static QTextStream stream{stderr, QIODevice::WriteOnly | QIODevice::Unbuffered};
+        return stream;
+    }
+
+    const QHash<QString, QOrmDataGenerator::Distribution> distributions = {
+        {"sequential", QOrmDataGenerator::Distribution::Sequential},
+        {"uniform", QOrmDataGenerator::Distribution::Uniform},
+        {"normal", QOrmDataGenerator::Distribution::Normal},
+        {"zipf", QOrmDataGenerator::Distribution::Zipf}};
+} // namespace
+
+// Creates the Province/Town database used by the benchmarks with arbitrary sizes, e.g. to record
+// and replay workloads against it with qtorm-replay.
+int main(int argc, char* argv[])
+{
+    QCoreApplication application{argc, argv};
+    QCoreApplication::setApplicationName("qtorm-datagen");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(
+        "Generates a database of provinces and towns with synthetic values.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("database", "SQLite database to create or append to.");
+
+    QCommandLineOption provincesOption{"provinces", "Number of provinces.", "count", "10000"};
+    QCommandLineOption townsOption{"towns", "Number of towns.", "count", "1000000"};
+    QCommandLineOption seedOption{"seed", "Seed of the generated values.", "seed", "0"};
+    QCommandLineOption distributionOption{
+        "distribution",
+        "How the towns are spread over the provinces: sequential, uniform, normal or zipf.",
+        "distribution",
+        "uniform"};
+    QCommandLineOption nameLengthOption{
+        "name-length", "Minimum and maximum length of the names.", "min,max", "8,16"};
+    QCommandLineOption recreateOption{"recreate", "Drops the existing tables first."};
+
+    parser.addOptions({provincesOption,
+                       townsOption,
+                       seedOption,
+                       distributionOption,
+                       nameLengthOption,
+                       recreateOption});
+    parser.process(application);
+
+    if (parser.positionalArguments().size() != 1)
+        parser.showHelp(1);
+
+    QString distributionName = parser.value(distributionOption).toLower();
+    QStringList nameLength = parser.value(nameLengthOption).split(',');
+
+    if (!distributions.contains(distributionName) || nameLength.size() != 2)
+        parser.showHelp(1);
+
+    qRegisterOrmEntity<Province, Town>();
+
+    QOrmSqliteConfiguration sqliteConfiguration{};
+    sqliteConfiguration.setVerbose(false);
+    sqliteConfiguration.setSchemaMode(parser.isSet(recreateOption)
+                                          ? QOrmSqliteConfiguration::SchemaMode::Recreate
+                                          : QOrmSqliteConfiguration::SchemaMode::Append);
+    sqliteConfiguration.setDatabaseName(parser.positionalArguments().first());
+
+    QOrmSession session{
+        QOrmSessionConfiguration{new QOrmSqliteProvider{sqliteConfiguration}, false}};
+    QOrmDataGenerator generator{&session, parser.value(seedOption).toULongLong()};
+
+    generator.setRowCount<Province>(parser.value(provincesOption).toLongLong());
+    generator.setRowCount<Town>(parser.value(townsOption).toLongLong());
+
+    for (const QMetaObject* entity : {&Province::staticMetaObject, &Town::staticMetaObject})
+        generator.setStringLength(*entity, "name", nameLength[0].toInt(), nameLength[1].toInt());
+
+    generator.setReferenceDistribution(Town::staticMetaObject,
+                                       "province",
+                                       distributions.value(distributionName));
+
+    QElapsedTimer timer;
+    timer.start();
+
+    QOrmError error = generator.generate();
+
+    if (error.type() != QOrm::ErrorType::None)
+    {
+        err() << "Unable to generate the database: " << error.text() << "\n";
+        return 1;
+    }
+
+    out() << "Generated " << generator.generatedRowCount<Province>() << " provinces and "
+          << generator.generatedRowCount<Town>() << " towns in " << timer.elapsed() << " ms\n";
+
+    return 0;
+}
@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2019 Dmitriy Purgin <dmitriy.purgin@sequality.at>
+ * Copyright (C) 2019 sequality software engineering e.U. <office@sequality.at>
+ *
+ * This file is part of QtOrm library.
+ *
+ * QtOrm is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QtOrm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QtOrm.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "town.h"
+
+Town::Town(QObject* parent)
+    : QObject{parent}
+{
+}
+
+int Town::id() const
+{
+    return m_id;
+}
+
+void Town::setId(int id)
+{
+    if (m_id == id)
+        return;
+
+    m_id = id;
+    emit idChanged(m_id);
+}
+
+QString Town::name() const
+{
+    return m_name;
+}
+
+void Town::setName(QString name)
+{
+    if (m_name == name)
+        return;
+
+    m_name = name;
+    emit nameChanged(m_name);
+}
+
+int Town::population() const
+{
+    return m_population;
+}
+
+void Town::setPopulation(int population)
+{
+    if (m_population == population)
+        return;
+
+    m_population = population;
+    emit populationChanged(m_population);
+}
+
+Province* Town::province() const
+{
+    return m_province;
+}
+
+void Town::setProvince(Province* province)
+{
+    if (m_province == province)
+        return;
+
+    m_province = province;
+    emit provinceChanged(m_province);
+}
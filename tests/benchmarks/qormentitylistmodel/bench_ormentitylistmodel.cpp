@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2019 Dmitriy Purgin <dmitriy.purgin@sequality.at>
+ * Copyright (C) 2019 sequality software engineering e.U. <office@sequality.at>
+ *
+ * This file is part of QtOrm library.
+ *
+ * QtOrm is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QtOrm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QtOrm.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <QOrmDataGenerator>
+#include <QOrmEntityListModel>
+#include <QOrmError>
+#include <QOrmSession>
+#include <QOrmSqliteConfiguration>
+#include <QOrmSqliteProvider>
+#include <QtTest>
+
+#include <memory>
+
+#include "domain/province.h"
+#include "domain/town.h"
+#include "shared/qormbenchmark.h"
+
+class EntityListModelBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void data();
+
+private:
+    std::unique_ptr<QOrmSession> m_session;
+};
+
+void EntityListModelBenchmark::initTestCase()
+{
+    qRegisterOrmEntity<Province, Town>();
+
+    QOrmSqliteConfiguration sqliteConfiguration{};
+    sqliteConfiguration.setVerbose(false);
+    sqliteConfiguration.setSchemaMode(QOrmSqliteConfiguration::SchemaMode::Recreate);
+    sqliteConfiguration.setDatabaseName(":memory:");
+
+    m_session = std::make_unique<QOrmSession>(
+        QOrmSessionConfiguration{new QOrmSqliteProvider{sqliteConfiguration}, false});
+
+    QOrmDataGenerator generator{m_session.get()};
+    generator.setRowCount<Province>(1);
+    generator.setRowCount<Town>(1000);
+    generator.setStringPattern(Town::staticMetaObject, "name", "Town %1");
+
+    QCOMPARE(generator.generate().type(), QOrm::ErrorType::None);
+}
+
+void EntityListModelBenchmark::cleanupTestCase()
+{
+    m_session.reset();
+}
+
+// Reads every role of every row, as a view does when it is populated
+void EntityListModelBenchmark::data()
+{
+    QOrmEntityListModel<Town> towns{*m_session};
+
+    const QList<int> roles = towns.roleNames().keys();
+    QCOMPARE(towns.rowCount(), 1000);
+
+    QBENCHMARK
+    {
+        for (int row = 0; row < towns.rowCount(); ++row)
+        {
+            QModelIndex index = towns.index(row);
+
+            for (int role : roles)
+                QVERIFY(towns.data(index, role).isValid());
+        }
+    }
+}
+
+QTORM_BENCHMARK_MAIN(EntityListModelBenchmark)
+
+#include "bench_ormentitylistmodel.moc"
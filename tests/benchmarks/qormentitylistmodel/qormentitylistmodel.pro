@@ -0,0 +1,16 @@
+QT = core testlib orm
+
+CONFIG += testcase benchmark warn_on silent c++17
+
+TARGET = bench_ormentitylistmodel
+
+INCLUDEPATH += $$PWD/..
+
+SOURCES += bench_ormentitylistmodel.cpp \
+    ../domain/province.cpp \
+    ../domain/town.cpp \
+
+HEADERS += \
+    ../domain/province.h \
+    ../domain/town.h \
+    ../shared/qormbenchmark.h \
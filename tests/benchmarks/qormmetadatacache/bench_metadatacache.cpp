@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2019 Dmitriy Purgin <dmitriy.purgin@sequality.at>
+ * Copyright (C) 2019 sequality software engineering e.U. <office@sequality.at>
+ *
+ * This file is part of QtOrm library.
+ *
+ * QtOrm is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QtOrm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QtOrm.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <QOrmMetadataCache>
+#include <QtTest>
+
+#include "domain/province.h"
+#include "domain/town.h"
+#include "shared/qormbenchmark.h"
+
+class MetadataCacheBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void construction();
+    void lookup();
+};
+
+void MetadataCacheBenchmark::initTestCase()
+{
+    qRegisterOrmEntity<Province, Town>();
+}
+
+// Building the metadata of Town builds the metadata of the referenced Province as well
+void MetadataCacheBenchmark::construction()
+{
+    QBENCHMARK
+    {
+        QOrmMetadataCache cache;
+        QCOMPARE(cache.get<Town>().className(), QString{"Town"});
+    }
+}
+
+void MetadataCacheBenchmark::lookup()
+{
+    QOrmMetadataCache cache;
+    QCOMPARE(cache.get<Town>().className(), QString{"Town"});
+
+    QBENCHMARK
+    {
+        QCOMPARE(cache.get<Town>().className(), QString{"Town"});
+    }
+}
+
+QTORM_BENCHMARK_MAIN(MetadataCacheBenchmark)
+
+#include "bench_metadatacache.moc"
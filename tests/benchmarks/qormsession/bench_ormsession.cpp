@@ -0,0 +1,323 @@
+/*
+ * Copyright (C) 2019 Dmitriy Purgin <dmitriy.purgin@sequality.at>
+ * Copyright (C) 2019 sequality software engineering e.U. <office@sequality.at>
+ *
+ * This file is part of QtOrm library.
+ *
+ * QtOrm is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QtOrm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QtOrm.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <QOrmDataGenerator>
+#include <QOrmEntityInstanceCache>
+#include <QOrmError>
+#include <QOrmSession>
+#include <QOrmSqliteConfiguration>
+#include <QOrmSqliteProvider>
+#include <QTemporaryDir>
+#include <QtTest>
+
+#include <memory>
+
+#include "domain/province.h"
+#include "domain/town.h"
+#include "shared/qormbenchmark.h"
+
+namespace
+{
+    constexpr int ProvinceCount = 100;
+    constexpr int ReferencingTownCount = 1000;
+} // namespace
+
+class SessionBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void insertSingle();
+    void insertBulk();
+    void insertBulk_data();
+
+    void readByIdCacheHit();
+    void readByIdCacheMiss();
+
+    void filteredScan();
+    void filteredScan_data();
+
+    void referenceResolution();
+    void referenceResolution_data();
+
+    void updateOneColumn();
+
+private:
+    Province* province(int id);
+    [[nodiscard]] bool populate(int townCount);
+    Town* insertTown(Province* province, int population);
+    void removeInsertedTowns();
+
+    template<typename T>
+    void evict(const QVector<T*>& instances)
+    {
+        for (T* instance : instances)
+        {
+            if (m_session->entityInstanceCache()->contains(instance))
+                delete m_session->entityInstanceCache()->take(instance);
+        }
+    }
+
+    QTemporaryDir m_databaseDir;
+    std::unique_ptr<QOrmSession> m_session;
+    std::unique_ptr<QOrmDataGenerator> m_generator;
+    QVector<Town*> m_insertedTowns;
+};
+
+void SessionBenchmark::initTestCase()
+{
+    qRegisterOrmEntity<Province, Town>();
+
+    QVERIFY(m_databaseDir.isValid());
+
+    QOrmSqliteConfiguration sqliteConfiguration{};
+    sqliteConfiguration.setVerbose(false);
+    sqliteConfiguration.setSchemaMode(QOrmSqliteConfiguration::SchemaMode::Recreate);
+    sqliteConfiguration.setDatabaseName(m_databaseDir.filePath("benchmark.db"));
+
+    m_session = std::make_unique<QOrmSession>(
+        QOrmSessionConfiguration{new QOrmSqliteProvider{sqliteConfiguration}, false});
+
+    m_generator = std::make_unique<QOrmDataGenerator>(m_session.get());
+    m_generator->setStringPattern(Province::staticMetaObject, "name", "Province %1");
+    m_generator->setStringPattern(Town::staticMetaObject, "name", "Town %1");
+    m_generator->setValueRange(Town::staticMetaObject, "population", 0, 1000000);
+    m_generator->setReferenceDistribution(Town::staticMetaObject,
+                                          "province",
+                                          QOrmDataGenerator::Distribution::Sequential);
+
+    m_generator->setRowCount<Province>(ProvinceCount);
+    QCOMPARE(m_generator->generate().type(), QOrm::ErrorType::None);
+    m_generator->setRowCount<Province>(0);
+}
+
+void SessionBenchmark::cleanupTestCase()
+{
+    m_generator.reset();
+    m_session.reset();
+}
+
+void SessionBenchmark::insertSingle()
+{
+    Province* upperAustria = province(1);
+    QVERIFY(upperAustria != nullptr);
+
+    QBENCHMARK
+    {
+        QVERIFY(insertTown(upperAustria, 0) != nullptr);
+    }
+
+    removeInsertedTowns();
+}
+
+void SessionBenchmark::insertBulk()
+{
+    QFETCH(int, townCount);
+
+    Province* upperAustria = province(1);
+    QVERIFY(upperAustria != nullptr);
+
+    QBENCHMARK
+    {
+        auto token = m_session->declareTransaction(QOrm::TransactionPropagation::Require,
+                                                   QOrm::TransactionAction::Commit);
+
+        for (int i = 0; i < townCount; ++i)
+            QVERIFY(insertTown(upperAustria, i) != nullptr);
+    }
+
+    removeInsertedTowns();
+}
+
+void SessionBenchmark::insertBulk_data()
+{
+    QTest::addColumn<int>("townCount");
+
+    QTest::newRow("100") << 100;
+    QTest::newRow("1k") << 1000;
+}
+
+void SessionBenchmark::readByIdCacheHit()
+{
+    QVERIFY(province(1) != nullptr);
+
+    QBENCHMARK
+    {
+        auto result = m_session->from<Province>().filter(Q_ORM_CLASS_PROPERTY(id) == 1).select();
+        QCOMPARE(result.toVector().size(), 1);
+    }
+}
+
+void SessionBenchmark::readByIdCacheMiss()
+{
+    int objectId = 0;
+
+    QBENCHMARK
+    {
+        auto result = m_session->from<Province>()
+                          .filter(Q_ORM_CLASS_PROPERTY(id) == objectId % ProvinceCount + 1)
+                          .select();
+        QCOMPARE(result.toVector().size(), 1);
+
+        evict(result.toVector());
+        ++objectId;
+    }
+}
+
+void SessionBenchmark::filteredScan()
+{
+    QFETCH(int, townCount);
+
+    QVERIFY(populate(townCount));
+
+    // "name" is not indexed: every read scans the whole table
+    QString townName = QStringLiteral("Town %1").arg(townCount / 2);
+    QVector<Town*> towns;
+
+    QBENCHMARK
+    {
+        towns = m_session->from<Town>()
+                    .filter(Q_ORM_CLASS_PROPERTY(name) == townName)
+                    .select()
+                    .toVector();
+        QCOMPARE(towns.size(), 1);
+    }
+
+    evict(QVector<Province*>{towns.first()->province()});
+    evict(towns);
+}
+
+void SessionBenchmark::filteredScan_data()
+{
+    QTest::addColumn<int>("townCount");
+
+    QTest::newRow("1k") << 1000;
+    QTest::newRow("100k") << 100000;
+    QTest::newRow("1M") << 1000000;
+}
+
+void SessionBenchmark::referenceResolution()
+{
+    QFETCH(bool, prefetchProvinces);
+
+    QVERIFY(populate(ReferencingTownCount));
+
+    QBENCHMARK
+    {
+        QVector<Province*> provinces;
+
+        // batched: a single read puts all referenced provinces into the cache. Otherwise, every
+        // distinct province is read by a separate query while resolving the towns.
+        if (prefetchProvinces)
+            provinces = m_session->from<Province>().select().toVector();
+
+        QVector<Town*> towns =
+            m_session->from<Town>().limit(ReferencingTownCount).select().toVector();
+        QCOMPARE(towns.size(), ReferencingTownCount);
+
+        for (const Town* town : qAsConst(towns))
+        {
+            if (!provinces.contains(town->province()))
+                provinces.push_back(town->province());
+        }
+
+        evict(towns);
+        evict(provinces);
+    }
+}
+
+void SessionBenchmark::referenceResolution_data()
+{
+    QTest::addColumn<bool>("prefetchProvinces");
+
+    QTest::newRow("nPlusOne") << false;
+    QTest::newRow("batched") << true;
+}
+
+void SessionBenchmark::updateOneColumn()
+{
+    Town* town = insertTown(province(1), 0);
+    QVERIFY(town != nullptr);
+
+    QBENCHMARK
+    {
+        town->setPopulation(town->population() + 1);
+        QVERIFY(m_session->merge(town));
+    }
+
+    removeInsertedTowns();
+}
+
+Province* SessionBenchmark::province(int id)
+{
+    QVector<Province*> provinces =
+        m_session->from<Province>().filter(Q_ORM_CLASS_PROPERTY(id) == id).select().toVector();
+
+    return provinces.isEmpty() ? nullptr : provinces.first();
+}
+
+// Generates the missing towns in bulk so that large tables are set up in reasonable time
+bool SessionBenchmark::populate(int townCount)
+{
+    qint64 populatedTownCount = m_generator->generatedRowCount<Town>();
+
+    if (populatedTownCount >= townCount)
+        return true;
+
+    m_generator->setRowCount<Town>(townCount - populatedTownCount);
+
+    return m_generator->generate().type() == QOrm::ErrorType::None;
+}
+
+Town* SessionBenchmark::insertTown(Province* province, int population)
+{
+    Town* town = new Town{QStringLiteral("Inserted town"), population, province};
+
+    if (!m_session->merge(town))
+    {
+        delete town;
+        return nullptr;
+    }
+
+    m_insertedTowns.push_back(town);
+
+    return town;
+}
+
+// Keeps the table sizes of the scans independent of the number of insert benchmark iterations
+void SessionBenchmark::removeInsertedTowns()
+{
+    evict(m_insertedTowns);
+    m_insertedTowns.clear();
+
+    QOrmQueryResult<Town> result = m_session->from<Town>()
+                                       .filter(Q_ORM_CLASS_PROPERTY(name) ==
+                                               QStringLiteral("Inserted town"))
+                                       .remove();
+    QCOMPARE(result.error().type(), QOrm::ErrorType::None);
+}
+
+QTORM_BENCHMARK_MAIN(SessionBenchmark)
+
+#include "bench_ormsession.moc"
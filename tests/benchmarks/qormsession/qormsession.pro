@@ -0,0 +1,16 @@
+QT = core testlib orm sql
+
+CONFIG += testcase benchmark warn_on silent c++17
+
+TARGET = bench_ormsession
+
+INCLUDEPATH += $$PWD/..
+
+SOURCES += bench_ormsession.cpp \
+    ../domain/province.cpp \
+    ../domain/town.cpp \
+
+HEADERS += \
+    ../domain/province.h \
+    ../domain/town.h \
+    ../shared/qormbenchmark.h \
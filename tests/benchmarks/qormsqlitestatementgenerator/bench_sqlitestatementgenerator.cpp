@@ -0,0 +1,144 @@
+/*
+ * Copyright (C) 2019 Dmitriy Purgin <dmitriy.purgin@sequality.at>
+ * Copyright (C) 2019 sequality software engineering e.U. <office@sequality.at>
+ *
+ * This file is part of QtOrm library.
+ *
+ * QtOrm is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QtOrm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QtOrm.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <QOrmFilter>
+#include <QOrmFilterExpression>
+#include <QOrmMetadataCache>
+#include <QOrmOrder>
+#include <QOrmQuery>
+#include <QOrmRelation>
+#include <QtTest>
+
+#include "domain/province.h"
+#include "domain/town.h"
+#include "shared/qormbenchmark.h"
+
+#include "private/qormglobal_p.h"
+#include "private/qormsqlitestatementgenerator_p.h"
+
+class SqliteStatementGeneratorBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void generateSelect();
+    void generateInsert();
+    void generateUpdate();
+    void generateDelete();
+
+private:
+    QOrmMetadataCache m_cache;
+};
+
+void SqliteStatementGeneratorBenchmark::initTestCase()
+{
+    qRegisterOrmEntity<Province, Town>();
+}
+
+void SqliteStatementGeneratorBenchmark::generateSelect()
+{
+    const QOrmMetadata& town = m_cache.get<Town>();
+    QOrmRelation relation{town};
+    QOrmFilter filter{QOrmPrivate::resolvedFilterExpression(
+        relation,
+        Q_ORM_CLASS_PROPERTY(population) > 1000 &&
+            Q_ORM_CLASS_PROPERTY(name) != QString::fromUtf8("Hagenberg im Mühlkreis"))};
+    std::vector<QOrmOrder> order{{*town.classPropertyMapping("name"), Qt::AscendingOrder}};
+
+    QOrmQuery query{
+        QOrm::Operation::Read, relation, town, filter, std::nullopt, order, QOrm::QueryFlags::None};
+    query.setLimit(10);
+
+    QOrmSqliteStatementGenerator generator;
+
+    QBENCHMARK
+    {
+        auto [statement, boundParameters] = generator.generate(query);
+        Q_UNUSED(statement)
+        Q_UNUSED(boundParameters)
+    }
+}
+
+void SqliteStatementGeneratorBenchmark::generateInsert()
+{
+    Province upperAustria{QString::fromUtf8("Oberösterreich")};
+    upperAustria.setId(1);
+    Town hagenberg{QString::fromUtf8("Hagenberg im Mühlkreis"), 2800, &upperAustria};
+
+    QOrmQuery query{QOrm::Operation::Create, m_cache.get<Town>(), &hagenberg};
+    QOrmSqliteStatementGenerator generator;
+
+    QBENCHMARK
+    {
+        auto [statement, boundParameters] = generator.generate(query);
+        Q_UNUSED(statement)
+        Q_UNUSED(boundParameters)
+    }
+}
+
+void SqliteStatementGeneratorBenchmark::generateUpdate()
+{
+    Province upperAustria{QString::fromUtf8("Oberösterreich")};
+    upperAustria.setId(1);
+    Town hagenberg{QString::fromUtf8("Hagenberg im Mühlkreis"), 2800, &upperAustria};
+    hagenberg.setId(1);
+
+    QOrmQuery query{QOrm::Operation::Update, m_cache.get<Town>(), &hagenberg};
+    QOrmSqliteStatementGenerator generator;
+
+    QBENCHMARK
+    {
+        auto [statement, boundParameters] = generator.generate(query);
+        Q_UNUSED(statement)
+        Q_UNUSED(boundParameters)
+    }
+}
+
+void SqliteStatementGeneratorBenchmark::generateDelete()
+{
+    const QOrmMetadata& town = m_cache.get<Town>();
+    QOrmRelation relation{town};
+    QOrmFilter filter{QOrmPrivate::resolvedFilterExpression(
+        relation, Q_ORM_CLASS_PROPERTY(id) == QVector<int>{1, 2, 3, 5, 8, 13})};
+
+    QOrmQuery query{QOrm::Operation::Delete,
+                    relation,
+                    std::nullopt,
+                    filter,
+                    std::nullopt,
+                    {},
+                    QOrm::QueryFlags::None};
+
+    QOrmSqliteStatementGenerator generator;
+
+    QBENCHMARK
+    {
+        auto [statement, boundParameters] = generator.generate(query);
+        Q_UNUSED(statement)
+        Q_UNUSED(boundParameters)
+    }
+}
+
+QTORM_BENCHMARK_MAIN(SqliteStatementGeneratorBenchmark)
+
+#include "bench_sqlitestatementgenerator.moc"
@@ -0,0 +1,16 @@
+QT = core testlib orm orm-private
+
+CONFIG += testcase benchmark warn_on silent c++17
+
+TARGET = bench_sqlitestatementgenerator
+
+INCLUDEPATH += $$PWD/..
+
+SOURCES += bench_sqlitestatementgenerator.cpp \
+    ../domain/province.cpp \
+    ../domain/town.cpp \
+
+HEADERS += \
+    ../domain/province.h \
+    ../domain/town.h \
+    ../shared/qormbenchmark.h \
@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) 2019 Dmitriy Purgin <dmitriy.purgin@sequality.at>
+ * Copyright (C) 2019 sequality software engineering e.U. <office@sequality.at>
+ *
+ * This file is part of QtOrm library.
+ *
+ * QtOrm is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QtOrm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QtOrm.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <QtCore/qcoreapplication.h>
+#include <QtCore/qfile.h>
+#include <QtCore/qjsonarray.h>
+#include <QtCore/qjsondocument.h>
+#include <QtCore/qjsonobject.h>
+#include <QtCore/qtemporarydir.h>
+#include <QtCore/qxmlstream.h>
+#include <QtTest/qtest.h>
+
+namespace QOrmBenchmark
+{
+    // Converts the QtTest XML log into a JSON object of the form
+    //   {"testCase": ..., "qtVersion": ...,
+    //    "results": [{"function": ..., "tag": ..., "metric": ..., "value": ...,
+    //                 "iterations": ...}]}
+    inline QJsonObject xmlLogToJson(QIODevice* xmlLog)
+    {
+        QJsonObject json;
+        QJsonArray results;
+        QString function;
+
+        QXmlStreamReader reader{xmlLog};
+
+        while (!reader.atEnd())
+        {
+            if (reader.readNext() != QXmlStreamReader::StartElement)
+                continue;
+
+            const QXmlStreamAttributes attributes = reader.attributes();
+            auto attribute = [&attributes](const char* name) {
+                return attributes.value(QLatin1String{name});
+            };
+
+            if (reader.name() == QLatin1String("TestCase"))
+            {
+                json.insert(QStringLiteral("testCase"), attribute("name").toString());
+            }
+            else if (reader.name() == QLatin1String("QtVersion"))
+            {
+                json.insert(QStringLiteral("qtVersion"), reader.readElementText());
+            }
+            else if (reader.name() == QLatin1String("TestFunction"))
+            {
+                function = attribute("name").toString();
+            }
+            else if (reader.name() == QLatin1String("BenchmarkResult"))
+            {
+                results.append(QJsonObject{
+                    {QStringLiteral("function"), function},
+                    {QStringLiteral("tag"), attribute("tag").toString()},
+                    {QStringLiteral("metric"), attribute("metric").toString()},
+                    {QStringLiteral("value"), attribute("value").toDouble()},
+                    {QStringLiteral("iterations"), attribute("iterations").toInt()}});
+            }
+        }
+
+        json.insert(QStringLiteral("results"), results);
+
+        return json;
+    }
+
+    // Runs the test object. If "-json <file>" is passed on the command line, the benchmark results
+    // are additionally written to <file>. Other arguments are passed to QtTest unchanged.
+    inline int exec(QObject* testObject, int argc, char* argv[])
+    {
+        QStringList arguments;
+
+        for (int i = 0; i < argc; ++i)
+            arguments.push_back(QString::fromLocal8Bit(argv[i]));
+
+        int jsonIndex = arguments.indexOf(QStringLiteral("-json"));
+
+        if (jsonIndex < 0 || jsonIndex + 1 >= arguments.size())
+            return QTest::qExec(testObject, arguments);
+
+        QString jsonFileName = arguments.takeAt(jsonIndex + 1);
+        arguments.removeAt(jsonIndex);
+
+        QTemporaryDir xmlLogDir;
+        QString xmlLogFileName = xmlLogDir.filePath(QStringLiteral("results.xml"));
+
+        arguments << QStringLiteral("-o") << xmlLogFileName + QStringLiteral(",xml")
+                  << QStringLiteral("-o") << QStringLiteral("-,txt");
+
+        int result = QTest::qExec(testObject, arguments);
+
+        QFile xmlLog{xmlLogFileName};
+
+        if (!xmlLog.open(QIODevice::ReadOnly))
+        {
+            qCritical() << "Unable to read the benchmark log" << xmlLogFileName;
+            return result != 0 ? result : 1;
+        }
+
+        QJsonObject json = xmlLogToJson(&xmlLog);
+        json.insert(QStringLiteral("passed"), result == 0);
+
+        QFile jsonFile{jsonFileName};
+
+        if (!jsonFile.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        {
+            qCritical() << "Unable to write the benchmark results to" << jsonFileName;
+            return result != 0 ? result : 1;
+        }
+
+        jsonFile.write(QJsonDocument{json}.toJson());
+
+        return result;
+    }
+} // namespace QOrmBenchmark
+
+#define QTORM_BENCHMARK_MAIN(TestObject)                                                           \
+    int main(int argc, char* argv[])                                                               \
+    {                                                                                              \
+        QCoreApplication app{argc, argv};                                                          \
+        TestObject testObject;                                                                     \
+        return QOrmBenchmark::exec(&testObject, argc, argv);                                       \
+    }
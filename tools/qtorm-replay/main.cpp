@@ -0,0 +1,507 @@
+/*
+ * Copyright (C) 2019 Dmitriy Purgin <dmitriy.purgin@sequality.at>
+ * Copyright (C) 2019 sequality software engineering e.U. <office@sequality.at>
+ *
+ * This file is part of QtOrm library.
+ *
+ * QtOrm is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QtOrm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QtOrm.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <QtCore/qcommandlineparser.h>
+#include <QtCore/qcoreapplication.h>
+#include <QtCore/qdir.h>
+#include <QtCore/qelapsedtimer.h>
+#include <QtCore/qfile.h>
+#include <QtCore/qfileinfo.h>
+#include <QtCore/qtemporarydir.h>
+#include <QtCore/qtextstream.h>
+#include <QtSql/qsqldatabase.h>
+#include <QtSql/qsqlerror.h>
+#include <QtSql/qsqlquery.h>
+
+#include "private/qormworkloadlog_p.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <map>
+#include <mutex>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+using QOrmPrivate::WorkloadEvent;
+
+namespace
+{
+    // A transaction or a statement executed outside of a transaction
+    struct WorkUnit
+    {
+        bool isTransaction{false};
+        bool commit{true};
+        std::vector<WorkloadEvent> statements;
+        // Recorded duration of the transaction
+        qint64 durationNsecs{0};
+    };
+
+    struct Latencies
+    {
+        std::vector<qint64> replayed;
+        std::vector<qint64> recorded;
+        qint64 errors{0};
+
+        void merge(const Latencies& other)
+        {
+            replayed.insert(replayed.end(), other.replayed.begin(), other.replayed.end());
+            recorded.insert(recorded.end(), other.recorded.begin(), other.recorded.end());
+            errors += other.errors;
+        }
+    };
+
+    struct ReplayResult
+    {
+        std::map<QString, Latencies> statements;
+        Latencies transactions;
+    };
+
+    QTextStream& out()
+    {
+        static QTextStream stream{stdout};
+        return stream;
+    }
+
+    QTextStream& err()
+    {
+        static QTextStream stream{stderr, QIODevice::WriteOnly | QIODevice::Unbuffered};
+        return stream;
+    }
+
+    // The values must be sorted
+    qint64 percentile(const std::vector<qint64>& values, double percentile)
+    {
+        if (values.empty())
+            return 0;
+
+        auto rank = static_cast<size_t>(std::ceil(percentile / 100.0 * values.size()));
+        return values[std::clamp<size_t>(rank, 1, values.size()) - 1];
+    }
+
+    QString formatNsecs(qint64 nsecs)
+    {
+        if (nsecs < 10000)
+            return QStringLiteral("%1 ns").arg(nsecs);
+        if (nsecs < 10000000)
+            return QStringLiteral("%1 us").arg(nsecs / 1000.0, 0, 'f', 1);
+
+        return QStringLiteral("%1 ms").arg(nsecs / 1000000.0, 0, 'f', 1);
+    }
+
+    QString abbreviated(QString statement, int length)
+    {
+        statement = statement.simplified();
+
+        if (statement.size() > length)
+            statement = statement.left(length - 3) + QStringLiteral("...");
+
+        return statement;
+    }
+
+    bool readWorkUnits(const QString& fileName, std::vector<WorkUnit>& units)
+    {
+        QOrmPrivate::WorkloadLogReader reader;
+
+        if (!reader.open(fileName))
+        {
+            err() << reader.errorString() << "\n";
+            return false;
+        }
+
+        WorkloadEvent event;
+        // Transactions in progress by connection: the transactions of concurrent connections
+        // interleave in the log
+        std::map<quint32, WorkUnit> transactions;
+        std::map<quint32, qint64> transactionBegins;
+
+        while (reader.readNext(event))
+        {
+            switch (event.type)
+            {
+                case WorkloadEvent::Type::Statement:
+                {
+                    auto transaction = transactions.find(event.connection);
+
+                    if (transaction != transactions.end())
+                        transaction->second.statements.push_back(event);
+                    else
+                        units.push_back(WorkUnit{false, true, {event}, event.durationNsecs});
+                    break;
+                }
+
+                case WorkloadEvent::Type::BeginTransaction:
+                    transactions[event.connection] = WorkUnit{true, true, {}, 0};
+                    transactionBegins[event.connection] = event.timestampNsecs;
+                    break;
+
+                case WorkloadEvent::Type::CommitTransaction:
+                case WorkloadEvent::Type::RollbackTransaction:
+                {
+                    auto transaction = transactions.find(event.connection);
+
+                    if (transaction == transactions.end())
+                        break;
+
+                    transaction->second.commit =
+                        event.type == WorkloadEvent::Type::CommitTransaction;
+                    transaction->second.durationNsecs =
+                        event.timestampNsecs - transactionBegins[event.connection];
+                    units.push_back(std::move(transaction->second));
+                    transactions.erase(transaction);
+                    break;
+                }
+            }
+        }
+
+        if (!reader.errorString().isEmpty())
+        {
+            err() << fileName << ": " << reader.errorString()
+                  << "; replaying the complete transactions only\n";
+        }
+
+        return true;
+    }
+
+    bool execute(QSqlDatabase& database,
+                 const WorkloadEvent& statement,
+                 Latencies& latencies,
+                 QString& errorString)
+    {
+        QElapsedTimer timer;
+        timer.start();
+
+        QSqlQuery query{database};
+        query.setForwardOnly(true);
+
+        bool ok = query.prepare(statement.statement);
+
+        if (ok)
+        {
+            for (auto it = statement.parameters.begin(); it != statement.parameters.end(); ++it)
+                query.bindValue(it.key(), it.value());
+
+            for (const QVariant& value : statement.positionalParameters)
+                query.addBindValue(value);
+
+            ok = query.exec();
+
+            while (ok && query.isSelect() && query.next())
+                ;
+        }
+
+        if (!ok)
+        {
+            latencies.errors += 1;
+            errorString = query.lastError().text();
+            return false;
+        }
+
+        latencies.replayed.push_back(timer.nsecsElapsed());
+        latencies.recorded.push_back(statement.durationNsecs);
+
+        return true;
+    }
+
+    void replay(int worker,
+                const QString& databaseName,
+                const QStringList& pragmas,
+                const std::vector<WorkUnit>& units,
+                std::atomic<size_t>& nextUnit,
+                ReplayResult& result,
+                std::mutex& errorMutex)
+    {
+        QString connectionName = QStringLiteral("qtorm-replay-%1").arg(worker);
+
+        {
+            QSqlDatabase database = QSqlDatabase::addDatabase("QSQLITE", connectionName);
+            database.setDatabaseName(databaseName);
+            database.setConnectOptions(QStringLiteral("QSQLITE_BUSY_TIMEOUT=60000"));
+
+            if (!database.open())
+            {
+                std::lock_guard<std::mutex> lock{errorMutex};
+                err() << "Unable to open " << databaseName << ": " << database.lastError().text()
+                      << "\n";
+                return;
+            }
+
+            for (const QString& pragma : pragmas)
+                QSqlQuery{database}.exec(QStringLiteral("PRAGMA ") + pragma);
+
+            for (size_t index = nextUnit++; index < units.size(); index = nextUnit++)
+            {
+                const WorkUnit& unit = units[index];
+                QString errorString;
+
+                QElapsedTimer transactionTimer;
+                transactionTimer.start();
+
+                if (unit.isTransaction && !database.transaction())
+                {
+                    result.transactions.errors += 1;
+                    continue;
+                }
+
+                for (const WorkloadEvent& statement : unit.statements)
+                {
+                    if (!execute(database, statement, result.statements[statement.statement],
+                                 errorString))
+                    {
+                        std::lock_guard<std::mutex> lock{errorMutex};
+                        err() << "Error in " << abbreviated(statement.statement, 60) << ": "
+                              << errorString << "\n";
+                    }
+                }
+
+                if (unit.isTransaction)
+                {
+                    bool ok = unit.commit ? database.commit() : database.rollback();
+
+                    if (!ok)
+                    {
+                        result.transactions.errors += 1;
+                        database.rollback();
+                        continue;
+                    }
+
+                    result.transactions.replayed.push_back(transactionTimer.nsecsElapsed());
+                    result.transactions.recorded.push_back(unit.durationNsecs);
+                }
+            }
+
+            database.close();
+        }
+
+        QSqlDatabase::removeDatabase(connectionName);
+    }
+
+    void printHistogram(const std::vector<qint64>& sorted)
+    {
+        if (sorted.empty())
+            return;
+
+        // Power-of-two buckets in microseconds
+        std::map<int, qint64> buckets;
+
+        for (qint64 nsecs : sorted)
+        {
+            qint64 usecs = std::max<qint64>(nsecs / 1000, 1);
+            buckets[static_cast<int>(std::log2(static_cast<double>(usecs)))] += 1;
+        }
+
+        qint64 maxCount = 0;
+
+        for (const auto& [bucket, count] : buckets)
+            maxCount = std::max(maxCount, count);
+
+        for (const auto& [bucket, count] : buckets)
+        {
+            QString range = QStringLiteral("%1 - %2 us").arg(qint64{1} << bucket).arg(
+                (qint64{1} << (bucket + 1)) - 1);
+            int width = static_cast<int>(50 * count / maxCount);
+
+            out() << QStringLiteral("  %1 | %2 %3")
+                         .arg(range, 24)
+                         .arg(QString{width, QLatin1Char('#')})
+                         .arg(count)
+                  << "\n";
+        }
+    }
+
+    void printLatencies(const QString& title, Latencies& latencies)
+    {
+        std::sort(latencies.replayed.begin(), latencies.replayed.end());
+        std::sort(latencies.recorded.begin(), latencies.recorded.end());
+
+        out() << title << ": " << latencies.replayed.size() << " replayed, " << latencies.errors
+              << " failed\n";
+
+        if (latencies.replayed.empty())
+            return;
+
+        out() << QStringLiteral("  %1 %2 %3 %4 %5")
+                     .arg(QString{}, -10)
+                     .arg("p50", 12)
+                     .arg("p95", 12)
+                     .arg("p99", 12)
+                     .arg("max", 12)
+              << "\n";
+
+        for (auto [name, values] :
+             {std::make_pair("replayed", &latencies.replayed),
+              std::make_pair("recorded", &latencies.recorded)})
+        {
+            out() << QStringLiteral("  %1 %2 %3 %4 %5")
+                         .arg(QString::fromLatin1(name), -10)
+                         .arg(formatNsecs(percentile(*values, 50)), 12)
+                         .arg(formatNsecs(percentile(*values, 95)), 12)
+                         .arg(formatNsecs(percentile(*values, 99)), 12)
+                         .arg(formatNsecs(values->empty() ? 0 : values->back()), 12)
+                  << "\n";
+        }
+
+        printHistogram(latencies.replayed);
+    }
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication application{argc, argv};
+    QCoreApplication::setApplicationName("qtorm-replay");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(
+        "Replays a QtOrm workload log against a copy of an SQLite database and reports the "
+        "statement latencies.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("log", "Workload log recorded with the workloadLog option.");
+    parser.addPositionalArgument("database", "SQLite database to replay the workload against.");
+
+    QCommandLineOption concurrencyOption{{"j", "concurrency"},
+                                         "Number of connections replaying in parallel.",
+                                         "connections",
+                                         "1"};
+    QCommandLineOption pragmaOption{
+        {"p", "pragma"},
+        "Executes PRAGMA <pragma> on every connection before replaying, e.g. cache_size=-65536.",
+        "pragma"};
+    QCommandLineOption inPlaceOption{
+        "in-place", "Replays against the database itself instead of a temporary copy."};
+    QCommandLineOption topOption{
+        "top", "Number of statement shapes to report, by total time.", "count", "10"};
+
+    parser.addOptions({concurrencyOption, pragmaOption, inPlaceOption, topOption});
+    parser.process(application);
+
+    if (parser.positionalArguments().size() != 2)
+        parser.showHelp(1);
+
+    QString logFileName = parser.positionalArguments().at(0);
+    QString databaseName = parser.positionalArguments().at(1);
+    int concurrency = std::max(parser.value(concurrencyOption).toInt(), 1);
+
+    std::vector<WorkUnit> units;
+
+    if (!readWorkUnits(logFileName, units))
+        return 1;
+
+    QTemporaryDir temporaryDir;
+
+    if (!parser.isSet(inPlaceOption))
+    {
+        QString copyName = temporaryDir.filePath(QFileInfo{databaseName}.fileName());
+
+        // The committed transactions of a database in WAL mode may not have been checkpointed
+        // into the database file yet. The shared-memory index is rebuilt from the WAL file.
+        for (const QString& suffix : {QString{}, QStringLiteral("-wal")})
+        {
+            if (!suffix.isEmpty() && !QFile::exists(databaseName + suffix))
+                continue;
+
+            if (!temporaryDir.isValid() || !QFile::copy(databaseName + suffix, copyName + suffix))
+            {
+                err() << "Unable to copy " << databaseName + suffix << " to " << copyName + suffix
+                      << "\n";
+                return 1;
+            }
+        }
+
+        databaseName = copyName;
+    }
+
+    std::vector<ReplayResult> results(static_cast<size_t>(concurrency));
+    std::vector<std::thread> workers;
+    std::atomic<size_t> nextUnit{0};
+    std::mutex errorMutex;
+
+    QElapsedTimer wallClock;
+    wallClock.start();
+
+    for (int worker = 0; worker < concurrency; ++worker)
+    {
+        workers.emplace_back(replay,
+                             worker,
+                             databaseName,
+                             parser.values(pragmaOption),
+                             std::cref(units),
+                             std::ref(nextUnit),
+                             std::ref(results[static_cast<size_t>(worker)]),
+                             std::ref(errorMutex));
+    }
+
+    for (std::thread& worker : workers)
+        worker.join();
+
+    qint64 wallTime = wallClock.nsecsElapsed();
+
+    ReplayResult total;
+
+    for (const ReplayResult& result : results)
+    {
+        for (const auto& [statement, latencies] : result.statements)
+            total.statements[statement].merge(latencies);
+
+        total.transactions.merge(result.transactions);
+    }
+
+    Latencies allStatements;
+
+    for (const auto& [statement, latencies] : total.statements)
+        allStatements.merge(latencies);
+
+    out() << "Replayed " << units.size() << " units of work with " << concurrency
+          << " connection(s) in " << formatNsecs(wallTime) << " ("
+          << QString::number(allStatements.replayed.size() * 1e9 / std::max<qint64>(wallTime, 1),
+                             'f',
+                             0)
+          << " statements/s)\n\n";
+
+    printLatencies("Statements", allStatements);
+    out() << "\n";
+    printLatencies("Transactions", total.transactions);
+
+    std::vector<std::pair<QString, Latencies*>> shapes;
+
+    for (auto& [statement, latencies] : total.statements)
+        shapes.emplace_back(statement, &latencies);
+
+    auto totalTime = [](const Latencies* latencies) {
+        return std::accumulate(latencies->replayed.begin(), latencies->replayed.end(), qint64{0});
+    };
+
+    std::sort(shapes.begin(), shapes.end(), [&totalTime](const auto& lhs, const auto& rhs) {
+        return totalTime(lhs.second) > totalTime(rhs.second);
+    });
+
+    shapes.resize(std::min(shapes.size(), static_cast<size_t>(parser.value(topOption).toInt())));
+
+    for (auto& [statement, latencies] : shapes)
+    {
+        out() << "\n";
+        printLatencies(abbreviated(statement, 100), *latencies);
+    }
+
+    out().flush();
+
+    return 0;
+}
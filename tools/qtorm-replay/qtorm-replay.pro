@@ -0,0 +1,12 @@
+QT = core sql orm orm-private
+
+CONFIG += console warn_on c++17
+CONFIG -= app_bundle
+
+TARGET = qtorm-replay
+TEMPLATE = app
+
+SOURCES += main.cpp
+
+target.path = $$[QT_INSTALL_BINS]
+INSTALLS += target